@@ -13,6 +13,7 @@ namespace ConfigConsts
     {
         static const unsigned int database_tag_name_len;
         static const unsigned int database_tag_value_len;
+        static const unsigned int database_search_term_len;
     };
 
 }
@@ -10,7 +10,11 @@ find_package(Qt5Test REQUIRED)
 addTestTarget(core
                 SOURCES
                     implementation/base_tags.cpp
-                    #implementation/oriented_image.cpp
+                    implementation/ffmpeg_frame_extractor.cpp
+                    implementation/ffmpeg_video_details_reader.cpp
+                    implementation/log_writer.cpp
+                    implementation/logger.cpp
+                    implementation/oriented_image.cpp
                     implementation/model_compositor.cpp
                     implementation/qmodelindex_selector.cpp
                     implementation/qmodelindex_comparator.cpp
@@ -18,20 +22,25 @@ addTestTarget(core
                     implementation/thumbnail_manager.cpp
                     implementation/thumbnails_cache.cpp
                     implementation/task_executor_utils.cpp
+                    implementation/thread_utils_null.cpp
                     imodel_compositor_data_source.hpp
 
                     unit_tests/containers_utils_tests.cpp
+                    unit_tests/ffmpeg_frame_extractor_tests.cpp
+                    unit_tests/ffmpeg_video_details_reader_tests.cpp
                     unit_tests/function_wrappers_tests.cpp
                     unit_tests/lazy_ptr_tests.cpp
+                    unit_tests/log_writer_tests.cpp
                     unit_tests/map_iterator_tests.cpp
                     unit_tests/model_compositor_tests.cpp
-                    #unit_tests/oriented_image_tests.cpp
+                    unit_tests/oriented_image_tests.cpp
                     unit_tests/ptr_iterator_tests.cpp
                     unit_tests/qmodelindex_comparator_tests.cpp
                     unit_tests/qmodelindex_selector_tests.cpp
                     unit_tests/status_tests.cpp
                     unit_tests/tag_name_info_tests.cpp
                     unit_tests/tag_value_tests.cpp
+                    unit_tests/task_executor_utils_tests.cpp
                     unit_tests/thumbnails_manager_tests.cpp
                     unit_tests/thumbnails_cache_tests.cpp
                 LIBRARIES
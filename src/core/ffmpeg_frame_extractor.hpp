@@ -0,0 +1,59 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FFMPEGFRAMEEXTRACTOR_HPP
+#define FFMPEGFRAMEEXTRACTOR_HPP
+
+#include <vector>
+
+#include <QImage>
+#include <QString>
+
+#include "core_export.h"
+
+// Class is reetrant.
+// Frames are read from ffmpeg's stdout as raw rgb data,
+// no temporary files nor intermediate image formats are used.
+
+class CORE_EXPORT FFMpegFrameExtractor
+{
+    public:
+        FFMpegFrameExtractor(const QString& ffmpegPath, const QString& ffprobePath);
+        FFMpegFrameExtractor(const FFMpegFrameExtractor &) = delete;
+        FFMpegFrameExtractor(FFMpegFrameExtractor &&) = delete;
+
+        FFMpegFrameExtractor& operator=(const FFMpegFrameExtractor &) = delete;
+        FFMpegFrameExtractor& operator=(FFMpegFrameExtractor &&) = delete;
+
+        virtual ~FFMpegFrameExtractor() = default;
+
+        QImage frameAt(const QString& video_file, int positionMs, int height) const;
+        std::vector<QImage> frames(const QString& video_file, int count, int height) const;  // 'count' frames evenly distributed over video
+        QImage strip(const QString& video_file, int count, int height) const;               // 'frames' placed side by side
+
+        static std::vector<QImage> decodeFrames(const QByteArray& raw, const QSize& size);  // split raw rgb24 data into frames of given size
+
+    private:
+        const QString m_ffmpegPath;
+        const QString m_ffprobePath;
+
+        std::vector<QImage> read(const QString& video_file, const QStringList& input_args, const QString& filters, int count, int height) const;
+};
+
+#endif // FFMPEGFRAMEEXTRACTOR_HPP
@@ -22,17 +22,28 @@
 
 #include <optional>
 
+#include <QByteArray>
 #include <QSize>
 #include <QStringList>
 
 #include "core_export.h"
 
 // Class is reetrant.
-// All its methods may take a while as ffmpeg is called inside
+// All its methods may take a while as ffmpeg is called inside.
+// ffprobe is run once per file, results are cached (and shared between instances)
+// until file is modified.
 
 class CORE_EXPORT FFMpegVideoDetailsReader
 {
     public:
+        struct Details
+        {
+            std::optional<QSize> resolution;                    // resolution with rotation applied
+            int durationMs = -1;
+            int rotation = 0;
+            bool readable = false;                              // ffprobe recognized file
+        };
+
         explicit FFMpegVideoDetailsReader(const QString& ffprobePath);
         FFMpegVideoDetailsReader(const FFMpegVideoDetailsReader &) = delete;
         FFMpegVideoDetailsReader(FFMpegVideoDetailsReader &&) = delete;
@@ -42,16 +53,18 @@ class CORE_EXPORT FFMpegVideoDetailsReader
 
         virtual ~FFMpegVideoDetailsReader() = default;
 
-        bool hasDetails(const QString &) const;                 // checks if given file contains any data to be read
+        bool hasDetails(const QString &) const;                 // checks if given file contains any data to be read (uses cached probe)
 
+        Details detailsOf(const QString& video_file) const;
         std::optional<QSize> resolutionOf(const QString& video_file) const;
         int durationOf(const QString& video_file) const;        // video duration in seconds
 
+        static Details parse(const QByteArray& ffprobeOutput);  // parse 'key=value' output of ffprobe
+
     private:
         const QString m_ffprobePath;
 
-        QStringList outputFor(const QString &) const;
-        int rotation(const QStringList &) const;
+        Details probe(const QString &) const;
 };
 
 #endif // FFMPEGVIDEODETAILSREADER_HPP
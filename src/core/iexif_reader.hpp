@@ -26,6 +26,10 @@ struct CORE_EXPORT IExifReader
         PixelXDimension,           // long
         PixelYDimension,           // long
         Exposure,                  // float
+        CameraMake,                // string
+        CameraModel,               // string
+        CameraSerialNumber,        // string
+        SubSecTimeOriginal,        // int (milliseconds)
     };
 
     virtual ~IExifReader() = default;
@@ -24,6 +24,9 @@ struct ILogger
 
     virtual void log(Severity, const QString& message) = 0;
 
+    // cheap check for guarding expensive messages construction
+    virtual bool isEnabled(Severity) const = 0;
+
     virtual void info(const QString &) = 0;
     virtual void warning(const QString &) = 0;
     virtual void error(const QString &) = 0;
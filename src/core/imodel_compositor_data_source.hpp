@@ -16,7 +16,9 @@ public:
     virtual const QStringList& data() const = 0;
 
 signals:
-    void dataChanged() const;
+    void dataChanged() const;                           // whole data was replaced
+    void rowsAppended(int first, int last) const;       // rows were appended at the end of data
+    void rowsRemoved(int first, int last) const;        // rows were removed from data
 };
 
 
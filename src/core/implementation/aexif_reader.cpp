@@ -106,6 +106,16 @@ std::optional<std::any> AExifReader::get(const QString& path, const IExifReader:
         case TagType::Exposure:
             result = exiv_result(readRational(TagType::Exposure));
             break;
+
+        case TagType::CameraMake:
+        case TagType::CameraModel:
+        case TagType::CameraSerialNumber:
+            result = exiv_result(readString(type));
+            break;
+
+        case TagType::SubSecTimeOriginal:
+            result = exiv_result(readSubSeconds(TagType::SubSecTimeOriginal));
+            break;
     }
 
     return result;
@@ -225,3 +235,23 @@ std::optional<float> AExifReader::readRational(const IExifReader::TagType& tagTy
     return result;
 }
 
+
+std::optional<int> AExifReader::readSubSeconds(const IExifReader::TagType& tagType) const
+{
+    std::optional<int> result;
+    const std::optional<std::string> valueRaw = read(tagType);
+
+    // value is a fraction of second written as digits after decimal point ("5" -> 500ms, "05" -> 50ms)
+    if (valueRaw.has_value())
+    {
+        try
+        {
+            const std::string fraction = "0." + *valueRaw;
+            result = static_cast<int>(std::stof(fraction) * 1000.f);
+        }
+        catch(const std::invalid_argument &) {}
+        catch(const std::out_of_range &) {}
+    }
+
+    return result;
+}
@@ -5,4 +5,5 @@ namespace ConfigConsts
 {
     const unsigned int Constraints::database_tag_name_len = 64;
     const unsigned int Constraints::database_tag_value_len = 2048;
+    const unsigned int Constraints::database_search_term_len = 64;
 }
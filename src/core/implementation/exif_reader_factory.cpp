@@ -40,6 +40,8 @@ IExifReader* ExifReaderFactory::get()
 {
     //ExifTool may not be thread safe. Prepare separate object for each thread
     const auto id = std::this_thread::get_id();
+
+    std::lock_guard<std::mutex> lock(m_feedersMutex);
     auto it = m_feeders.find(id);
 
     if (it == m_feeders.end())
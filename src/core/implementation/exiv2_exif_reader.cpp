@@ -15,6 +15,10 @@ namespace
         { AExifReader::TagType::PixelXDimension,  "Exif.Photo.PixelXDimension" },
         { AExifReader::TagType::PixelYDimension,  "Exif.Photo.PixelYDimension" },
         { AExifReader::TagType::Exposure,         "Exif.Photo.ExposureBiasValue" },
+        { AExifReader::TagType::CameraMake,       "Exif.Image.Make" },
+        { AExifReader::TagType::CameraModel,      "Exif.Image.Model" },
+        { AExifReader::TagType::CameraSerialNumber, "Exif.Photo.BodySerialNumber" },
+        { AExifReader::TagType::SubSecTimeOriginal, "Exif.Photo.SubSecTimeOriginal" },
     };
 }
 
@@ -0,0 +1,157 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ffmpeg_frame_extractor.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include <QPainter>
+#include <QProcess>
+
+#include "ffmpeg_video_details_reader.hpp"
+
+
+FFMpegFrameExtractor::FFMpegFrameExtractor(const QString& ffmpegPath, const QString& ffprobePath)
+    : m_ffmpegPath(ffmpegPath)
+    , m_ffprobePath(ffprobePath)
+{
+    assert(ffmpegPath.isEmpty() == false);
+    assert(ffprobePath.isEmpty() == false);
+}
+
+
+QImage FFMpegFrameExtractor::frameAt(const QString& video_file, int positionMs, int height) const
+{
+    const QStringList input_args = { "-ss", QString::number(positionMs / 1000.0, 'f', 3) };
+    const std::vector<QImage> result = read(video_file, input_args, QString(), 1, height);
+
+    return result.empty()? QImage(): result.front();
+}
+
+
+std::vector<QImage> FFMpegFrameExtractor::frames(const QString& video_file, int count, int height) const
+{
+    assert(count > 0);
+
+    const FFMpegVideoDetailsReader videoDetailsReader(m_ffprobePath);
+    const int durationMs = videoDetailsReader.detailsOf(video_file).durationMs;
+
+    std::vector<QImage> result;
+
+    if (durationMs > 0)
+    {
+        // use one ffmpeg run for all frames: pick 'count' frames per video duration
+        const QString fps_filter = QString("fps=%1/%2").arg(count * 1000).arg(durationMs);
+
+        result = read(video_file, {}, fps_filter, count, height);
+    }
+
+    return result;
+}
+
+
+QImage FFMpegFrameExtractor::strip(const QString& video_file, int count, int height) const
+{
+    const std::vector<QImage> images = frames(video_file, count, height);
+
+    QImage result;
+
+    if (images.empty() == false)
+    {
+        const int frame_width = images.front().width();
+
+        result = QImage(frame_width * static_cast<int>(images.size()), height, QImage::Format_RGB888);
+        result.fill(Qt::black);
+
+        QPainter painter(&result);
+
+        for (std::size_t i = 0; i < images.size(); i++)
+            painter.drawImage(frame_width * static_cast<int>(i), 0, images[i]);
+    }
+
+    return result;
+}
+
+
+std::vector<QImage> FFMpegFrameExtractor::read(const QString& video_file,
+                                               const QStringList& input_args,
+                                               const QString& filters,
+                                               int count,
+                                               int height) const
+{
+    const FFMpegVideoDetailsReader videoDetailsReader(m_ffprobePath);
+    const std::optional<QSize> resolution = videoDetailsReader.detailsOf(video_file).resolution;
+
+    std::vector<QImage> result;
+
+    // exact output size needs to be known as raw frames carry no header
+    if (resolution.has_value() == false || resolution->height() <= 0 || height <= 0)
+        return result;
+
+    const int width = std::max(1, qRound(resolution->width() * height / static_cast<double>(resolution->height())));
+    const QString scale_filter = QString("scale=%1:%2").arg(width).arg(height);
+    const QString all_filters = filters.isEmpty()? scale_filter: filters + "," + scale_filter;
+
+    QStringList ffmpeg_args = { "-v", "error", "-nostdin" };
+    ffmpeg_args += input_args;
+    ffmpeg_args += QStringList
+    {
+        "-i", video_file,
+        "-vframes", QString::number(count),
+        "-vf", all_filters,
+        "-f", "rawvideo",
+        "-pix_fmt", "rgb24",
+        "-"
+    };
+
+    QProcess ffmpeg_process;
+    ffmpeg_process.start(m_ffmpegPath, ffmpeg_args);
+    const bool status = ffmpeg_process.waitForFinished();
+
+    if (status)
+        result = decodeFrames(ffmpeg_process.readAllStandardOutput(), QSize(width, height));
+
+    return result;
+}
+
+
+std::vector<QImage> FFMpegFrameExtractor::decodeFrames(const QByteArray& raw, const QSize& size)
+{
+    std::vector<QImage> result;
+
+    if (size.isEmpty())
+        return result;
+
+    const int bytes_per_line = size.width() * 3;
+    const int frame_size = bytes_per_line * size.height();
+    const int frames = raw.size() / frame_size;           // incomplete frame at the end (if any) is dropped
+
+    result.reserve(frames);
+
+    for (int i = 0; i < frames; i++)
+    {
+        const uchar* frame_data = reinterpret_cast<const uchar *>(raw.constData()) + static_cast<std::size_t>(i) * frame_size;
+
+        // QImage does not take ownership of 'raw' - make a deep copy
+        result.push_back(QImage(frame_data, size.width(), size.height(), bytes_per_line, QImage::Format_RGB888).copy());
+    }
+
+    return result;
+}
@@ -21,9 +21,32 @@
 
 #include <cassert>
 
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
 #include <QProcess>
-#include <QRegularExpression>
-#include <QTime>
+
+#include <OpenLibrary/putils/ts_resource.hpp>
+
+
+namespace
+{
+    struct CachedDetails
+    {
+        QDateTime lastModified;
+        qint64 size;
+        FFMpegVideoDetailsReader::Details details;
+    };
+
+    typedef QCache<QString, CachedDetails> DetailsCache;
+
+    ol::ThreadSafeResource<DetailsCache>& detailsCache()
+    {
+        static ol::ThreadSafeResource<DetailsCache> cache(256);
+
+        return cache;
+    }
+}
 
 
 FFMpegVideoDetailsReader::FFMpegVideoDetailsReader(const QString& ffmpeg): m_ffprobePath(ffmpeg)
@@ -34,123 +57,121 @@ FFMpegVideoDetailsReader::FFMpegVideoDetailsReader(const QString& ffmpeg): m_ffp
 
 bool FFMpegVideoDetailsReader::hasDetails(const QString& filePath) const
 {
-    QProcess ffprobe_process;
-    ffprobe_process.setProcessChannelMode(QProcess::MergedChannels);
-
-    const QStringList ffprobe_args = { filePath };
-
-    ffprobe_process.start(m_ffprobePath, ffprobe_args );
-    const bool status = ffprobe_process.waitForFinished() &&
-                        ffprobe_process.exitCode() == 0;
-
-    return status;
+    return detailsOf(filePath).readable;
 }
 
 
-
-std::optional<QSize> FFMpegVideoDetailsReader::resolutionOf(const QString& video_file) const
+FFMpegVideoDetailsReader::Details FFMpegVideoDetailsReader::detailsOf(const QString& video_file) const
 {
-    const QStringList output = outputFor(video_file);
-
-    QRegularExpression resolution_regex(".*Stream [^ ]+ Video:.*, ([0-9]+)x([0-9]+).*");
+    const QFileInfo fileInfo(video_file);
+    const QString absolute_path = fileInfo.absoluteFilePath();
+    const QDateTime lastModified = fileInfo.lastModified();
+    const qint64 size = fileInfo.size();
 
-    std::optional<QSize> result;
-    for(const QString& line: output)
     {
-        const auto match = resolution_regex.match(line);
+        auto cache = detailsCache().lock();
+        const CachedDetails* cached = cache->object(absolute_path);
 
-        if (match.hasMatch())
-        {
-            const QStringList captured = match.capturedTexts();
-            const QString resolution_x_str = captured[1];
-            const QString resolution_y_str = captured[2];
-
-            const int resolution_x = resolution_x_str.toInt();
-            const int resolution_y = resolution_y_str.toInt();
+        if (cached != nullptr && cached->lastModified == lastModified && cached->size == size)
+            return cached->details;
+    }
 
-            result = QSize(resolution_x, resolution_y);
+    // ffprobe is called without lock so many files can be probed simultaneously
+    const Details details = probe(absolute_path);
 
-            const int r = rotation(output);
+    detailsCache().lock()->insert(absolute_path, new CachedDetails{lastModified, size, details});
 
-            if (r == 90)
-                result->transpose();
+    return details;
+}
 
-            break;
-        }
-    }
 
-    return result;
+std::optional<QSize> FFMpegVideoDetailsReader::resolutionOf(const QString& video_file) const
+{
+    return detailsOf(video_file).resolution;
 }
 
 
 int FFMpegVideoDetailsReader::durationOf(const QString& video_file) const
 {
-    const QStringList output = outputFor(video_file);
+    const int durationMs = detailsOf(video_file).durationMs;
 
-    QRegularExpression duration_regex(".*Duration: ([0-9:\\.]+).*");
+    return durationMs < 0? -1: durationMs / 1000;
+}
 
-    int duration = -1;
 
-    for(const QString& line: output)
+FFMpegVideoDetailsReader::Details FFMpegVideoDetailsReader::probe(const QString& video_file) const
+{
+    // ask for machine readable 'key=value' lines for first video stream only
+    const QStringList ffprobe_args =
     {
-        const auto match = duration_regex.match(line);
+        "-v", "error",
+        "-select_streams", "v:0",
+        "-show_entries", "format=duration:stream=width,height:stream_tags=rotate:stream_side_data=rotation",
+        "-of", "default=noprint_wrappers=1",
+        video_file
+    };
 
-        if (match.hasMatch())
-        {
-            const QStringList captured = match.capturedTexts();
-            const QString duration_str = captured[1] + "0";                 // convert 100th parts of second to miliseconds
-            const QTime duration_time = QTime::fromString(duration_str, "hh:mm:ss.zzz");
-            duration = QTime(0, 0, 0).secsTo(duration_time);
+    QProcess ffprobe_process;
+    ffprobe_process.start(m_ffprobePath, ffprobe_args);
+    const bool status = ffprobe_process.waitForFinished() &&
+                        ffprobe_process.exitStatus() == QProcess::NormalExit &&
+                        ffprobe_process.exitCode() == 0;
 
-            break;
-        }
+    Details details;
+
+    if (status)
+    {
+        details = parse(ffprobe_process.readAllStandardOutput());
+        details.readable = true;
     }
 
-    return duration;
+    return details;
 }
 
 
-QStringList FFMpegVideoDetailsReader::outputFor(const QString& video_file) const
+FFMpegVideoDetailsReader::Details FFMpegVideoDetailsReader::parse(const QByteArray& ffprobeOutput)
 {
-    QProcess ffprobe_process;
-    ffprobe_process.setProcessChannelMode(QProcess::MergedChannels);
+    Details details;
 
-    const QStringList ffprobe_args = { video_file };
+    int width = -1;
+    int height = -1;
 
-    ffprobe_process.start(m_ffprobePath, ffprobe_args );
-    bool status = ffprobe_process.waitForFinished();
+    for (const QByteArray& rawLine: ffprobeOutput.split('\n'))
+    {
+        const QString line = QString::fromUtf8(rawLine).trimmed();
+        const int separator = line.indexOf('=');
 
-    QStringList result;
-    if (status)
-        while(ffprobe_process.canReadLine())
-        {
-            const QByteArray line = ffprobe_process.readLine();
-            result.append(line.constData());
-        }
+        if (separator == -1)
+            continue;
 
-    return result;
-}
+        const QString key = line.left(separator);
+        const QString value = line.mid(separator + 1);
 
+        if (key == QLatin1String("width"))
+            width = value.toInt();
+        else if (key == QLatin1String("height"))
+            height = value.toInt();
+        else if (key == QLatin1String("duration"))
+        {
+            bool ok = false;
+            const double duration = value.toDouble(&ok);
 
-int FFMpegVideoDetailsReader::rotation(const QStringList& output) const
-{
-    QRegularExpression rotation_regex(" *rotate *: ([0-9]+).*");
-    int rotation = 0;
+            if (ok)
+                details.durationMs = static_cast<int>(duration * 1000);
+        }
+        else if (key == QLatin1String("TAG:rotate"))
+            details.rotation = (value.toInt() % 360 + 360) % 360;
+        else if (key == QLatin1String("rotation"))                      // display matrix (newer ffmpeg) uses counter-clockwise angles
+            details.rotation = (-value.toInt() % 360 + 360) % 360;
+    }
 
-    for(const QString& line: output)
+    if (width > 0 && height > 0)
     {
-        const auto match = rotation_regex.match(line);
-
-        if (match.hasMatch())
-        {
-            const QStringList captured = match.capturedTexts();
-            const QString rotation_str = captured[1];
-
-            rotation = rotation_str.toInt();
+        details.resolution = QSize(width, height);
 
-            break;
-        }
+        if (details.rotation == 90 || details.rotation == 270)
+            details.resolution->transpose();
     }
 
-    return rotation;
+    return details;
 }
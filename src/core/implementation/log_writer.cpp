@@ -0,0 +1,192 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "log_writer.hpp"
+
+#include <cassert>
+
+#include "thread_utils.hpp"
+
+
+namespace
+{
+    std::size_t roundUpToPowerOf2(std::size_t value)
+    {
+        std::size_t result = 1;
+
+        while (result < value)
+            result *= 2;
+
+        return result;
+    }
+
+    constexpr auto WriterIdleTimeout = std::chrono::milliseconds(100);
+}
+
+
+LogWriter::LogWriter(const std::vector<std::ostream *>& outputs, std::size_t capacity):
+    m_outputs(outputs),
+    m_slots(std::make_unique<Slot[]>(roundUpToPowerOf2(capacity))),
+    m_mask(roundUpToPowerOf2(capacity) - 1),
+    m_head(0),
+    m_written(0),
+    m_writerSleeps(false),
+    m_work(true)
+{
+    for (std::size_t i = 0; i <= m_mask; i++)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    m_writer = std::thread(&LogWriter::writer, this);
+}
+
+
+LogWriter::~LogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeUpMutex);
+        m_work = false;
+    }
+
+    m_wakeUp.notify_one();
+
+    assert(m_writer.joinable());
+    m_writer.join();
+}
+
+
+void LogWriter::write(std::string&& line)
+{
+    while (tryPush(line) == false)
+    {
+        // buffer is full - let writer do its job
+        wakeWriter();
+        std::this_thread::yield();
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_writerSleeps.load())
+        wakeWriter();
+}
+
+
+void LogWriter::flush()
+{
+    const std::size_t target = m_head.load(std::memory_order_acquire);
+
+    std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+    m_wakeUp.notify_one();
+    m_batchWritten.wait(lock, [this, target]
+    {
+        return m_written.load(std::memory_order_acquire) >= target;
+    });
+}
+
+
+bool LogWriter::tryPush(std::string& line)
+{
+    std::size_t position = m_head.load(std::memory_order_relaxed);
+
+    for(;;)
+    {
+        Slot& slot = m_slots[position & m_mask];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - position);
+
+        if (diff == 0)
+        {
+            if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.line = std::move(line);
+                slot.sequence.store(position + 1, std::memory_order_release);
+
+                return true;
+            }
+        }
+        else if (diff < 0)
+            return false;                   // slot not consumed yet - buffer is full
+        else
+            position = m_head.load(std::memory_order_relaxed);
+    }
+}
+
+
+void LogWriter::wakeWriter()
+{
+    std::lock_guard<std::mutex> lock(m_wakeUpMutex);
+    m_wakeUp.notify_one();
+}
+
+
+void LogWriter::writer()
+{
+    set_thread_name("LogWriter");
+
+    std::size_t tail = 0;
+    std::string batch;
+
+    for(;;)
+    {
+        batch.clear();
+
+        // take all lines published so far
+        for(;;)
+        {
+            Slot& slot = m_slots[tail & m_mask];
+
+            if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+                break;
+
+            batch += slot.line;
+            batch += '\n';
+            slot.line.clear();
+            slot.sequence.store(tail + m_mask + 1, std::memory_order_release);
+            tail++;
+        }
+
+        if (batch.empty() == false)
+        {
+            for (std::ostream* output: m_outputs)
+            {
+                output->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                output->flush();
+            }
+
+            std::lock_guard<std::mutex> lock(m_wakeUpMutex);
+            m_written.store(tail, std::memory_order_release);
+            m_batchWritten.notify_all();
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeUpMutex);
+
+        if (m_work == false)
+            break;
+
+        // Producers notify writer only when it sleeps.
+        // Check for lines published before flag was set, timeout is just a safety net.
+        m_writerSleeps.store(true);
+
+        if (m_slots[tail & m_mask].sequence.load() != tail + 1)
+            m_wakeUp.wait_for(lock, WriterIdleTimeout);
+
+        m_writerSleeps.store(false);
+    }
+}
@@ -19,32 +19,25 @@
 
 #include "logger.hpp"
 
-#include <cassert>
-#include <iostream>
-
-#include <sstream>
-
 #include <QString>
-#include <QFile>
 #include <QTime>
-#include <QDir>
 
 #include <core/ilogger_factory.hpp>
+#include <core/log_writer.hpp>
 
 
-Logger::Logger(std::mutex& output_mutex, std::ostream& stream, const QStringList& utility, Severity severity, const ILoggerFactory* factory):
+Logger::Logger(LogWriter& writer, const QStringList& utility, Severity severity, const ILoggerFactory* factory):
     m_utility(utility),
     m_severity(severity),
-    m_file(stream),
-    m_outputMutex(output_mutex),
+    m_writer(writer),
     m_loggerFactory(factory)
 {
 
 }
 
 
-Logger::Logger(std::mutex& output_mutex, std::ostream& stream, const QString& utility, Severity severity, const ILoggerFactory* factory):
-    Logger(output_mutex, stream, QStringList({utility}), severity, factory)
+Logger::Logger(LogWriter& writer, const QString& utility, Severity severity, const ILoggerFactory* factory):
+    Logger(writer, QStringList({utility}), severity, factory)
 {
 
 }
@@ -52,7 +45,8 @@ Logger::Logger(std::mutex& output_mutex, std::ostream& stream, const QString& ut
 
 void Logger::log(ILogger::Severity sev, const QString& message)
 {
-    std::lock_guard<std::mutex> lock(m_outputMutex);
+    if (isEnabled(sev) == false)
+        return;
 
     const QString s = severity(sev);
     const QString m = QString("%1 %2 [%3][%4]: %5")
@@ -62,14 +56,17 @@ void Logger::log(ILogger::Severity sev, const QString& message)
                         .arg(m_utility.join(":"))
                         .arg(message);
 
-    const std::string message_str = m.toStdString();
+    m_writer.write(m.toStdString());
 
-    if (sev <= m_severity)
-    {
-        m_file << message_str << "\n";
+    // make sure errors reach outputs in case application is about to die
+    if (sev == Severity::Error)
+        m_writer.flush();
+}
 
-        std::cout << message_str << std::endl;
-    }
+
+bool Logger::isEnabled(ILogger::Severity sev) const
+{
+    return sev <= m_severity;
 }
 
 
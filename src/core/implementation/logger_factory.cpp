@@ -19,10 +19,12 @@
 
 #include "logger_factory.hpp"
 
+#include <iostream>
+
 #include "logger.hpp"
 #include "log_file_rotator.hpp"
 
-LoggerFactory::LoggerFactory(const QString& path): m_logFile(), m_logingLevel(ILogger::Severity::Warning), m_outputMutex()
+LoggerFactory::LoggerFactory(const QString& path): m_logFile(), m_logingLevel(ILogger::Severity::Warning), m_writer({&m_logFile, &std::cout})
 {
     const QString log_path = path + "/photo_broom.log";
     LogFileRotator().rotate(log_path);
@@ -47,7 +49,7 @@ std::unique_ptr<ILogger> LoggerFactory::get(const QString& utility) const
 
 std::unique_ptr<ILogger> LoggerFactory::get(const QStringList& utility) const
 {
-    auto logger = std::make_unique<Logger>(m_outputMutex, m_logFile, utility, m_logingLevel, this);
+    auto logger = std::make_unique<Logger>(m_writer, utility, m_logingLevel, this);
 
     return std::move(logger);
 }
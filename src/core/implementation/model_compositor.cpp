@@ -48,10 +48,20 @@ void ModelCompositor::add(const IModelCompositorDataSource* dataSource)
     if (is_data_source_empty == false)
         endInsertRows();
 
+    using namespace std::placeholders;
+
     auto connection = connect(dataSource, &IModelCompositorDataSource::dataChanged,
                               std::bind(&ModelCompositor::dataSourceChanged, this, dataSource));
 
+    auto appended_connection = connect(dataSource, &IModelCompositorDataSource::rowsAppended,
+                                       std::bind(&ModelCompositor::dataSourceRowsAppended, this, dataSource, _1, _2));
+
+    auto removed_connection = connect(dataSource, &IModelCompositorDataSource::rowsRemoved,
+                                      std::bind(&ModelCompositor::dataSourceRowsRemoved, this, dataSource, _1, _2));
+
     m_connections.push_back(connection);
+    m_connections.push_back(appended_connection);
+    m_connections.push_back(removed_connection);
 }
 
 
@@ -124,3 +134,38 @@ void ModelCompositor::dataSourceChanged(const IModelCompositorDataSource* change
             begin += data_source_size;
     }
 }
+
+
+void ModelCompositor::dataSourceRowsAppended(const IModelCompositorDataSource* changed_source, int first, int last)
+{
+    const int begin = sourceOffset(changed_source);
+
+    beginInsertRows(QModelIndex(), begin + first, begin + last);
+    m_sources[changed_source] += last - first + 1;
+    endInsertRows();
+}
+
+
+void ModelCompositor::dataSourceRowsRemoved(const IModelCompositorDataSource* changed_source, int first, int last)
+{
+    const int begin = sourceOffset(changed_source);
+
+    beginRemoveRows(QModelIndex(), begin + first, begin + last);
+    m_sources[changed_source] -= last - first + 1;
+    endRemoveRows();
+}
+
+
+int ModelCompositor::sourceOffset(const IModelCompositorDataSource* source) const
+{
+    int begin = 0;
+    for (const auto& [data_source, data_source_size]: m_sources)
+    {
+        if (data_source == source)
+            break;
+        else
+            begin += data_source_size;
+    }
+
+    return begin;
+}
@@ -18,29 +18,28 @@
 
 #include "oriented_image.hpp"
 
+#include <algorithm>
 #include <any>
 
+#include <QImageReader>
+
 #include <core/iexif_reader.hpp>
 
 
-OrientedImage::OrientedImage():
-    m_oriented()
+namespace
 {
-}
-
+    int orientationOf(IExifReader* exif, const QString& src)
+    {
+        const std::optional<std::any> orientation_raw = exif->get(src, IExifReader::TagType::Orientation);
 
-OrientedImage::OrientedImage(IExifReader* exif, const QString& src):
-    m_oriented()
-{
-    QImage img(src);
-    QImage rotated;
+        return orientation_raw.has_value()?
+                   std::any_cast<int>(*orientation_raw):
+                   0;
+    }
 
-    if (img.isNull() == false)
+    QImage orient(const QImage& img, int orientation)
     {
-        const std::optional<std::any> orientation_raw = exif->get(src, IExifReader::TagType::Orientation);
-        const int orientation = orientation_raw.has_value()?
-                                    std::any_cast<int>(*orientation_raw):
-                                    0;
+        QImage rotated;
 
         switch(orientation)
         {
@@ -102,9 +101,52 @@ OrientedImage::OrientedImage(IExifReader* exif, const QString& src):
                 break;
             }
         }
+
+        return rotated;
     }
+}
+
 
-    m_oriented = rotated;
+OrientedImage::OrientedImage():
+    m_oriented(),
+    m_scale(1.0)
+{
+}
+
+
+OrientedImage::OrientedImage(IExifReader* exif, const QString& src):
+    m_oriented(),
+    m_scale(1.0)
+{
+    const QImage img(src);
+
+    if (img.isNull() == false)
+        m_oriented = orient(img, orientationOf(exif, src));
+}
+
+
+OrientedImage::OrientedImage(IExifReader* exif, const QString& src, int maxSize):
+    m_oriented(),
+    m_scale(1.0)
+{
+    QImageReader reader(src);
+    const QSize size = reader.size();
+
+    // let decoder do the scaling (jpeg decoder can skip most of work then)
+    if (size.isValid() && std::max(size.width(), size.height()) > maxSize)
+    {
+        const QSize scaled = size.scaled(maxSize, maxSize, Qt::KeepAspectRatio);
+
+        reader.setScaledSize(scaled);
+        m_scale = static_cast<double>(scaled.width()) / size.width();
+    }
+
+    const QImage img = reader.read();
+
+    if (img.isNull() == false)
+        m_oriented = orient(img, orientationOf(exif, src));
+    else
+        m_scale = 1.0;
 }
 
 
@@ -118,3 +160,17 @@ const QImage* OrientedImage::operator->() const
 {
     return &m_oriented;
 }
+
+
+double OrientedImage::scale() const
+{
+    return m_scale;
+}
+
+
+QRect OrientedImage::mapToOriginal(const QRect& rect) const
+{
+    const QRectF original(rect.x() / m_scale, rect.y() / m_scale, rect.width() / m_scale, rect.height() / m_scale);
+
+    return original.toRect();
+}
@@ -56,3 +56,26 @@ std::vector<SearchExpressionEvaluator::Filter> SearchExpressionEvaluator::evalua
 
     return result;
 }
+
+
+std::vector<QString> SearchExpressionEvaluator::terms(const QString& text)
+{
+    std::vector<QString> result;
+    QString term;
+
+    for(const QChar c: text)
+    {
+        if (c.isLetterOrNumber())
+            term.append(c.toLower());
+        else if (term.isEmpty() == false)
+        {
+            result.push_back(term);
+            term.clear();
+        }
+    }
+
+    if (term.isEmpty() == false)
+        result.push_back(term);
+
+    return result;
+}
@@ -1,5 +1,9 @@
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <exception>
+#include <memory>
 
 #include "task_executor_utils.hpp"
 #include "containers_utils.hpp"
@@ -136,3 +140,84 @@ void TasksQueue::task_finished()
 
     try_to_fire();
 }
+
+
+namespace
+{
+    struct ParallelForState
+    {
+        ParallelForState(std::size_t c, const std::function<void(std::size_t)>& f):
+            callable(f),
+            count(c),
+            next(0),
+            processed(0),
+            error()
+        {
+        }
+
+        // returns false when there was nothing more to process
+        bool processNext()
+        {
+            const std::size_t index = next++;
+
+            if (index >= count)
+                return false;
+
+            std::exception_ptr exception;
+
+            try
+            {
+                callable(index);
+            }
+            catch(...)
+            {
+                exception = std::current_exception();
+            }
+
+            // item is processed even if callable failed, otherwise parallelFor would wait forever
+            std::lock_guard<std::mutex> lock(mutex);
+            processed++;
+
+            if (exception && !error)
+                error = exception;
+
+            if (processed == count)
+                allProcessed.notify_all();
+
+            return true;
+        }
+
+        const std::function<void(std::size_t)> callable;
+        const std::size_t count;
+        std::atomic<std::size_t> next;
+        std::size_t processed;
+        std::exception_ptr error;       // first exception thrown by callable
+        std::mutex mutex;
+        std::condition_variable allProcessed;
+    };
+}
+
+
+void parallelFor(ITaskExecutor* executor, std::size_t count, std::size_t jobs, const std::function<void(std::size_t)>& callable)
+{
+    auto state = std::make_shared<ParallelForState>(count, callable);
+
+    // helpers may start after all work is done - they keep state alive and quit immediately then
+    const std::size_t helpers = std::min(jobs, count) > 1? std::min(jobs, count) - 1: 0;
+    for (std::size_t i = 0; i < helpers; i++)
+        runOn(executor, [state]()
+        {
+            while(state->processNext());
+        });
+
+    while(state->processNext());
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->allProcessed.wait(lock, [&state]
+    {
+        return state->processed == state->count;
+    });
+
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
@@ -18,12 +18,13 @@
 
 #include "thumbnail_generator.hpp"
 
+#include <algorithm>
+
 #include <QFile>
 #include <QFileInfo>
-#include <QProcess>
 
-#include <system/system.hpp>
 #include "constants.hpp"
+#include "ffmpeg_frame_extractor.hpp"
 #include "ffmpeg_video_details_reader.hpp"
 #include "iconfiguration.hpp"
 #include "iexif_reader.hpp"
@@ -100,11 +101,14 @@ QImage ThumbnailGenerator::fromImage(const QString& path, int height)
 
     const int photo_scaling = stopwatch.stop();
 
-    const QString read_time_message = QString("photo %1 read time: %2ms").arg(path).arg(photo_read);
-    m_logger->debug(read_time_message);
+    if (m_logger->isEnabled(ILogger::Severity::Debug))
+    {
+        const QString read_time_message = QString("photo %1 read time: %2ms").arg(path).arg(photo_read);
+        m_logger->debug(read_time_message);
 
-    const QString scaling_time_message = QString("photo scaling time: %1ms").arg(photo_scaling);
-    m_logger->debug(scaling_time_message);
+        const QString scaling_time_message = QString("photo scaling time: %1ms").arg(photo_scaling);
+        m_logger->debug(scaling_time_message);
+    }
 
     return image;
 }
@@ -120,28 +124,10 @@ QImage ThumbnailGenerator::fromVideo(const QString& path, int height, const QStr
     {
         const FFMpegVideoDetailsReader videoDetailsReader(ffprobe);
         const QString absolute_path = pathInfo.absoluteFilePath();
-        const int seconds = videoDetailsReader.durationOf(absolute_path);
-
-        auto tmpDir = System::createTmpDir("FromVideoTask", System::Confidential);
-        const QString thumbnail_path = System::getTmpFile(tmpDir->path(), "jpeg");
-
-        QProcess ffmpeg_process4thumbnail;
-        const QStringList ffmpeg_thumbnail_args =
-        {
-            "-y",                                        // overwrite file created with QTemporaryFile
-            "-ss", QString::number(seconds / 10),
-            "-i", absolute_path,
-            "-vframes", "1",
-            "-vf", QString("scale=-1:%1").arg(height),
-            "-q:v", "2",
-            thumbnail_path
-        };
-
-        ffmpeg_process4thumbnail.start(ffmpeg, ffmpeg_thumbnail_args );
-        const bool status = ffmpeg_process4thumbnail.waitForFinished();
-
-        if (status)
-            result = QImage(thumbnail_path);
+        const int durationMs = videoDetailsReader.detailsOf(absolute_path).durationMs;
+
+        const FFMpegFrameExtractor frameExtractor(ffmpeg, ffprobe);
+        result = frameExtractor.frameAt(absolute_path, std::max(durationMs, 0) / 10, height);
     }
 
     return result;
@@ -0,0 +1,81 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LOG_WRITER_HPP
+#define LOG_WRITER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core_export.h"
+
+
+/**
+ * @brief Writes log lines to output streams on a background thread.
+ *
+ * Producers (any thread) put lines into a bounded lock-free ring buffer.
+ * Writer thread takes all pending lines, writes them as one batch
+ * to each output and flushes outputs once per batch.
+ * When buffer is full producers wait for writer - no line is dropped.
+ */
+class CORE_EXPORT LogWriter
+{
+    public:
+        explicit LogWriter(const std::vector<std::ostream *> &, std::size_t capacity = 8192);
+        LogWriter(const LogWriter &) = delete;
+        ~LogWriter();
+
+        LogWriter& operator=(const LogWriter &) = delete;
+
+        void write(std::string &&);
+
+        /// blocks until all lines written so far are stored in outputs
+        void flush();
+
+    private:
+        struct Slot
+        {
+            std::atomic<std::size_t> sequence;
+            std::string line;
+        };
+
+        const std::vector<std::ostream *> m_outputs;
+        std::unique_ptr<Slot[]> m_slots;
+        const std::size_t m_mask;
+        alignas(64) std::atomic<std::size_t> m_head;        // next slot for producers
+        alignas(64) std::atomic<std::size_t> m_written;     // number of lines written to outputs
+        std::atomic<bool> m_writerSleeps;
+        std::atomic<bool> m_work;
+        std::mutex m_wakeUpMutex;
+        std::condition_variable m_wakeUp;
+        std::condition_variable m_batchWritten;
+        std::thread m_writer;
+
+        bool tryPush(std::string &);
+        void wakeWriter();
+        void writer();
+};
+
+#endif // LOG_WRITER_HPP
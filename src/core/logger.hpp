@@ -20,10 +20,6 @@
 #ifndef LOGGER_HPP
 #define LOGGER_HPP
 
-#include <string>
-#include <map>
-#include <mutex>
-
 #include <QStringList>
 
 #include "ilogger.hpp"
@@ -32,6 +28,7 @@
 
 class QIODevice;
 class QString;
+class LogWriter;
 
 struct ILoggerFactory;
 
@@ -39,14 +36,15 @@ struct ILoggerFactory;
 class CORE_EXPORT Logger: public ILogger
 {
     public:
-        Logger(std::mutex &, std::ostream &, const QString& utility, Severity, const ILoggerFactory *);
-        Logger(std::mutex &, std::ostream &, const QStringList& utility, Severity, const ILoggerFactory *);
+        Logger(LogWriter &, const QString& utility, Severity, const ILoggerFactory *);
+        Logger(LogWriter &, const QStringList& utility, Severity, const ILoggerFactory *);
         Logger(const Logger& other) = delete;
         ~Logger() = default;
 
         Logger& operator=(const Logger& other) = delete;
 
         void log(Severity, const QString& message) override;
+        bool isEnabled(Severity) const override;
 
         void info(const QString &) override;
         void warning(const QString &) override;
@@ -59,8 +57,7 @@ class CORE_EXPORT Logger: public ILogger
     private:
         const QStringList m_utility;
         Severity m_severity;
-        std::ostream& m_file;
-        std::mutex& m_outputMutex;
+        LogWriter& m_writer;
         const ILoggerFactory* m_loggerFactory;
 
         QString currentTime() const;
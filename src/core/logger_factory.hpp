@@ -21,10 +21,10 @@
 #define LOGGERFACTORY_HPP
 
 #include <fstream>
-#include <mutex>
 
 #include "ilogger_factory.hpp"
 #include "ilogger.hpp"
+#include "log_writer.hpp"
 
 #include "core_export.h"
 
@@ -44,7 +44,7 @@ class CORE_EXPORT LoggerFactory: public ILoggerFactory
     private:
         mutable std::ofstream m_logFile;
         ILogger::Severity m_logingLevel;
-        mutable std::mutex m_outputMutex;
+        mutable LogWriter m_writer;
 };
 
 #endif // LOGGERFACTORY_HPP
@@ -44,6 +44,9 @@ class CORE_EXPORT ModelCompositor: public QAbstractListModel
         std::vector<QMetaObject::Connection> m_connections;
 
         void dataSourceChanged(const IModelCompositorDataSource *);
+        void dataSourceRowsAppended(const IModelCompositorDataSource *, int first, int last);
+        void dataSourceRowsRemoved(const IModelCompositorDataSource *, int first, int last);
+        int sourceOffset(const IModelCompositorDataSource *) const;
 };
 
 #endif // MODELCOMPOSITOR_HPP
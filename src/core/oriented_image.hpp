@@ -31,12 +31,17 @@ class CORE_EXPORT OrientedImage
     public:
         OrientedImage();
         OrientedImage(IExifReader *, const QString& path);
+        OrientedImage(IExifReader *, const QString& path, int maxSize);   // decode image with longer side limited to maxSize
 
         QImage get() const;
         const QImage* operator->() const;
 
+        double scale() const;                                             // decoded size to original size ratio
+        QRect mapToOriginal(const QRect &) const;                         // map rect on decoded image to original image's coordinates
+
     private:
         QImage m_oriented;
+        double m_scale;
 };
 
 #endif // ORIENTED_IMAGE_HPP
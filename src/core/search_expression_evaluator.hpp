@@ -48,6 +48,10 @@ class CORE_EXPORT SearchExpressionEvaluator
 
         Expression evaluate(const QString& input) const;
 
+        // split text into lower case words (letters and digits).
+        // Used by backends for building and querying search index.
+        static std::vector<QString> terms(const QString& text);
+
     private:
         QString m_separator;
 };
@@ -3,6 +3,7 @@
 #define TASK_EXECUTOR_UTILS
 
 #include <deque>
+#include <functional>
 #include <mutex>
 #include <future>
 #include <condition_variable>
@@ -70,6 +71,14 @@ void runOn(ITaskExecutor* executor, Callable&& callable)
 }
 
 
+// Helper function.
+// Call 'callable' for each index in range [0, count) using up to 'jobs' executor's workers.
+// Calling thread takes part in processing, so it is safe to call this function from inside of executor's task
+// (even when there are no free workers). Returns when all indexes were processed.
+// If 'callable' throws, remaining indexes are still processed and the first exception is rethrown then.
+CORE_EXPORT void parallelFor(ITaskExecutor *, std::size_t count, std::size_t jobs, const std::function<void(std::size_t)> &);
+
+
 // Helper class.
 // A subqueue for ITaskExecutor.
 // Its purpose is to have a queue of tasks to be executed by executor
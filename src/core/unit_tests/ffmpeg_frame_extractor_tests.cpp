@@ -0,0 +1,80 @@
+
+#include <gmock/gmock.h>
+
+#include <QColor>
+
+#include "ffmpeg_frame_extractor.hpp"
+
+
+namespace
+{
+    // raw rgb24 frame filled with one color
+    QByteArray rawFrame(const QSize& size, const QColor& color)
+    {
+        QByteArray frame;
+
+        for (int i = 0; i < size.width() * size.height(); i++)
+        {
+            frame.append(static_cast<char>(color.red()));
+            frame.append(static_cast<char>(color.green()));
+            frame.append(static_cast<char>(color.blue()));
+        }
+
+        return frame;
+    }
+}
+
+
+TEST(FFMpegFrameExtractorTest, decodesFramesFromRawData)
+{
+    // odd width - lines of rgb24 frames are not 32 bit aligned
+    const QSize size(3, 2);
+    const QByteArray raw = rawFrame(size, Qt::red) + rawFrame(size, Qt::green) + rawFrame(size, Qt::blue);
+
+    const std::vector<QImage> frames = FFMpegFrameExtractor::decodeFrames(raw, size);
+
+    ASSERT_EQ(frames.size(), 3);
+
+    const std::vector<QColor> colors = { Qt::red, Qt::green, Qt::blue };
+
+    for (std::size_t i = 0; i < frames.size(); i++)
+    {
+        EXPECT_EQ(frames[i].size(), size);
+
+        for (int y = 0; y < size.height(); y++)
+            for (int x = 0; x < size.width(); x++)
+                EXPECT_EQ(frames[i].pixelColor(x, y), colors[i]);
+    }
+}
+
+
+TEST(FFMpegFrameExtractorTest, incompleteFrameIsDropped)
+{
+    const QSize size(4, 4);
+    const QByteArray raw = rawFrame(size, Qt::white) + rawFrame(size, Qt::black).left(10);
+
+    const std::vector<QImage> frames = FFMpegFrameExtractor::decodeFrames(raw, size);
+
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(frames.front().pixelColor(3, 3), QColor(Qt::white));
+}
+
+
+TEST(FFMpegFrameExtractorTest, framesDoNotShareDataWithInput)
+{
+    const QSize size(2, 2);
+    QByteArray raw = rawFrame(size, Qt::red);
+
+    const std::vector<QImage> frames = FFMpegFrameExtractor::decodeFrames(raw, size);
+    raw.fill(0);
+
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(frames.front().pixelColor(0, 0), QColor(Qt::red));
+}
+
+
+TEST(FFMpegFrameExtractorTest, emptyInput)
+{
+    EXPECT_TRUE(FFMpegFrameExtractor::decodeFrames(QByteArray(), QSize(4, 4)).empty());
+    EXPECT_TRUE(FFMpegFrameExtractor::decodeFrames(rawFrame(QSize(4, 4), Qt::red), QSize()).empty());
+}
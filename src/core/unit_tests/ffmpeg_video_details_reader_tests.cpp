@@ -0,0 +1,110 @@
+
+#include <gmock/gmock.h>
+
+#include "ffmpeg_video_details_reader.hpp"
+
+
+// outputs captured from ffprobe run with arguments used by FFMpegVideoDetailsReader
+
+TEST(FFMpegVideoDetailsReaderTest, parsesVideoDetails)
+{
+    const QByteArray output =
+        "width=1920\n"
+        "height=1080\n"
+        "duration=12.345000\n";
+
+    const FFMpegVideoDetailsReader::Details details = FFMpegVideoDetailsReader::parse(output);
+
+    ASSERT_TRUE(details.resolution.has_value());
+    EXPECT_EQ(*details.resolution, QSize(1920, 1080));
+    EXPECT_EQ(details.durationMs, 12345);
+    EXPECT_EQ(details.rotation, 0);
+}
+
+
+TEST(FFMpegVideoDetailsReaderTest, parsesRotationTag)
+{
+    // ffmpeg 4.x: rotation stored as stream tag
+    const QByteArray output =
+        "width=1920\n"
+        "height=1080\n"
+        "TAG:rotate=90\n"
+        "duration=3.003000\n";
+
+    const FFMpegVideoDetailsReader::Details details = FFMpegVideoDetailsReader::parse(output);
+
+    EXPECT_EQ(details.rotation, 90);
+    EXPECT_EQ(details.resolution, QSize(1080, 1920));
+    EXPECT_EQ(details.durationMs, 3003);
+}
+
+
+TEST(FFMpegVideoDetailsReaderTest, parsesDisplayMatrixRotation)
+{
+    // ffmpeg 5.x and newer: rotation stored in display matrix (counter-clockwise)
+    const QByteArray output =
+        "width=1280\n"
+        "height=720\n"
+        "rotation=-90\n"
+        "duration=5.005000\n";
+
+    const FFMpegVideoDetailsReader::Details details = FFMpegVideoDetailsReader::parse(output);
+
+    EXPECT_EQ(details.rotation, 90);
+    EXPECT_EQ(details.resolution, QSize(720, 1280));
+
+    const FFMpegVideoDetailsReader::Details upsideDown = FFMpegVideoDetailsReader::parse("width=1280\nheight=720\nrotation=180\n");
+
+    EXPECT_EQ(upsideDown.rotation, 180);
+    EXPECT_EQ(upsideDown.resolution, QSize(1280, 720));
+}
+
+
+TEST(FFMpegVideoDetailsReaderTest, parsesWindowsLineEndingsAndMissingTrailingNewline)
+{
+    const QByteArray output =
+        "width=640\r\n"
+        "height=480\r\n"
+        "duration=1.500000";
+
+    const FFMpegVideoDetailsReader::Details details = FFMpegVideoDetailsReader::parse(output);
+
+    EXPECT_EQ(details.resolution, QSize(640, 480));
+    EXPECT_EQ(details.durationMs, 1500);
+}
+
+
+TEST(FFMpegVideoDetailsReaderTest, unknownDuration)
+{
+    // still images and some streams have no duration
+    const QByteArray output =
+        "width=4000\n"
+        "height=3000\n"
+        "duration=N/A\n";
+
+    const FFMpegVideoDetailsReader::Details details = FFMpegVideoDetailsReader::parse(output);
+
+    EXPECT_EQ(details.resolution, QSize(4000, 3000));
+    EXPECT_EQ(details.durationMs, -1);
+}
+
+
+TEST(FFMpegVideoDetailsReaderTest, noVideoStream)
+{
+    // audio file: only format's duration is printed
+    const FFMpegVideoDetailsReader::Details details = FFMpegVideoDetailsReader::parse("duration=180.000000\n");
+
+    EXPECT_FALSE(details.resolution.has_value());
+    EXPECT_EQ(details.durationMs, 180000);
+}
+
+
+TEST(FFMpegVideoDetailsReaderTest, emptyOutput)
+{
+    const FFMpegVideoDetailsReader::Details details = FFMpegVideoDetailsReader::parse(QByteArray());
+
+    EXPECT_FALSE(details.resolution.has_value());
+    EXPECT_EQ(details.durationMs, -1);
+    EXPECT_EQ(details.rotation, 0);
+    EXPECT_FALSE(details.readable);
+}
@@ -0,0 +1,115 @@
+
+#include <sstream>
+#include <thread>
+#include <gmock/gmock.h>
+
+#include <QStringList>
+
+#include "log_writer.hpp"
+#include "logger.hpp"
+
+
+namespace
+{
+    std::vector<std::string> lines(const std::stringstream& stream)
+    {
+        std::vector<std::string> result;
+        std::istringstream input(stream.str());
+
+        for (std::string line; std::getline(input, line);)
+            result.push_back(line);
+
+        return result;
+    }
+}
+
+
+TEST(LogWriterTest, linesAreWrittenToAllOutputs)
+{
+    std::stringstream first, second;
+
+    {
+        LogWriter writer({&first, &second});
+
+        writer.write("line 1");
+        writer.write("line 2");
+    }
+
+    EXPECT_THAT(lines(first), testing::ElementsAre("line 1", "line 2"));
+    EXPECT_THAT(lines(second), testing::ElementsAre("line 1", "line 2"));
+}
+
+
+TEST(LogWriterTest, flushWaitsForLines)
+{
+    std::stringstream output;
+    LogWriter writer({&output});
+
+    writer.write("line");
+    writer.flush();
+
+    EXPECT_THAT(lines(output), testing::ElementsAre("line"));
+}
+
+
+TEST(LogWriterTest, noLinesAreLostWhenManyThreadsWrite)
+{
+    const int threads = 8;
+    const int linesPerThread = 2000;
+    std::stringstream output;
+
+    {
+        // small buffer so producers need to wait for writer
+        LogWriter writer({&output}, 16);
+        std::vector<std::thread> producers;
+
+        for (int t = 0; t < threads; t++)
+            producers.emplace_back([&writer, t]
+            {
+                for (int i = 0; i < linesPerThread; i++)
+                    writer.write(std::to_string(t) + " " + std::to_string(i));
+            });
+
+        for (auto& producer: producers)
+            producer.join();
+    }
+
+    // every line exactly once and in order for each thread
+    std::vector<int> next(threads, 0);
+
+    for (const std::string& line: lines(output))
+    {
+        std::istringstream parser(line);
+        int t = 0, i = 0;
+        parser >> t >> i;
+
+        ASSERT_EQ(next[t], i);
+        next[t]++;
+    }
+
+    EXPECT_THAT(next, testing::Each(linesPerThread));
+}
+
+
+TEST(LoggerTest, messagesAboveSeverityAreIgnored)
+{
+    std::stringstream output;
+
+    {
+        LogWriter writer({&output});
+        Logger logger(writer, QString("Test"), ILogger::Severity::Info, nullptr);
+
+        EXPECT_TRUE(logger.isEnabled(ILogger::Severity::Error));
+        EXPECT_TRUE(logger.isEnabled(ILogger::Severity::Info));
+        EXPECT_FALSE(logger.isEnabled(ILogger::Severity::Debug));
+        EXPECT_FALSE(logger.isEnabled(ILogger::Severity::Trace));
+
+        logger.info("info message");
+        logger.trace("trace message");
+    }
+
+    const std::vector<std::string> written = lines(output);
+
+    ASSERT_EQ(written.size(), 1);
+    EXPECT_THAT(written.front(), testing::EndsWith("[I][Test]: info message"));
+}
@@ -231,3 +231,48 @@ TEST(ModelCompositorTest, complexDataSourceSignalsEmission)
 
     compare_content(model_compositor, data1 + data2_2 + data3);
 }
+
+
+TEST(ModelCompositorTest, dataSourceRowsAppendedAndRemoved)
+{
+    const QStringList data1 = {"a", "b", "cc"};
+    QStringList data2 = {"1", "2", "3", "4"};
+
+    NiceMock<ModelCompositorDataSourceMock> dataSourceMock1;
+    ON_CALL(dataSourceMock1, data).WillByDefault(ReturnRef(data1));
+
+    NiceMock<ModelCompositorDataSourceMock> dataSourceMock2;
+    ON_CALL(dataSourceMock2, data).WillByDefault(ReturnRef(data2));
+
+    ModelCompositor model_compositor;
+    model_compositor.add(&dataSourceMock1);
+    model_compositor.add(&dataSourceMock2);
+
+    QSignalSpy rows_removed_spy(&model_compositor, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy rows_inserted_spy(&model_compositor, &QAbstractItemModel::rowsInserted);
+
+    // append rows to one of sources
+    data2.append({"5", "6"});
+    emit dataSourceMock2.rowsAppended(4, 5);
+
+    ASSERT_EQ(rows_removed_spy.count(), 0);
+    ASSERT_EQ(rows_inserted_spy.count(), 1);
+    EXPECT_EQ(model_compositor.rowCount(), 9);
+
+    // remove single row from one of sources
+    data2.removeAt(1);
+    emit dataSourceMock2.rowsRemoved(1, 1);
+
+    ASSERT_EQ(rows_removed_spy.count(), 1);
+    ASSERT_EQ(rows_inserted_spy.count(), 1);
+    EXPECT_EQ(model_compositor.rowCount(), 8);
+
+    // only changed rows are reported
+    const int offset1 = rows_range(rows_inserted_spy, 0).first - 4;
+    const int offset2 = rows_range(rows_removed_spy, 0).first - 1;
+    EXPECT_EQ(offset1, offset2);
+    EXPECT_EQ(rows_count(rows_inserted_spy, 0), 2);
+    EXPECT_EQ(rows_count(rows_removed_spy, 0), 1);
+
+    compare_content(model_compositor, data1 + data2);
+}
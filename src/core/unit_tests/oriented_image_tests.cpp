@@ -2,22 +2,106 @@
 #include <gmock/gmock.h>
 
 #include <QImage>
+#include <QTemporaryDir>
 
 #include <unit_tests_utils/mock_exif_reader.hpp>
 #include "oriented_image.hpp"
 
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
 
-TEST(OrientedImageTest, constructor)
+
+namespace
+{
+    QString storeImage(const QTemporaryDir& dir, int width, int height)
+    {
+        QImage image(width, height, QImage::Format_RGB32);
+        image.fill(Qt::gray);
+
+        const QString path = dir.filePath("image.png");
+        image.save(path);
+
+        return path;
+    }
+}
+
+
+TEST(OrientedImageTest, defaultConstructor)
+{
+    const OrientedImage image;
+
+    EXPECT_TRUE(image->isNull());
+    EXPECT_EQ(image.scale(), 1.0);
+}
+
+
+TEST(OrientedImageTest, scaledDecode)
+{
+    QTemporaryDir dir;
+    const QString path = storeImage(dir, 400, 200);
+
+    NiceMock<MockExifReader> exif;
+    const OrientedImage image(&exif, path, 100);
+
+    EXPECT_EQ(image->size(), QSize(100, 50));
+    EXPECT_EQ(image.scale(), 0.25);
+}
+
+
+TEST(OrientedImageTest, smallImageIsNotScaled)
+{
+    QTemporaryDir dir;
+    const QString path = storeImage(dir, 40, 20);
+
+    NiceMock<MockExifReader> exif;
+    const OrientedImage image(&exif, path, 100);
+
+    EXPECT_EQ(image->size(), QSize(40, 20));
+    EXPECT_EQ(image.scale(), 1.0);
+}
+
+
+TEST(OrientedImageTest, scaledDecodeOfRotatedImage)
 {
-    // TODO: build issues...
-    //       probably broken by https://gcc.gnu.org/bugzilla/show_bug.cgi?id=90415
+    QTemporaryDir dir;
+    const QString path = storeImage(dir, 400, 200);
+
+    NiceMock<MockExifReader> exif;
+    ON_CALL(exif, get(path, IExifReader::TagType::Orientation))
+        .WillByDefault(Return(std::optional<std::any>(6)));     // rotated by 90 degrees
+
+    const OrientedImage image(&exif, path, 100);
+
+    EXPECT_EQ(image->size(), QSize(50, 100));
+    EXPECT_EQ(image.scale(), 0.25);
+}
+
 
-    /*
-    OrientedImage();
+TEST(OrientedImageTest, mappingToOriginal)
+{
+    QTemporaryDir dir;
+    const QString path = storeImage(dir, 300, 150);
+
+    NiceMock<MockExifReader> exif;
+    const OrientedImage image(&exif, path, 100);
+
+    ASSERT_EQ(image->size(), QSize(100, 50));
+
+    EXPECT_EQ(image.mapToOriginal(QRect(10, 20, 30, 10)), QRect(30, 60, 90, 30));
+
+    // 7 / (1/3) is not exactly 21 in floating point - truncation would give 20
+    EXPECT_EQ(image.mapToOriginal(QRect(7, 11, 5, 5)), QRect(21, 33, 15, 15));
+}
+
+
+TEST(OrientedImageTest, mappingOfNotScaledImage)
+{
+    QTemporaryDir dir;
+    const QString path = storeImage(dir, 40, 20);
 
-    QImage qimage(10, 100, QImage::Format_RGB32);
-    MockExifReader exif;
+    NiceMock<MockExifReader> exif;
+    const OrientedImage image(&exif, path, 100);
 
-    OrientedImage(&exif, qimage);
-    */
+    EXPECT_EQ(image.mapToOriginal(QRect(1, 2, 3, 4)), QRect(1, 2, 3, 4));
 }
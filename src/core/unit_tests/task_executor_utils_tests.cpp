@@ -0,0 +1,127 @@
+
+#include <stdexcept>
+#include <vector>
+#include <gmock/gmock.h>
+
+#include <unit_tests_utils/fake_task_executor.hpp>
+
+#include "task_executor_utils.hpp"
+
+
+namespace
+{
+    // executor which never runs tasks
+    struct BusyTaskExecutor: ITaskExecutor
+    {
+        void add(std::unique_ptr<ITask>&& task) override
+        {
+            tasks.push_back(std::move(task));
+        }
+
+        void addLight(std::unique_ptr<ITask>&& task) override
+        {
+            tasks.push_back(std::move(task));
+        }
+
+        int heavyWorkers() const override
+        {
+            return 4;
+        }
+
+        std::vector<std::unique_ptr<ITask>> tasks;
+    };
+}
+
+
+TEST(ParallelForTest, eachIndexIsProcessedOnce)
+{
+    FakeTaskExecutor executor;
+    std::vector<int> calls(100, 0);
+
+    parallelFor(&executor, calls.size(), 4, [&calls](std::size_t i)
+    {
+        calls[i]++;
+    });
+
+    EXPECT_THAT(calls, testing::Each(1));
+}
+
+
+TEST(ParallelForTest, callerProcessesWorkWhenThereAreNoFreeWorkers)
+{
+    BusyTaskExecutor executor;
+    std::vector<int> calls(10, 0);
+
+    parallelFor(&executor, calls.size(), 4, [&calls](std::size_t i)
+    {
+        calls[i]++;
+    });
+
+    EXPECT_THAT(calls, testing::Each(1));
+    EXPECT_EQ(executor.tasks.size(), 3);
+
+    // late helpers should find nothing to do
+    for (auto& task: executor.tasks)
+        task->perform();
+
+    EXPECT_THAT(calls, testing::Each(1));
+}
+
+
+TEST(ParallelForTest, emptyRange)
+{
+    BusyTaskExecutor executor;
+
+    parallelFor(&executor, 0, 4, [](std::size_t)
+    {
+        FAIL();
+    });
+
+    EXPECT_TRUE(executor.tasks.empty());
+}
+
+
+TEST(ParallelForTest, exceptionIsRethrownWhenAllIndexesAreProcessed)
+{
+    FakeTaskExecutor executor;
+    std::vector<int> calls(10, 0);
+
+    EXPECT_THROW(
+    {
+        parallelFor(&executor, calls.size(), 4, [&calls](std::size_t i)
+        {
+            calls[i]++;
+
+            if (i % 3 == 0)
+                throw std::runtime_error("failure");
+        });
+    }, std::runtime_error);
+
+    EXPECT_THAT(calls, testing::Each(1));
+}
+
+
+TEST(ParallelForTest, exceptionInCallerThreadDoesNotBlock)
+{
+    BusyTaskExecutor executor;
+    std::vector<int> calls(10, 0);
+
+    EXPECT_THROW(
+    {
+        parallelFor(&executor, calls.size(), 4, [&calls](std::size_t i)
+        {
+            calls[i]++;
+
+            if (i == 0)
+                throw std::logic_error("failure");
+        });
+    }, std::logic_error);
+
+    EXPECT_THAT(calls, testing::Each(1));
+
+    // late helpers should find nothing to do
+    for (auto& task: executor.tasks)
+        task->perform();
+
+    EXPECT_THAT(calls, testing::Each(1));
+}
@@ -14,7 +14,7 @@ namespace Database
             PersonInfo::Id store(const PersonInfo& pi) override;
 
         private:
-            virtual void dropPersonInfo(const PersonInfo::Id &) = 0;
+            virtual bool dropPersonInfo(const PersonInfo::Id &) = 0;             // returns false on error
             virtual PersonInfo::Id storePerson(const PersonInfo &) = 0;
     };
 }
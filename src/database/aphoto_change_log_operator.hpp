@@ -11,8 +11,10 @@ namespace Database
     {
         public:
             void storeDifference(const Photo::Data &, const Photo::DataDelta &) override;
-            void groupCreated(const Group::Id &, const Group::Type &, const Photo::Id& representative) override;
+            void groupCreated(const Group::Id &, const Group::Type &, const Photo::Id& representative, const std::vector<Photo::Id>& members) override;
             void groupDeleted(const Group::Id &, const Photo::Id& representative, const std::vector<Photo::Id>& members) override;
+            void flush() override;
+            void discard() override;
 
         protected:
             enum Operation
@@ -28,16 +30,31 @@ namespace Database
                 Group   = 2,
             };
 
-            virtual void append(const Photo::Id &, Operation, Field, const QString& data) = 0;
+            struct Entry
+            {
+                Photo::Id photoId;
+                Operation operation;
+                Field field;
+                TagTypes tagType;       // TagTypes::Invalid for non-tag fields
+                QString oldValue;       // null for Add
+                QString newValue;       // null for Remove
+            };
+
+            // groups are stored as 'id,role' values
+            static QString encodeGroup(const GroupInfo &);
+
+            virtual void append(const std::vector<Entry> &) = 0;
             void process(const Photo::Id &, const Tag::TagsList &, const Tag::TagsList &);
             void process(const Photo::Id &, const GroupInfo &, const GroupInfo &);
 
-            QString format(int, Operation, Field, const QString &);
+            QString format(const Entry &);
 
         private:
+            std::vector<Entry> m_pending;
+
             QString fieldToStr(Field);
             QString opToStr(Operation);
-            QString dataToStr(Field, Operation, const QString &);
+            QString dataToStr(const Entry &);
     };
 }
 
@@ -1,7 +1,15 @@
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
+
 #include <QFileInfo>
 
+#include <core/base_tags.hpp>
+#include <core/containers_utils.hpp>
+
 #include "memory_backend.hpp"
+#include "database/general_flags.hpp"
 #include "database/project_info.hpp"
 
 
@@ -25,6 +33,67 @@ namespace
 
         return (is_less? -1: 0) + (is_greater? 1: 0);
     }
+
+    template<typename T>
+    bool matches(const T& value, const T& expected, Database::FilterPhotosWithTag::ValueMode mode)
+    {
+        switch (mode)
+        {
+            case Database::FilterPhotosWithTag::ValueMode::Equal:          return value == expected;
+            case Database::FilterPhotosWithTag::ValueMode::Less:           return value < expected;
+            case Database::FilterPhotosWithTag::ValueMode::LessOrEqual:    return value <= expected;
+            case Database::FilterPhotosWithTag::ValueMode::Greater:        return value > expected;
+            case Database::FilterPhotosWithTag::ValueMode::GreaterOrEqual: return value >= expected;
+        }
+
+        assert(!"unexpected");
+        return false;
+    }
+
+    template<typename Index, typename Key>
+    void removeFromIndex(Index& index, const Key& key, const Photo::Id& id)
+    {
+        auto it = index.find(key);
+
+        if (it != index.end())
+        {
+            it->second.erase(id);
+
+            if (it->second.empty())
+                index.erase(it);
+        }
+    }
+
+    std::set<Photo::Id> intersection(const std::set<Photo::Id>& lhs, const std::set<Photo::Id>& rhs)
+    {
+        std::set<Photo::Id> result;
+        std::set_intersection(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(), std::inserter(result, result.end()));
+
+        return result;
+    }
+
+    std::set<Photo::Id> difference(const std::set<Photo::Id>& lhs, const std::set<Photo::Id>& rhs)
+    {
+        std::set<Photo::Id> result;
+        std::set_difference(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(), std::inserter(result, result.end()));
+
+        return result;
+    }
+
+    // words of photo's path and tags used by text search
+    std::set<QString> searchTerms(const Photo::Data& data)
+    {
+        std::set<QString> terms;
+
+        for (const QString& term: SearchExpressionEvaluator::terms(data.path))
+            terms.insert(term);
+
+        for (const auto& tag: data.tags)
+            for (const QString& term: SearchExpressionEvaluator::terms(tag.second.rawValue()))
+                terms.insert(term);
+
+        return terms;
+    }
 }
 
 
@@ -35,6 +104,7 @@ namespace Database
     {
         std::vector<Photo::Id> ids;
         ids.reserve(photos.size());
+        TagValuesCounts tagValuesChanges;
 
         for (Photo::DataDelta& delta: photos)
         {
@@ -44,18 +114,30 @@ namespace Database
             delta.setId(id);
 
             Photo::Data data;
-            data.apply(delta);
+            data.id = id;
+
+            // sql backends log initial state of photo too
+            photoChangeLogOperator().storeDifference(data, delta);
 
-            auto [it, i] = m_photos.insert(data);      // insert empty Data for given id
+            apply(data, delta);
+            index(data);
+            countTagValues(tagValuesChanges, {}, data.tags);
+
+            auto [it, i] = m_photos.emplace(id, data);
             assert(i == true);
 
-            ids.push_back(data.id);
+            ids.push_back(id);
 
             m_nextPhotoId++;
         }
 
+        photoChangeLogOperator().flush();
+
         emit photosAdded(ids);
 
+        if (tagValuesChanges.empty() == false)
+            emit tagValuesChanged(tagValuesChanges);
+
         return true;
     }
 
@@ -63,58 +145,149 @@ namespace Database
     bool MemoryBackend::update(const std::vector<Photo::DataDelta>& deltas)
     {
         std::set<Photo::Id> ids;
+        TagValuesCounts tagValuesChanges;
 
         for (const auto& delta: deltas)
         {
             auto it = m_photos.find(delta.getId());
 
-            Photo::Data data = *it;
+            if (it == m_photos.end())
+                continue;
+
+            Photo::Data& data = it->second;
             photoChangeLogOperator().storeDifference(data, delta);
 
-            data.apply(delta);
+            const Tag::TagsList previousTags = data.tags;
 
-            it = m_photos.erase(it);
-            m_photos.insert(it, data);
+            unindex(data);
+            apply(data, delta);
+            index(data);
+            countTagValues(tagValuesChanges, previousTags, data.tags);
 
             ids.insert(delta.getId());
         }
 
+        photoChangeLogOperator().flush();
+
+        emit photosUpdated(deltas);
         emit photosModified(ids);
 
+        if (tagValuesChanges.empty() == false)
+            emit tagValuesChanged(tagValuesChanges);
+
         return true;
     }
 
 
-    std::vector<TagValue> MemoryBackend::listTagValues(const TagTypes& type, const Filter &)
+    std::vector<TagValue> MemoryBackend::listTagValues(const TagTypes& type, const Filter& filter)
     {
-        std::set<TagValue> values;
+        std::vector<TagValue> values;
 
-        for(const auto& photo: m_photos)
+        auto type_it = m_tagsIndex.find(type);
+
+        if (type_it != m_tagsIndex.end())
         {
-            auto it = photo.tags.find(type);
-            if (it != photo.tags.end() && it->second.type() != Tag::ValueType::Empty)
-                values.insert(it->second);
+            const bool allPhotos = std::holds_alternative<EmptyFilter>(filter);
+            const PhotosSet filtered = allPhotos? PhotosSet(): evaluate(filter);
+            const Tag::ValueType valueType = BaseTags::getType(type);
+
+            for (const auto& [rawValue, photos]: type_it->second)
+            {
+                const bool used = allPhotos || std::any_of(photos.cbegin(), photos.cend(), [&filtered](const Photo::Id& id)
+                {
+                    return filtered.find(id) != filtered.end();
+                });
+
+                if (used)
+                    values.push_back(TagValue::fromRaw(rawValue, valueType));
+            }
         }
 
-        std::vector<TagValue> values_vec;
-        values_vec.reserve(values.size());
+        return values;
+    }
+
+
+    TagValuesCounts MemoryBackend::tagValuesCounts()
+    {
+        TagValuesCounts counts;
+
+        for (const auto& [type, values]: m_tagsIndex)
+        {
+            const Tag::ValueType valueType = BaseTags::getType(type);
 
-        std::copy(values.begin(), values.end(), std::back_inserter(values_vec));
+            for (const auto& [rawValue, photos]: values)
+                counts[type][TagValue::fromRaw(rawValue, valueType)] = static_cast<int>(photos.size());
+        }
 
-        return values_vec;
+        return counts;
     }
 
 
     Photo::Data MemoryBackend::getPhoto(const Photo::Id& id)
     {
         auto it = m_photos.find(id);
-        return it == m_photos.end()? Photo::Data(): *it;
+        return it == m_photos.end()? Photo::Data(): it->second;
     }
 
 
-    int MemoryBackend::getPhotosCount(const Filter &)
+    std::vector<Photo::Data> MemoryBackend::getPhotos(const std::vector<Photo::Id>& ids)
     {
-        return 0;
+        std::vector<Photo::Data> result;
+        result.reserve(ids.size());
+
+        for (const Photo::Id& id: ids)
+        {
+            auto it = m_photos.find(id);
+
+            if (it != m_photos.end())
+                result.push_back(it->second);
+        }
+
+        return result;
+    }
+
+
+    int MemoryBackend::getPhotosCount(const Filter& filter)
+    {
+        const std::size_t count = std::holds_alternative<EmptyFilter>(filter)?
+                                      m_photos.size():
+                                      evaluate(filter).size();
+
+        return static_cast<int>(count);
+    }
+
+
+    std::map<QDate, int> MemoryBackend::datesHistogram(const Filter& filter, DatesResolution resolution)
+    {
+        std::map<QDate, int> histogram;
+
+        const PhotosSet photos = evaluate(filter);
+        std::size_t datedPhotos = 0;
+
+        auto dates = m_tagsIndex.find(TagTypes::Date);
+
+        if (dates != m_tagsIndex.end())
+            for (const auto& [rawDate, ids]: dates->second)
+            {
+                const std::size_t count = intersection(photos, ids).size();
+
+                if (count == 0)
+                    continue;
+
+                const QDate date = TagValue::fromRaw(rawDate, Tag::ValueType::Date).getDate();
+
+                if (resolution == DatesResolution::Month)
+                    histogram[QDate(date.year(), date.month(), 1)] += static_cast<int>(count);
+                else
+                    histogram[date] += static_cast<int>(count);
+
+                datedPhotos += count;
+            }
+
+        if (photos.size() > datedPhotos)
+            histogram[QDate()] = static_cast<int>(photos.size() - datedPhotos);
+
+        return histogram;
     }
 
 
@@ -146,6 +319,28 @@ namespace Database
     {
         std::vector<Photo::Id> ids;
 
+        auto flag_it = m_flagsIndex.find(Photo::FlagsE::StagingArea);
+
+        if (flag_it != m_flagsIndex.end())
+        {
+            auto staged_it = flag_it->second.find(1);
+
+            if (staged_it != flag_it->second.end())
+                ids.assign(staged_it->second.cbegin(), staged_it->second.cend());
+        }
+
+        for (const Photo::Id& id: ids)
+        {
+            Photo::Data& data = m_photos.at(id);
+
+            unindex(data);
+            data.flags[Photo::FlagsE::StagingArea] = 0;
+            index(data);
+        }
+
+        if (ids.empty() == false)
+            emit photosMarkedAsReviewed(ids);
+
         return ids;
     }
 
@@ -191,6 +386,12 @@ namespace Database
     }
 
 
+    IExifFeaturesOperator& MemoryBackend::exifFeaturesOperator()
+    {
+        return *this;
+    }
+
+
     std::vector<PersonName> MemoryBackend::listPeople()
     {
         std::vector<PersonName> result;
@@ -222,22 +423,70 @@ namespace Database
     }
 
 
-    std::vector<PersonFingerprint> MemoryBackend::fingerprintsFor(const Person::Id &)
+    std::vector<PersonFingerprint> MemoryBackend::fingerprintsFor(const Person::Id& id)
     {
         std::vector<PersonFingerprint> fingerprints;
 
+        for (const PersonInfo& info: m_peopleInfo)
+            if (info.p_id == id && info.f_id.valid())
+            {
+                auto it = m_fingerprints.find(info.f_id);
+
+                if (it != m_fingerprints.end())
+                    fingerprints.push_back(it->second);
+            }
+
         return fingerprints;
     }
 
 
-    std::map<PersonInfo::Id, PersonFingerprint> MemoryBackend::fingerprintsFor(const std::vector<PersonInfo::Id>& id)
+    std::map<PersonInfo::Id, PersonFingerprint> MemoryBackend::fingerprintsFor(const std::vector<PersonInfo::Id>& ids)
     {
         std::map<PersonInfo::Id, PersonFingerprint> fingerprints;
 
+        for (const PersonInfo::Id& id: ids)
+        {
+            auto info_it = m_peopleInfo.find(id);
+
+            if (info_it != m_peopleInfo.end() && info_it->f_id.valid())
+            {
+                auto it = m_fingerprints.find(info_it->f_id);
+
+                if (it != m_fingerprints.end())
+                    fingerprints.emplace(id, it->second);
+            }
+        }
+
         return fingerprints;
     }
 
 
+    std::map<Person::Id, Person::Fingerprint> MemoryBackend::peopleCentroids()
+    {
+        std::map<Person::Id, std::pair<Person::Fingerprint, int>> sums;
+
+        for (const PersonInfo& info: m_peopleInfo)
+            if (info.p_id.valid() && info.f_id.valid())
+            {
+                auto it = m_fingerprints.find(info.f_id);
+
+                if (it != m_fingerprints.end())
+                {
+                    auto& [sum, count] = sums[info.p_id];
+                    sum += it->second.fingerprint();
+                    count++;
+                }
+            }
+
+        std::map<Person::Id, Person::Fingerprint> centroids;
+
+        for (const auto& [id, sum]: sums)
+            centroids.emplace(id, sum.first / sum.second);
+
+        return centroids;
+    }
+
+
     Person::Id MemoryBackend::store(const PersonName &pn)
     {
         Person::Id id = pn.id();
@@ -275,19 +524,69 @@ namespace Database
     }
 
 
-    PersonFingerprint::Id MemoryBackend::store(const PersonFingerprint &)
+    PersonFingerprint::Id MemoryBackend::store(const PersonFingerprint& fingerprint)
     {
-        PersonFingerprint::Id id;
+        PersonFingerprint::Id id = fingerprint.id();
+
+        // keep precision of sql backends which store float32 components
+        Person::Fingerprint components(fingerprint.fingerprint().size());
+        std::transform(fingerprint.fingerprint().cbegin(), fingerprint.fingerprint().cend(), components.begin(), [](double component)
+        {
+            return static_cast<float>(component);
+        });
+
+        if (id.valid())
+        {
+            // empty fingerprint means removal
+            if (components.empty())
+                m_fingerprints.erase(id);
+            else
+                m_fingerprints.insert_or_assign(id, PersonFingerprint(id, components));
+        }
+        else
+        {
+            id = PersonFingerprint::Id(m_nextFingerprint++);
+            m_fingerprints.emplace(id, PersonFingerprint(id, components));
+        }
 
         return id;
     }
 
 
-    void MemoryBackend::dropPersonInfo(const PersonInfo::Id& id)
+    bool MemoryBackend::storeDetectedFaces(const std::map<Photo::Id, std::vector<QRect>>& faces)
+    {
+        for (const auto& [id, locations]: faces)
+        {
+            if (m_photos.find(id) == m_photos.end())
+                continue;
+
+            const std::vector<PersonInfo> known = listPeople(id);
+
+            for (const QRect& location: locations)
+            {
+                const bool exists = std::any_of(known.cbegin(), known.cend(), [location](const PersonInfo& info)
+                {
+                    return info.rect.intersects(location);
+                });
+
+                if (exists == false)
+                    storePerson(PersonInfo(Person::Id(), id, PersonFingerprint::Id(), location));
+            }
+
+            m_flags[id][CommonGeneralFlags::FacesAnalysed] = 1;
+        }
+
+        return true;
+    }
+
+
+    bool MemoryBackend::dropPersonInfo(const PersonInfo::Id& id)
     {
         auto it = m_peopleInfo.find(id);
         if (it != m_peopleInfo.end())
             m_peopleInfo.erase(it);
+
+        return true;
     }
 
 
@@ -310,10 +609,9 @@ namespace Database
     }
 
 
-    void MemoryBackend::append(const Photo::Id& id, Operation operation, Field field, const QString& data)
+    void MemoryBackend::append(const std::vector<Entry>& entries)
     {
-        const auto entry = std::make_tuple(id, operation, field, data);
-        m_logEntries.push_back(entry);
+        m_logEntries.insert(m_logEntries.end(), entries.begin(), entries.end());
     }
 
 
@@ -323,11 +621,7 @@ namespace Database
 
         for(const auto& entry: m_logEntries)
         {
-            const QString formatted = format(std::get<0>(entry),
-                                             std::get<1>(entry),
-                                             std::get<2>(entry),
-                                             std::get<3>(entry)
-            );
+            const QString formatted = format(entry);
 
             list.append(formatted);
         }
@@ -336,6 +630,32 @@ namespace Database
     }
 
 
+    bool MemoryBackend::storeFeatures(const std::map<Photo::Id, ExifFeatures>& features)
+    {
+        for (const auto& [id, data]: features)
+            if (m_photos.find(id) != m_photos.end())
+                m_exifFeatures[id] = data;
+
+        return true;
+    }
+
+
+    std::map<Photo::Id, ExifFeatures> MemoryBackend::getFeatures(const std::vector<Photo::Id>& ids)
+    {
+        std::map<Photo::Id, ExifFeatures> result;
+
+        for (const Photo::Id& id: ids)
+        {
+            auto it = m_exifFeatures.find(id);
+
+            if (it != m_exifFeatures.end())
+                result.insert(*it);
+        }
+
+        return result;
+    }
+
+
     Group::Id MemoryBackend::addGroup(const Photo::Id& representative_photo, Group::Type type)
     {
         Group::Id gid(m_nextGroup++);
@@ -359,21 +679,14 @@ namespace Database
 
         if (it != m_groups.end())
         {
-            m_groups.erase(gid);
+            r_id = it->second.first;
+            m_groups.erase(it);
 
-            std::vector<Photo::Id> photosToClear;
+            std::vector<Photo::Id> photosToClear = { r_id };
 
-            for(Photo::Data data: m_photos)
-                if (data.groupInfo.role != GroupInfo::Role::None &&
-                    data.groupInfo.group_id == gid)
-                {
-                    const Photo::Id id = data.id;
-
-                    photosToClear.push_back(id);
-
-                    if (data.groupInfo.role == GroupInfo::Role::Representative)
-                        r_id = id;
-                }
+            auto members_it = m_groupMembers.find(gid);
+            if (members_it != m_groupMembers.end())
+                photosToClear.insert(photosToClear.end(), members_it->second.cbegin(), members_it->second.cend());
 
             std::vector<Photo::DataDelta> deltas;
             deltas.reserve(photosToClear.size());
@@ -393,31 +706,134 @@ namespace Database
     }
 
 
-    Group::Type MemoryBackend::type(const Group::Id &) const
+    std::vector<Group::Id> MemoryBackend::addGroups(const std::vector<GroupDefinition>& groups)
     {
-        Group::Type t = Group::Type::Invalid;
+        std::vector<Group::Id> ids;
+        std::vector<Photo::DataDelta> members;
+
+        for (const GroupDefinition& group: groups)
+        {
+            const Group::Id gid = addGroup(group.representative, group.type);
+            ids.push_back(gid);
 
-        return t;
+            for (const Photo::Id& member: group.members)
+            {
+                Photo::DataDelta delta(member);
+                delta.insert<Photo::Field::GroupInfo>(GroupInfo(gid, GroupInfo::Member));
+                members.push_back(delta);
+            }
+        }
+
+        if (members.empty() == false)
+            update(members);
+
+        return ids;
     }
 
 
-    std::vector<Photo::Id> MemoryBackend::membersOf(const Group::Id &) const
+    std::vector<Photo::Id> MemoryBackend::removeGroups(const std::vector<Group::Id>& groups)
+    {
+        std::vector<Photo::Id> representatives;
+
+        for (const Group::Id& gid: groups)
+            representatives.push_back(removeGroup(gid));
+
+        return representatives;
+    }
+
+
+    Group::Type MemoryBackend::type(const Group::Id& id) const
+    {
+        auto it = m_groups.find(id);
+
+        return it == m_groups.end()? Group::Type::Invalid: it->second.second;
+    }
+
+
+    std::vector<Photo::Id> MemoryBackend::membersOf(const Group::Id& id) const
     {
         std::vector<Photo::Id> ids;
 
+        auto it = m_groupMembers.find(id);
+        if (it != m_groupMembers.end())
+            ids.assign(it->second.cbegin(), it->second.cend());
+
         return ids;
     }
 
 
-    bool MemoryBackend::removePhoto(const Photo::Id &)
+    bool MemoryBackend::removePhoto(const Photo::Id& id)
     {
-        return false;
+        FilterPhotosWithId id_filter;
+        id_filter.filter = id;
+
+        return removePhotos(id_filter);
     }
 
 
-    bool MemoryBackend::removePhotos(const Filter &)
+    bool MemoryBackend::removePhotos(const Filter& filter)
     {
-        return false;
+        const PhotosSet ids = evaluate(filter);
+
+        // groups of removed representatives are removed too (as with foreign keys in sql backends)
+        PhotosSet ungrouped;
+
+        for (auto it = m_groups.begin(); it != m_groups.end();)
+        {
+            if (ids.find(it->second.first) != ids.end())
+            {
+                auto members_it = m_groupMembers.find(it->first);
+                if (members_it != m_groupMembers.end())
+                    ungrouped.merge(difference(members_it->second, ids));
+
+                it = m_groups.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        for (const Photo::Id& id: ungrouped)
+        {
+            Photo::Data& data = m_photos.at(id);
+
+            unindex(data);
+            data.groupInfo = GroupInfo();
+            index(data);
+        }
+
+        TagValuesCounts tagValuesChanges;
+
+        for (const Photo::Id& id: ids)
+        {
+            auto it = m_photos.find(id);
+
+            unindex(it->second);
+            countTagValues(tagValuesChanges, it->second.tags, {});
+            m_photos.erase(it);
+            m_flags.erase(id);
+            m_exifFeatures.erase(id);
+        }
+
+        for (auto it = m_peopleInfo.begin(); it != m_peopleInfo.end();)
+            if (ids.find(it->ph_id) != ids.end())
+                it = m_peopleInfo.erase(it);
+            else
+                ++it;
+
+        m_logEntries.erase(std::remove_if(m_logEntries.begin(), m_logEntries.end(), [&ids](const Entry& entry)
+        {
+            return ids.find(entry.photoId) != ids.end();
+        }), m_logEntries.end());
+
+        if (ungrouped.empty() == false)
+            emit photosModified(ungrouped);
+
+        emit photosRemoved( std::vector<Photo::Id>(ids.cbegin(), ids.cend()) );
+
+        if (tagValuesChanges.empty() == false)
+            emit tagValuesChanged(tagValuesChanges);
+
+        return true;
     }
 
 
@@ -440,23 +856,15 @@ namespace Database
     }
 
 
-    std::vector<Photo::Id> MemoryBackend::getPhotos(const Filter &)
+    std::vector<Photo::Id> MemoryBackend::getPhotos(const Filter& filter)
     {
-        std::vector<Photo::Id> ids;
-
-        for(const auto& photo: m_photos)
-            ids.push_back(photo.id);
+        const PhotosSet photos = evaluate(filter);
+        const std::vector<Photo::Id> ids(photos.cbegin(), photos.cend());
 
         return ids;
     }
 
 
-    Photo::Id MemoryBackend::getIdFor(const Photo::Data& d)
-    {
-        return d.id;
-    }
-
-
     Person::Id MemoryBackend::getIdFor(const PersonName& pn)
     {
         return pn.id();
@@ -504,4 +912,368 @@ namespace Database
         }
     }
 
+
+    void MemoryBackend::apply(Photo::Data& data, const Photo::DataDelta& delta) const
+    {
+        data.apply(delta);
+
+        // behave as sql backends do: empty tags are not stored, flags are stored as a whole
+        if (delta.has(Photo::Field::Tags))
+            for (auto it = data.tags.begin(); it != data.tags.end();)
+                if (it->second.type() == Tag::ValueType::Empty)
+                    it = data.tags.erase(it);
+                else
+                    ++it;
+
+        if (delta.has(Photo::Field::Flags) || delta.has(Photo::Field::FlagsChanges))
+            for (const Photo::FlagsE flag: { Photo::FlagsE::StagingArea,
+                                             Photo::FlagsE::ExifLoaded,
+                                             Photo::FlagsE::Sha256Loaded,
+                                             Photo::FlagsE::ThumbnailLoaded,
+                                             Photo::FlagsE::GeometryLoaded })
+                data.flags.emplace(flag, 0);
+    }
+
+
+    void MemoryBackend::index(const Photo::Data& data)
+    {
+        for (const auto& [type, value]: data.tags)
+            m_tagsIndex[type][value.rawValue()].insert(data.id);
+
+        for (const auto& [flag, value]: data.flags)
+            m_flagsIndex[flag][value].insert(data.id);
+
+        m_pathsIndex[data.path].insert(data.id);
+
+        for (const QString& term: searchTerms(data))
+            m_termsIndex[term].insert(data.id);
+
+        if (data.groupInfo.role == GroupInfo::Member)
+            m_groupMembers[data.groupInfo.group_id].insert(data.id);
+    }
+
+
+    void MemoryBackend::unindex(const Photo::Data& data)
+    {
+        for (const auto& [type, value]: data.tags)
+            removeFromIndex(m_tagsIndex[type], value.rawValue(), data.id);
+
+        for (const auto& [flag, value]: data.flags)
+            removeFromIndex(m_flagsIndex[flag], value, data.id);
+
+        removeFromIndex(m_pathsIndex, data.path, data.id);
+
+        for (const QString& term: searchTerms(data))
+            removeFromIndex(m_termsIndex, term, data.id);
+
+        if (data.groupInfo.role == GroupInfo::Member)
+            removeFromIndex(m_groupMembers, data.groupInfo.group_id, data.id);
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::allPhotos() const
+    {
+        PhotosSet ids;
+
+        for (const auto& photo: m_photos)
+            ids.insert(photo.first);
+
+        return ids;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const Filter& filter) const
+    {
+        const PhotosSet result = std::visit([this](const auto& arg) -> PhotosSet {
+                return this->evaluate(arg);
+            },
+            filter
+        );
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const EmptyFilter &) const
+    {
+        return allPhotos();
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const GroupFilter& groupFilter) const
+    {
+        if (groupFilter.filters.empty())
+            return allPhotos();
+
+        auto it = groupFilter.filters.cbegin();
+        PhotosSet result = evaluate(*it);
+
+        for (++it; it != groupFilter.filters.cend() && result.empty() == false; ++it)
+            result = intersection(result, evaluate(*it));
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosWithTag& filter) const
+    {
+        PhotosSet result;
+
+        auto type_it = m_tagsIndex.find(filter.tagType);
+        const std::map<QString, PhotosSet> noValues;
+        const std::map<QString, PhotosSet>& values = type_it == m_tagsIndex.end()? noValues: type_it->second;
+
+        if (filter.tagValue.type() == Tag::ValueType::Empty)
+        {
+            // any value
+            for (const auto& photos: values)
+                result.insert(photos.second.cbegin(), photos.second.cend());
+        }
+        else
+        {
+            const QString expected = filter.tagValue.rawValue();
+
+            // sql backends compare ratings as integers unless empty values are included
+            const bool numeric = filter.tagType == TagTypes::Rating && filter.includeEmpty == false;
+
+            if (filter.valueMode == FilterPhotosWithTag::ValueMode::Equal && numeric == false)
+            {
+                auto it = values.find(expected);
+                if (it != values.end())
+                    result = it->second;
+            }
+            else
+                for (const auto& [value, photos]: values)
+                {
+                    const bool match = numeric?
+                                           matches(value.toInt(), expected.toInt(), filter.valueMode):
+                                           matches(value, expected, filter.valueMode);
+
+                    if (match)
+                        result.insert(photos.cbegin(), photos.cend());
+                }
+
+            // photos without tag are treated as ones with empty value
+            if (filter.includeEmpty && matches(QString(), expected, filter.valueMode))
+            {
+                PhotosSet tagged;
+                for (const auto& photos: values)
+                    tagged.insert(photos.second.cbegin(), photos.second.cend());
+
+                result.merge(difference(allPhotos(), tagged));
+            }
+        }
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosWithFlags& filter) const
+    {
+        PhotosSet result;
+        bool first = true;
+
+        for (const auto& [flag, value]: filter.flags)
+        {
+            const PhotosSet* photos = nullptr;
+
+            auto flag_it = m_flagsIndex.find(flag);
+            if (flag_it != m_flagsIndex.end())
+            {
+                auto value_it = flag_it->second.find(value);
+                if (value_it != flag_it->second.end())
+                    photos = &value_it->second;
+            }
+
+            const PhotosSet matching = photos == nullptr? PhotosSet(): *photos;
+
+            switch (filter.mode)
+            {
+                case FilterPhotosWithFlags::Mode::And:
+                    result = first? matching: intersection(result, matching);
+                    break;
+
+                case FilterPhotosWithFlags::Mode::Or:
+                    result.insert(matching.cbegin(), matching.cend());
+                    break;
+            }
+
+            first = false;
+        }
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosWithSha256& filter) const
+    {
+        PhotosSet result;
+
+        for (const auto& [id, data]: m_photos)
+            if (data.sha256Sum == filter.sha256)
+                result.insert(id);
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterNotMatchingFilter& filter) const
+    {
+        return difference(allPhotos(), evaluate(*filter.filter.get()));
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosWithId& filter) const
+    {
+        PhotosSet result;
+
+        if (m_photos.find(filter.filter) != m_photos.end())
+            result.insert(filter.filter);
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosMatchingExpression& filter) const
+    {
+        PhotosSet result;
+
+        for (const SearchExpressionEvaluator::Filter& condition: filter.expression)
+        {
+            PhotosSet photos;
+            std::function<bool(const QString &)> matchesName;
+
+            if (condition.m_exact)
+            {
+                for (const auto& values: m_tagsIndex)
+                {
+                    auto it = values.second.find(condition.m_value);
+
+                    if (it != values.second.end())
+                        photos.insert(it->second.cbegin(), it->second.cend());
+                }
+
+                matchesName = [&condition](const QString& name)
+                {
+                    return name == condition.m_value;
+                };
+            }
+            else
+            {
+                // same rules as sql backends: each word needs to be a beginning of some indexed word
+                const std::vector<QString> terms = SearchExpressionEvaluator::terms(condition.m_value);
+
+                if (terms.empty())
+                    continue;
+
+                for (auto it = terms.cbegin(); it != terms.cend(); ++it)
+                {
+                    PhotosSet photosWithTerm;
+
+                    for (auto t_it = m_termsIndex.lower_bound(*it); t_it != m_termsIndex.end() && t_it->first.startsWith(*it); ++t_it)
+                        photosWithTerm.insert(t_it->second.cbegin(), t_it->second.cend());
+
+                    photos = it == terms.cbegin()? photosWithTerm: intersection(photos, photosWithTerm);
+                }
+
+                matchesName = [&terms](const QString& name)
+                {
+                    return std::all_of(terms.cbegin(), terms.cend(), [&name](const QString& term)
+                    {
+                        return name.startsWith(term, Qt::CaseInsensitive) || name.contains(" " + term, Qt::CaseInsensitive);
+                    });
+                };
+            }
+
+            std::set<Person::Id> people;
+            for (const PersonName& person: m_peopleNames)
+                if (matchesName(person.name()))
+                    people.insert(person.id());
+
+            for (const PersonInfo& info: m_peopleInfo)
+                if (people.find(info.p_id) != people.end())
+                    photos.insert(info.ph_id);
+
+            result.insert(photos.cbegin(), photos.cend());
+        }
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosWithPath& filter) const
+    {
+        auto it = m_pathsIndex.find(filter.path);
+
+        return it == m_pathsIndex.end()? PhotosSet(): it->second;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosWithRole& filter) const
+    {
+        PhotosSet representatives;
+        for (const auto& group: m_groups)
+            representatives.insert(group.second.first);
+
+        PhotosSet members;
+        for (const auto& group: m_groupMembers)
+            members.insert(group.second.cbegin(), group.second.cend());
+
+        PhotosSet result;
+
+        switch (filter.m_role)
+        {
+            case FilterPhotosWithRole::Role::Regular:
+                result = difference(difference(allPhotos(), representatives), members);
+                break;
+
+            case FilterPhotosWithRole::Role::GroupRepresentative:
+                result = representatives;
+                break;
+
+            case FilterPhotosWithRole::Role::GroupMember:
+                result = members;
+                break;
+        }
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosWithPerson& filter) const
+    {
+        PhotosSet result;
+
+        for (const PersonInfo& info: m_peopleInfo)
+            if (info.p_id == filter.person_id)
+                result.insert(info.ph_id);
+
+        return result;
+    }
+
+
+    MemoryBackend::PhotosSet MemoryBackend::evaluate(const FilterPhotosWithGeneralFlags& filter) const
+    {
+        PhotosSet result;
+
+        // photos without flag are treated as ones with 0
+        for (const auto& photo: m_photos)
+        {
+            int value = 0;
+
+            auto flags_it = m_flags.find(photo.first);
+            if (flags_it != m_flags.end())
+            {
+                auto it = flags_it->second.find(filter.name);
+                if (it != flags_it->second.end())
+                    value = it->second;
+            }
+
+            if (value == filter.value)
+                result.insert(photo.first);
+        }
+
+        return result;
+    }
+
 }
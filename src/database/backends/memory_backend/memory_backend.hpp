@@ -2,9 +2,12 @@
 #ifndef MEMORYBACKEND_HPP
 #define MEMORYBACKEND_HPP
 
+#include <unordered_map>
+
 #include "database/aphoto_change_log_operator.hpp"
 #include "database/apeople_information_accessor.hpp"
 #include "database/ibackend.hpp"
+#include "database/iexif_features_operator.hpp"
 #include "database/igroup_operator.hpp"
 #include "database/iphoto_operator.hpp"
 
@@ -15,11 +18,15 @@ namespace Database
 {
     /**
     * \brief memory based backend
+    *
+    * Photos are kept in a hash map. Tags, flags and paths are indexed
+    * so filters can be evaluated without scanning all photos.
     */
     class DATABASE_MEMORY_BACKEND_EXPORT MemoryBackend:
         public IBackend,
                APeopleInformationAccessor,
                APhotoChangeLogOperator,
+               IExifFeaturesOperator,
                IGroupOperator,
                IPhotoOperator
     {
@@ -28,8 +35,11 @@ namespace Database
             bool addPhotos(std::vector<Photo::DataDelta>& photos) override;
             bool update(const std::vector<Photo::DataDelta> &) override;
             std::vector<TagValue> listTagValues(const TagTypes &, const Filter &) override;
+            TagValuesCounts tagValuesCounts() override;
             Photo::Data getPhoto(const Photo::Id &) override;
+            std::vector<Photo::Data> getPhotos(const std::vector<Photo::Id> &) override;
             int getPhotosCount(const Filter &) override;
+            std::map<QDate, int> datesHistogram(const Filter &, DatesResolution) override;
             void set(const Photo::Id& id, const QString& name, int value) override;
             std::optional<int> get(const Photo::Id& id, const QString& name) override;
             std::vector<Photo::Id> markStagedAsReviewed() override;
@@ -39,6 +49,7 @@ namespace Database
             IPhotoOperator& photoOperator() override;
             IPhotoChangeLogOperator& photoChangeLogOperator() override;
             IPeopleInformationAccessor& peopleInformationAccessor() override;
+            IExifFeaturesOperator& exifFeaturesOperator() override;
 
         private:
             // APeopleInformationAccessor interface
@@ -47,18 +58,26 @@ namespace Database
             PersonName person(const Person::Id &) override;
             std::vector<PersonFingerprint> fingerprintsFor(const Person::Id &) override;
             std::map<PersonInfo::Id, PersonFingerprint> fingerprintsFor(const std::vector<PersonInfo::Id>& id) override;
+            std::map<Person::Id, Person::Fingerprint> peopleCentroids() override;
             Person::Id store(const PersonName& pn) override;
             PersonFingerprint::Id store(const PersonFingerprint &) override;
-            void dropPersonInfo(const PersonInfo::Id &) override;
+            bool storeDetectedFaces(const std::map<Photo::Id, std::vector<QRect>> &) override;
+            bool dropPersonInfo(const PersonInfo::Id &) override;
             PersonInfo::Id storePerson(const PersonInfo &) override;
 
             // APhotoChangeLogOperator interface
-            void append(const Photo::Id &, Operation, Field, const QString& data) override;
+            void append(const std::vector<Entry> &) override;
             QStringList dumpChangeLog() override;
 
+            // IExifFeaturesOperator interface
+            bool storeFeatures(const std::map<Photo::Id, ExifFeatures> &) override;
+            std::map<Photo::Id, ExifFeatures> getFeatures(const std::vector<Photo::Id> &) override;
+
             // IGroupOperator interface
             Group::Id addGroup(const Photo::Id& representative_photo, Group::Type) override;
             Photo::Id removeGroup(const Group::Id &) override;
+            std::vector<Group::Id> addGroups(const std::vector<GroupDefinition> &) override;
+            std::vector<Photo::Id> removeGroups(const std::vector<Group::Id> &) override;
             Group::Type type(const Group::Id &) const override;
             std::vector<Photo::Id> membersOf(const Group::Id &) const override;
 
@@ -71,14 +90,34 @@ namespace Database
             //
             typedef std::map<QString, int> Flags;
             typedef std::pair<Photo::Id, Group::Type> GroupData;
-            typedef std::tuple<Photo::Id, Operation, Field, QString> LogEntry;
+            typedef std::set<Photo::Id> PhotosSet;
 
-            static Photo::Id getIdFor(const Photo::Data& d);
             static Person::Id getIdFor(const PersonName& pn);
             static PersonInfo::Id getIdFor(const PersonInfo& pn);
 
             void onPhotos(std::vector<Photo::Data> &, const Action &) const;
 
+            // photos storage
+            void apply(Photo::Data &, const Photo::DataDelta &) const;
+            void index(const Photo::Data &);
+            void unindex(const Photo::Data &);
+            PhotosSet allPhotos() const;
+
+            // filters evaluation
+            PhotosSet evaluate(const Filter &) const;
+            PhotosSet evaluate(const EmptyFilter &) const;
+            PhotosSet evaluate(const GroupFilter &) const;
+            PhotosSet evaluate(const FilterPhotosWithTag &) const;
+            PhotosSet evaluate(const FilterPhotosWithFlags &) const;
+            PhotosSet evaluate(const FilterPhotosWithSha256 &) const;
+            PhotosSet evaluate(const FilterNotMatchingFilter &) const;
+            PhotosSet evaluate(const FilterPhotosWithId &) const;
+            PhotosSet evaluate(const FilterPhotosMatchingExpression &) const;
+            PhotosSet evaluate(const FilterPhotosWithPath &) const;
+            PhotosSet evaluate(const FilterPhotosWithRole &) const;
+            PhotosSet evaluate(const FilterPhotosWithPerson &) const;
+            PhotosSet evaluate(const FilterPhotosWithGeneralFlags &) const;
+
             template<typename T, typename IdT>
             struct IdComparer
             {
@@ -100,17 +139,27 @@ namespace Database
                 using is_transparent = void;
             };
 
+            std::unordered_map<Photo::Id, Photo::Data, Photo::IdHash> m_photos;
             std::map<Photo::Id, Flags> m_flags;
             std::map<Group::Id, GroupData> m_groups;
-            std::set<Photo::Data, IdComparer<Photo::Data, Photo::Id>> m_photos;
             std::set<PersonName, IdComparer<PersonName, Person::Id>> m_peopleNames;
             std::set<PersonInfo, IdComparer<PersonInfo, PersonInfo::Id>> m_peopleInfo;
-            std::vector<LogEntry> m_logEntries;
+            std::map<PersonFingerprint::Id, PersonFingerprint> m_fingerprints;
+            std::vector<Entry> m_logEntries;
+            std::map<Photo::Id, ExifFeatures> m_exifFeatures;
+
+            // secondary indexes
+            std::map<TagTypes, std::map<QString, PhotosSet>> m_tagsIndex;           // raw tag value -> photos
+            std::map<Photo::FlagsE, std::map<int, PhotosSet>> m_flagsIndex;         // flag value -> photos
+            std::map<QString, PhotosSet> m_pathsIndex;
+            std::map<QString, PhotosSet> m_termsIndex;                              // words of paths and tags -> photos
+            std::map<Group::Id, PhotosSet> m_groupMembers;
 
             int m_nextPhotoId = 0;
             int m_nextPersonName = 0;
             int m_nextGroup = 0;
             int m_nextPersonInfo = 0;
+            int m_nextFingerprint = 0;
     };
 }
 
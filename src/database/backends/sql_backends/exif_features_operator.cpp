@@ -0,0 +1,192 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2020  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "exif_features_operator.hpp"
+
+#include <algorithm>
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+#include <core/ilogger.hpp>
+#include <database/ibackend.hpp>
+
+#include "isql_query_executor.hpp"
+#include "tables.hpp"
+
+
+namespace
+{
+    // number of photos read/deleted at once
+    constexpr std::size_t RowsPerQuery = 500;
+
+    template<typename T>
+    QVariant toVariant(const std::optional<T>& value)
+    {
+        return value.has_value()? QVariant(*value): QVariant();
+    }
+
+    template<typename T>
+    std::optional<T> fromVariant(const QVariant& value)
+    {
+        std::optional<T> result;
+
+        if (value.isNull() == false)
+            result = value.value<T>();
+
+        return result;
+    }
+
+    template<typename T>
+    QString idsList(const T& first, const T& last)
+    {
+        QStringList ids;
+
+        for (auto it = first; it != last; ++it)
+            ids.append(QString::number(it->value()));
+
+        return ids.join(", ");
+    }
+}
+
+
+namespace Database
+{
+
+    ExifFeaturesOperator::ExifFeaturesOperator(const QString& connection, ISqlQueryExecutor* executor, ILogger* logger):
+        m_connectionName(connection),
+        m_executor(executor),
+        m_logger(logger)
+    {
+
+    }
+
+
+    bool ExifFeaturesOperator::storeFeatures(const std::map<Photo::Id, ExifFeatures>& features)
+    {
+        if (features.empty())
+            return true;
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        bool status = true;
+
+        try
+        {
+            DB_ERROR_ON_FALSE1(db.transaction());
+
+            std::vector<Photo::Id> ids;
+            ids.reserve(features.size());
+
+            for (const auto& [id, data]: features)
+                ids.push_back(id);
+
+            QSqlQuery query(db);
+
+            // drop current features
+            for (std::size_t i = 0; i < ids.size(); i += RowsPerQuery)
+            {
+                const std::size_t last = std::min(i + RowsPerQuery, ids.size());
+
+                const QString deleteQuery =
+                    QString("DELETE FROM %1 WHERE photo_id IN (%2)")
+                        .arg(TAB_EXIF_FEATURES)
+                        .arg(idsList(ids.begin() + i, ids.begin() + last));
+
+                DB_ERROR_ON_FALSE1(m_executor->exec(deleteQuery, &query));
+            }
+
+            // photos could have been removed in the meantime, skip them
+            DB_ERROR_ON_FALSE1(m_executor->prepare(
+                "INSERT INTO " TAB_EXIF_FEATURES "(photo_id, sequence_number, exposure, orientation, sub_second_time, "
+                                                  "camera_make, camera_model, camera_serial_number, file_size, file_modified) "
+                "SELECT ?, ?, ?, ?, ?, ?, ?, ?, ?, ? FROM " TAB_PHOTOS " WHERE id = ?", &query));
+
+            for (const auto& [id, data]: features)
+            {
+                query.addBindValue(id.value());
+                query.addBindValue(toVariant(data.sequenceNumber));
+                query.addBindValue(toVariant(data.exposure));
+                query.addBindValue(toVariant(data.orientation));
+                query.addBindValue(toVariant(data.subSecondTime));
+                query.addBindValue(data.cameraMake);
+                query.addBindValue(data.cameraModel);
+                query.addBindValue(data.cameraSerialNumber);
+                query.addBindValue(data.fileSize);
+                query.addBindValue(data.fileModified);
+                query.addBindValue(id.value());
+
+                DB_ERROR_ON_FALSE1(m_executor->exec(query));
+            }
+
+            DB_ERROR_ON_FALSE1(db.commit());
+        }
+        catch(const db_error& ex)
+        {
+            db.rollback();
+            status = false;
+
+            m_logger->error(ex.what());
+        }
+
+        return status;
+    }
+
+
+    std::map<Photo::Id, ExifFeatures> ExifFeaturesOperator::getFeatures(const std::vector<Photo::Id>& ids)
+    {
+        std::map<Photo::Id, ExifFeatures> result;
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        for (std::size_t i = 0; i < ids.size(); i += RowsPerQuery)
+        {
+            const std::size_t last = std::min(i + RowsPerQuery, ids.size());
+
+            const QString readQuery =
+                QString("SELECT photo_id, sequence_number, exposure, orientation, sub_second_time, "
+                        "camera_make, camera_model, camera_serial_number, file_size, file_modified "
+                        "FROM %1 WHERE photo_id IN (%2)")
+                    .arg(TAB_EXIF_FEATURES)
+                    .arg(idsList(ids.begin() + i, ids.begin() + last));
+
+            if (m_executor->exec(readQuery, &query) == false)
+                break;
+
+            while (query.next())
+            {
+                const Photo::Id id(query.value(0).toInt());
+
+                ExifFeatures& data = result[id];
+                data.sequenceNumber = fromVariant<int>(query.value(1));
+                data.exposure = fromVariant<float>(query.value(2));
+                data.orientation = fromVariant<int>(query.value(3));
+                data.subSecondTime = fromVariant<int>(query.value(4));
+                data.cameraMake = query.value(5).toString();
+                data.cameraModel = query.value(6).toString();
+                data.cameraSerialNumber = query.value(7).toString();
+                data.fileSize = query.value(8).toLongLong();
+                data.fileModified = query.value(9).toLongLong();
+            }
+        }
+
+        return result;
+    }
+}
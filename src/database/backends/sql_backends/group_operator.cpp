@@ -18,8 +18,12 @@
 
 #include "group_operator.hpp"
 
+#include <map>
+#include <set>
+
 #include <QSqlDatabase>
 #include <QSqlQuery>
+#include <QStringList>
 
 #include <core/ilogger.hpp>
 
@@ -30,6 +34,13 @@
 #include "query_structs.hpp"
 #include "tables.hpp"
 
+namespace
+{
+    // number of rows inserted/deleted at once
+    constexpr std::size_t RowsPerQuery = 500;
+}
+
+
 namespace Database
 {
 
@@ -49,88 +60,195 @@ namespace Database
 
     Group::Id GroupOperator::addGroup(const Photo::Id& id, Group::Type type)
     {
-        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        const std::vector<Group::Id> ids = addGroups( { {id, type, {}} } );
+
+        return ids.empty()? Group::Id(): ids.front();
+    }
 
-        Group::Id grp_id;
 
-        InsertQueryData insertData(TAB_GROUPS);
+    Photo::Id GroupOperator::removeGroup(const Group::Id& gid)
+    {
+        const std::vector<Photo::Id> representatives = removeGroups( {gid} );
+
+        return representatives.empty()? Photo::Id(): representatives.front();
+    }
 
-        insertData.setColumns("id", "representative_id", "type");
-        insertData.setValues(InsertQueryData::Value::Null, id, static_cast<int>(type));
 
-        QSqlQuery query = m_queryGenerator->insert(db, insertData);
+    std::vector<Group::Id> GroupOperator::addGroups(const std::vector<GroupDefinition>& groups)
+    {
+        std::vector<Group::Id> ids;
+
+        if (groups.empty())
+            return ids;
 
-        bool status = m_executor->exec(query);
+        std::set<Photo::Id> modified_photos;
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
 
-        //update id
-        if (status)                                    // Get Id from database after insert
+        try
         {
-            QVariant group_id  = query.lastInsertId();
-            status = group_id.isValid();
+            DB_ERROR_ON_FALSE1(db.transaction());
+
+            // groups need to be inserted one by one to get their ids
+            QSqlQuery query(db);
+            DB_ERROR_ON_FALSE1(m_executor->prepare("INSERT INTO " TAB_GROUPS "(representative_id, type) VALUES(:representative_id, :type)", &query));
+
+            std::vector<Photo::Id> members;
+            QStringList membership;
+
+            for (const GroupDefinition& group: groups)
+            {
+                query.bindValue(":representative_id", group.representative.value());
+                query.bindValue(":type", static_cast<int>(group.type));
+
+                DB_ERROR_ON_FALSE1(m_executor->exec(query));
+
+                const QVariant group_id = query.lastInsertId();
+                DB_ERROR_ON_FALSE1(group_id.isValid());
 
-            if (status)
+                const Group::Id gid(group_id.toInt());
+                ids.push_back(gid);
+
+                m_backend->photoChangeLogOperator().groupCreated(gid, group.type, group.representative, group.members);
+
+                modified_photos.insert(group.representative);
+
+                for (const Photo::Id& member: group.members)
+                {
+                    members.push_back(member);
+                    membership.append(QString("(%1, %2)").arg(gid.value()).arg(member.value()));
+                    modified_photos.insert(member);
+                }
+            }
+
+            // photo can be a member of one group only
+            for (std::size_t i = 0; i < members.size(); i += RowsPerQuery)
             {
-                grp_id = Group::Id(group_id.toInt());
+                const std::size_t last = std::min(i + RowsPerQuery, members.size());
+
+                QStringList photos;
+                for (std::size_t j = i; j < last; j++)
+                    photos.append(QString::number(members[j].value()));
+
+                const QString members_delete =
+                    QString("DELETE FROM %1 WHERE photo_id IN (%2)").arg(TAB_GROUPS_MEMBERS).arg(photos.join(", "));
+
+                const QString members_insert =
+                    QString("INSERT INTO %1(group_id, photo_id) VALUES %2")
+                        .arg(TAB_GROUPS_MEMBERS)
+                        .arg(membership.mid(static_cast<int>(i), static_cast<int>(last - i)).join(", "));
 
-                m_backend->photoChangeLogOperator().groupCreated(grp_id, type, id);
-                emit m_backend->photosModified( {id} );      // photo is now a representative  TODO: I don't like it. notifications about photos should not be raised from groups module
+                DB_ERROR_ON_FALSE1(m_executor->exec(members_delete, &query));
+                DB_ERROR_ON_FALSE1(m_executor->exec(members_insert, &query));
             }
+
+            m_backend->photoChangeLogOperator().flush();
+
+            DB_ERROR_ON_FALSE1(db.commit());
+
+            // TODO: I don't like it. notifications about photos should not be raised from groups module
+            emit m_backend->photosModified(modified_photos);
+        }
+        catch(const db_error& ex)
+        {
+            m_backend->photoChangeLogOperator().discard();
+            db.rollback();
+            ids.clear();
+
+            m_logger->error(ex.what());
         }
 
-        return grp_id;
+        return ids;
     }
 
 
-    Photo::Id GroupOperator::removeGroup(const Group::Id& gid)
+    std::vector<Photo::Id> GroupOperator::removeGroups(const std::vector<Group::Id>& groups)
     {
-        Photo::Id representativePhoto;
+        std::vector<Photo::Id> representatives;
+
+        if (groups.empty())
+            return representatives;
+
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
 
         try
         {
-            const QString query_str =
-                QString("SELECT representative_id FROM %1 WHERE id=%2").arg(TAB_GROUPS).arg(gid);
+            DB_ERROR_ON_FALSE1(db.transaction());
+
+            QStringList ids;
+            for (const Group::Id& gid: groups)
+                ids.append(QString::number(gid.value()));
+
+            const QString idsList = ids.join(", ");
 
             QSqlQuery query(db);
-            DB_ERROR_ON_FALSE1(m_executor->exec(query_str, &query));
-            DB_ERROR_ON_FALSE1(query.next());
 
-            const Photo::Id ph_id( query.value(0).toInt() );
+            // collect representatives and members
+            std::map<Group::Id, Photo::Id> representativeOf;
+            std::map<Group::Id, std::vector<Photo::Id>> members;
+            std::set<Photo::Id> modified_photos;
 
-            const std::vector<Photo::Id> members = membersOf(gid);
-            std::set<Photo::Id> modified_photos(members.cbegin(), members.cend());
+            const QString representatives_list =
+                QString("SELECT id, representative_id FROM %1 WHERE id IN (%2)").arg(TAB_GROUPS).arg(idsList);
 
-            // add representative to modified_photos
-            // as it won't be part of the group anymore
-            modified_photos.insert(ph_id);
+            DB_ERROR_ON_FALSE1(m_executor->exec(representatives_list, &query));
 
-            DB_ERROR_ON_FALSE1(db.transaction());
+            while(query.next())
+            {
+                const Group::Id gid(query.value(0).toInt());
+                const Photo::Id ph_id(query.value(1).toInt());
+
+                representativeOf[gid] = ph_id;
+                modified_photos.insert(ph_id);
+            }
+
+            const QString members_list =
+                QString("SELECT group_id, photo_id FROM %1 WHERE group_id IN (%2)").arg(TAB_GROUPS_MEMBERS).arg(idsList);
+
+            DB_ERROR_ON_FALSE1(m_executor->exec(members_list, &query));
 
-            const QString members_delete =
-                QString("DELETE FROM %1 WHERE group_id=%2").arg(TAB_GROUPS_MEMBERS).arg(gid);
+            while(query.next())
+            {
+                const Group::Id gid(query.value(0).toInt());
+                const Photo::Id ph_id(query.value(1).toInt());
+
+                members[gid].push_back(ph_id);
+                modified_photos.insert(ph_id);
+            }
+
+            // members are removed by foreign key
+            const QString groups_delete =
+                QString("DELETE FROM %1 WHERE id IN (%2)").arg(TAB_GROUPS).arg(idsList);
 
-            const QString group_delete =
-                QString("DELETE FROM %1 WHERE id=%2").arg(TAB_GROUPS).arg(gid);
+            DB_ERROR_ON_FALSE1(m_executor->exec(groups_delete, &query));
 
-            DB_ERROR_ON_FALSE1(m_executor->exec(members_delete, &query));
-            DB_ERROR_ON_FALSE1(m_executor->exec(group_delete, &query));
+            for (const auto& [gid, ph_id]: representativeOf)
+                m_backend->photoChangeLogOperator().groupDeleted(gid, ph_id, members[gid]);
+
+            m_backend->photoChangeLogOperator().flush();
 
             DB_ERROR_ON_FALSE1(db.commit());
 
             // TODO: I don't like it. notifications about photos should not be raised from groups module
-            m_backend->photoChangeLogOperator().groupDeleted(gid, ph_id, members);
             emit m_backend->photosModified(modified_photos);
 
-            representativePhoto = ph_id;
+            representatives.reserve(groups.size());
+
+            for (const Group::Id& gid: groups)
+            {
+                auto it = representativeOf.find(gid);
+                representatives.push_back(it == representativeOf.end()? Photo::Id(): it->second);
+            }
         }
         catch(const db_error& ex)
         {
+            m_backend->photoChangeLogOperator().discard();
             db.rollback();
+            representatives.clear();
 
             m_logger->error(ex.what());
         }
 
-        return representativePhoto;
+        return representatives;
     }
 
 
@@ -39,6 +39,8 @@ namespace Database
 
             Group::Id addGroup(const Photo::Id &, Group::Type) override;
             Photo::Id removeGroup(const Group::Id &) override;
+            std::vector<Group::Id> addGroups(const std::vector<GroupDefinition> &) override;
+            std::vector<Photo::Id> removeGroups(const std::vector<Group::Id> &) override;
             Group::Type type(const Group::Id &) const override;
             std::vector<Photo::Id> membersOf(const Group::Id &) const override;
 
@@ -18,24 +18,80 @@
 
 #include "people_information_accessor.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 #include <QRegularExpression>
+#include <QtEndian>
 #include <QSqlDatabase>
 #include <QSqlDriver>
 #include <QSqlQuery>
 
+#include <core/containers_utils.hpp>
+#include <core/ilogger.hpp>
+#include <database/general_flags.hpp>
+#include <database/ibackend.hpp>
+
 #include "isql_query_executor.hpp"
 #include "isql_query_constructor.hpp"
 #include "tables.hpp"
+#include "transaction.hpp"
 #include "query_structs.hpp"
 
+
+namespace
+{
+    // number of photos read/deleted at once
+    constexpr std::size_t RowsPerQuery = 500;
+
+    QString encodeLocation(const QRect& face)
+    {
+        return face.isEmpty()?
+            QString():
+            QString("%1,%2 %3x%4")
+                .arg(face.x())
+                .arg(face.y())
+                .arg(face.width())
+                .arg(face.height());
+    }
+
+    QRect decodeLocation(const QString& location)
+    {
+        const QStringList location_list = location.split(QRegularExpression("[ ,x]"));
+
+        return location_list.size() == 4?
+            QRect(location_list[0].toInt(),
+                  location_list[1].toInt(),
+                  location_list[2].toInt(),
+                  location_list[3].toInt()):
+            QRect();
+    }
+
+    template<typename T>
+    QString idsList(const T& first, const T& last)
+    {
+        QStringList ids;
+
+        for (auto it = first; it != last; ++it)
+            ids.append(QString::number(it->value()));
+
+        return ids.join(", ");
+    }
+}
+
+
 namespace Database
 {
     PeopleInformationAccessor::PeopleInformationAccessor(const QString& connectionName,
                                                          Database::ISqlQueryExecutor& queryExecutor,
-                                                         const IGenericSqlQueryGenerator& query_generator)
+                                                         NestedTransaction& transaction,
+                                                         const IGenericSqlQueryGenerator& query_generator,
+                                                         ILogger* logger)
         : m_connectionName(connectionName)
         , m_executor(queryExecutor)
+        , m_transaction(transaction)
         , m_query_generator(query_generator)
+        , m_logger(logger)
         , m_dbHasSizeFeature(false)
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
@@ -105,14 +161,7 @@ namespace Database
                 QRect location;
 
                 if (query.isNull(2) == false)
-                {
-                    const QVariant location_raw = query.value(2);
-                    const QStringList location_list = location_raw.toString().split(QRegularExpression("[ ,x]"));
-                    location = QRect(location_list[0].toInt(),
-                                     location_list[1].toInt(),
-                                     location_list[2].toInt(),
-                                     location_list[3].toInt());
-                }
+                    location = decodeLocation(query.value(2).toString());
 
                 result.emplace_back(id, pid, ph_id, f_id, location);
             }
@@ -166,14 +215,7 @@ namespace Database
         while(query.next())
         {
             const PersonFingerprint::Id fid(query.value(0).toInt());
-            const QByteArray raw_fingerprint = query.value(1).toByteArray();
-            const QList<QByteArray> splitted = raw_fingerprint.split(' ');
-
-            Person::Fingerprint fingerprint;
-            fingerprint.reserve(splitted.size());
-
-            for(const QByteArray& component: splitted)
-                fingerprint.push_back(component.toDouble());
+            const Person::Fingerprint fingerprint = decodeFingerprint(query.value(1).toByteArray());
 
             result.emplace_back(fid, fingerprint);
         }
@@ -203,14 +245,7 @@ namespace Database
         {
             const PersonInfo::Id id(query.value(0).toInt());
             const PersonFingerprint::Id fid(query.value(1).toInt());
-            const QByteArray raw_fingerprint = query.value(2).toByteArray();
-            const QList<QByteArray> splitted = raw_fingerprint.split(' ');
-
-            Person::Fingerprint fingerprint;
-            fingerprint.reserve(splitted.size());
-
-            for(const QByteArray& component: splitted)
-                fingerprint.push_back(component.toDouble());
+            const Person::Fingerprint fingerprint = decodeFingerprint(query.value(2).toByteArray());
 
             result.emplace(id, PersonFingerprint(fid, fingerprint));
         }
@@ -219,6 +254,26 @@ namespace Database
     }
 
 
+    std::map<Person::Id, Person::Fingerprint> PeopleInformationAccessor::peopleCentroids()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        std::map<Person::Id, Person::Fingerprint> result;
+
+        if (m_executor.exec("SELECT person_id, fingerprint FROM " TAB_PEOPLE_CENTROIDS, &query))
+            while(query.next())
+            {
+                const Person::Id id(query.value(0).toInt());
+                const Person::Fingerprint centroid = decodeFingerprint(query.value(1).toByteArray());
+
+                result.emplace(id, centroid);
+            }
+
+        return result;
+    }
+
+
     Person::Id PeopleInformationAccessor::store(const PersonName& d)
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
@@ -268,71 +323,252 @@ namespace Database
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
 
-        QStringList fingerprint_list;
-        for(double b: fingerprint.fingerprint())
-            fingerprint_list.append(QString::number(b));
-
-        const QString fingerprint_raw = fingerprint_list.join(" ");
+        const QByteArray fingerprint_raw = encodeFingerprint(fingerprint.fingerprint());
 
         PersonFingerprint::Id fid = fingerprint.id();
 
-        if (fid.valid())
+        Transaction transaction(m_transaction);
+
+        try
         {
-            if (fingerprint.fingerprint().empty())
+            DB_ERROR_ON_FALSE1(transaction.begin());
+
+            // people using modified fingerprint need their centroids to be updated
+            const std::set<Person::Id> affected = fid.valid()?
+                                                      peopleWith(QString("fingerprint_id = %1").arg(fid)):
+                                                      std::set<Person::Id>();
+
+            if (fid.valid())
             {
-                const QString delete_query = QString ("DELETE from %1 WHERE id = %2")
-                                                .arg(TAB_FACES_FINGERPRINTS)
-                                                .arg(fid);
+                if (fingerprint.fingerprint().empty())
+                {
+                    const QString delete_query = QString ("DELETE from %1 WHERE id = %2")
+                                                    .arg(TAB_FACES_FINGERPRINTS)
+                                                    .arg(fid);
 
-                QSqlQuery query(db);
-                m_executor.exec(delete_query, &query);
+                    QSqlQuery query(db);
+                    DB_ERROR_ON_FALSE1(m_executor.exec(delete_query, &query));
+                }
+                else
+                {
+                    UpdateQueryData updateData(TAB_FACES_FINGERPRINTS);
+                    updateData.addColumn("fingerprint");
+                    updateData.addValue(fingerprint_raw);
+                    updateData.addCondition("id", QString::number(fid));
+
+                    QSqlQuery query(db);
+                    query = m_query_generator.update(db, updateData);
+
+                    DB_ERROR_ON_FALSE1(m_executor.exec(query));
+                }
             }
             else
             {
-                UpdateQueryData updateData(TAB_FACES_FINGERPRINTS);
-                updateData.addColumn("fingerprint");
-                updateData.addValue(fingerprint_raw);
-                updateData.addCondition("id", QString::number(fid));
+                InsertQueryData insertData(TAB_FACES_FINGERPRINTS);
+                insertData.addColumn("fingerprint");
+                insertData.addValue(fingerprint_raw);
 
                 QSqlQuery query(db);
-                query = m_query_generator.update(db, updateData);
+                query = m_query_generator.insert(db, insertData);
 
-                m_executor.exec(query);
+                DB_ERROR_ON_FALSE1(m_executor.exec(query));
+                fid = PersonFingerprint::Id(query.lastInsertId().toInt());
             }
+
+            DB_ERROR_ON_FALSE1(updateCentroids(affected));
+            DB_ERROR_ON_FALSE1(transaction.commit());
         }
-        else
+        catch(const db_error &)
         {
-            InsertQueryData insertData(TAB_FACES_FINGERPRINTS);
-            insertData.addColumn("fingerprint");
-            insertData.addValue(fingerprint_raw);
+            fid = PersonFingerprint::Id();
+        }
+
+        return fid;
+    }
+
+
+    bool PeopleInformationAccessor::storeDetectedFaces(const std::map<Photo::Id, std::vector<QRect>>& faces)
+    {
+        if (faces.empty())
+            return true;
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        bool status = true;
+
+        Transaction transaction(m_transaction);
+
+        try
+        {
+            DB_ERROR_ON_FALSE1(transaction.begin());
+
+            std::vector<Photo::Id> ids;
+            ids.reserve(faces.size());
+
+            for (const auto& [id, locations]: faces)
+                ids.push_back(id);
 
             QSqlQuery query(db);
-            query = m_query_generator.insert(db, insertData);
 
-            m_executor.exec(query);
-            fid = PersonFingerprint::Id(query.lastInsertId().toInt());
+            // collect locations already known, so they are not duplicated
+            std::map<Photo::Id, std::vector<QRect>> existing;
+
+            for (std::size_t i = 0; i < ids.size(); i += RowsPerQuery)
+            {
+                const std::size_t last = std::min(i + RowsPerQuery, ids.size());
+                const QString idsStr = idsList(ids.begin() + i, ids.begin() + last);
+
+                const QString readQuery =
+                    QString("SELECT photo_id, location FROM %1 WHERE photo_id IN (%2)")
+                        .arg(TAB_PEOPLE)
+                        .arg(idsStr);
+
+                DB_ERROR_ON_FALSE1(m_executor.exec(readQuery, &query));
+
+                while (query.next())
+                    if (query.isNull(1) == false)
+                        existing[Photo::Id(query.value(0).toInt())].push_back(decodeLocation(query.value(1).toString()));
+
+                const QString flagsDelete =
+                    QString("DELETE FROM %1 WHERE name = '%2' AND photo_id IN (%3)")
+                        .arg(TAB_GENERAL_FLAGS)
+                        .arg(CommonGeneralFlags::FacesAnalysed)
+                        .arg(idsStr);
+
+                DB_ERROR_ON_FALSE1(m_executor.exec(flagsDelete, &query));
+            }
+
+            // photos could have been removed in the meantime, skip them
+            DB_ERROR_ON_FALSE1(m_executor.prepare(
+                "INSERT INTO " TAB_PEOPLE "(photo_id, location) "
+                "SELECT ?, ? FROM " TAB_PHOTOS " WHERE id = ?", &query));
+
+            for (const auto& [id, locations]: faces)
+            {
+                const std::vector<QRect>& known = existing[id];
+
+                for (const QRect& location: locations)
+                {
+                    const bool exists = std::any_of(known.cbegin(), known.cend(), [location](const QRect& rect)
+                    {
+                        return rect.intersects(location);
+                    });
+
+                    if (exists)
+                        continue;
+
+                    query.addBindValue(id.value());
+                    query.addBindValue(encodeLocation(location));
+                    query.addBindValue(id.value());
+
+                    DB_ERROR_ON_FALSE1(m_executor.exec(query));
+                }
+            }
+
+            DB_ERROR_ON_FALSE1(m_executor.prepare(
+                "INSERT INTO " TAB_GENERAL_FLAGS "(photo_id, name, value) "
+                "SELECT ?, ?, 1 FROM " TAB_PHOTOS " WHERE id = ?", &query));
+
+            for (const Photo::Id& id: ids)
+            {
+                query.addBindValue(id.value());
+                query.addBindValue(CommonGeneralFlags::FacesAnalysed);
+                query.addBindValue(id.value());
+
+                DB_ERROR_ON_FALSE1(m_executor.exec(query));
+            }
+
+            DB_ERROR_ON_FALSE1(transaction.commit());
         }
+        catch(const db_error& error)
+        {
+            m_logger->error(QString("Could not store faces detected on %1 photos: %2")
+                                .arg(faces.size())
+                                .arg(error.what()));
 
-        return fid;
+            status = false;
+        }
+
+        return status;
+    }
+
+
+    QByteArray PeopleInformationAccessor::encodeFingerprint(const Person::Fingerprint& fingerprint)
+    {
+        QByteArray raw(static_cast<int>(fingerprint.size() * sizeof(float)), Qt::Uninitialized);
+        char* data = raw.data();
+
+        for(double component: fingerprint)
+        {
+            const float value = static_cast<float>(component);
+
+            quint32 bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            qToLittleEndian(bits, data);
+
+            data += sizeof(bits);
+        }
+
+        return raw;
+    }
+
+
+    Person::Fingerprint PeopleInformationAccessor::decodeFingerprint(const QByteArray& raw)
+    {
+        const std::size_t components = static_cast<std::size_t>(raw.size()) / sizeof(float);
+        const char* data = raw.constData();
+
+        Person::Fingerprint fingerprint;
+        fingerprint.reserve(components);
+
+        for(std::size_t i = 0; i < components; i++)
+        {
+            const quint32 bits = qFromLittleEndian<quint32>(data);
+
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            fingerprint.push_back(value);
+
+            data += sizeof(bits);
+        }
+
+        return fingerprint;
     }
 
 
     /**
      * \brief drop person details from database
      * \param id if of person to be dropped
-     *
-     * \todo no reaction on error
+     * \return false on error
      */
-    void PeopleInformationAccessor::dropPersonInfo(const PersonInfo::Id& id)
+    bool PeopleInformationAccessor::dropPersonInfo(const PersonInfo::Id& id)
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
 
-        const QString query = QString("DELETE FROM %1 WHERE id=%2")
-                                .arg(TAB_PEOPLE)
-                                .arg(id);
+        Transaction transaction(m_transaction);
+        bool status = true;
+
+        try
+        {
+            DB_ERROR_ON_FALSE1(transaction.begin());
+
+            const std::set<Person::Id> affected = peopleWith(QString("id = %1").arg(id));
+
+            const QString query = QString("DELETE FROM %1 WHERE id=%2")
+                                    .arg(TAB_PEOPLE)
+                                    .arg(id);
+
+            QSqlQuery q(db);
+            DB_ERROR_ON_FALSE1(m_executor.exec(query, &q));
+
+            DB_ERROR_ON_FALSE1(updateCentroids(affected));
+            DB_ERROR_ON_FALSE1(transaction.commit());
+        }
+        catch(const db_error &)
+        {
+            status = false;
+        }
 
-        QSqlQuery q(db);
-        m_executor.exec(query, &q);
+        return status;
     }
 
 
@@ -354,14 +590,7 @@ namespace Database
         queryData.setColumns("photo_id");
         queryData.setValues(fd.ph_id);
 
-        const QRect& face = fd.rect;
-        const QString face_coords = face.isEmpty()?
-                                        QString():
-                                        QString("%1,%2 %3x%4")
-                                            .arg(face.x())
-                                            .arg(face.y())
-                                            .arg(face.width())
-                                            .arg(face.height());
+        const QString face_coords = encodeLocation(fd.rect);
 
         queryData.addColumn("location");
         queryData.addValue(face_coords);
@@ -380,25 +609,47 @@ namespace Database
         queryData.addColumn("fingerprint_id");
         queryData.addValue(fingerprint_id);
 
-        QSqlQuery query;
+        Transaction transaction(m_transaction);
 
-        if (id.valid())
-        {
-            UpdateQueryData updateQueryData(queryData);
-            updateQueryData.addCondition("id", QString::number(id));
-            query = m_query_generator.update(db, updateQueryData);
-        }
-        else
+        try
         {
-            query = m_query_generator.insert(db, queryData);
-        }
+            DB_ERROR_ON_FALSE1(transaction.begin());
+
+            // previous and new person need their centroids to be updated
+            std::set<Person::Id> affected = id.valid()?
+                                                peopleWith(QString("id = %1").arg(id)):
+                                                std::set<Person::Id>();
+
+            if (fd.p_id.valid())
+                affected.insert(fd.p_id);
 
-        const bool status = m_executor.exec(query);
+            QSqlQuery query;
 
-        if (status && id.valid() == false)
+            if (id.valid())
+            {
+                UpdateQueryData updateQueryData(queryData);
+                updateQueryData.addCondition("id", QString::number(id));
+                query = m_query_generator.update(db, updateQueryData);
+            }
+            else
+            {
+                query = m_query_generator.insert(db, queryData);
+            }
+
+            DB_ERROR_ON_FALSE1(m_executor.exec(query));
+
+            if (id.valid() == false)
+            {
+                const QVariant vid  = query.lastInsertId();
+                id = vid.toInt();
+            }
+
+            DB_ERROR_ON_FALSE1(updateCentroids(affected));
+            DB_ERROR_ON_FALSE1(transaction.commit());
+        }
+        catch(const db_error &)
         {
-            const QVariant vid  = query.lastInsertId();
-            id = vid.toInt();
+            id = PersonInfo::Id();
         }
 
         return id;
@@ -434,4 +685,99 @@ namespace Database
         return result;
     }
 
+
+    /**
+     * \brief get people assigned to rows of people table matching condition
+     */
+    std::set<Person::Id> PeopleInformationAccessor::peopleWith(const QString& condition) const
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString s = QString("SELECT DISTINCT person_id FROM %1 WHERE person_id IS NOT NULL AND %2")
+                            .arg(TAB_PEOPLE)
+                            .arg(condition);
+
+        std::set<Person::Id> result;
+
+        if (m_executor.exec(s, &query))
+            while(query.next())
+                result.insert(Person::Id(query.value(0).toInt()));
+
+        return result;
+    }
+
+
+    /**
+     * \brief calculate average fingerprints of people
+     * \param condition condition for rows of people table to be used
+     * \return centroid of each person with at least one fingerprint
+     */
+    std::map<Person::Id, Person::Fingerprint> PeopleInformationAccessor::calculateCentroids(const QString& condition) const
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString s = QString("SELECT %1.person_id, %2.fingerprint FROM %1 JOIN %2 ON %2.id = %1.fingerprint_id "
+                                  "WHERE %1.person_id IS NOT NULL AND %3")
+                            .arg(TAB_PEOPLE)
+                            .arg(TAB_FACES_FINGERPRINTS)
+                            .arg(condition);
+
+        std::map<Person::Id, std::pair<Person::Fingerprint, int>> sums;
+
+        if (m_executor.exec(s, &query))
+            while(query.next())
+            {
+                auto& [sum, count] = sums[Person::Id(query.value(0).toInt())];
+
+                sum += decodeFingerprint(query.value(1).toByteArray());
+                count++;
+            }
+
+        std::map<Person::Id, Person::Fingerprint> result;
+
+        for (const auto& [id, sum]: sums)
+            result.emplace(id, sum.first / sum.second);
+
+        return result;
+    }
+
+
+    /**
+     * \brief recalculate stored centroids of given people
+     * \return false on error
+     */
+    bool PeopleInformationAccessor::updateCentroids(const std::set<Person::Id>& people)
+    {
+        if (people.empty())
+            return true;
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString ids = idsList(people.begin(), people.end());
+        const auto centroids = calculateCentroids(QString("%1.person_id IN (%2)").arg(TAB_PEOPLE).arg(ids));
+
+        const QString deleteQuery = QString("DELETE FROM %1 WHERE person_id IN (%2)")
+                                        .arg(TAB_PEOPLE_CENTROIDS)
+                                        .arg(ids);
+
+        bool status = m_executor.exec(deleteQuery, &query);
+
+        if (status && centroids.empty() == false)
+        {
+            status = m_executor.prepare("INSERT INTO " TAB_PEOPLE_CENTROIDS "(person_id, fingerprint) VALUES(?, ?)", &query);
+
+            for (auto it = centroids.cbegin(); status && it != centroids.cend(); ++it)
+            {
+                query.addBindValue(it->first.value());
+                query.addBindValue(encodeFingerprint(it->second));
+
+                status = m_executor.exec(query);
+            }
+        }
+
+        return status;
+    }
 }
@@ -18,10 +18,16 @@
 #ifndef PEOPLE_INFORMATION_ACCESSOR_HPP
 #define PEOPLE_INFORMATION_ACCESSOR_HPP
 
+#include <set>
 #include <vector>
 
+#include <QByteArray>
+
 #include "database/apeople_information_accessor.hpp"
 
+class NestedTransaction;
+struct ILogger;
+
 namespace Database
 {
     struct ISqlQueryExecutor;
@@ -30,25 +36,38 @@ namespace Database
     class PeopleInformationAccessor: public APeopleInformationAccessor
     {
         public:
-            PeopleInformationAccessor(const QString &, Database::ISqlQueryExecutor &, const IGenericSqlQueryGenerator &);
+            PeopleInformationAccessor(const QString &, Database::ISqlQueryExecutor &, NestedTransaction &, const IGenericSqlQueryGenerator &, ILogger *);
 
             std::vector<PersonName>  listPeople() override final;
             std::vector<PersonInfo>  listPeople(const Photo::Id &) override final;
             PersonName               person(const Person::Id &) override final;
             std::vector<PersonFingerprint> fingerprintsFor(const Person::Id &) override;
             std::map<PersonInfo::Id, PersonFingerprint> fingerprintsFor(const std::vector<PersonInfo::Id>& id) override;
+            std::map<Person::Id, Person::Fingerprint> peopleCentroids() override;
             Person::Id               store(const PersonName &) override final;
             PersonFingerprint::Id    store(const PersonFingerprint &) override;
+            bool                     storeDetectedFaces(const std::map<Photo::Id, std::vector<QRect>> &) override;
+
+            // fingerprints are stored as little endian float32 components
+            static QByteArray encodeFingerprint(const Person::Fingerprint &);
+            static Person::Fingerprint decodeFingerprint(const QByteArray &);
+
+            // recalculate stored centroids of given people. To be called within transaction modifying people
+            bool updateCentroids(const std::set<Person::Id> &);
 
         private:
             const QString m_connectionName;
             Database::ISqlQueryExecutor& m_executor;
+            NestedTransaction& m_transaction;
             const IGenericSqlQueryGenerator& m_query_generator;
+            ILogger* m_logger;
             bool m_dbHasSizeFeature;
 
-            void dropPersonInfo(const PersonInfo::Id &) override;
+            bool dropPersonInfo(const PersonInfo::Id &) override;
             PersonInfo::Id storePerson(const PersonInfo &) override;
             PersonName person(const QString &) const;
+            std::set<Person::Id> peopleWith(const QString& condition) const;
+            std::map<Person::Id, Person::Fingerprint> calculateCentroids(const QString& condition) const;
     };
 }
 
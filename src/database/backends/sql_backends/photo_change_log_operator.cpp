@@ -20,6 +20,7 @@
 
 #include <QSqlDatabase>
 #include <QSqlQuery>
+#include <QStringList>
 
 #include "database/ibackend.hpp"
 #include "query_structs.hpp"
@@ -28,6 +29,14 @@
 #include "isql_query_executor.hpp"
 
 
+namespace
+{
+    // number of change log entries inserted at once (6 bound values each, date is CURRENT_TIMESTAMP).
+    // 100 * 6 stays below SQLite's default limit of 999 bound variables per query.
+    constexpr std::size_t RowsPerQuery = 100;
+}
+
+
 namespace Database
 {
     PhotoChangeLogOperator::PhotoChangeLogOperator(const QString& name,
@@ -54,7 +63,7 @@ namespace Database
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
 
-        const QString queryStr = QString("SELECT photo_id, operation, field, data FROM %1").arg(TAB_PHOTOS_CHANGE_LOG);
+        const QString queryStr = QString("SELECT photo_id, operation, field, tag_type, old_value, new_value FROM %1 ORDER BY id").arg(TAB_PHOTOS_CHANGE_LOG);
         QSqlQuery query(queryStr, db);
 
         m_executor->exec(query);
@@ -62,17 +71,15 @@ namespace Database
         QStringList results;
         while(query.next())
         {
-            const QVariant photoIdVar = query.value("photo_id");
-            const QVariant operationVar = query.value("operation");
-            const QVariant fieldVar = query.value("field");
-            const QVariant dataVar = query.value("data");
-
-            const int photoId = photoIdVar.toInt();
-            const Operation operation = static_cast<Operation>(operationVar.toInt());
-            const Field field = static_cast<Field>(fieldVar.toInt());
-            const QString data = dataVar.toString();
+            Entry entry;
+            entry.photoId = Photo::Id(query.value("photo_id").toInt());
+            entry.operation = static_cast<Operation>(query.value("operation").toInt());
+            entry.field = static_cast<Field>(query.value("field").toInt());
+            entry.tagType = static_cast<TagTypes>(query.value("tag_type").toInt());
+            entry.oldValue = query.value("old_value").toString();
+            entry.newValue = query.value("new_value").toString();
 
-            const QString result = format(photoId, operation, field, data);
+            const QString result = format(entry);
 
             results.append(result);
         }
@@ -81,24 +88,48 @@ namespace Database
     }
 
 
-    void PhotoChangeLogOperator::append(const Photo::Id& ph_id, PhotoChangeLogOperator::Operation op, PhotoChangeLogOperator::Field field, const QString& data)
+    void PhotoChangeLogOperator::append(const std::vector<Entry>& entries)
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
 
-        InsertQueryData insertData(TAB_PHOTOS_CHANGE_LOG);
+        int preparedRows = 0;
 
-        insertData.setColumns("id", "photo_id", "operation", "field", "data", "date");
-        insertData.setValues(InsertQueryData::Value::Null,
-                             ph_id,
-                             static_cast<int>(op),
-                             static_cast<int>(field),
-                             data,
-                             InsertQueryData::Value::CurrentTime
-                            );
-
-        QSqlQuery query = m_queryGenerator->insert(db, insertData);
-
-        DB_ERROR_ON_FALSE1(m_executor->exec(query));
+        for (std::size_t i = 0; i < entries.size(); i += RowsPerQuery)
+        {
+            const std::size_t last = std::min(i + RowsPerQuery, entries.size());
+            const int rows = static_cast<int>(last - i);
+
+            // prepare query only when number of rows changes (last chunk)
+            if (rows != preparedRows)
+            {
+                QStringList values;
+                for (int r = 0; r < rows; r++)
+                    values.append("(?, ?, ?, ?, ?, ?, CURRENT_TIMESTAMP)");
+
+                const QString queryStr =
+                    QString("INSERT INTO %1(photo_id, operation, field, tag_type, old_value, new_value, date) VALUES %2")
+                        .arg(TAB_PHOTOS_CHANGE_LOG)
+                        .arg(values.join(", "));
+
+                DB_ERROR_ON_FALSE1(m_executor->prepare(queryStr, &query));
+                preparedRows = rows;
+            }
+
+            for (std::size_t j = i; j < last; j++)
+            {
+                const Entry& entry = entries[j];
+
+                query.addBindValue(entry.photoId.value());
+                query.addBindValue(static_cast<int>(entry.operation));
+                query.addBindValue(static_cast<int>(entry.field));
+                query.addBindValue(entry.field == Tags? QVariant(static_cast<int>(entry.tagType)): QVariant());
+                query.addBindValue(entry.oldValue.isNull()? QVariant(): QVariant(entry.oldValue));
+                query.addBindValue(entry.newValue.isNull()? QVariant(): QVariant(entry.newValue));
+            }
+
+            DB_ERROR_ON_FALSE1(m_executor->exec(query));
+        }
     }
 
 }
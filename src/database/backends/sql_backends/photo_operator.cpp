@@ -18,34 +18,26 @@
 
 #include "photo_operator.hpp"
 
+#include <set>
+
 #include <QSqlDatabase>
 #include <QSqlQuery>
 
+#include <core/base_tags.hpp>
 #include <core/ilogger.hpp>
 #include <database/ibackend.hpp>
 
 #include "isql_query_executor.hpp"
+#include "people_information_accessor.hpp"
 #include "sql_filter_query_generator.hpp"
 #include "tables.hpp"
+#include "transaction.hpp"
 
 
 namespace Database
 {
 
     namespace {
-        std::map<const char *, const char *> tables_to_clear =
-        {
-            { TAB_FLAGS,          "photo_id" },
-            { TAB_GENERAL_FLAGS,  "photo_id" },
-            { TAB_GEOMETRY,       "photo_id" },
-            { TAB_GROUPS_MEMBERS, "photo_id" },
-            { TAB_PEOPLE,         "photo_id" },
-            { TAB_SHA256SUMS,     "photo_id" },
-            { TAB_TAGS,           "photo_id" },
-            { TAB_THUMBS,         "photo_id" },
-            { TAB_PHOTOS,         "id"       }
-        };
-
         std::map<TagTypes, const char *> namesForJoins =
         {
             { TagTypes::Event,    "event_tag"    },
@@ -57,9 +49,16 @@ namespace Database
         };
     }
 
-    PhotoOperator::PhotoOperator(const QString& connection, ISqlQueryExecutor* executor, ILogger* logger, IBackend* backend):
+    PhotoOperator::PhotoOperator(const QString& connection,
+                                 ISqlQueryExecutor* executor,
+                                 NestedTransaction* transaction,
+                                 PeopleInformationAccessor* peopleAccessor,
+                                 ILogger* logger,
+                                 IBackend* backend):
         m_connectionName(connection),
         m_executor(executor),
+        m_transaction(transaction),
+        m_peopleAccessor(peopleAccessor),
         m_logger(logger),
         m_backend(backend)
     {
@@ -83,49 +82,108 @@ namespace Database
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
         QSqlQuery query(db);
 
-        //collect ids of photos to be dropped
+        Transaction transaction(*m_transaction);
+
         std::vector<Photo::Id> ids;
-        bool status = m_executor->exec(filterQuery, &query);
+        std::set<Photo::Id> ungrouped;
+        TagValuesCounts removedTagValues;
+        bool status = true;
 
-        if (status)
+        try
         {
+            DB_ERROR_ON_FALSE1(transaction.begin());
+
+            //collect ids of photos to be dropped
+            DB_ERROR_ON_FALSE1(m_executor->exec(filterQuery, &query));
+
             while(query.next())
             {
                 const Photo::Id id(query.value(0).toUInt());
 
                 ids.push_back(id);
             }
-        }
 
-        //from filtered photos, get info about tags used there
-        std::vector<QString> queries =
-        {
-            QString("CREATE TEMPORARY TABLE drop_indices AS %1").arg(filterQuery),
-            QString("DELETE FROM " TAB_FLAGS             " WHERE photo_id IN (SELECT * FROM drop_indices)"),
-            QString("DELETE FROM " TAB_GENERAL_FLAGS     " WHERE photo_id IN (SELECT * FROM drop_indices)"),
-            QString("DELETE FROM " TAB_GEOMETRY          " WHERE photo_id IN (SELECT * FROM drop_indices)"),
-            // There should be no data in groups and group members TODO: check + remove group if not true
-            QString("DELETE FROM " TAB_PEOPLE            " WHERE photo_id IN (SELECT * FROM drop_indices)"),
-            QString("DELETE FROM " TAB_PHOTOS_CHANGE_LOG " WHERE photo_id IN (SELECT * FROM drop_indices)"),
-            QString("DELETE FROM " TAB_SHA256SUMS        " WHERE photo_id IN (SELECT * FROM drop_indices)"),
-            QString("DELETE FROM " TAB_TAGS              " WHERE photo_id IN (SELECT * FROM drop_indices)"),
-            QString("DELETE FROM " TAB_THUMBS            " WHERE photo_id IN (SELECT * FROM drop_indices)"),
-
-            QString("DELETE FROM " TAB_PHOTOS            " WHERE id IN (SELECT * FROM drop_indices)"),
-            QString("DROP TABLE drop_indices")
-        };
+            // members of groups with removed representatives will lose their groups
+            const QString membersQuery =
+                QString("SELECT %2.photo_id FROM %2 JOIN %1 ON (%1.id = %2.group_id) "
+                        "WHERE %1.representative_id IN (%3) AND %2.photo_id NOT IN (%3)")
+                    .arg(TAB_GROUPS)
+                    .arg(TAB_GROUPS_MEMBERS)
+                    .arg(filterQuery);
 
-        status = db.transaction();
+            DB_ERROR_ON_FALSE1(m_executor->exec(membersQuery, &query));
 
-        if (status)
-            status = m_executor->exec(queries, &query);
+            while(query.next())
+                ungrouped.insert(Photo::Id(query.value(0).toInt()));
+
+            // dates of removed photos for photos per day counters
+            std::map<QString, int> removedDates;
+
+            const QString datesQuery =
+                QString("SELECT value, COUNT(*) FROM %1 WHERE name = %2 AND photo_id IN (%3) GROUP BY value")
+                    .arg(TAB_TAGS)
+                    .arg(TagTypes::Date)
+                    .arg(filterQuery);
+
+            DB_ERROR_ON_FALSE1(m_executor->exec(datesQuery, &query));
+
+            while(query.next())
+                removedDates[query.value(0).toString()] = -query.value(1).toInt();
+
+            // values of tags used by removed photos
+            const QString tagsQuery =
+                QString("SELECT name, value, COUNT(*) FROM %1 WHERE photo_id IN (%2) GROUP BY name, value")
+                    .arg(TAB_TAGS)
+                    .arg(filterQuery);
+
+            DB_ERROR_ON_FALSE1(m_executor->exec(tagsQuery, &query));
+
+            while(query.next())
+            {
+                const TagTypes tagType = static_cast<TagTypes>(query.value(0).toInt());
+                const TagValue tagValue = TagValue::fromRaw(query.value(1).toString(), BaseTags::getType(tagType));
+
+                removedTagValues[tagType][tagValue] = -query.value(2).toInt();
+            }
+
+            // people on removed photos need their centroids to be recalculated
+            std::set<Person::Id> people;
+
+            const QString peopleQuery =
+                QString("SELECT DISTINCT person_id FROM %1 WHERE person_id IS NOT NULL AND photo_id IN (%2)")
+                    .arg(TAB_PEOPLE)
+                    .arg(filterQuery);
+
+            DB_ERROR_ON_FALSE1(m_executor->exec(peopleQuery, &query));
+
+            while(query.next())
+                people.insert(Person::Id(query.value(0).toInt()));
+
+            // all photo's data (and groups it represents) is removed by foreign keys.
+            // Derived table is used as MySQL does not allow subqueries on table being modified.
+            DB_ERROR_ON_FALSE1(m_executor->exec(QString("DELETE FROM " TAB_PHOTOS " WHERE id IN (SELECT * FROM (%1) AS drop_indices)").arg(filterQuery), &query));
+
+            DB_ERROR_ON_FALSE1(updatePhotosPerDay(removedDates));
+            DB_ERROR_ON_FALSE1(m_peopleAccessor->updateCentroids(people));
+
+            DB_ERROR_ON_FALSE1(transaction.commit());
+        }
+        catch(const db_error& error)
+        {
+            m_logger->error(error.what());
+            status = false;
+        }
 
         if (status)
-            status = db.commit();
-        else
-            db.rollback();
+        {
+            if (ungrouped.empty() == false)
+                emit m_backend->photosModified(ungrouped);
 
-        emit m_backend->photosRemoved(ids);
+            emit m_backend->photosRemoved(ids);
+
+            if (removedTagValues.empty() == false)
+                emit m_backend->tagValuesChanged(removedTagValues);
+        }
 
         return status;
     }
@@ -170,6 +228,54 @@ namespace Database
     }
 
 
+    bool PhotoOperator::updatePhotosPerDay(const std::map<QString, int>& differences)
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        bool status = true;
+
+        for (auto it = differences.cbegin(); status && it != differences.cend(); ++it)
+        {
+            const auto& [day, difference] = *it;
+
+            if (difference == 0)
+                continue;
+
+            const QString updateQuery =
+                QString("UPDATE %1 SET photos = photos + %2 WHERE day = '%3'")
+                    .arg(TAB_PHOTOS_PER_DAY)
+                    .arg(difference)
+                    .arg(day);
+
+            status = m_executor->exec(updateQuery, &query);
+
+            if (status && query.numRowsAffected() == 0)
+            {
+                const QString insertQuery =
+                    QString("INSERT INTO %1(day, photos) VALUES('%2', %3)")
+                        .arg(TAB_PHOTOS_PER_DAY)
+                        .arg(day)
+                        .arg(difference);
+
+                status = m_executor->exec(insertQuery, &query);
+            }
+
+            if (status && difference < 0)
+            {
+                const QString deleteQuery =
+                    QString("DELETE FROM %1 WHERE day = '%2' AND photos <= 0")
+                        .arg(TAB_PHOTOS_PER_DAY)
+                        .arg(day);
+
+                status = m_executor->exec(deleteQuery, &query);
+            }
+        }
+
+        return status;
+    }
+
+
     /**
      * \brief collect photo ids SELECTed by SQL query
      * \param query SQL SELECT query which returns photo ids
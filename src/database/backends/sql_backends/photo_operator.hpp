@@ -19,11 +19,14 @@
 #ifndef PHOTO_OPERATOR_HPP
 #define PHOTO_OPERATOR_HPP
 
+#include <map>
+
 #include <QString>
 
 #include <database/iphoto_operator.hpp>
 
 
+class NestedTransaction;
 class QSqlQuery;
 struct ILogger;
 
@@ -31,11 +34,12 @@ namespace Database
 {
     struct IBackend;
     struct ISqlQueryExecutor;
+    class PeopleInformationAccessor;
 
     class PhotoOperator: public IPhotoOperator
     {
         public:
-            PhotoOperator(const QString &, ISqlQueryExecutor *, ILogger *, IBackend *);
+            PhotoOperator(const QString &, ISqlQueryExecutor *, NestedTransaction *, PeopleInformationAccessor *, ILogger *, IBackend *);
 
             bool removePhoto(const Photo::Id &) override;
             bool removePhotos(const Filter &) override;
@@ -43,6 +47,9 @@ namespace Database
 
             std::vector<Photo::Id> getPhotos(const Filter &) override final;
 
+            // apply differences (raw date -> photos count change) to number of photos per day
+            bool updatePhotosPerDay(const std::map<QString, int> &);
+
         private:
             struct SortingContext
             {
@@ -54,6 +61,8 @@ namespace Database
 
             QString m_connectionName;
             ISqlQueryExecutor* m_executor;
+            NestedTransaction* m_transaction;
+            PeopleInformationAccessor* m_peopleAccessor;
             ILogger* m_logger;
             IBackend* m_backend;
 
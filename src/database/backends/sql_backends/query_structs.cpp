@@ -69,6 +69,13 @@ namespace Database
     }
 
 
+    void InsertQueryData::addValue(const QByteArray& value)
+    {
+        m_data->m_args--;
+        m_data->m_values.push_back(value);
+    }
+
+
     void InsertQueryData::addValue(int value)
     {
         m_data->m_args--;
@@ -51,6 +51,7 @@ namespace Database
 
             void addColumn(const QString &);
             void addValue(const QString &);
+            void addValue(const QByteArray &);
 
         private:
             struct Data;
@@ -21,12 +21,14 @@
 
 #include "sql_backend.hpp"
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <optional>
 #include <set>
 #include <sstream>
 #include <thread>
+#include <utility>
 
 #include <QDate>
 #include <QSqlDatabase>
@@ -37,11 +39,14 @@
 #include <QPixmap>
 
 #include <core/base_tags.hpp>
+#include <core/constants.hpp>
+#include <core/containers_utils.hpp>
 #include <core/tag.hpp>
 #include <core/task_executor.hpp>
 #include <core/ilogger.hpp>
 #include <core/ilogger_factory.hpp>
 #include <core/map_iterator.hpp>
+#include <core/search_expression_evaluator.hpp>
 #include <database/filter.hpp>
 #include <database/project_info.hpp>
 
@@ -56,14 +61,77 @@
 // about insert + update/ignore: http://stackoverflow.com/questions/15277373/sqlite-upsert-update-or-insert
 
 
+namespace
+{
+    // number of photos read at once by ASqlBackend::getPhotos()
+    constexpr std::size_t PhotosPerQuery = 500;
+
+    QString joinIds(std::vector<Photo::Id>::const_iterator first, std::vector<Photo::Id>::const_iterator last)
+    {
+        QStringList ids;
+
+        for(auto it = first; it != last; ++it)
+            ids.append(QString::number(it->value()));
+
+        return ids.join(", ");
+    }
+
+    void appendSearchTerms(std::set<QString>& terms, const QString& text)
+    {
+        for (const QString& term: SearchExpressionEvaluator::terms(text))
+            terms.insert(term.left(ConfigConsts::Constraints::database_search_term_len));
+    }
+
+    // words of photo's path and tags used by text search
+    std::set<QString> searchTerms(const QString& path, const Tag::TagsList& tags)
+    {
+        std::set<QString> terms;
+
+        appendSearchTerms(terms, path);
+
+        for (const auto& tag: tags)
+            appendSearchTerms(terms, tag.second.rawValue());
+
+        return terms;
+    }
+
+    const char* flagColumn(Photo::FlagsE flag)
+    {
+        switch (flag)
+        {
+            case Photo::FlagsE::StagingArea:     return FLAG_STAGING_AREA;
+            case Photo::FlagsE::ExifLoaded:      return FLAG_TAGS_LOADED;
+            case Photo::FlagsE::Sha256Loaded:    return FLAG_SHA256_LOADED;
+            case Photo::FlagsE::ThumbnailLoaded: return FLAG_THUMB_LOADED;
+            case Photo::FlagsE::GeometryLoaded:  return FLAG_GEOM_LOADED;
+        }
+
+        assert(!"Unknown flag");
+        return "";
+    }
+
+    QString searchTermsInsert(int photo_id, const std::set<QString>& terms)
+    {
+        QStringList rows;
+
+        // terms consist of letters and digits only, no need to escape them
+        for (const QString& term: terms)
+            rows.append(QString("(%1, '%2')").arg(photo_id).arg(term));
+
+        return QString("INSERT INTO %1(photo_id, term) VALUES %2").arg(TAB_SEARCH_TERMS).arg(rows.join(", "));
+    }
+}
+
+
 namespace Database
 {
 
     ASqlBackend::ASqlBackend(ILogger* l):
-        m_peopleInfoAccessor([this](){ return new PeopleInformationAccessor(this->m_connectionName, this->m_executor, *this->getGenericQueryGenerator()); }),
+        m_peopleInfoAccessor([this](){ return new PeopleInformationAccessor(this->m_connectionName, this->m_executor, this->m_tr_db, *this->getGenericQueryGenerator(), this->m_logger.get()); }),
         m_connectionName(""),
         m_logger(nullptr),
         m_executor(),
+        m_readerName(),
         m_dbHasSizeFeature(false),
         m_dbOpen(false)
     {
@@ -99,12 +167,37 @@ namespace Database
     }
 
 
+    std::unique_ptr<IBackend> ASqlBackend::createReader()
+    {
+        static std::atomic<int> readers(0);
+
+        std::unique_ptr<ASqlBackend> reader = construct();
+
+        if (reader)
+            reader->m_readerName = QString(":reader:%1").arg(readers++);
+
+        return reader;
+    }
+
+
     const QString& ASqlBackend::getConnectionName() const
     {
         return m_connectionName;
     }
 
 
+    std::unique_ptr<ASqlBackend> ASqlBackend::construct() const
+    {
+        return {};
+    }
+
+
+    bool ASqlBackend::isReader() const
+    {
+        return m_readerName.isEmpty() == false;
+    }
+
+
     GroupOperator& ASqlBackend::groupOperator()
     {
         // this lazy initialization is kind of a workaround:
@@ -127,6 +220,8 @@ namespace Database
         if (m_photoOperator.get() == nullptr)
             m_photoOperator = std::make_unique<PhotoOperator>(m_connectionName,
                                                               &m_executor,
+                                                              &m_tr_db,
+                                                              &*m_peopleInfoAccessor,
                                                               m_logger.get(),
                                                               this
                                                              );
@@ -156,6 +251,18 @@ namespace Database
     }
 
 
+    ExifFeaturesOperator& ASqlBackend::exifFeaturesOperator()
+    {
+        if (m_exifFeaturesOperator.get() == nullptr)
+            m_exifFeaturesOperator = std::make_unique<ExifFeaturesOperator>(m_connectionName,
+                                                                            &m_executor,
+                                                                            m_logger.get()
+                                                                           );
+
+        return *m_exifFeaturesOperator.get();
+    }
+
+
     bool ASqlBackend::dbOpened()
     {
         return true;
@@ -225,7 +332,7 @@ namespace Database
     {
         //store thread id for further validation
         m_executor.set( std::this_thread::get_id() );
-        m_connectionName = prjInfo.databaseLocation;
+        m_connectionName = prjInfo.databaseLocation + m_readerName;
         m_tr_db.setConnectionName(m_connectionName);
 
         BackendStatus status = StatusCodes::Ok;
@@ -244,7 +351,10 @@ namespace Database
             DB_ERROR_ON_FALSE2(dbOpened(), StatusCodes::OpenFailed);
             DB_ERROR_ON_FALSE3(db.driver()->hasFeature(QSqlDriver::BLOB), StatusCodes::OpenFailed, "DB driver does not support BLOB");
             DB_ERROR_ON_FALSE3(db.driver()->hasFeature(QSqlDriver::LastInsertId), StatusCodes::OpenFailed, "DB driver does not support LastInsertId");
-            DB_ERROR_ON_FALSE2(checkStructure(), StatusCodes::GeneralError);
+
+            // readers work on database prepared by main backend
+            if (isReader() == false)
+                DB_ERROR_ON_FALSE2(checkStructure(), StatusCodes::GeneralError);
         }
         catch(const db_error& err)
         {
@@ -295,12 +405,22 @@ namespace Database
                 touchedIds.insert(data.getId());
             }
 
+            photoChangeLogOperator().flush();
+
             DB_ERROR_ON_FALSE1(transaction.commit());
 
+            const TagValuesCounts tagValuesChanges = std::exchange(m_tagValuesChanges, {});
+
+            emit photosUpdated(dataVector);
             emit photosModified(touchedIds);
+
+            if (tagValuesChanges.empty() == false)
+                emit tagValuesChanged(tagValuesChanges);
         }
         catch(const db_error& error)
         {
+            photoChangeLogOperator().discard();
+            m_tagValuesChanges.clear();
             m_logger->error(error.what());
             status = false;
         }
@@ -349,6 +469,32 @@ namespace Database
     }
 
 
+    TagValuesCounts ASqlBackend::tagValuesCounts()
+    {
+        TagValuesCounts result;
+
+        const QString queryStr = QString("SELECT name, value, COUNT(*) FROM %1 GROUP BY name, value")
+                                    .arg(TAB_TAGS);
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const bool status = m_executor.exec(queryStr, &query);
+
+        while (status && query.next())
+        {
+            const TagTypes tagType = static_cast<TagTypes>(query.value(0).toInt());
+            const QString raw_value = query.value(1).toString();
+            const int count = query.value(2).toInt();
+
+            if (raw_value.isEmpty() == false)
+                result[tagType][TagValue::fromRaw(raw_value, BaseTags::getType(tagType))] = count;
+        }
+
+        return result;
+    }
+
+
     Photo::Data ASqlBackend::getPhoto(const Photo::Id& id)
     {
         const bool valid_id = doesPhotoExist(id);
@@ -383,26 +529,85 @@ namespace Database
     }
 
 
+    std::vector<Photo::Data> ASqlBackend::getPhotos(const std::vector<Photo::Id>& ids)
+    {
+        std::vector<Photo::Data> result;
+        result.reserve(ids.size());
+
+        for(std::size_t i = 0; i < ids.size(); i += PhotosPerQuery)
+        {
+            const auto first = ids.cbegin() + i;
+            const auto last = ids.cbegin() + std::min(i + PhotosPerQuery, ids.size());
+
+            const std::vector<Photo::Data> photos = getPhotosData(first, last);
+            result.insert(result.end(), photos.cbegin(), photos.cend());
+        }
+
+        return result;
+    }
+
+
     int ASqlBackend::getPhotosCount(const Filter& filter)
     {
-        const QString queryStr = SqlFilterQueryGenerator().generate(filter);
+        const QString filterQuery = SqlFilterQueryGenerator().generate(filter);
+        const QString queryStr = QString("SELECT COUNT(*) FROM (%1) AS filtered").arg(filterQuery);
 
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
         QSqlQuery query(db);
 
-        m_executor.exec(queryStr, &query);
+        const bool status = m_executor.exec(queryStr, &query);
 
-        int result = 0;
-
-        if (m_dbHasSizeFeature)
-            result = query.size();
-        else
-            result = query.next()? 1: 0;
+        const int result = status && query.next()? query.value(0).toInt(): 0;
 
         return result;
     }
 
 
+    std::map<QDate, int> ASqlBackend::datesHistogram(const Filter& filter, DatesResolution resolution)
+    {
+        std::map<QDate, int> histogram;
+
+        const QString filterQuery = SqlFilterQueryGenerator().generate(filter);
+
+        // counters are maintained for all photos, for other filters dates need to be counted
+        const QString queryStr = std::holds_alternative<EmptyFilter>(filter)?
+            QString("SELECT day, photos FROM %1").arg(TAB_PHOTOS_PER_DAY):
+            QString("SELECT value, COUNT(*) FROM %1 WHERE name = %2 AND photo_id IN (%3) GROUP BY value")
+                .arg(TAB_TAGS)
+                .arg(TagTypes::Date)
+                .arg(filterQuery);
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const bool status = m_executor.exec(queryStr, &query);
+        int datedPhotos = 0;
+
+        while (status && query.next())
+        {
+            const QDate date = TagValue::fromRaw(query.value(0).toString(), Tag::ValueType::Date).getDate();
+            const int photos = query.value(1).toInt();
+
+            if (resolution == DatesResolution::Month)
+                histogram[QDate(date.year(), date.month(), 1)] += photos;
+            else
+                histogram[date] += photos;
+
+            datedPhotos += photos;
+        }
+
+        if (status)
+        {
+            const int undatedPhotos = getPhotosCount(filter) - datedPhotos;
+
+            if (undatedPhotos > 0)
+                histogram[QDate()] = undatedPhotos;
+        }
+
+        return histogram;
+    }
+
+
     void ASqlBackend::set(const Photo::Id& id, const QString& name, int value)
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
@@ -545,7 +750,36 @@ namespace Database
                     status = StatusCodes::VersionTooOld;
                     break;
 
-                case 5:             // current version, break updgrades chain
+                case 5:
+                    status = upgradeV5ToV6();
+                    [[fallthrough]];
+
+                case 6:
+                    if (status)
+                        status = upgradeV6ToV7();
+                    [[fallthrough]];
+
+                case 7:
+                    if (status)
+                        status = upgradeV7ToV8();
+                    [[fallthrough]];
+
+                case 8:
+                    if (status)
+                        status = upgradeV8ToV9();
+                    [[fallthrough]];
+
+                case 9:
+                    if (status)
+                        status = upgradeV9ToV10();
+                    [[fallthrough]];
+
+                case 10:
+                    if (status)
+                        status = upgradeV10ToV11();
+                    [[fallthrough]];
+
+                case 11:            // current version, break updgrades chain
                     break;
 
                 default:
@@ -565,6 +799,384 @@ namespace Database
         return status;
     }
 
+    /**
+     * \brief add ON DELETE CASCADE to all foreign keys referring photos and groups
+     *
+     * Foreign keys cannot be altered so tables are rebuilt.
+     * New tables are created with '_v6' suffix, filled with data (orphans are skipped),
+     * then old tables are dropped and new ones renamed.
+     */
+    BackendStatus ASqlBackend::upgradeV5ToV6()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString id = getGenericQueryGenerator()->getTypeFor(ColDefinition::Purpose::ID);
+        const QString tagValue = QString("VARCHAR(%1)").arg(ConfigConsts::Constraints::database_tag_value_len);
+        const QString photoRef = "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE";
+        const QString existingPhotos = "photo_id IN (SELECT id FROM " TAB_PHOTOS ")";
+
+        struct Table
+        {
+            QString name;
+            QString columnsDefinition;
+            QString columns;
+            QString condition;
+            QStringList indices;
+        };
+
+        const std::vector<Table> tablesToRebuild =
+        {
+            {
+                TAB_TAGS,
+                QString("id %1, value %2, name INTEGER NOT NULL, photo_id INTEGER NOT NULL, %3").arg(id, tagValue, photoRef),
+                "id, value, name, photo_id",
+                existingPhotos,
+                { "CREATE UNIQUE INDEX tg_id_idx ON " TAB_TAGS " (id)", "CREATE INDEX tg_photo_id_idx ON " TAB_TAGS " (photo_id)" }
+            },
+            {
+                TAB_THUMBS,
+                QString("id %1, photo_id INTEGER NOT NULL, data BLOB, %2").arg(id, photoRef),
+                "id, photo_id, data",
+                existingPhotos,
+                { "CREATE UNIQUE INDEX th_photo_id_idx ON " TAB_THUMBS " (photo_id)" }
+            },
+            {
+                TAB_SHA256SUMS,
+                QString("id %1, photo_id INTEGER NOT NULL, sha256 CHAR(32) NOT NULL, %2").arg(id, photoRef),
+                "id, photo_id, sha256",
+                existingPhotos,
+                { "CREATE UNIQUE INDEX ha_photo_id_idx ON " TAB_SHA256SUMS " (photo_id)", "CREATE INDEX ha_sha256_idx ON " TAB_SHA256SUMS " (sha256)" }
+            },
+            {
+                TAB_GEOMETRY,
+                QString("id %1, photo_id INTEGER NOT NULL, width INT NOT NULL, height INT NOT NULL, %2").arg(id, photoRef),
+                "id, photo_id, width, height",
+                existingPhotos,
+                { "CREATE UNIQUE INDEX g_id_idx ON " TAB_GEOMETRY " (id)", "CREATE UNIQUE INDEX g_photo_id_idx ON " TAB_GEOMETRY " (photo_id)" }
+            },
+            {
+                TAB_FLAGS,
+                QString("id %1, photo_id INTEGER NOT NULL, staging_area INT NOT NULL, tags_loaded INT NOT NULL, "
+                        "sha256_loaded INT NOT NULL, thumbnail_loaded INT NOT NULL, geometry_loaded INT NOT NULL, %2").arg(id, photoRef),
+                "id, photo_id, staging_area, tags_loaded, sha256_loaded, thumbnail_loaded, geometry_loaded",
+                existingPhotos,
+                { "CREATE UNIQUE INDEX fl_photo_id_idx ON " TAB_FLAGS " (photo_id)" }
+            },
+            {
+                TAB_PEOPLE,
+                QString("id %1, photo_id INTEGER NOT NULL, person_id INTEGER, fingerprint_id INTEGER, location CHAR(64), %2, "
+                        "FOREIGN KEY(person_id) REFERENCES " TAB_PEOPLE_NAMES "(id), "
+                        "FOREIGN KEY(fingerprint_id) REFERENCES " TAB_FACES_FINGERPRINTS "(id)").arg(id, photoRef),
+                "id, photo_id, person_id, fingerprint_id, location",
+                existingPhotos + " AND (person_id IS NULL OR person_id IN (SELECT id FROM " TAB_PEOPLE_NAMES "))"
+                               + " AND (fingerprint_id IS NULL OR fingerprint_id IN (SELECT id FROM " TAB_FACES_FINGERPRINTS "))",
+                { }
+            },
+            {
+                TAB_GENERAL_FLAGS,
+                QString("id %1, photo_id INTEGER NOT NULL, name CHAR(64), value INTEGER, %2").arg(id, photoRef),
+                "id, photo_id, name, value",
+                existingPhotos,
+                { }
+            },
+            {
+                TAB_PHOTOS_CHANGE_LOG,
+                QString("id %1, photo_id INTEGER NOT NULL, operation INTEGER, field INTEGER, data %2, date TIMESTAMP NOT NULL, %3").arg(id, tagValue, photoRef),
+                "id, photo_id, operation, field, data, date",
+                existingPhotos,
+                { }
+            },
+            {
+                TAB_GROUPS,
+                QString("id %1, representative_id INTEGER NOT NULL, type INTEGER, "
+                        "FOREIGN KEY(representative_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE").arg(id),
+                "id, representative_id, type",
+                "representative_id IN (SELECT id FROM " TAB_PHOTOS ")",
+                { }
+            },
+            {
+                // refer new groups table, reference will follow its rename
+                TAB_GROUPS_MEMBERS,
+                QString("id %1, group_id INTEGER NOT NULL, photo_id INTEGER NOT NULL, "
+                        "FOREIGN KEY(group_id) REFERENCES " TAB_GROUPS "_v6(id) ON DELETE CASCADE, %2").arg(id, photoRef),
+                "id, group_id, photo_id",
+                existingPhotos + " AND group_id IN (SELECT id FROM " TAB_GROUPS "_v6)",
+                { }
+            },
+        };
+
+        BackendStatus status = StatusCodes::Ok;
+
+        // create and fill new tables
+        for (auto it = tablesToRebuild.cbegin(); status && it != tablesToRebuild.cend(); ++it)
+        {
+            const QString newName = it->name + "_v6";
+
+            status = m_executor.exec(getGenericQueryGenerator()->prepareCreationQuery(newName, it->columnsDefinition), &query);
+
+            if (status)
+                status = m_executor.exec(QString("INSERT INTO %1 (%3) SELECT %3 FROM %2 WHERE %4")
+                                            .arg(newName, it->name, it->columns, it->condition), &query);
+        }
+
+        // drop old ones (children first)
+        for (auto it = tablesToRebuild.crbegin(); status && it != tablesToRebuild.crend(); ++it)
+            status = m_executor.exec(QString("DROP TABLE %1").arg(it->name), &query);
+
+        // rename new ones and restore indices
+        for (auto it = tablesToRebuild.cbegin(); status && it != tablesToRebuild.cend(); ++it)
+        {
+            status = m_executor.exec(QString("ALTER TABLE %1_v6 RENAME TO %1").arg(it->name), &query);
+
+            for (auto index = it->indices.cbegin(); status && index != it->indices.cend(); ++index)
+                status = m_executor.exec(*index, &query);
+        }
+
+        return status;
+    }
+
+
+    /**
+     * \brief replace encoded 'data' column of change log with typed columns
+     *
+     * Tag entries used to be stored as 'type base64(old) base64(new)',
+     * group entries as 'old_id new_id,old_role new_role'.
+     * Entries are decoded here and copied to rebuilt table.
+     */
+    BackendStatus ASqlBackend::upgradeV6ToV7()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString id = getGenericQueryGenerator()->getTypeFor(ColDefinition::Purpose::ID);
+        const QString tagValue = QString("VARCHAR(%1)").arg(ConfigConsts::Constraints::database_tag_value_len);
+        const QString columnsDefinition =
+            QString("id %1, photo_id INTEGER NOT NULL, operation INTEGER, field INTEGER, tag_type INTEGER, "
+                    "old_value %2, new_value %2, date TIMESTAMP NOT NULL, "
+                    "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE").arg(id, tagValue);
+
+        BackendStatus status = m_executor.exec(getGenericQueryGenerator()->prepareCreationQuery(TAB_PHOTOS_CHANGE_LOG "_v7", columnsDefinition), &query);
+
+        if (status)
+            status = m_executor.exec("SELECT id, photo_id, operation, field, data, date FROM " TAB_PHOTOS_CHANGE_LOG, &query);
+
+        QSqlQuery insertQuery(db);
+
+        if (status)
+            status = m_executor.prepare("INSERT INTO " TAB_PHOTOS_CHANGE_LOG "_v7 (id, photo_id, operation, field, tag_type, old_value, new_value, date) "
+                                        "VALUES(?, ?, ?, ?, ?, ?, ?, ?)", &insertQuery);
+
+        // values of v6 enums: operation: 1 - add, 2 - modify, 3 - remove; field: 1 - tags, 2 - group
+        auto decode = [](const QString& encoded)
+        {
+            return QString::fromUtf8(QByteArray::fromBase64(encoded.toUtf8()));
+        };
+
+        while (status && query.next())
+        {
+            const int operation = query.value(2).toInt();
+            const int field = query.value(3).toInt();
+            const QString data = query.value(4).toString();
+
+            QVariant tagType, oldValue, newValue;
+
+            if (field == 1)
+            {
+                const QStringList items = data.split(" ");
+                tagType = items.value(0).toInt();
+
+                if (operation == 1)
+                    newValue = decode(items.value(1));
+                else if (operation == 3)
+                    oldValue = decode(items.value(1));
+                else
+                {
+                    oldValue = decode(items.value(1));
+                    newValue = decode(items.value(2));
+                }
+            }
+            else
+            {
+                if (operation == 1)
+                    newValue = data;
+                else if (operation == 3)
+                    oldValue = data;
+                else
+                {
+                    const QStringList ids_roles = data.split(",");
+                    const QStringList ids = ids_roles.value(0).split(" ");
+                    const QStringList roles = ids_roles.value(1).split(" ");
+
+                    oldValue = QString("%1,%2").arg(ids.value(0), roles.value(0));
+                    newValue = QString("%1,%2").arg(ids.value(1), roles.value(1));
+                }
+            }
+
+            insertQuery.addBindValue(query.value(0));
+            insertQuery.addBindValue(query.value(1));
+            insertQuery.addBindValue(operation);
+            insertQuery.addBindValue(field);
+            insertQuery.addBindValue(tagType);
+            insertQuery.addBindValue(oldValue);
+            insertQuery.addBindValue(newValue);
+            insertQuery.addBindValue(query.value(5));
+
+            status = m_executor.exec(insertQuery);
+        }
+
+        query.finish();
+
+        if (status)
+            status = m_executor.exec("DROP TABLE " TAB_PHOTOS_CHANGE_LOG, &query);
+
+        if (status)
+            status = m_executor.exec("ALTER TABLE " TAB_PHOTOS_CHANGE_LOG "_v7 RENAME TO " TAB_PHOTOS_CHANGE_LOG, &query);
+
+        if (status)
+            status = m_executor.exec("CREATE INDEX pcl_photo_id_idx ON " TAB_PHOTOS_CHANGE_LOG " (photo_id)", &query);
+
+        if (status)
+            status = m_executor.exec("CREATE INDEX pcl_date_idx ON " TAB_PHOTOS_CHANGE_LOG " (date)", &query);
+
+        return status;
+    }
+
+
+    /**
+     * \brief fill search terms table with words of photos' paths and tags
+     */
+    BackendStatus ASqlBackend::upgradeV7ToV8()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        std::map<int, std::set<QString>> terms;
+
+        BackendStatus status = m_executor.exec("SELECT id, path FROM " TAB_PHOTOS, &query);
+
+        while (status && query.next())
+            appendSearchTerms(terms[query.value(0).toInt()], query.value(1).toString());
+
+        if (status)
+            status = m_executor.exec("SELECT photo_id, value FROM " TAB_TAGS, &query);
+
+        while (status && query.next())
+            appendSearchTerms(terms[query.value(0).toInt()], query.value(1).toString());
+
+        query.finish();
+
+        for (auto it = terms.cbegin(); status && it != terms.cend(); ++it)
+            if (it->second.empty() == false)
+                status = m_executor.exec(searchTermsInsert(it->first, it->second), &query);
+
+        return status;
+    }
+
+
+    /**
+     * \brief count photos per day
+     */
+    BackendStatus ASqlBackend::upgradeV8ToV9()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString fillQuery =
+            QString("INSERT INTO %1(day, photos) SELECT value, COUNT(*) FROM %2 WHERE name = %3 GROUP BY value")
+                .arg(TAB_PHOTOS_PER_DAY)
+                .arg(TAB_TAGS)
+                .arg(TagTypes::Date);
+
+        return m_executor.exec(fillQuery, &query);
+    }
+
+
+    /**
+     * \brief convert fingerprints from space separated text doubles into float32 blobs
+     */
+    BackendStatus ASqlBackend::upgradeV9ToV10()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        BackendStatus status = m_executor.exec("SELECT id, fingerprint FROM " TAB_FACES_FINGERPRINTS, &query);
+
+        // read all fingerprints first, so table is not modified while being read
+        std::vector<std::pair<int, Person::Fingerprint>> fingerprints;
+
+        while (status && query.next())
+        {
+            Person::Fingerprint fingerprint;
+
+            for (const QByteArray& component: query.value(1).toByteArray().split(' '))
+                if (component.isEmpty() == false)
+                    fingerprint.push_back(component.toDouble());
+
+            fingerprints.emplace_back(query.value(0).toInt(), fingerprint);
+        }
+
+        QSqlQuery updateQuery(db);
+
+        if (status)
+            status = m_executor.prepare("UPDATE " TAB_FACES_FINGERPRINTS " SET fingerprint = ? WHERE id = ?", &updateQuery);
+
+        for (auto it = fingerprints.cbegin(); status && it != fingerprints.cend(); ++it)
+        {
+            updateQuery.addBindValue(PeopleInformationAccessor::encodeFingerprint(it->second));
+            updateQuery.addBindValue(it->first);
+
+            status = m_executor.exec(updateQuery);
+        }
+
+        return status;
+    }
+
+
+    /**
+     * \brief calculate average fingerprint of each person
+     */
+    BackendStatus ASqlBackend::upgradeV10ToV11()
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString fingerprintsQuery =
+            QString("SELECT %1.person_id, %2.fingerprint FROM %1 JOIN %2 ON %2.id = %1.fingerprint_id WHERE %1.person_id IS NOT NULL")
+                .arg(TAB_PEOPLE)
+                .arg(TAB_FACES_FINGERPRINTS);
+
+        BackendStatus status = m_executor.exec(fingerprintsQuery, &query);
+
+        std::map<int, std::pair<Person::Fingerprint, int>> sums;
+
+        while (status && query.next())
+        {
+            auto& [sum, count] = sums[query.value(0).toInt()];
+
+            sum += PeopleInformationAccessor::decodeFingerprint(query.value(1).toByteArray());
+            count++;
+        }
+
+        QSqlQuery insertQuery(db);
+
+        if (status)
+            status = m_executor.prepare("INSERT INTO " TAB_PEOPLE_CENTROIDS "(person_id, fingerprint) VALUES(?, ?)", &insertQuery);
+
+        for (auto it = sums.begin(); status && it != sums.end(); ++it)
+        {
+            const auto& [sum, count] = it->second;
+
+            insertQuery.addBindValue(it->first);
+            insertQuery.addBindValue(PeopleInformationAccessor::encodeFingerprint(sum / count));
+
+            status = m_executor.exec(insertQuery);
+        }
+
+        return status;
+    }
+
+
     /**
      * \brief get people details for given people ids
      * \return vector of person details structure
@@ -650,14 +1262,17 @@ namespace Database
                         query = getGenericQueryGenerator()->update(db, updateQueryData);
                     }
 
-                    const QMap<QString, QVariant> bound = query.boundValues();
+                    if (m_logger->isEnabled(ILogger::Severity::Debug))
+                    {
+                        const QMap<QString, QVariant> bound = query.boundValues();
 
-                    QStringList binded_values;
-                    for(QMap<QString, QVariant>::const_iterator it = bound.begin(); it != bound.end(); ++it)
-                        binded_values.append(it.key() + " = " + it.value().toString());
+                        QStringList binded_values;
+                        for(QMap<QString, QVariant>::const_iterator it = bound.begin(); it != bound.end(); ++it)
+                            binded_values.append(it.key() + " = " + it.value().toString());
 
-                    const QString binded_values_msg = "Binded values: " + binded_values.join(", ");
-                    m_logger->debug(binded_values_msg);
+                        const QString binded_values_msg = "Binded values: " + binded_values.join(", ");
+                        m_logger->debug(binded_values_msg);
+                    }
 
                     status = m_executor.exec(query);
                 }
@@ -716,19 +1331,38 @@ namespace Database
      */
     bool ASqlBackend::storeData(const Photo::DataDelta& data)
     {
-        const Photo::Data currentStateOfPhoto = getPhoto(data.getId());
-
         assert(data.getId());
 
+        // field level changes of flags, checksum and geometry do not depend on current state of photo
+        const bool needsCurrentState = data.has(Photo::Field::Tags) ||
+                                       data.has(Photo::Field::TagsChanges) ||
+                                       data.has(Photo::Field::Path) ||
+                                       data.has(Photo::Field::GroupInfo);
+
+        Photo::Data currentStateOfPhoto;
+
+        if (needsCurrentState)
+            currentStateOfPhoto = getPhoto(data.getId());
+        else
+            currentStateOfPhoto.id = data.getId();
+
+        const bool tagsChanged = data.has(Photo::Field::Tags) || data.has(Photo::Field::TagsChanges);
+        const Tag::TagsList tags = tagsChanged? Photo::Data(currentStateOfPhoto).apply(data).tags: currentStateOfPhoto.tags;
+
         bool status = true;
 
         //store used tags
         if (data.has(Photo::Field::Tags))
-        {
-            const Tag::TagsList& tags = data.get<Photo::Field::Tags>();
+            status = storeTags(data.getId(), data.get<Photo::Field::Tags>());
 
-            status = storeTags(data.getId(), tags);
-        }
+        if (status && data.has(Photo::Field::TagsChanges))
+            status = storeTagsChanges(data.getId(), data.get<Photo::Field::TagsChanges>());
+
+        if (status && tagsChanged)
+            status = storeDate(currentStateOfPhoto.tags, tags);
+
+        if (status && tagsChanged)
+            countTagValues(m_tagValuesChanges, currentStateOfPhoto.tags, tags);
 
         if (status && data.has(Photo::Field::Geometry))
         {
@@ -748,12 +1382,21 @@ namespace Database
             status = storeFlags(data.getId(), flags);
         }
 
+        if (status && data.has(Photo::Field::FlagsChanges))
+        {
+            const Photo::FlagValues& flags = data.get<Photo::Field::FlagsChanges>();
+            status = storeFlagsChanges(data.getId(), flags);
+        }
+
         if (status && data.has(Photo::Field::GroupInfo))
         {
             const GroupInfo& groupInfo = data.get<Photo::Field::GroupInfo>();
             status = storeGroup(data.getId(), groupInfo);
         }
 
+        if (status && (tagsChanged || data.has(Photo::Field::Path)))
+            status = storeSearchTerms(data.getId(), searchTerms(currentStateOfPhoto.path, tags));
+
         photoChangeLogOperator().storeDifference(currentStateOfPhoto, data);
 
         return status;
@@ -862,6 +1505,36 @@ namespace Database
     }
 
 
+    /**
+     * \brief set or remove chosen tags of photo, leave other ones untouched
+     * \param changes tags to be set. Tags with empty values are to be removed
+     * \return false on error
+     */
+    bool ASqlBackend::storeTagsChanges(const Photo::Id& id, const Tag::TagsList& changes) const
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        QStringList names;
+        for (const auto& change: changes)
+            names.append(QString::number(change.first));
+
+        // there is no unique key for (photo_id, name), so upsert is done as delete + insert
+        const QString deleteQuery = QString("DELETE FROM %1 WHERE photo_id = %2 AND name IN (%3)")
+                                        .arg(TAB_TAGS)
+                                        .arg(id.value())
+                                        .arg(names.join(", "));
+
+        bool status = changes.empty() || m_executor.exec(deleteQuery, &query);
+
+        for (auto it = changes.begin(); status && it != changes.end(); ++it)
+            if (it->second.type() != Tag::ValueType::Empty)
+                status = store(it->second, id.value(), it->first, -1);
+
+        return status;
+    }
+
+
     /**
      * \brief store photo's flags
      * \return false on error
@@ -893,6 +1566,34 @@ namespace Database
     }
 
 
+    /**
+     * \brief set chosen flags of photo, leave other ones untouched
+     * \return false on error
+     */
+    bool ASqlBackend::storeFlagsChanges(const Photo::Id& id, const Photo::FlagValues& changes) const
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        QStringList assignments;
+        for (const auto& [flag, value]: changes)
+            assignments.append(QString("%1 = %2").arg(flagColumn(flag)).arg(value));
+
+        const QString updateQuery = QString("UPDATE %1 SET %2 WHERE photo_id = %3")
+                                        .arg(TAB_FLAGS)
+                                        .arg(assignments.join(", "))
+                                        .arg(id.value());
+
+        bool status = changes.empty() || m_executor.exec(updateQuery, &query);
+
+        // no flags stored for photo yet - create them
+        if (status && changes.empty() == false && query.numRowsAffected() == 0)
+            status = storeFlags(id, changes);
+
+        return status;
+    }
+
+
     /**
      * \brief store photo's group details
      * \return false on error
@@ -935,6 +1636,59 @@ namespace Database
     }
 
 
+    /**
+     * \brief update number of photos per day when photo's date changes
+     * \return false on error
+     */
+    bool ASqlBackend::storeDate(const Tag::TagsList& previousTags, const Tag::TagsList& tags)
+    {
+        auto dateOf = [](const Tag::TagsList& tagsList)
+        {
+            auto it = tagsList.find(TagTypes::Date);
+
+            return it == tagsList.end()? QString(): it->second.rawValue();
+        };
+
+        const QString previousDate = dateOf(previousTags);
+        const QString date = dateOf(tags);
+
+        std::map<QString, int> differences;
+
+        if (previousDate != date)
+        {
+            if (previousDate.isEmpty() == false)
+                differences[previousDate] = -1;
+
+            if (date.isEmpty() == false)
+                differences[date] = 1;
+        }
+
+        return photoOperator().updatePhotosPerDay(differences);
+    }
+
+
+    /**
+     * \brief replace photo's search terms
+     * \return false on error
+     */
+    bool ASqlBackend::storeSearchTerms(const Photo::Id& id, const std::set<QString>& terms) const
+    {
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        const QString deleteQuery = QString("DELETE FROM %1 WHERE photo_id = %2")
+                                        .arg(TAB_SEARCH_TERMS)
+                                        .arg(id);
+
+        bool status = m_executor.exec(deleteQuery, &query);
+
+        if (status && terms.empty() == false)
+            status = m_executor.exec(searchTermsInsert(id, terms), &query);
+
+        return status;
+    }
+
+
     /**
      * \brief insert set of photos to database
      * \param data_set vector of photo details to be stored
@@ -955,10 +1709,19 @@ namespace Database
             for(Photo::DataDelta& data: data_set)
                 introduce(data);
 
+            photoChangeLogOperator().flush();
+
             DB_ERROR_ON_FALSE1(transaction.commit());
+
+            const TagValuesCounts tagValuesChanges = std::exchange(m_tagValuesChanges, {});
+
+            if (tagValuesChanges.empty() == false)
+                emit tagValuesChanged(tagValuesChanges);
         }
         catch(const db_error& error)
         {
+            photoChangeLogOperator().discard();
+            m_tagValuesChanges.clear();
             m_logger->error(error.what());
             status = false;
         }
@@ -1078,8 +1841,9 @@ namespace Database
     {
         QSqlDatabase db = QSqlDatabase::database(m_connectionName);
         QSqlQuery query(db);
+        // LEFT JOIN: group may have no members
         QString queryStr = QString("SELECT %1.id, %1.representative_id, %2.photo_id FROM %1 "
-                                   "JOIN %2 ON (%1.id = %2.group_id) "
+                                   "LEFT JOIN %2 ON (%1.id = %2.group_id) "
                                    "WHERE (%1.representative_id = %3 OR %2.photo_id = %3)"
         );
 
@@ -1098,7 +1862,7 @@ namespace Database
 
             const int groupId = groupVariant.toInt();
             const int representativeId = representativeVariant.toInt();
-            const int memberId = memberVariant.toInt();
+            const int memberId = memberVariant.isNull()? -1: memberVariant.toInt();
 
             const Group::Id gid(groupId);
 
@@ -1184,6 +1948,145 @@ namespace Database
     }
 
 
+    /**
+     * \brief read all details of photos from range
+     * \return details of existing photos in order of appearance in range
+     *
+     * Equivalent of getPhoto() for many photos. Each kind of data is read with one query.
+     */
+    std::vector<Photo::Data> ASqlBackend::getPhotosData(std::vector<Photo::Id>::const_iterator first,
+                                                        std::vector<Photo::Id>::const_iterator last) const
+    {
+        const QString idsList = joinIds(first, last);
+
+        QSqlDatabase db = QSqlDatabase::database(m_connectionName);
+        QSqlQuery query(db);
+
+        std::map<Photo::Id, Photo::Data> photos;
+
+        // paths (and existence)
+        const QString pathsQuery = QString("SELECT id, path FROM %1 WHERE id IN (%2)")
+                                   .arg(TAB_PHOTOS)
+                                   .arg(idsList);
+
+        bool status = m_executor.exec(pathsQuery, &query);
+
+        while (status && query.next())
+        {
+            const Photo::Id id(query.value(0).toInt());
+            Photo::Data& data = photos[id];
+
+            data.id = id;
+            data.path = query.value(1).toString();
+        }
+
+        auto forEachRow = [&](const QString& queryStr, auto&& op)
+        {
+            if (status)
+                status = m_executor.exec(queryStr, &query);
+
+            while (status && query.next())
+            {
+                const Photo::Id id(query.value(0).toInt());
+                auto it = photos.find(id);
+
+                if (it != photos.end())
+                    op(it->second);
+            }
+        };
+
+        // tags
+        forEachRow(QString("SELECT photo_id, name, value FROM %1 WHERE photo_id IN (%2)")
+                   .arg(TAB_TAGS)
+                   .arg(idsList),
+                   [&query](Photo::Data& data)
+        {
+            const TagTypes tagNameType = static_cast<TagTypes>( query.value(1).toInt() );
+            const QVariant value = query.value(2);
+
+            // storing routine doesn't store empty tags (see store() for tags)
+            assert(value.isValid() && value.isNull() == false);
+            if (value.isValid() && value.isNull() == false)
+                data.tags[tagNameType] = TagValue::fromRaw(value.toString(), BaseTags::getType(tagNameType));
+        });
+
+        // geometry
+        forEachRow(QString("SELECT photo_id, width, height FROM %1 WHERE photo_id IN (%2)")
+                   .arg(TAB_GEOMETRY)
+                   .arg(idsList),
+                   [&query](Photo::Data& data)
+        {
+            const QSize geometry(query.value(1).toInt(), query.value(2).toInt());
+
+            if (geometry.isValid())
+                data.geometry = geometry;
+        });
+
+        // sha256
+        forEachRow(QString("SELECT photo_id, sha256 FROM %1 WHERE photo_id IN (%2)")
+                   .arg(TAB_SHA256SUMS)
+                   .arg(idsList),
+                   [&query](Photo::Data& data)
+        {
+            data.sha256Sum = query.value(1).toString().toLatin1();
+        });
+
+        // flags
+        forEachRow(QString("SELECT photo_id, staging_area, tags_loaded, sha256_loaded, thumbnail_loaded, geometry_loaded FROM %1 WHERE photo_id IN (%2)")
+                   .arg(TAB_FLAGS)
+                   .arg(idsList),
+                   [&query](Photo::Data& data)
+        {
+            data.flags[Photo::FlagsE::StagingArea] = query.value(1).toInt();
+            data.flags[Photo::FlagsE::ExifLoaded] = query.value(2).toInt();
+            data.flags[Photo::FlagsE::Sha256Loaded] = query.value(3).toInt();
+            data.flags[Photo::FlagsE::ThumbnailLoaded] = query.value(4).toInt();
+            data.flags[Photo::FlagsE::GeometryLoaded] = query.value(5).toInt();
+        });
+
+        // groups
+        if (status)
+        {
+            const QString groupsQuery = QString("SELECT %1.id, %1.representative_id, %2.photo_id FROM %1 "
+                                                "LEFT JOIN %2 ON (%1.id = %2.group_id) "
+                                                "WHERE (%1.representative_id IN (%3) OR %2.photo_id IN (%3))")
+                                        .arg(TAB_GROUPS)
+                                        .arg(TAB_GROUPS_MEMBERS)
+                                        .arg(idsList);
+
+            status = m_executor.exec(groupsQuery, &query);
+
+            while (status && query.next())
+            {
+                const Group::Id gid(query.value(0).toInt());
+                const Photo::Id representativeId(query.value(1).toInt());
+                const Photo::Id memberId(query.value(2).toInt());
+
+                auto representative = photos.find(representativeId);
+                if (representative != photos.end())
+                    representative->second.groupInfo = GroupInfo(gid, GroupInfo::Representative);
+
+                auto member = query.isNull(2)? photos.end(): photos.find(memberId);
+                if (member != photos.end() && member->second.groupInfo.role != GroupInfo::Representative)
+                    member->second.groupInfo = GroupInfo(gid, GroupInfo::Member);
+            }
+        }
+
+        std::vector<Photo::Data> result;
+        result.reserve(photos.size());
+
+        for(auto it = first; it != last; ++it)
+        {
+            auto photo = photos.find(*it);
+
+            if (photo != photos.end())
+                result.push_back(photo->second);
+        }
+
+        return result;
+    }
+
+
     /**
      * \brief check if \param id is a valid photo id.
      */
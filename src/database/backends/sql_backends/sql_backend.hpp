@@ -22,12 +22,15 @@
 #ifndef ASQLBACKEND_HPP
 #define ASQLBACKEND_HPP
 
+#include <map>
 #include <memory>
+#include <set>
 #include <vector>
 #include <vector>
 
 #include "core/lazy_ptr.hpp"
 #include "database/ibackend.hpp"
+#include "exif_features_operator.hpp"
 #include "group_operator.hpp"
 #include "people_information_accessor.hpp"
 #include "photo_change_log_operator.hpp"
@@ -62,6 +65,7 @@ namespace Database
             bool operator==(const ASqlBackend& other) = delete;
 
             void closeConnections() override;
+            std::unique_ptr<IBackend> createReader() override;
 
             /**
              * \brief Get connection name
@@ -74,10 +78,20 @@ namespace Database
              */
             const QString& getConnectionName() const;
 
+            /**
+             * \brief reader mode
+             * \return true if backend was created by createReader()
+             *
+             * In reader mode backend should open read only connection
+             * and should not modify database structure.
+             */
+            bool isReader() const;
+
             GroupOperator& groupOperator() override;
             PhotoOperator& photoOperator() override;
             PhotoChangeLogOperator& photoChangeLogOperator() override;
             IPeopleInformationAccessor& peopleInformationAccessor() override;
+            ExifFeaturesOperator& exifFeaturesOperator() override;
 
         protected:
             /**
@@ -90,6 +104,14 @@ namespace Database
              */
             virtual BackendStatus prepareDB(const ProjectInfo& location) = 0;
 
+            /**
+             * \brief construct backend of the same type
+             * \return new backend or nullptr if readers are not supported
+             *
+             * Called by createReader(). Returned backend will be switched to reader mode.
+             */
+            virtual std::unique_ptr<ASqlBackend> construct() const;
+
             /**
              * \brief called when DB was opened.
              * \return operation status
@@ -127,11 +149,14 @@ namespace Database
             std::unique_ptr<GroupOperator> m_groupOperator;
             std::unique_ptr<PhotoOperator> m_photoOperator;
             std::unique_ptr<PhotoChangeLogOperator> m_photoChangeLogOperator;
-            lazy_ptr<IPeopleInformationAccessor, std::function<IPeopleInformationAccessor*()>> m_peopleInfoAccessor;
+            std::unique_ptr<ExifFeaturesOperator> m_exifFeaturesOperator;
+            lazy_ptr<PeopleInformationAccessor, std::function<PeopleInformationAccessor*()>> m_peopleInfoAccessor;
             mutable NestedTransaction m_tr_db;
+            TagValuesCounts m_tagValuesChanges;                 // changes of tag values made by pending transaction
             QString m_connectionName;
             std::unique_ptr<ILogger> m_logger;
             SqlQueryExecutor m_executor;
+            QString m_readerName;
             bool m_dbHasSizeFeature;
             bool m_dbOpen;
 
@@ -141,9 +166,12 @@ namespace Database
             bool update(const std::vector<Photo::DataDelta> &) override final;
 
             std::vector<TagValue>    listTagValues(const TagTypes &, const Filter &) override final;
+            TagValuesCounts          tagValuesCounts() override final;
 
             Photo::Data              getPhoto(const Photo::Id &) override final;
+            std::vector<Photo::Data> getPhotos(const std::vector<Photo::Id> &) override final;
             int                      getPhotosCount(const Filter &) override final;
+            std::map<QDate, int>     datesHistogram(const Filter &, DatesResolution) override final;
             void                     set(const Photo::Id &, const QString &, int) override final;
             std::optional<int>       get(const Photo::Id &, const QString &) override final;
 
@@ -153,6 +181,12 @@ namespace Database
             // general helpers
             BackendStatus checkStructure();
             Database::BackendStatus checkDBVersion();
+            Database::BackendStatus upgradeV5ToV6();
+            Database::BackendStatus upgradeV6ToV7();
+            Database::BackendStatus upgradeV7ToV8();
+            Database::BackendStatus upgradeV8ToV9();
+            Database::BackendStatus upgradeV9ToV10();
+            Database::BackendStatus upgradeV10ToV11();
             bool updateOrInsert(const UpdateQueryData &) const;
 
             // helpers for sql operations
@@ -169,8 +203,12 @@ namespace Database
             bool storeGeometryFor(const Photo::Id &, const QSize &) const;
             bool storeSha256(int photo_id, const Photo::Sha256sum &) const;
             bool storeTags(int photo_id, const Tag::TagsList &) const;
+            bool storeTagsChanges(const Photo::Id &, const Tag::TagsList &) const;
             bool storeFlags(const Photo::Id &, const Photo::FlagValues &) const;
+            bool storeFlagsChanges(const Photo::Id &, const Photo::FlagValues &) const;
             bool storeGroup(const Photo::Id &, const GroupInfo &) const;
+            bool storeSearchTerms(const Photo::Id &, const std::set<QString> &) const;
+            bool storeDate(const Tag::TagsList& previousTags, const Tag::TagsList& tags);
 
             Tag::TagsList        getTagsFor(const Photo::Id &) const;
             QSize                getGeometryFor(const Photo::Id &) const;
@@ -179,6 +217,8 @@ namespace Database
             void    updateFlagsOn(Photo::Data &, const Photo::Id &) const;
             QString getPathFor(const Photo::Id &) const;
             bool doesPhotoExist(const Photo::Id &) const;
+            std::vector<Photo::Data> getPhotosData(std::vector<Photo::Id>::const_iterator,
+                                                   std::vector<Photo::Id>::const_iterator) const;
     };
 }
 
@@ -21,6 +21,8 @@
 
 #include <QStringList>
 
+#include <core/constants.hpp>
+
 #include "tables.hpp"
 
 
@@ -36,6 +38,38 @@ namespace Database
             else
                 return "tags.value";
         }
+
+        // smallest string greater than all strings starting with prefix.
+        // Null string is returned when there is no such string or it cannot be encoded
+        // (prefix ends with U+FFFF, the last code point or with a lone surrogate).
+        QString prefixEnd(const QString& prefix)
+        {
+            if (prefix.isEmpty())
+                return {};
+
+            const int last = prefix.size() - 1;
+            const QChar lastChar = prefix[last];
+
+            if (lastChar.isLowSurrogate() && last > 0 && prefix[last - 1].isHighSurrogate())
+            {
+                const uint codePoint = QChar::surrogateToUcs4(prefix[last - 1], lastChar);
+
+                if (codePoint == QChar::LastValidCodePoint)
+                    return {};
+
+                const uint next = codePoint + 1;
+
+                return prefix.left(last - 1) + QString::fromUcs4(&next, 1);
+            }
+
+            if (lastChar.isSurrogate() || lastChar.unicode() == 0xFFFF)
+                return {};
+
+            // there are no characters between U+D7FF and U+E000 (surrogates are not characters)
+            const ushort next = lastChar.unicode() == 0xD7FF? 0xE000: lastChar.unicode() + 1;
+
+            return prefix.left(last) + QChar(next);
+        }
     }
 
     SqlFilterQueryGenerator::SqlFilterQueryGenerator()
@@ -218,7 +252,7 @@ namespace Database
     {
         assert(sha256.sha256.isEmpty() == false);
 
-        return QString("SELECT id FROM %1 JOIN (%2) ON (%2.photo_id = %1.id) WHERE %2.sha256 = '%3'")
+        return QString("SELECT %1.id FROM %1 JOIN (%2) ON (%2.photo_id = %1.id) WHERE %2.sha256 = '%3'")
                 .arg(TAB_PHOTOS)
                 .arg(TAB_SHA256SUMS)
                 .arg(sha256.sha256.constData());
@@ -243,59 +277,64 @@ namespace Database
 
     QString SqlFilterQueryGenerator::visit(const FilterPhotosMatchingExpression& filter) const
     {
-        const SearchExpressionEvaluator::Expression conditions = filter.expression;
-        const std::size_t s = conditions.size();
-
-        QString tags_conditions;
-        QString people_conditions;
+        QStringList conditions;
 
-        for(std::size_t i = 0; i < s; i++)
+        for(const SearchExpressionEvaluator::Filter& condition: filter.expression)
         {
-            const QString condition = conditions[i].m_value;
+            QString tags_condition;
+            QString people_condition;
 
-            if (conditions[i].m_exact)
+            if (condition.m_exact)
             {
-                tags_conditions += QString("%1.value = '%2'")
-                                        .arg(TAB_TAGS)
-                                        .arg(condition);
+                QString value = condition.m_value;
+                value.replace("'", "''");
 
-                people_conditions += QString("%1.name = '%2'")
-                                            .arg(TAB_PEOPLE_NAMES)
-                                            .arg(condition);
+                tags_condition = QString("%1.id IN (SELECT %2.photo_id FROM %2 WHERE %2.value = '%3')")
+                                    .arg(TAB_PHOTOS, TAB_TAGS, value);
+
+                people_condition = QString("%1.name = '%2'")
+                                    .arg(TAB_PEOPLE_NAMES, value);
             }
             else
             {
-                tags_conditions += QString("%1.value LIKE '%%2%'")
-                                        .arg(TAB_TAGS)
-                                        .arg(condition);
+                // each word of condition needs to be a beginning of some indexed word
+                QStringList terms_conditions;
+                QStringList names_conditions;
 
-                people_conditions += QString("%1.name LIKE '%%2%'")
-                                            .arg(TAB_PEOPLE_NAMES)
-                                            .arg(condition);
-            }
+                for(const QString& word: SearchExpressionEvaluator::terms(condition.m_value))
+                {
+                    const QString term = word.left(ConfigConsts::Constraints::database_search_term_len);
+                    const QString termEnd = prefixEnd(term);
 
-            if (i + 1 < s)
-            {
-                tags_conditions += " OR ";
-                people_conditions += " OR ";
+                    // without upper bound range is open and LIKE drops terms not starting with prefix
+                    // (terms consist of letters and numbers only, so there is nothing to escape)
+                    const QString range = termEnd.isNull()?
+                        QString("%1.term >= '%2' AND %1.term LIKE '%2%'").arg(TAB_SEARCH_TERMS, term):
+                        QString("%1.term >= '%2' AND %1.term < '%3'").arg(TAB_SEARCH_TERMS, term, termEnd);
+
+                    terms_conditions.append(QString("%1.id IN (SELECT %2.photo_id FROM %2 WHERE %3)")
+                                                .arg(TAB_PHOTOS, TAB_SEARCH_TERMS, range));
+
+                    names_conditions.append(QString("(%1.name LIKE '%2%' OR %1.name LIKE '% %2%')")
+                                                .arg(TAB_PEOPLE_NAMES, term));
+                }
+
+                if (terms_conditions.isEmpty())
+                    continue;
+
+                tags_condition = terms_conditions.join(" AND ");
+                people_condition = names_conditions.join(" AND ");
             }
-        }
 
-        const QString tags_query = QString("SELECT %1.id FROM %1 JOIN (%2) ON (%1.id = %2.photo_id) WHERE (%3)")
-                                        .arg(TAB_PHOTOS)
-                                        .arg(TAB_TAGS)
-                                        .arg(tags_conditions);
+            const QString people_query = QString("SELECT %1.photo_id FROM %1 JOIN %2 ON (%1.person_id = %2.id) WHERE %3")
+                                            .arg(TAB_PEOPLE, TAB_PEOPLE_NAMES, people_condition);
 
-        const QString people_query = QString("SELECT %1.id FROM %1 JOIN (%2, %3) ON (%1.id = %2.photo_id AND %2.person_id = %3.id) WHERE (%4)")
-                                            .arg(TAB_PHOTOS)
-                                            .arg(TAB_PEOPLE)
-                                            .arg(TAB_PEOPLE_NAMES)
-                                            .arg(people_conditions);
+            conditions.append(QString("(%1) OR %2.id IN (%3)").arg(tags_condition, TAB_PHOTOS, people_query));
+        }
 
-        return QString("SELECT %1.id FROM %1 WHERE %1.id IN (%2) OR %1.id IN (%3)")
+        return QString("SELECT %1.id FROM %1 WHERE %2")
                 .arg(TAB_PHOTOS)
-                .arg(tags_query)
-                .arg(people_query);
+                .arg(conditions.isEmpty()? "0 = 1": conditions.join(" OR "));
     }
 
     QString SqlFilterQueryGenerator::visit(const FilterPhotosWithPath& filter) const
@@ -322,11 +361,13 @@ namespace Database
             break;
 
             case FilterPhotosWithRole::Role::GroupRepresentative:
-                result = QString("SELECT groups.representative_id FROM groups");
+                result = QString("SELECT %1.id FROM %1 WHERE %1.id IN (SELECT groups.representative_id FROM groups)")
+                            .arg(TAB_PHOTOS);
             break;
 
             case FilterPhotosWithRole::Role::GroupMember:
-                result = QString("SELECT groups_members.photo_id FROM groups_members");
+                result = QString("SELECT %1.id FROM %1 WHERE %1.id IN (SELECT groups_members.photo_id FROM groups_members)")
+                            .arg(TAB_PHOTOS);
             break;
         }
 
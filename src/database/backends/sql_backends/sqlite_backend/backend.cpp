@@ -17,7 +17,7 @@ namespace Database
 
     struct SQLiteBackend::Data
     {
-        Data(): m_initialized(false) {}
+        Data(ILogger* logger): m_logger(logger), m_initialized(false) {}
 
         ~Data()
         {
@@ -36,16 +36,20 @@ namespace Database
 
                 /// TODO: use some nice way for setting database name here
                 db_obj.setDatabaseName(prjInfo.databaseLocation );
+
+                if (backend->isReader())
+                    db_obj.setConnectOptions("QSQLITE_OPEN_READONLY");
             }
 
             return status;
         }
 
+        ILogger* m_logger;
         bool m_initialized;
     };
 
 
-    SQLiteBackend::SQLiteBackend(IConfiguration *, ILogger* l): ASqlBackend(l), m_data(new Data)
+    SQLiteBackend::SQLiteBackend(IConfiguration *, ILogger* l): ASqlBackend(l), m_data(new Data(l))
     {
 
     }
@@ -63,11 +67,22 @@ namespace Database
     }
 
 
+    std::unique_ptr<ASqlBackend> SQLiteBackend::construct() const
+    {
+        // WAL journal allows readers to work while writer is active
+        return std::make_unique<SQLiteBackend>(nullptr, m_data->m_logger);
+    }
+
+
     bool SQLiteBackend::dbOpened()
     {
         QSqlDatabase db = QSqlDatabase::database(getConnectionName());
         QSqlQuery query(db);
 
+        // journal mode is persistent, it was set by writer
+        if (isReader())
+            return query.exec("PRAGMA query_only = ON;") && Database::ASqlBackend::dbOpened();
+
         bool status = query.exec("PRAGMA journal_mode = WAL;");
 
         if (status)
@@ -26,6 +26,7 @@ namespace Database
         private:
             // ASqlBackend:
             virtual BackendStatus prepareDB(const ProjectInfo &) override;
+            virtual std::unique_ptr<ASqlBackend> construct() const override;
             virtual bool dbOpened() override;
             virtual const IGenericSqlQueryGenerator* getGenericQueryGenerator() const override;
 
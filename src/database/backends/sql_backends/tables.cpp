@@ -10,7 +10,7 @@ namespace Database
         //check for proper sizes
         static_assert(sizeof(int) >= 4, "int is smaller than MySQL's equivalent");
 
-        const int db_version = 5;
+        const int db_version = 11;
 
         TableDefinition
         table_versionHistory(TAB_VER,
@@ -40,7 +40,7 @@ namespace Database
                        { "value", QString("VARCHAR(%1)").arg(ConfigConsts::Constraints::database_tag_value_len) },
                        { "name", "INTEGER NOT NULL"        },
                        { "photo_id", "INTEGER NOT NULL"    },
-                       { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", ""   },
+                       { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", ""   },
                    },
                    {
                        { "tg_id", "UNIQUE INDEX", "(id)" },
@@ -55,7 +55,7 @@ namespace Database
                              { "id", "", ColDefinition::Purpose::ID                      },
                              { "photo_id", "INTEGER NOT NULL"                            },
                              { "data", "BLOB"                                            },
-                             { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
+                             { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", "" }
                          },
                          {
                              { "th_photo_id", "UNIQUE INDEX", "(photo_id)" }  //one thumbnail per photo
@@ -69,7 +69,7 @@ namespace Database
                              { "id", "", ColDefinition::Purpose::ID                      },
                              { "photo_id INTEGER NOT NULL", ""                           },
                              { "sha256 CHAR(32) NOT NULL", ""                            },
-                             { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
+                             { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", "" }
                          },
                          {
                              { "ha_photo_id", "UNIQUE INDEX", "(photo_id)" },               //one sha per photo
@@ -85,7 +85,7 @@ namespace Database
                            { "photo_id INTEGER NOT NULL", ""        },
                            { "width", "INT NOT NULL"                },
                            { "height", "INT NOT NULL"               },
-                           { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
+                           { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", "" }
                        },
                        {
                            { "g_id", "UNIQUE INDEX", "(id)"             },
@@ -105,7 +105,7 @@ namespace Database
                         { FLAG_SHA256_LOADED, "INT NOT NULL" },
                         { FLAG_THUMB_LOADED,  "INT NOT NULL" },
                         { FLAG_GEOM_LOADED,   "INT NOT NULL" },
-                        { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
+                        { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", "" }
                     },
                     {
                         { "fl_photo_id", "UNIQUE INDEX", "(photo_id)" }  //one set of flags per photo
@@ -119,7 +119,7 @@ namespace Database
                         { "id", "", ColDefinition::Purpose::ID   },
                         { "representative_id",  "INTEGER NOT NULL"     },
                         { "type",               "INTEGER"              },
-                        { "FOREIGN KEY(representative_id) REFERENCES " TAB_PHOTOS "(id)", "" }
+                        { "FOREIGN KEY(representative_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", "" }
                     }
         );
 
@@ -130,8 +130,8 @@ namespace Database
                         { "id", "", ColDefinition::Purpose::ID   },
                         { "group_id", "INTEGER NOT NULL"         },
                         { "photo_id", "INTEGER NOT NULL"         },
-                        { "FOREIGN KEY(group_id) REFERENCES " TAB_GROUPS "(id)", "" },
-                        { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", "" }
+                        { "FOREIGN KEY(group_id) REFERENCES " TAB_GROUPS "(id) ON DELETE CASCADE", "" },
+                        { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", "" }
                     }
         );
 
@@ -156,7 +156,7 @@ namespace Database
                         { "person_id", "INTEGER"               }, // may be null when only face was found but noone was assigned
                         { "fingerprint_id", "INTEGER"          }, // null if fingerprint not calculated
                         { "location", "CHAR(64)"               }, // format: (x),(y) (w)x(h); may be null if person was assigned, but we do not know location
-                        { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", ""  },
+                        { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", ""  },
                         { "FOREIGN KEY(person_id) REFERENCES " TAB_PEOPLE_NAMES "(id)", "" },
                         { "FOREIGN KEY(fingerprint_id) REFERENCES " TAB_FACES_FINGERPRINTS "(id)", "" },
                     }
@@ -177,7 +177,7 @@ namespace Database
                                 { "photo_id", "INTEGER NOT NULL"       },
                                 { "name", "CHAR(64)"                   },
                                 { "value", "INTEGER"                   },
-                                { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", ""  },
+                                { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", ""  },
                             }
         );
 
@@ -188,9 +188,79 @@ namespace Database
                                 { "photo_id", "INTEGER NOT NULL"       },
                                 { "operation", "INTEGER"               },       // add/delete/modify
                                 { "field", "INTEGER"                   },       // tag? flag? person?
-                                { "data",  QString("VARCHAR(%1)").arg(ConfigConsts::Constraints::database_tag_value_len) },
+                                { "tag_type", "INTEGER"                },       // for tags only
+                                { "old_value", QString("VARCHAR(%1)").arg(ConfigConsts::Constraints::database_tag_value_len) },   // NULL for additions
+                                { "new_value", QString("VARCHAR(%1)").arg(ConfigConsts::Constraints::database_tag_value_len) },   // NULL for removals
                                 { "date", "TIMESTAMP NOT NULL"         },
-                                { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id)", ""  },
+                                { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", ""  },
+                            },
+                            {
+                                { "pcl_photo_id", "INDEX", "(photo_id)" },
+                                { "pcl_date", "INDEX", "(date)" },
+                            }
+        );
+
+        // words of photo's path and tags used by text search
+        TableDefinition
+        table_search_terms(TAB_SEARCH_TERMS,
+                            {
+                                { "id", "", ColDefinition::Purpose::ID },
+                                { "photo_id", "INTEGER NOT NULL"       },
+                                { "term", QString("VARCHAR(%1) NOT NULL").arg(ConfigConsts::Constraints::database_search_term_len) },
+                                { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", ""  },
+                            },
+                            {
+                                { "st_photo_id", "INDEX", "(photo_id)" },
+                                { "st_term", "INDEX", "(term, photo_id)" },   // covering index for prefix searches
+                            }
+        );
+
+        // number of photos with given date. Maintained for quick access to timeline
+        TableDefinition
+        table_photos_per_day(TAB_PHOTOS_PER_DAY,
+                            {
+                                { "id", "", ColDefinition::Purpose::ID },
+                                { "day", "CHAR(10) NOT NULL"           },       // raw value of date tag
+                                { "photos", "INTEGER NOT NULL"         },
+                            },
+                            {
+                                { "ppd_day", "UNIQUE INDEX", "(day)" },
+                            }
+        );
+
+        // exif data used by tools, so files do not need to be read again
+        TableDefinition
+        table_exif_features(TAB_EXIF_FEATURES,
+                            {
+                                { "id", "", ColDefinition::Purpose::ID },
+                                { "photo_id", "INTEGER NOT NULL"       },
+                                { "sequence_number", "INTEGER"         },
+                                { "exposure", "FLOAT"                  },
+                                { "orientation", "INTEGER"             },
+                                { "sub_second_time", "INTEGER"         },
+                                { "camera_make", "VARCHAR(128)"        },
+                                { "camera_model", "VARCHAR(128)"       },
+                                { "camera_serial_number", "VARCHAR(128)" },
+                                { "file_size", "BIGINT NOT NULL"       },       // file state features were read from
+                                { "file_modified", "BIGINT NOT NULL"   },
+                                { "FOREIGN KEY(photo_id) REFERENCES " TAB_PHOTOS "(id) ON DELETE CASCADE", ""  },
+                            },
+                            {
+                                { "ef_photo_id", "UNIQUE INDEX", "(photo_id)" },    // one set of features per photo
+                            }
+        );
+
+        // average fingerprint of each person. Maintained for quick faces recognition
+        TableDefinition
+        table_people_centroids(TAB_PEOPLE_CENTROIDS,
+                            {
+                                { "id", "", ColDefinition::Purpose::ID },
+                                { "person_id", "INTEGER NOT NULL"      },
+                                { "fingerprint", "BLOB"                },
+                                { "FOREIGN KEY(person_id) REFERENCES " TAB_PEOPLE_NAMES "(id)", ""  },
+                            },
+                            {
+                                { "pc_person_id", "UNIQUE INDEX", "(person_id)" },  // one centroid per person
                             }
         );
 
@@ -211,5 +281,9 @@ namespace Database
             { TAB_FACES_FINGERPRINTS,   table_faces_fingerprints },
             { TAB_GENERAL_FLAGS,        table_general_flags },
             { TAB_PHOTOS_CHANGE_LOG,    table_photos_change_log },
+            { TAB_SEARCH_TERMS,         table_search_terms },
+            { TAB_PHOTOS_PER_DAY,       table_photos_per_day },
+            { TAB_EXIF_FEATURES,        table_exif_features },
+            { TAB_PEOPLE_CENTROIDS,     table_people_centroids },
         };
 }
@@ -19,6 +19,10 @@
 #define TAB_FACES_FINGERPRINTS   "faces_fingerprints"
 #define TAB_GENERAL_FLAGS        "general_flags"
 #define TAB_PHOTOS_CHANGE_LOG    "photos_change_log"
+#define TAB_SEARCH_TERMS         "search_terms"
+#define TAB_PHOTOS_PER_DAY       "photos_per_day"
+#define TAB_EXIF_FEATURES        "exif_features"
+#define TAB_PEOPLE_CENTROIDS     "people_centroids"
 
 #define FLAG_STAGING_AREA  "staging_area"
 #define FLAG_TAGS_LOADED   "tags_loaded"
@@ -14,6 +14,7 @@ addTestTarget(database_backends
                     # memory backend linked
 
                     # other sql stuff
+                    backends/sql_backends/exif_features_operator.cpp
                     backends/sql_backends/generic_sql_query_constructor.cpp
                     backends/sql_backends/group_operator.cpp
                     backends/sql_backends/people_information_accessor.cpp
@@ -28,13 +29,19 @@ addTestTarget(database_backends
                     backends/sql_backends/transaction.cpp
 
                     # sql tests:
+                    unit_tests_for_backends/backends_comparison_tests.cpp
                     unit_tests_for_backends/common.hpp
+                    unit_tests_for_backends/concurrent_updates_tests.cpp
+                    unit_tests_for_backends/exif_features_tests.cpp
+                    unit_tests_for_backends/foreign_keys_tests.cpp
                     unit_tests_for_backends/general_flags_tests.cpp
                     unit_tests_for_backends/groups_tests.cpp
+                    unit_tests_for_backends/migration_tests.cpp
                     unit_tests_for_backends/people_tests.cpp
                     unit_tests_for_backends/photo_operator_tests.cpp
                     unit_tests_for_backends/photos_change_log_tests.cpp
                     unit_tests_for_backends/photos_tests.cpp
+                    unit_tests_for_backends/readers_tests.cpp
                     unit_tests_for_backends/tags_tests.cpp
 
                     # dependencies
@@ -8,15 +8,19 @@ addTestTarget(database
                     backends/sql_backends/generic_sql_query_constructor.cpp
                     backends/sql_backends/sql_filter_query_generator.cpp
                     backends/sql_backends/query_structs.cpp
+                    database_tools/implementation/cached_exif_reader.cpp
                     database_tools/implementation/json_to_backend.cpp
                     database_tools/implementation/series_detector.cpp
                     implementation/aphoto_change_log_operator.cpp
+                    implementation/async_database.cpp
                     implementation/filter.cpp
                     implementation/photo_data.cpp
                     implementation/photo_info.cpp
                     # memory backend linked
 
                     # tests:
+                    unit_tests/async_database_tests.cpp
+                    unit_tests/cached_exif_reader_tests.cpp
                     unit_tests/data_delta_tests.cpp
                     unit_tests/db_error_tests.cpp
                     unit_tests/generic_sql_query_constructor_tests.cpp
@@ -0,0 +1,76 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2020  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CACHED_EXIF_READER_HPP
+#define CACHED_EXIF_READER_HPP
+
+#include <map>
+
+#include <QHash>
+
+#include <core/iexif_reader.hpp>
+#include <database/iexif_features_operator.hpp>
+#include <database/photo_data.hpp>
+#include <database_export.h>
+
+
+/// read features of file
+DATABASE_EXPORT Database::ExifFeatures readExifFeatures(IExifReader &, const QString& path);
+
+/// check if features were read from current version of file
+DATABASE_EXPORT bool exifFeaturesUpToDate(const Database::ExifFeatures &, const QString& path);
+
+
+/**
+ * \brief IExifReader using features stored in database
+ *
+ * Data available in Database::ExifFeatures is taken from stored features.
+ * Files with no features (or changed since features were read)
+ * are read with provided reader. Such refreshed features are collected
+ * so they can be stored in database for the next time.
+ */
+class DATABASE_EXPORT CachedExifReader: public IExifReader
+{
+    public:
+        CachedExifReader(IExifReader &,
+                         const std::vector<Photo::Data> &,
+                         const std::map<Photo::Id, Database::ExifFeatures> &);
+
+        bool hasExif(const QString& path) override;
+        Tag::TagsList getTagsFor(const QString& path) override;
+        std::optional<std::any> get(const QString& path, const TagType &) override;
+
+        /// features which were read from files
+        const std::map<Photo::Id, Database::ExifFeatures>& refreshed() const;
+
+    private:
+        struct Entry
+        {
+            Photo::Id id;
+            std::optional<Database::ExifFeatures> features;
+            bool verified = false;
+        };
+
+        IExifReader& m_reader;
+        QHash<QString, Entry> m_entries;
+        std::map<Photo::Id, Database::ExifFeatures> m_refreshed;
+
+        const Database::ExifFeatures& features(const QString& path, Entry &);
+};
+
+#endif
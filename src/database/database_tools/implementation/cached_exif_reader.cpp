@@ -0,0 +1,179 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2020  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../cached_exif_reader.hpp"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+
+namespace
+{
+    template<typename T>
+    std::optional<T> readTag(IExifReader& exif, const QString& path, IExifReader::TagType type)
+    {
+        const std::optional<std::any> value = exif.get(path, type);
+        std::optional<T> result;
+
+        if (value.has_value())
+            if (const T* v = std::any_cast<T>(&value.value()))
+                result = *v;
+
+        return result;
+    }
+
+    QString readString(IExifReader& exif, const QString& path, IExifReader::TagType type)
+    {
+        const std::optional<std::string> value = readTag<std::string>(exif, path, type);
+
+        return value.has_value()? QString::fromStdString(*value): QString();
+    }
+
+    template<typename T>
+    std::optional<std::any> toAny(const std::optional<T>& value)
+    {
+        std::optional<std::any> result;
+
+        if (value.has_value())
+            result = *value;
+
+        return result;
+    }
+
+    std::optional<std::any> toAny(const QString& value)
+    {
+        std::optional<std::any> result;
+
+        if (value.isEmpty() == false)
+            result = value.toStdString();
+
+        return result;
+    }
+}
+
+
+Database::ExifFeatures readExifFeatures(IExifReader& exif, const QString& path)
+{
+    const QFileInfo info(path);
+
+    Database::ExifFeatures features;
+    features.sequenceNumber = readTag<int>(exif, path, IExifReader::TagType::SequenceNumber);
+    features.exposure = readTag<float>(exif, path, IExifReader::TagType::Exposure);
+    features.orientation = readTag<int>(exif, path, IExifReader::TagType::Orientation);
+    features.subSecondTime = readTag<int>(exif, path, IExifReader::TagType::SubSecTimeOriginal);
+    features.cameraMake = readString(exif, path, IExifReader::TagType::CameraMake);
+    features.cameraModel = readString(exif, path, IExifReader::TagType::CameraModel);
+    features.cameraSerialNumber = readString(exif, path, IExifReader::TagType::CameraSerialNumber);
+    features.fileSize = info.size();
+    features.fileModified = info.lastModified().toMSecsSinceEpoch();
+
+    return features;
+}
+
+
+bool exifFeaturesUpToDate(const Database::ExifFeatures& features, const QString& path)
+{
+    const QFileInfo info(path);
+
+    return info.size() == features.fileSize &&
+           info.lastModified().toMSecsSinceEpoch() == features.fileModified;
+}
+
+
+CachedExifReader::CachedExifReader(IExifReader& reader,
+                                   const std::vector<Photo::Data>& photos,
+                                   const std::map<Photo::Id, Database::ExifFeatures>& features)
+    : m_reader(reader)
+{
+    m_entries.reserve(static_cast<int>(photos.size()));
+
+    for (const Photo::Data& photo: photos)
+    {
+        Entry& entry = m_entries[photo.path];
+        entry.id = photo.id;
+
+        auto it = features.find(photo.id);
+        if (it != features.end())
+            entry.features = it->second;
+    }
+}
+
+
+bool CachedExifReader::hasExif(const QString& path)
+{
+    return m_reader.hasExif(path);
+}
+
+
+Tag::TagsList CachedExifReader::getTagsFor(const QString& path)
+{
+    return m_reader.getTagsFor(path);
+}
+
+
+std::optional<std::any> CachedExifReader::get(const QString& path, const TagType& type)
+{
+    auto it = m_entries.find(path);
+
+    if (it == m_entries.end())
+        return m_reader.get(path, type);
+
+    const Database::ExifFeatures& data = features(path, it.value());
+
+    switch (type)
+    {
+        case TagType::SequenceNumber:       return toAny(data.sequenceNumber);
+        case TagType::Exposure:             return toAny(data.exposure);
+        case TagType::Orientation:          return toAny(data.orientation);
+        case TagType::SubSecTimeOriginal:   return toAny(data.subSecondTime);
+        case TagType::CameraMake:           return toAny(data.cameraMake);
+        case TagType::CameraModel:          return toAny(data.cameraModel);
+        case TagType::CameraSerialNumber:   return toAny(data.cameraSerialNumber);
+
+        case TagType::DateTimeOriginal:
+        case TagType::PixelXDimension:
+        case TagType::PixelYDimension:
+            break;
+    }
+
+    return m_reader.get(path, type);
+}
+
+
+const std::map<Photo::Id, Database::ExifFeatures>& CachedExifReader::refreshed() const
+{
+    return m_refreshed;
+}
+
+
+const Database::ExifFeatures& CachedExifReader::features(const QString& path, Entry& entry)
+{
+    // stored features are verified once, when used for the first time
+    if (entry.verified == false)
+    {
+        if (entry.features.has_value() == false || exifFeaturesUpToDate(*entry.features, path) == false)
+        {
+            entry.features = readExifFeatures(m_reader, path);
+            m_refreshed[entry.id] = *entry.features;
+        }
+
+        entry.verified = true;
+    }
+
+    return *entry.features;
+}
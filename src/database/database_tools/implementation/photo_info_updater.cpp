@@ -22,6 +22,7 @@
 #include <core/task_executor.hpp>
 
 #include "database/general_flags.hpp"
+#include "database/database_tools/cached_exif_reader.hpp"
 
 // TODO: unit tests
 
@@ -47,6 +48,11 @@ struct UpdaterTask: ITaskExecutor::ITask
         invokeMethod(m_updater, &PhotoInfoUpdater::applyFlags, id, generic_flag);
     }
 
+    void apply(const Photo::Id& id, const Database::ExifFeatures& features)
+    {
+        invokeMethod(m_updater, &PhotoInfoUpdater::applyExifFeatures, id, features);
+    }
+
     UpdaterTask(const UpdaterTask &) = delete;
     UpdaterTask& operator=(const UpdaterTask &) = delete;
 
@@ -91,7 +97,7 @@ namespace
 
             Photo::DataDelta delta(m_photoInfo.id);
             delta.insert<Photo::Field::Checksum>(hexHash);
-            delta.insert<Photo::Field::Flags>( {{Photo::FlagsE::Sha256Loaded, 1}} );
+            delta.setFlag(Photo::FlagsE::Sha256Loaded, 1);
 
             apply(delta);
         }
@@ -127,7 +133,7 @@ namespace
             {
                 Photo::DataDelta delta(m_photoInfo.id);
                 delta.insert<Photo::Field::Geometry>(*size);
-                delta.insert<Photo::Field::Flags>( {{Photo::FlagsE::GeometryLoaded, 1}} );
+                delta.setFlag(Photo::FlagsE::GeometryLoaded, 1);
 
                 apply(delta);
             }
@@ -170,22 +176,23 @@ namespace
 
             // merge found tags with current tags.
             const Tag::TagsList new_tags = feeder->getTagsFor(m_photoInfo.path);
-            const Tag::TagsList cur_tags = m_photoInfo.tags;
+            const Tag::TagsList& cur_tags = m_photoInfo.tags;
 
-            Tag::TagsList tags = cur_tags;
+            Photo::DataDelta delta(m_photoInfo.id);
 
             for (const auto& entry: new_tags)
             {
-                auto it = tags.find(entry.first);
+                auto it = cur_tags.find(entry.first);
 
-                if (it == tags.end())   // no such tag yet?
-                    tags.insert(entry);
+                if (it == cur_tags.end())   // no such tag yet?
+                    delta.setTag(entry.first, entry.second);
             }
 
-            Photo::DataDelta delta(m_photoInfo.id);
-            delta.insert<Photo::Field::Tags>(tags);
-            delta.insert<Photo::Field::Flags>( {{Photo::FlagsE::ExifLoaded, 1}} );
+            delta.setFlag(Photo::FlagsE::ExifLoaded, 1);
 
+            // keep exif data needed by tools (file is already loaded by reader).
+            // Features need to be applied first as delta will trigger cache flush
+            apply(m_photoInfo.id, readExifFeatures(*feeder, m_photoInfo.path));
             apply(delta);
         }
 
@@ -309,19 +316,35 @@ void PhotoInfoUpdater::applyFlags(const Photo::Id& id, const std::pair<QString,
 }
 
 
+void PhotoInfoUpdater::applyExifFeatures(const Photo::Id& id, const Database::ExifFeatures& features)
+{
+    assert(m_threadId == std::this_thread::get_id());
+
+    m_exifFeatures[id] = features;
+}
+
+
 void PhotoInfoUpdater::flushCache()
 {
     if (m_touchedPhotos.empty() == false)
     {
         m_logger->debug(QString("Sending %1 photos to update").arg(m_touchedPhotos.size()));
 
-        m_db->exec([delta = std::move(m_touchedPhotos)](Database::IBackend& db)
-        {
-            const std::vector<Photo::DataDelta> vectorOfDeltas(value_map_iterator<TouchedPhotos>(delta.cbegin()),
-                                                               value_map_iterator<TouchedPhotos>(delta.cend()));
+        const std::vector<Photo::DataDelta> vectorOfDeltas(value_map_iterator<TouchedPhotos>(m_touchedPhotos.cbegin()),
+                                                           value_map_iterator<TouchedPhotos>(m_touchedPhotos.cend()));
+
+        m_db->update(vectorOfDeltas);
+        m_touchedPhotos.clear();
+    }
 
-            db.update(vectorOfDeltas);
+    if (m_exifFeatures.empty() == false)
+    {
+        m_db->exec([features = std::move(m_exifFeatures)](Database::IBackend& backend)
+        {
+            backend.exifFeaturesOperator().storeFeatures(features);
         });
+
+        m_exifFeatures.clear();
     }
 }
 
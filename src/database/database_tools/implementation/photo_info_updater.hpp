@@ -9,6 +9,7 @@
 #include <core/exif_reader_factory.hpp>
 #include <core/itask_executor.hpp>
 #include <core/media_information.hpp>
+#include <database/iexif_features_operator.hpp>
 #include <database/iphoto_info.hpp>
 #include <database/idatabase.hpp>
 
@@ -42,6 +43,7 @@ class PhotoInfoUpdater final: public QObject
 
         MediaInformation m_mediaInformation;
         TouchedPhotos m_touchedPhotos;
+        std::map<Photo::Id, Database::ExifFeatures> m_exifFeatures;
         QTimer m_cacheFlushTimer;
         std::set<UpdaterTask *> m_tasks;
         std::mutex m_tasksMutex;
@@ -56,6 +58,7 @@ class PhotoInfoUpdater final: public QObject
         void taskFinished(UpdaterTask *);
         void apply(const Photo::DataDelta &);
         void applyFlags(const Photo::Id &, const std::pair<QString, int>& generic_flag);
+        void applyExifFeatures(const Photo::Id &, const Database::ExifFeatures &);
         void flushCache();
         void resetFlushTimer();
 
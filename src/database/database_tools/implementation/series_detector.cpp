@@ -18,8 +18,11 @@
 
 #include "../series_detector.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <tuple>
 #include <unordered_set>
-#include <QDateTime>
 
 #include <core/iexif_reader.hpp>
 #include <core/tags_utils.hpp>
@@ -29,215 +32,259 @@
 
 namespace
 {
-    class BaseGroupValidator
+    // everything detection needs to know about photo
+    struct PhotoFeatures
     {
-    public:
-        void setCurrentPhoto(const Photo::Data& d)
-        {
-            m_data = d;
-        }
-
-        Photo::Data m_data;
+        std::chrono::milliseconds timestamp;
+        std::optional<int> sequence;
+        std::optional<float> exposure;
+        std::size_t camera;                 // index of camera which took photo
+        std::size_t photo;                  // index of photo in input data
     };
 
-    template<Group::Type>
-    class GroupValidator;
+    template<typename T>
+    std::optional<T> readTag(IExifReader& exif, const QString& path, IExifReader::TagType type)
+    {
+        const std::optional<std::any> value = exif.get(path, type);
+        std::optional<T> result;
+
+        if (value.has_value())
+            if (const T* v = std::any_cast<T>(&value.value()))
+                result = *v;
+
+        return result;
+    }
 
-    template<>
-    class GroupValidator<Group::Type::Animation>: BaseGroupValidator
+    class SeriesExtractor
     {
     public:
-        GroupValidator(IExifReader& exif, const SeriesDetector::Rules &)
-            : m_exifReader(exif)
+        SeriesExtractor(IExifReader& exifReader,
+                        const std::vector<Photo::Data>& photos,
+                        const SeriesDetector::Rules& r,
+                        const SeriesDetector::ProgressCallback& progress,
+                        const SeriesDetector::CancelPredicate& cancel)
+            : m_exifReader(exifReader)
+            , m_photos(photos)
+            , m_rules(r)
+            , m_progress(progress)
+            , m_cancel(cancel)
+            , m_done(0)
+            , m_total(photos.size() * 2)        // reading of features + sweep
         {
 
         }
 
-        void setCurrentPhoto(const Photo::Data& d)
+        void extract(const SeriesDetector::CandidateCallback& callback)
         {
-            BaseGroupValidator::setCurrentPhoto(d);
-            m_sequence = m_exifReader.get(m_data.path, IExifReader::TagType::SequenceNumber);
+            readFeatures();
+            sweep(callback);
         }
 
-        bool canBePartOfGroup()
-        {
-            const bool has_exif_data = m_sequence.has_value();
-
-            if (has_exif_data)
-            {
-                const int s = std::any_cast<int>(m_sequence.value());
-                auto s_it = m_sequence_numbers.find(s);
+    private:
+        typedef std::tuple<std::string, std::string, std::string> Camera;
 
-                return s_it == m_sequence_numbers.end();
-            }
-            else
-                return false;
-        }
+        IExifReader& m_exifReader;
+        const std::vector<Photo::Data>& m_photos;
+        const SeriesDetector::Rules& m_rules;
+        const SeriesDetector::ProgressCallback& m_progress;
+        const SeriesDetector::CancelPredicate& m_cancel;
+        std::vector<PhotoFeatures> m_features;
+        std::size_t m_done;
+        const std::size_t m_total;
 
-        void accept()
+        void readFeatures()
         {
-            assert(m_sequence);
+            std::map<Camera, std::size_t> cameras;
 
-            const int s = std::any_cast<int>(m_sequence.value());
+            m_features.reserve(m_photos.size());
 
-            m_sequence_numbers.insert(s);
-        }
+            for (std::size_t i = 0; i < m_photos.size(); i++)
+            {
+                if (cancelled())
+                    return;
 
-        std::optional<std::any> m_sequence;
+                const Photo::Data& data = m_photos[i];
 
-        std::unordered_set<int> m_sequence_numbers;
-        IExifReader& m_exifReader;
-    };
+                const Camera camera(readTag<std::string>(m_exifReader, data.path, IExifReader::TagType::CameraMake).value_or(std::string()),
+                                    readTag<std::string>(m_exifReader, data.path, IExifReader::TagType::CameraModel).value_or(std::string()),
+                                    readTag<std::string>(m_exifReader, data.path, IExifReader::TagType::CameraSerialNumber).value_or(std::string()));
 
-    template<>
-    class GroupValidator<Group::Type::HDR>: GroupValidator<Group::Type::Animation>
-    {
-        typedef GroupValidator<Group::Type::Animation> Base;
+                const auto camera_it = cameras.emplace(camera, cameras.size()).first;
 
-    public:
-        GroupValidator(IExifReader& exif, const SeriesDetector::Rules& r)
-            : Base(exif, r)
-        {
+                PhotoFeatures features;
+                const std::optional<int> subSeconds = readTag<int>(m_exifReader, data.path, IExifReader::TagType::SubSecTimeOriginal);
 
-        }
+                features.timestamp = Tag::timestamp(data.tags) + std::chrono::milliseconds(subSeconds.value_or(0));
+                features.sequence = readTag<int>(m_exifReader, data.path, IExifReader::TagType::SequenceNumber);
+                features.exposure = readTag<float>(m_exifReader, data.path, IExifReader::TagType::Exposure);
+                features.camera = camera_it->second;
+                features.photo = i;
 
-        void setCurrentPhoto(const Photo::Data& d)
-        {
-            Base::setCurrentPhoto(d);
-            m_exposure = m_exifReader.get(d.path, IExifReader::TagType::Exposure);
-        }
+                m_features.push_back(features);
 
-        bool canBePartOfGroup()
-        {
-            const bool has_exif_data = Base::canBePartOfGroup() && m_exposure;
+                step(1);
+            }
 
-            if (has_exif_data)
+            // Photos come sorted by time. Keep this order but put photos of each camera together,
+            // so series taken with different cameras at the same time are not mixed.
+            std::stable_sort(m_features.begin(), m_features.end(), [](const PhotoFeatures& lhs, const PhotoFeatures& rhs)
             {
-                const int e = std::any_cast<float>(m_exposure.value());
-
-                auto e_it = m_exposures.find(e);
-
-                return e_it == m_exposures.end();
-            }
-            else
-                return false;
+                return lhs.camera < rhs.camera;
+            });
         }
 
-        void accept()
+        // All group types are checked at each position. HDR has the highest priority, then animation,
+        // generic series are the last resort. Series of lower priority end where one of higher priority begins.
+        void sweep(const SeriesDetector::CandidateCallback& callback)
         {
-            assert(m_exposure);
+            for (std::size_t i = 0; i < m_features.size();)
+            {
+                if (cancelled())
+                    return;
 
-            Base::accept();
+                Group::Type type = Group::Type::Invalid;
+                std::size_t last = i + 1;
 
-            const int e = std::any_cast<float>(m_exposure.value());
-            m_exposures.insert(e);
-        }
+                if (hdrStarts(i))
+                {
+                    type = Group::Type::HDR;
+                    last = hdrEnd(i);
+                }
+                else if (animationStarts(i))
+                {
+                    type = Group::Type::Animation;
+                    last = animationEnd(i);
+                }
+                else
+                {
+                    type = Group::Type::Generic;
+                    last = genericEnd(i);
+                }
 
-        std::optional<std::any> m_exposure;
-        std::unordered_set<float> m_exposures;
-    };
+                const std::size_t members = last - i;
 
-    template<>
-    class GroupValidator<Group::Type::Generic>: BaseGroupValidator
-    {
-    public:
-        GroupValidator(IExifReader &, const SeriesDetector::Rules& r)
-            : m_prev_stamp(0)
-            , m_rules(r)
-        {
+                if (members > 1)
+                {
+                    SeriesDetector::GroupCandidate group;
+                    group.type = type;
+                    group.members.reserve(members);
+
+                    for (std::size_t j = i; j < last; j++)
+                        group.members.push_back(m_photos[m_features[j].photo]);
 
+                    callback(group);
+                }
+
+                i = last;
+                step(members);
+            }
         }
 
-        void setCurrentPhoto(const Photo::Data& d)
+        bool sameCamera(std::size_t lhs, std::size_t rhs) const
         {
-            BaseGroupValidator::setCurrentPhoto(d);
-            m_current_stamp = Tag::timestamp(d.tags);
+            return m_features[lhs].camera == m_features[rhs].camera;
         }
 
-        bool canBePartOfGroup()
+        // photos at 'i' and 'i + 1' can start HDR series
+        bool hdrStarts(std::size_t i) const
         {
-            return m_prev_stamp.count() == 0 || m_current_stamp - m_prev_stamp <= m_rules.manualSeriesMaxGap;
+            if (i + 1 >= m_features.size() || sameCamera(i, i + 1) == false)
+                return false;
+
+            const PhotoFeatures& first = m_features[i];
+            const PhotoFeatures& second = m_features[i + 1];
+
+            return first.sequence && first.exposure && second.sequence && second.exposure &&
+                   *first.sequence != *second.sequence &&
+                   *first.exposure != *second.exposure;
         }
 
-        void accept()
+        // photos at 'i' and 'i + 1' can start animation (and 'i + 1' is not a beginning of HDR)
+        bool animationStarts(std::size_t i) const
         {
-            m_prev_stamp = m_current_stamp;
-        }
+            if (i + 1 >= m_features.size() || sameCamera(i, i + 1) == false)
+                return false;
 
-        std::chrono::milliseconds m_prev_stamp,
-                                  m_current_stamp;
-        const SeriesDetector::Rules& m_rules;
-    };
+            const PhotoFeatures& first = m_features[i];
+            const PhotoFeatures& second = m_features[i + 1];
 
-    class SeriesExtractor
-    {
-    public:
-        SeriesExtractor(Database::IBackend& backend,
-                    IExifReader& exifReader,
-                    const std::vector<Photo::Id>& photos,
-                    const SeriesDetector::Rules& r)
-            : m_backend(backend)
-            , m_exifReader(exifReader)
-            , m_rules(r)
+            return first.sequence && second.sequence &&
+                   *first.sequence != *second.sequence &&
+                   hdrStarts(i + 1) == false;
+        }
+
+        // each photo of HDR series has different sequence number and exposure
+        std::size_t hdrEnd(std::size_t i) const
         {
-            for (const Photo::Id& id: photos)
+            std::unordered_set<int> sequence_numbers;
+            std::unordered_set<float> exposures;
+
+            std::size_t j = i;
+            for (; j < m_features.size() && sameCamera(i, j); j++)
             {
-                const Photo::Data data = m_backend.getPhoto(id);
-                m_photos.push_back(data);
+                const PhotoFeatures& features = m_features[j];
+
+                if (features.sequence && features.exposure &&
+                    sequence_numbers.insert(*features.sequence).second &&
+                    exposures.insert(*features.exposure).second)
+                    continue;
+                else
+                    break;
             }
+
+            return j;
         }
 
-        template<Group::Type type>
-        std::vector<SeriesDetector::GroupCandidate> extract()
+        // each photo of animation has different sequence number
+        std::size_t animationEnd(std::size_t i) const
         {
-            std::vector<SeriesDetector::GroupCandidate> results;
+            std::unordered_set<int> sequence_numbers;
 
-            for (auto it = m_photos.begin(); it != m_photos.end();)
+            std::size_t j = i;
+            for (; j < m_features.size() && sameCamera(i, j); j++)
             {
-                SeriesDetector::GroupCandidate group;
-                group.type = type;
+                const PhotoFeatures& features = m_features[j];
 
-                GroupValidator<type> validator(m_exifReader, m_rules);
+                if (j > i && hdrStarts(j))
+                    break;
 
-                for (auto it2 = it; it2 != m_photos.end(); ++it2)
-                {
-                    const Photo::Data& data = *it2;
-
-                    validator.setCurrentPhoto(data);
+                if (features.sequence && sequence_numbers.insert(*features.sequence).second)
+                    continue;
+                else
+                    break;
+            }
 
-                    if (validator.canBePartOfGroup())
-                    {
-                        group.members.push_back(data);
-                        validator.accept();
-                    }
-                    else
-                        break;
-                }
+            return j;
+        }
 
-                const auto members = group.members.size();
+        // photos of generic series are taken one by one with limited gap
+        std::size_t genericEnd(std::size_t i) const
+        {
+            std::size_t j = i + 1;
+            for (; j < m_features.size() && sameCamera(i, j); j++)
+            {
+                if (m_features[j].timestamp - m_features[j - 1].timestamp > m_rules.manualSeriesMaxGap)
+                    break;
 
-                // each photo should have different exposure
-                if (members > 1)
-                {
-                    results.push_back(group);
+                if (hdrStarts(j) || animationStarts(j))
+                    break;
+            }
 
-                    auto first = it;
-                    auto last = first + members;
+            return j;
+        }
 
-                    it = m_photos.erase(first, last);
-                }
-                else
-                    ++it;
-            }
+        void step(std::size_t steps)
+        {
+            m_done += steps;
 
-            return results;
+            if (m_progress)
+                m_progress(m_done, m_total);
         }
 
-    private:
-        Database::IBackend& m_backend;
-        IExifReader& m_exifReader;
-        const SeriesDetector::Rules& m_rules;
-        std::deque<Photo::Data> m_photos;
+        bool cancelled() const
+        {
+            return m_cancel && m_cancel();
+        }
     };
 }
 
@@ -250,40 +297,52 @@ SeriesDetector::Rules::Rules(std::chrono::milliseconds manualSeriesMaxGap)
 
 
 SeriesDetector::SeriesDetector(Database::IBackend& backend, IExifReader* exif):
-    m_backend(backend), m_exifReader(exif)
+    m_backend(&backend), m_exifReader(exif)
 {
 
 }
 
 
-std::vector<SeriesDetector::GroupCandidate> SeriesDetector::listCandidates(const Rules& rules) const
+SeriesDetector::SeriesDetector(IExifReader* exif):
+    m_backend(nullptr), m_exifReader(exif)
 {
-    std::vector<GroupCandidate> result;
 
+}
+
+
+std::vector<Photo::Data> SeriesDetector::readCandidates(Database::IBackend& backend)
+{
     // find photos which are not part of any group
     Database::FilterPhotosWithRole group_filter(Database::FilterPhotosWithRole::Role::Regular);
-    const auto photos = m_backend.photoOperator().onPhotos( {group_filter}, Database::Actions::SortByTimestamp() );
+    const auto photos = backend.photoOperator().onPhotos( {group_filter}, Database::Actions::SortByTimestamp() );
 
-    // find groups
-    auto sequence_groups = analyze_photos(photos, rules);
-
-    return sequence_groups;
+    return backend.getPhotos(photos);
 }
 
 
-std::vector<SeriesDetector::GroupCandidate> SeriesDetector::analyze_photos(const std::vector<Photo::Id>& photos,
-                                                                           const Rules& rules) const
+std::vector<SeriesDetector::GroupCandidate> SeriesDetector::listCandidates(const Rules& rules) const
 {
-    SeriesExtractor extractor(m_backend, *m_exifReader, photos, rules);
+    assert(m_backend != nullptr);
 
-    auto hdrs = extractor.extract<Group::Type::HDR>();
-    auto animations = extractor.extract<Group::Type::Animation>();
-    auto generics = extractor.extract<Group::Type::Generic>();
+    std::vector<GroupCandidate> result;
 
-    std::vector<SeriesDetector::GroupCandidate> sequences;
-    std::copy(hdrs.begin(), hdrs.end(), std::back_inserter(sequences));
-    std::copy(animations.begin(), animations.end(), std::back_inserter(sequences));
-    std::copy(generics.begin(), generics.end(), std::back_inserter(sequences));
+    const std::vector<Photo::Data> photos = readCandidates(*m_backend);
 
-    return sequences;
+    listCandidates(photos, rules, [&result](const GroupCandidate& candidate)
+    {
+        result.push_back(candidate);
+    });
+
+    return result;
+}
+
+
+void SeriesDetector::listCandidates(const std::vector<Photo::Data>& photos,
+                                    const Rules& rules,
+                                    const CandidateCallback& callback,
+                                    const ProgressCallback& progress,
+                                    const CancelPredicate& cancel) const
+{
+    SeriesExtractor extractor(*m_exifReader, photos, rules, progress, cancel);
+    extractor.extract(callback);
 }
@@ -46,6 +46,7 @@ namespace Database
             // direct reemits
             connect(&backend, &IBackend::photosRemoved, this, &SignalMapper::photosRemoved);
             connect(&backend, &IBackend::photosMarkedAsReviewed, this, &SignalMapper::photosMarkedAsReviewed);
+            connect(&backend, &IBackend::tagValuesChanged, this, &SignalMapper::tagValuesChanged);
         }
 
         m_db = db;
@@ -69,11 +70,18 @@ namespace Database
 
     void SignalMapper::i_photosModified(const std::set<Photo::Id>& ids) const
     {
+        std::vector<IPhotoInfo::Ptr> photos;
+        photos.reserve(ids.size());
+
         for (const Photo::Id& id: ids)
         {
             IPhotoInfo::Ptr photo = m_db->utils().getPhotoFor(id);
+            photos.push_back(photo);
+
             emit photoModified(photo);
         }
+
+        emit photosModified(photos);
     }
 
 }
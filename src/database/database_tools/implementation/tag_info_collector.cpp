@@ -19,16 +19,23 @@
 
 #include "../tag_info_collector.hpp"
 
-#include <memory>
+#include <QHash>
 
 #include <core/base_tags.hpp>
+#include <core/function_wrappers.hpp>
 #include "idatabase.hpp"
 
 
-TagInfoCollector::TagInfoCollector(): m_tags(), m_tags_mutex(), m_database(nullptr), m_observerId(0)
+std::size_t TagInfoCollector::TagValueHash::operator()(const TagValue& value) const
 {
-    connect(&m_mapper, &Database::SignalMapper::photoModified,
-            this,      &TagInfoCollector::photoModified);
+    return qHash(value.rawValue());
+}
+
+
+TagInfoCollector::TagInfoCollector(): m_tags(), m_tags_mutex(), m_database(nullptr), m_observerId(0), m_loaded(false)
+{
+    connect(&m_mapper, &Database::SignalMapper::tagValuesChanged,
+            this,      &TagInfoCollector::tagValuesChanged);
 }
 
 
@@ -41,10 +48,7 @@ TagInfoCollector::~TagInfoCollector()
 void TagInfoCollector::set(Database::IDatabase* db)
 {
     m_database = db;
-
-    // TODO: ADatabaseSignals doesn't emit signal when tags are changed.
-    // It would require improvements in backend (#10 and maybe #180), so for now listen for photo modifications.
-    // Github issue: #183
+    m_loaded = false;
 
     m_mapper.set(db);
     if (m_database != nullptr)
@@ -55,69 +59,121 @@ void TagInfoCollector::set(Database::IDatabase* db)
 const std::vector<TagValue>& TagInfoCollector::get(const TagTypes& info) const
 {
     std::lock_guard<std::mutex> lock(m_tags_mutex);
-    return m_tags[info];
+    return m_tags[info].values;
 }
 
 
-void TagInfoCollector::gotTagValues(const TagTypes& tagType, const std::vector<TagValue>& values)
+void TagInfoCollector::gotTagValuesCounts(const Database::TagValuesCounts& counts)
 {
+    ValuesChange added;     // not needed, whole set is being reloaded
+
     std::unique_lock<std::mutex> lock(m_tags_mutex);
-    m_tags[tagType] = values;
+    m_tags.clear();
+
+    for(const auto& [tagType, values]: counts)
+        for(const auto& [tagValue, count]: values)
+            addReferences(tagType, tagValue, count, added);
+
+    m_loaded = true;
+
     lock.unlock();
 
-    emit setOfValuesChanged(tagType);
+    for(const TagTypes& tagType: BaseTags::getAll())
+        emit setOfValuesChanged(tagType);
 }
 
 
-void TagInfoCollector::photoModified(const IPhotoInfo::Ptr& photoInfo)
+void TagInfoCollector::tagValuesChanged(const Database::TagValuesCounts& changes)
 {
-    const Tag::TagsList tags = photoInfo->getTags();
+    // Counts are read by a task executed in database's thread after changes emited before it.
+    // Both changes and counts reach this thread in the order they were sent,
+    // so changes which come before counts are already included in them.
+    if (m_loaded == false)
+        return;
 
-    // TODO: it would be nice to ask database about current set of values for all photos
-    // but it is very noisy when many photos are being updated (newly added for example).
-    // For now we just read all tags from changed photos and append their values.
+    ValuesChange added, removed;
 
     std::unique_lock<std::mutex> lock(m_tags_mutex);
 
-    for(const auto& tag: tags)
-    {
-        const TagTypes& tagType = tag.first;
-        const TagValue& tagValue = tag.second;
+    for(const auto& [tagType, values]: changes)
+        for(const auto& [tagValue, difference]: values)
+        {
+            if (difference > 0)
+                addReferences(tagType, tagValue, difference, added);
+            else if (difference < 0)
+                removeReferences(tagType, tagValue, -difference, removed);
+        }
+
+    lock.unlock();
 
-        std::vector<TagValue>& values = m_tags[tagType];
-        auto found = std::find(values.begin(), values.end(), tagValue);
+    notify(added, removed);
+}
+
+
+void TagInfoCollector::addReferences(const TagTypes& tagType, const TagValue& tagValue, int count, ValuesChange& added)
+{
+    Values& values = m_tags[tagType];
+    auto [it, inserted] = values.references.emplace(tagValue, std::make_pair(values.values.size(), 0));
 
-        if (found == values.end())
-            values.emplace_back(tagValue);
+    if (inserted)
+    {
+        values.values.push_back(tagValue);
+        added[tagType].push_back(tagValue);
     }
 
-    lock.unlock();
+    it->second.second += count;
+}
+
+
+void TagInfoCollector::removeReferences(const TagTypes& tagType, const TagValue& tagValue, int count, ValuesChange& removed)
+{
+    Values& values = m_tags[tagType];
+    auto it = values.references.find(tagValue);
+
+    if (it != values.references.end())
+    {
+        it->second.second -= count;
 
-    // send notifications
-    for(const auto& tag: tags)
-        emit setOfValuesChanged(tag.first);
+        if (it->second.second <= 0)
+        {
+            // move last value in place of removed one
+            const std::size_t pos = it->second.first;
+
+            if (pos + 1 != values.values.size())
+            {
+                values.values[pos] = std::move(values.values.back());
+                values.references[values.values[pos]].first = pos;
+            }
+
+            values.values.pop_back();
+            values.references.erase(it);
+
+            removed[tagType].push_back(tagValue);
+        }
+    }
 }
 
 
-void TagInfoCollector::updateAllTags()
+void TagInfoCollector::notify(const ValuesChange& added, const ValuesChange& removed)
 {
-    auto tagNames = BaseTags::getAll();
+    for(const auto& [tagType, values]: removed)
+        emit valuesRemoved(tagType, values);
 
-    for(const TagTypes& baseTagName: tagNames)
-        updateValuesFor(baseTagName);
+    for(const auto& [tagType, values]: added)
+        emit valuesAdded(tagType, values);
 }
 
 
-void TagInfoCollector::updateValuesFor(const TagTypes& tagType)
+void TagInfoCollector::updateAllTags()
 {
     if (m_database != nullptr)
     {
-        using namespace std::placeholders;
-        auto result = std::bind(&TagInfoCollector::gotTagValues, this, _1, _2);
-        m_database->exec([tagType, result](Database::IBackend& backend)
+        // exec() (not execRead()) keeps counts in order with changes made by other tasks
+        m_database->exec([this](Database::IBackend& backend)
         {
-            const auto values = backend.listTagValues(tagType, {});
-            result(tagType, values);
+            const Database::TagValuesCounts counts = backend.tagValuesCounts();
+
+            invokeMethod(this, &TagInfoCollector::gotTagValuesCounts, counts);
         });
     }
 }
@@ -20,7 +20,9 @@ struct DATABASE_EXPORT ITagInfoCollector: public QObject
     Q_OBJECT
 
 signals:
-    void setOfValuesChanged(const TagTypes &);
+    void setOfValuesChanged(const TagTypes &);                                  // whole set of values was reloaded
+    void valuesAdded(const TagTypes &, const std::vector<TagValue> &);          // values used by photos for the first time
+    void valuesRemoved(const TagTypes &, const std::vector<TagValue> &);        // values not used by any photo anymore
 };
 
 #endif
@@ -21,6 +21,7 @@
 
 #include <chrono>
 #include <deque>
+#include <functional>
 
 #include <database/group.hpp>
 #include <database/photo_data.hpp>
@@ -51,15 +52,30 @@ class DATABASE_EXPORT SeriesDetector
             Rules(std::chrono::milliseconds manualSeriesMaxGap = std::chrono::seconds(10));
         };
 
+        typedef std::function<void(const GroupCandidate &)> CandidateCallback;
+        typedef std::function<void(std::size_t, std::size_t)> ProgressCallback;    // number of processed steps and total number of steps
+        typedef std::function<bool()> CancelPredicate;                             // returns true when detection should be stopped
+
         SeriesDetector(Database::IBackend &, IExifReader *);
+        explicit SeriesDetector(IExifReader *);
+
+        // Read photos which can be grouped (sorted by time of take).
+        // This is the only part of detection which needs database.
+        static std::vector<Photo::Data> readCandidates(Database::IBackend &);
 
         std::vector<GroupCandidate> listCandidates(const Rules& = Rules()) const;
 
+        // Find groups among photos returned by readCandidates().
+        // Each group is reported as soon as it is found.
+        void listCandidates(const std::vector<Photo::Data> &,
+                            const Rules &,
+                            const CandidateCallback &,
+                            const ProgressCallback& = {},
+                            const CancelPredicate& = {}) const;
+
     private:
-        Database::IBackend& m_backend;
+        Database::IBackend* m_backend;
         IExifReader* m_exifReader;
-
-        std::vector<SeriesDetector::GroupCandidate> analyze_photos(const std::vector<Photo::Id> &, const Rules &) const;
 };
 
 #endif // SERIESDETECTOR_HPP
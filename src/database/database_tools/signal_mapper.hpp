@@ -22,6 +22,7 @@
 #include <QObject>
 
 #include <database/iphoto_info.hpp>
+#include <database/tag_values_counts.hpp>
 
 #include "database_export.h"
 
@@ -42,8 +43,10 @@ namespace Database
         signals:
             void photosAdded(const std::vector<IPhotoInfo::Ptr> &) const;         // emited after new photos were added to database
             void photoModified(const IPhotoInfo::Ptr &) const;                    // emited when photo updated
+            void photosModified(const std::vector<IPhotoInfo::Ptr> &) const;      // emited after photoModified() with all photos updated at once
             void photosRemoved(const std::vector<Photo::Id> &) const;             // emited after photos removal
             void photosMarkedAsReviewed(const std::vector<Photo::Id> &) const;    // emited when done with photos marking
+            void tagValuesChanged(const TagValuesCounts &) const;                 // emited when number of photos using tag values changes
 
         private:
             IDatabase* m_db;
@@ -21,11 +21,11 @@
 #define TAGINFOCOLLECTOR_HPP
 
 #include <mutex>
+#include <unordered_map>
 
 #include <database/database_tools/signal_mapper.hpp>
 
 #include "itag_info_collector.hpp"
-#include "../iphoto_info.hpp"
 #include "database_export.h"
 
 namespace Database
@@ -47,17 +47,35 @@ class DATABASE_EXPORT TagInfoCollector: public ITagInfoCollector
         const std::vector<TagValue>& get(const TagTypes &) const override;
 
     private:
+        struct TagValueHash
+        {
+            std::size_t operator()(const TagValue &) const;
+        };
+
+        // distinct values of tag with number of photos using them
+        struct Values
+        {
+            std::vector<TagValue> values;
+            std::unordered_map<TagValue, std::pair<std::size_t, int>, TagValueHash> references;     // value -> (position in values, number of photos)
+        };
+
+        typedef std::map<TagTypes, std::vector<TagValue>> ValuesChange;
+
         Database::SignalMapper m_mapper;
-        mutable std::map<TagTypes, std::vector<TagValue>> m_tags;
+        mutable std::map<TagTypes, Values> m_tags;
         mutable std::mutex m_tags_mutex;
         Database::IDatabase* m_database;
         int m_observerId;
+        bool m_loaded;                          // counts were read from database, changes can be applied
+
+        void gotTagValuesCounts(const Database::TagValuesCounts &);
+        void tagValuesChanged(const Database::TagValuesCounts &);
 
-        void gotTagValues(const TagTypes &, const std::vector<TagValue> &);
-        void photoModified(const IPhotoInfo::Ptr &);
+        void addReferences(const TagTypes &, const TagValue &, int, ValuesChange &);
+        void removeReferences(const TagTypes &, const TagValue &, int, ValuesChange &);
+        void notify(const ValuesChange& added, const ValuesChange& removed);
 
         void updateAllTags();
-        void updateValuesFor(const TagTypes &);
 };
 
 #endif // TAGINFOCOLLECTOR_H
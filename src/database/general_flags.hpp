@@ -13,6 +13,8 @@ namespace Database::CommonGeneralFlags
         Broken      = 1,                    // 1 - one or more photo parameters could not be determined (dimension, thumbnail etc)
         Missing     = 2,                    // 2 - photo file is missing
     };
+
+    const QString FacesAnalysed("faces_analysed");      // 1 - faces were looked for and their locations stored
 }
 
 #endif // GENERAL_FLAGS_HPP_INCLUDED
@@ -20,12 +20,15 @@
 #ifndef IBACKEND_HPP
 #define IBACKEND_HPP
 
+#include <map>
 #include <string>
 #include <set>
 #include <vector>
 #include <optional>
 #include <magic_enum.hpp>
 
+#include <QDate>
+
 #include <core/tag.hpp>
 
 #include "database_status.hpp"
@@ -34,6 +37,7 @@
 #include "person_data.hpp"
 #include "photo_data.hpp"
 #include "ipeople_information_accessor.hpp"
+#include "tag_values_counts.hpp"
 #include "database_export.h"
 
 
@@ -57,6 +61,7 @@ struct ILoggerFactory;
 
 namespace Database
 {
+    struct IExifFeaturesOperator;
     struct IGroupOperator;
     struct IPhotoChangeLogOperator;
     struct IPhotoOperator;
@@ -91,6 +96,13 @@ namespace Database
             }
     };
 
+    /// resolution of dates histogram
+    enum class DatesResolution
+    {
+        Day,
+        Month,          // dates are truncated to the first day of month
+    };
+
     /** \brief Low level database interface.
      *
      * It defines way of communication with database backend.\n
@@ -127,12 +139,28 @@ namespace Database
         virtual std::vector<TagValue>    listTagValues(const TagTypes &,
                                                        const Filter &) = 0;
 
+        /// count photos using each value of each tag
+        virtual TagValuesCounts          tagValuesCounts() = 0;
+
         /// get particular photo
         virtual Photo::Data              getPhoto(const Photo::Id &) = 0;
 
+        /// get many photos at once. Photos which do not exist are skipped
+        virtual std::vector<Photo::Data> getPhotos(const std::vector<Photo::Id> &) = 0;
+
         /// Count photos matching filter
         virtual int                      getPhotosCount(const Filter &) = 0;
 
+        /**
+         * \brief count photos per date
+         * \arg filter photos to be counted
+         * \arg resolution count photos per day or per month
+         * \return number of photos for each date. Photos without date are counted under invalid QDate.
+         *
+         * First and last valid dates of result give range of dates for filtered photos.
+         */
+        virtual std::map<QDate, int>     datesHistogram(const Filter &, DatesResolution) = 0;
+
         /**
          * \brief set flag for photo to given value
          * \arg id id of photo
@@ -176,6 +204,16 @@ namespace Database
         /// \brief close database connection
         virtual void closeConnections() = 0;
 
+        /**
+         * \brief create backend with read only connection to the same database
+         * \return new backend or nullptr if backend does not support concurrent readers
+         *
+         * Returned backend needs to be initialized with init() (with the same ProjectInfo)
+         * in a thread it is going to be used in. Database needs to be initialized by
+         * this backend first. Returned backend can be used simultaneously with this one.
+         */
+        virtual std::unique_ptr<IBackend> createReader() { return {}; }
+
         // TODO: a set of 'operators' which are about to replace methods above
         //       in the name of interface segregation and repository pattern (see #272 on github)
 
@@ -199,10 +237,19 @@ namespace Database
 
         virtual IPeopleInformationAccessor& peopleInformationAccessor() = 0;
 
+        /**
+         * \brief get exif features operator
+         * \return operator of exif data cached in database
+         */
+        virtual IExifFeaturesOperator& exifFeaturesOperator() = 0;
+
     signals:
         /// emited after new photos were added to database
         void photosAdded(const std::vector<Photo::Id> &);
 
+        ///< emited by update() with applied changes. Followed by photosModified()
+        void photosUpdated(const std::vector<Photo::DataDelta> &);
+
         ///< emited when photos updated
         void photosModified(const std::set<Photo::Id> &);
 
@@ -212,6 +259,9 @@ namespace Database
         ///< emited when done with photos marking
         void photosMarkedAsReviewed(const std::vector<Photo::Id> &);
 
+        ///< emited after tags of photos were changed (or photos added or removed) with differences in number of photos using each value
+        void tagValuesChanged(const TagValuesCounts &);
+
     private:
         Q_OBJECT
     };
@@ -69,6 +69,17 @@ namespace Database
             execute(std::move(task));
         }
 
+        // Run read only task. It may be run in parallel with other read only tasks
+        // on a separate connection, so it may be executed before previously queued exec() tasks.
+        template<typename Callable>
+        void execRead(Callable&& f)
+        {
+            static_assert(std::is_invocable<Callable, IBackend &>::value);
+
+            auto task = std::make_unique<Task<Callable>>(std::forward<Callable>(f));
+            executeRead(std::move(task));
+        }
+
         struct ITask
         {
             virtual ~ITask() = default;
@@ -91,6 +102,9 @@ namespace Database
             };
 
             virtual void execute(std::unique_ptr<ITask> &&) = 0;
+
+            // by default read only tasks are executed as any other task
+            virtual void executeRead(std::unique_ptr<ITask>&& task) { execute(std::move(task)); }
     };
 
     // High level utils to be used in db's thread
@@ -114,6 +128,7 @@ namespace Database
 
         // store data
         virtual void update(const Photo::DataDelta &) = 0;
+        virtual void update(const std::vector<Photo::DataDelta> &) = 0;
 
         // other
         virtual IUtils& utils() = 0;
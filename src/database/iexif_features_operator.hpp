@@ -0,0 +1,57 @@
+
+#ifndef IEXIF_FEATURES_OPERATOR_HPP
+#define IEXIF_FEATURES_OPERATOR_HPP
+
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <QString>
+
+#include "photo_types.hpp"
+
+namespace Database
+{
+    // Exif data used by tools (like series detection).
+    // Kept in database so files do not need to be opened again.
+    struct ExifFeatures
+    {
+        std::optional<int>   sequenceNumber;
+        std::optional<float> exposure;
+        std::optional<int>   orientation;
+        std::optional<int>   subSecondTime;           // milliseconds
+        QString cameraMake;
+        QString cameraModel;
+        QString cameraSerialNumber;
+
+        // state of file features were read from
+        qint64 fileSize = 0;
+        qint64 fileModified = 0;                    // milliseconds since epoch
+
+        bool operator==(const ExifFeatures& other) const
+        {
+            return sequenceNumber == other.sequenceNumber &&
+                   exposure == other.exposure &&
+                   orientation == other.orientation &&
+                   subSecondTime == other.subSecondTime &&
+                   cameraMake == other.cameraMake &&
+                   cameraModel == other.cameraModel &&
+                   cameraSerialNumber == other.cameraSerialNumber &&
+                   fileSize == other.fileSize &&
+                   fileModified == other.fileModified;
+        }
+    };
+
+    struct IExifFeaturesOperator
+    {
+        virtual ~IExifFeaturesOperator() = default;
+
+        /// store features of photos (replacing current ones)
+        virtual bool storeFeatures(const std::map<Photo::Id, ExifFeatures> &) = 0;
+
+        /// read features of photos. Photos without features are skipped
+        virtual std::map<Photo::Id, ExifFeatures> getFeatures(const std::vector<Photo::Id> &) = 0;
+    };
+}
+
+#endif
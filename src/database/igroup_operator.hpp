@@ -2,15 +2,31 @@
 #ifndef IGROUP_OPERATOR_HPP
 #define IGROUP_OPERATOR_HPP
 
+#include <vector>
+
 #include "group.hpp"
 #include "photo_types.hpp"
 
 namespace Database
 {
+    struct GroupDefinition
+    {
+        Photo::Id representative;
+        Group::Type type;
+        std::vector<Photo::Id> members;
+    };
+
     struct IGroupOperator
     {
         virtual Group::Id addGroup(const Photo::Id& representative_photo, Group::Type) = 0;
         virtual Photo::Id removeGroup(const Group::Id &) = 0;
+
+        // create many groups at once (with members). Returns ids of created groups in order of definitions
+        virtual std::vector<Group::Id> addGroups(const std::vector<GroupDefinition> &) = 0;
+
+        // remove many groups at once. Returns representatives of removed groups in order of ids
+        virtual std::vector<Photo::Id> removeGroups(const std::vector<Group::Id> &) = 0;
+
         virtual Group::Type type(const Group::Id &) const = 0;
         virtual std::vector<Photo::Id> membersOf(const Group::Id &) const = 0;
     };
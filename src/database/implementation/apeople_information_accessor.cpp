@@ -11,7 +11,10 @@ namespace Database
         PersonInfo::Id result = fd.id;
 
         if (fd.id.valid() && fd.rect.isValid() == false && fd.p_id.valid() == false)
-            dropPersonInfo(fd.id);
+        {
+            if (dropPersonInfo(fd.id) == false)
+                result = PersonInfo::Id();
+        }
         else
         {
             PersonInfo to_store = fd;
@@ -40,7 +43,10 @@ namespace Database
             }
 
             if (to_store.id.valid() && to_store.rect.isValid() == false && to_store.p_id.valid() == false)
-                dropPersonInfo(fd.id);
+            {
+                if (dropPersonInfo(fd.id) == false)
+                    result = PersonInfo::Id();
+            }
             else
                 result = storePerson(to_store);
         }
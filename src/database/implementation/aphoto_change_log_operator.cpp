@@ -3,75 +3,6 @@
 #include "core/containers_utils.hpp"
 
 
-namespace
-{
-    QString encodeTag(const TagValue& value)
-    {
-        const QString encodedValue = value.rawValue().toUtf8().toBase64();
-
-        return encodedValue;
-    }
-
-    QString encodeTag(const TagTypes& tag, const TagValue& value)
-    {
-        const QString encoded = QString("%1 %2")
-                                    .arg(tag)
-                                    .arg(encodeTag(value));
-
-        return encoded;
-    }
-
-    QString encodeTag(const TagTypes& tag, const TagValue& valueOld, const TagValue& valueNew)
-    {
-        const QString encoded = QString("%1 %2 %3")
-                                    .arg(tag)
-                                    .arg(encodeTag(valueOld))
-                                    .arg(encodeTag(valueNew));
-
-        return encoded;
-    }
-
-    QString decodeTag(const QString& encoded)
-    {
-        assert(encoded.split(" ").size() == 1);
-
-        const QByteArray array = QByteArray::fromBase64(encoded.toUtf8());
-
-        return array;
-    }
-
-    std::tuple<TagTypes, TagValue> decodeTag2(const QString& encoded)
-    {
-        const QStringList items = encoded.split(" ");
-        assert(items.size() == 2);
-
-        const QString& tagInfoStr = items.front();
-        const QString& tagValueStr = items.back();
-
-        const TagTypes tagType = static_cast<TagTypes>(tagInfoStr.toInt());
-        const QString decodedTagValue = decodeTag(tagValueStr);
-
-        return std::make_tuple(tagType, decodedTagValue);
-    }
-
-    std::tuple<TagTypes, TagValue, TagValue> decodeTag3(const QString& encoded)
-    {
-        const QStringList items = encoded.split(" ");
-        assert(items.size() == 3);
-
-        const QString& tagInfoStr = items[0];
-        const QString& oldTagValueStr = items[1];
-        const QString& newTagValueStr = items[2];
-
-        const TagTypes tagType = static_cast<TagTypes>(tagInfoStr.toInt());
-        const QString decodedOldTagValue = decodeTag(oldTagValueStr);
-        const QString decodedNewTagValue = decodeTag(newTagValueStr);
-
-        return std::make_tuple(tagType, decodedOldTagValue, decodedNewTagValue);
-    }
-}
-
-
 namespace Database
 {
 
@@ -80,10 +11,10 @@ namespace Database
         assert(currentContent.id == newContent.getId());
         const Photo::Id& id = currentContent.id;
 
-        if (newContent.has(Photo::Field::Tags))
+        if (newContent.has(Photo::Field::Tags) || newContent.has(Photo::Field::TagsChanges))
         {
             const auto& oldTags = currentContent.tags;
-            const auto& newTags = newContent.get<Photo::Field::Tags>();
+            const auto newTags = Photo::Data(currentContent).apply(newContent).tags;
 
             process(id, oldTags, newTags);
         }
@@ -98,9 +29,12 @@ namespace Database
     }
 
 
-    void APhotoChangeLogOperator::groupCreated(const Group::Id& id, const Group::Type &, const Photo::Id& representative_id)
+    void APhotoChangeLogOperator::groupCreated(const Group::Id& id, const Group::Type &, const Photo::Id& representative_id, const std::vector<Photo::Id>& members)
     {
         process(representative_id, GroupInfo(), GroupInfo(id, GroupInfo::Role::Representative));
+
+        for(const Photo::Id& ph_id: members)
+            process(ph_id, GroupInfo(), GroupInfo(id, GroupInfo::Role::Member));
     }
 
 
@@ -113,6 +47,25 @@ namespace Database
     }
 
 
+    void APhotoChangeLogOperator::flush()
+    {
+        if (m_pending.empty() == false)
+        {
+            // clear buffer even if append throws - entries belong to failed transaction then
+            std::vector<Entry> entries;
+            entries.swap(m_pending);
+
+            append(entries);
+        }
+    }
+
+
+    void APhotoChangeLogOperator::discard()
+    {
+        m_pending.clear();
+    }
+
+
     void APhotoChangeLogOperator::process(const Photo::Id& id, const Tag::TagsList& oldTags, const Tag::TagsList& newTags)
     {
         std::vector<std::pair<TagTypes, TagValue>> tagsRemoved;
@@ -125,63 +78,44 @@ namespace Database
                 std::back_inserter(tagsAdded));
 
         for(const auto& d: tagsRemoved)
-        {
-            const QString data = encodeTag(d.first, d.second);
-            append(id, Remove, Tags, data);
-        }
+            m_pending.push_back( {id, Remove, Tags, d.first, d.second.rawValue(), QString()} );
 
         for(const auto& d: tagsChanged)
-        {
-            const QString data = encodeTag(std::get<0>(d), std::get<1>(d), std::get<2>(d));
-            append(id, Modify, Tags, data);
-        }
+            m_pending.push_back( {id, Modify, Tags, std::get<0>(d), std::get<1>(d).rawValue(), std::get<2>(d).rawValue()} );
 
         for(const auto& d: tagsAdded)
-        {
-            const QString data = encodeTag(d.first, d.second);
-            append(id, Add, Tags, data);
-        }
+            m_pending.push_back( {id, Add, Tags, d.first, QString(), d.second.rawValue()} );
     }
 
 
     void APhotoChangeLogOperator::process(const Photo::Id& id, const GroupInfo& oldGroupInfo, const GroupInfo& newGroupInfo)
     {
         if (oldGroupInfo.group_id.valid() && newGroupInfo.group_id.valid())   // both valid -> modification
-        {
-            const QString data = QString("%1 %2,%3 %4")
-                                    .arg(oldGroupInfo.group_id)
-                                    .arg(newGroupInfo.group_id)
-                                    .arg(oldGroupInfo.role)
-                                    .arg(newGroupInfo.role);
-
-            append(id, Modify, Group, data);
-        }
+            m_pending.push_back( {id, Modify, Group, TagTypes::Invalid, encodeGroup(oldGroupInfo), encodeGroup(newGroupInfo)} );
         else if (oldGroupInfo.group_id.valid() && !newGroupInfo.group_id)     // only old valid -> removal
-        {
-            const QString data = QString("%1,%2")
-                                    .arg(oldGroupInfo.group_id)
-                                    .arg(oldGroupInfo.role);
-
-            append(id, Remove, Group, data);
-        }
+            m_pending.push_back( {id, Remove, Group, TagTypes::Invalid, encodeGroup(oldGroupInfo), QString()} );
         else if (!oldGroupInfo.group_id && newGroupInfo.group_id.valid())    // only new valid -> addition
-        {
-            const QString data = QString("%1,%2")
-                                    .arg(newGroupInfo.group_id)
-                                    .arg(newGroupInfo.role);
+            m_pending.push_back( {id, Add, Group, TagTypes::Invalid, QString(), encodeGroup(newGroupInfo)} );
+    }
 
-            append(id, Add, Group, data);
-        }
+
+    QString APhotoChangeLogOperator::encodeGroup(const GroupInfo& groupInfo)
+    {
+        const QString encoded = QString("%1,%2")
+                                    .arg(groupInfo.group_id)
+                                    .arg(groupInfo.role);
+
+        return encoded;
     }
 
 
-    QString APhotoChangeLogOperator::format(int photoId, Operation operation, Field field, const QString& data)
+    QString APhotoChangeLogOperator::format(const Entry& entry)
     {
         const QString result = QString("photo id: %1. %2 %3. %4")
-                                    .arg(photoId)
-                                    .arg(fieldToStr(field))
-                                    .arg(opToStr(operation))
-                                    .arg(dataToStr(field, operation, data));
+                                    .arg(entry.photoId)
+                                    .arg(fieldToStr(entry.field))
+                                    .arg(opToStr(entry.operation))
+                                    .arg(dataToStr(entry));
 
         return result;
     }
@@ -214,52 +148,47 @@ namespace Database
     }
 
 
-    QString APhotoChangeLogOperator::dataToStr(APhotoChangeLogOperator::Field field,
-                                               APhotoChangeLogOperator::Operation op,
-                                               const QString& data)
+    QString APhotoChangeLogOperator::dataToStr(const Entry& entry)
     {
         QString result;
 
-        switch(field)
+        switch(entry.field)
         {
             case Tags:
-                switch(op)
+            {
+                const TagTypeInfo tag_info(entry.tagType);
+
+                switch(entry.operation)
                 {
                     case Add:
-                    case Remove:
-                    {
-                        auto encoded = decodeTag2(data);
-                        const TagTypeInfo tag_info(std::get<0>(encoded));
-                        const TagValue& tag_value = std::get<1>(encoded);
+                        result = QString("%1: %2")
+                                    .arg(tag_info.getName())
+                                    .arg(entry.newValue);
+                        break;
 
+                    case Remove:
                         result = QString("%1: %2")
                                     .arg(tag_info.getName())
-                                    .arg(tag_value.rawValue());
-                    }
-                    break;
+                                    .arg(entry.oldValue);
+                        break;
 
                     case Modify:
-                    {
-                        auto encoded = decodeTag3(data);
-                        const TagTypeInfo tag_info(std::get<0>(encoded));
-                        const TagValue& old_tag_value = std::get<1>(encoded);
-                        const TagValue& new_tag_value = std::get<2>(encoded);
-
                         result = QString("%1: %2 -> %3")
                                     .arg(tag_info.getName())
-                                    .arg(old_tag_value.rawValue())
-                                    .arg(new_tag_value.rawValue());
-                    }
+                                    .arg(entry.oldValue)
+                                    .arg(entry.newValue);
+                        break;
                 }
                 break;
+            }
 
             case Group:
-                switch(op)
+                switch(entry.operation)
                 {
                     case Add:
                     case Remove:
                     {
-                        const QStringList id_type = data.split(",");
+                        const QStringList id_type = (entry.operation == Add? entry.newValue: entry.oldValue).split(",");
 
                         result = QString("%1: %2")
                                     .arg(id_type[0])
@@ -269,15 +198,14 @@ namespace Database
 
                     case Modify:
                     {
-                        const QStringList ids_types = data.split(",");
-                        const QStringList ids = ids_types[0].split(" ");
-                        const QStringList types = ids_types[1].split(" ");
+                        const QStringList old_id_type = entry.oldValue.split(",");
+                        const QStringList new_id_type = entry.newValue.split(",");
 
                         result = QString("%1 -> %2, %3 -> %4")
-                                    .arg(ids[0])
-                                    .arg(ids[1])
-                                    .arg(types[0])
-                                    .arg(types[1]);
+                                    .arg(old_id_type[0])
+                                    .arg(new_id_type[0])
+                                    .arg(old_id_type[1])
+                                    .arg(new_id_type[1]);
                     }
                 }
                 break;
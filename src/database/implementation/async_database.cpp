@@ -19,13 +19,19 @@
 
 #include "async_database.hpp"
 
-#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <QElapsedTimer>
 
 #include <OpenLibrary/putils/ts_queue.hpp>
 
 #include <core/down_cast.hpp>
+#include <core/map_iterator.hpp>
 #include <core/logger_factory.hpp>
 #include <core/thread_utils.hpp>
 
@@ -40,12 +46,83 @@
 
 namespace Database
 {
+    namespace
+    {
+        // SQLite in WAL mode allows many readers next to one writer
+        constexpr std::size_t ReadersCount = 2;
+
+        // max number of photos updated in one transaction by Executor
+        constexpr std::size_t GroupCommitLimit = 5000;
+    }
+
     struct IThreadTask
     {
         virtual ~IThreadTask() {}
         virtual void execute(IBackend &) = 0;
     };
 
+    // photos update. Consecutive updates are merged into one transaction by Executor
+    struct UpdateTask: IThreadTask
+    {
+        UpdateTask(const std::vector<Photo::DataDelta>& deltas, ILogger* logger):
+            m_logger(logger)
+        {
+            for (const Photo::DataDelta& delta: deltas)
+                add(delta);
+        }
+
+        void execute(IBackend& backend) override
+        {
+            if (backend.update(m_deltas))
+                return;
+
+            // whole batch was rolled back because of one broken delta (i.e. for removed photo).
+            // Store photos one by one so valid changes are not lost.
+            if (m_deltas.size() > 1)
+            {
+                m_logger->warning(QString("Update of %1 photos failed, retrying photos one by one").arg(m_deltas.size()));
+
+                for (const Photo::DataDelta& delta: m_deltas)
+                    if (backend.update({delta}) == false)
+                        m_logger->error(QString("Could not update photo with id %1").arg(delta.getId()));
+            }
+            else if (m_deltas.size() == 1)
+                m_logger->error(QString("Could not update photo with id %1").arg(m_deltas.front().getId()));
+        }
+
+        void merge(const UpdateTask& other)
+        {
+            for (const Photo::DataDelta& delta: other.m_deltas)
+                add(delta);
+        }
+
+        std::size_t size() const
+        {
+            return m_deltas.size();
+        }
+
+        private:
+            std::vector<Photo::DataDelta> m_deltas;
+            std::map<Photo::Id, std::size_t> m_positions;
+            ILogger* m_logger;
+
+            void add(const Photo::DataDelta& delta)
+            {
+                auto [it, inserted] = m_positions.emplace(delta.getId(), m_deltas.size());
+
+                if (inserted)
+                    m_deltas.push_back(delta);
+                else
+                {
+                    // newer values win, older ones fill missing fields
+                    Photo::DataDelta combined = delta;
+                    combined |= m_deltas[it->second];
+                    m_deltas[it->second] = combined;
+                }
+            }
+    };
+
+
     struct Executor
     {
         Executor(Database::IBackend& backend, ILogger* logger):
@@ -66,27 +143,18 @@ namespace Database
         {
             set_thread_name("ADatabase");
 
-            for(;;)
-            {
-                std::optional< std::unique_ptr<IThreadTask> > task = m_tasks.pop();
+            std::optional< std::unique_ptr<IThreadTask> > task = m_tasks.pop();
 
-                if (task)
-                {
-                    QElapsedTimer timer;
-                    timer.start();
+            while (task)
+            {
+                std::optional< std::unique_ptr<IThreadTask> > next;
 
-                    IThreadTask* baseTask = task->get();
-                    baseTask->execute(m_backend);
+                if (UpdateTask* update = dynamic_cast<UpdateTask *>(task->get()))
+                    next = coalesce(*update);
 
-                    const qint64 elapsed = timer.elapsed();
+                run(**task);
 
-                    if (elapsed > 300)
-                        m_logger->error("DB task took more than 300ms");
-                    else if (elapsed > 100)
-                        m_logger->warning("DB task took more than 100ms");
-                }
-                else
-                    break;
+                task = next? std::move(next): m_tasks.pop();
             }
         }
 
@@ -105,8 +173,164 @@ namespace Database
             ol::TS_Queue<std::unique_ptr<IThreadTask>> m_tasks;
             Database::IBackend& m_backend;
             std::unique_ptr<ILogger> m_logger;
+
+            void run(IThreadTask& task)
+            {
+                QElapsedTimer timer;
+                timer.start();
+
+                task.execute(m_backend);
+
+                const qint64 elapsed = timer.elapsed();
+
+                if (elapsed > 300)
+                    m_logger->error("DB task took more than 300ms");
+                else if (elapsed > 100)
+                    m_logger->warning("DB task took more than 100ms");
+            }
+
+            // Group commit: merge updates already waiting in queue into 'batch'.
+            // Does not wait for more tasks when queue is empty.
+            // Returns first task which is not an update (it needs to be run after 'batch').
+            std::optional< std::unique_ptr<IThreadTask> > coalesce(UpdateTask& batch)
+            {
+                while (batch.size() < GroupCommitLimit && m_tasks.empty() == false)
+                {
+                    std::optional< std::unique_ptr<IThreadTask> > next = m_tasks.pop_for(std::chrono::milliseconds(0));
+
+                    if (next.has_value() == false)
+                        break;
+
+                    if (UpdateTask* update = dynamic_cast<UpdateTask *>(next->get()))
+                        batch.merge(*update);
+                    else
+                        return next;
+                }
+
+                return {};
+            }
+    };
+
+
+    // Threads with read only connections to database.
+    // Used for tasks which do not need to wait for writes queued in Executor.
+    struct ReadersPool
+    {
+        ReadersPool(ILogger* logger):
+            m_tasks(1024),
+            m_logger(logger->subLogger("ReadersPool")),
+            m_ready(false),
+            m_stopped(false)
+        {
+
+        }
+
+        ReadersPool(const ReadersPool &) = delete;
+        ReadersPool& operator=(const ReadersPool &) = delete;
+
+        ~ReadersPool()
+        {
+            stop();
+        }
+
+        // run in db thread when main backend is ready
+        void start(IBackend& backend, const ProjectInfo& prjInfo, std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(m_readersMutex);
+
+            if (m_stopped)
+                return;
+
+            for (std::size_t i = 0; i < count; i++)
+            {
+                std::unique_ptr<IBackend> reader = backend.createReader();
+
+                if (reader.get() == nullptr)
+                    break;
+
+                IBackend* readerPtr = reader.get();
+                m_backends.push_back(std::move(reader));
+                m_threads.emplace_back(&ReadersPool::work, this, readerPtr, prjInfo);
+            }
+        }
+
+        void stop()
+        {
+            std::vector<std::thread> threads;
+
+            {
+                std::lock_guard<std::mutex> lock(m_readersMutex);
+                m_stopped = true;
+                m_ready = false;
+                m_tasks.stop();
+                threads.swap(m_threads);
+            }
+
+            for (std::thread& thread: threads)
+                thread.join();
+
+            m_backends.clear();
+        }
+
+        // returns false if there are no readers available
+        bool addTask(std::unique_ptr<IThreadTask>& task)
+        {
+            // nested read tasks are executed immediately (see AsyncDatabase::addTask())
+            if (t_currentReader.first == this)
+            {
+                task->execute(*t_currentReader.second);
+                return true;
+            }
+            else if (m_ready)
+            {
+                m_tasks.push(std::move(task));
+                return true;
+            }
+            else
+                return false;
+        }
+
+        private:
+            static thread_local std::pair<const ReadersPool *, IBackend *> t_currentReader;
+
+            ol::TS_Queue<std::unique_ptr<IThreadTask>> m_tasks;
+            std::vector<std::unique_ptr<IBackend>> m_backends;
+            std::vector<std::thread> m_threads;
+            std::mutex m_readersMutex;
+            std::unique_ptr<ILogger> m_logger;
+            std::atomic<bool> m_ready;
+            bool m_stopped;
+
+            void work(IBackend* backend, const ProjectInfo& prjInfo)
+            {
+                set_thread_name("ADatabaseReader");
+
+                if (backend->init(prjInfo))
+                {
+                    t_currentReader = std::make_pair(this, backend);
+                    m_ready = true;
+
+                    for(;;)
+                    {
+                        std::optional< std::unique_ptr<IThreadTask> > task = m_tasks.pop();
+
+                        if (task)
+                            (*task)->execute(*backend);
+                        else
+                            break;
+                    }
+
+                    t_currentReader = {};
+                }
+                else
+                    m_logger->error("Could not open read only connection to database");
+
+                backend->closeConnections();
+            }
     };
 
+    thread_local std::pair<const ReadersPool *, IBackend *> ReadersPool::t_currentReader;
+
 
     struct CustomAction: IThreadTask
     {
@@ -144,6 +368,7 @@ namespace Database
         m_backend(backend),
         m_storeKeeper(keeper)
     {
+        connect(backend, &IBackend::photosUpdated, this, &Utils::photosUpdated, Qt::DirectConnection);
         connect(backend, &IBackend::photosModified, this, &Utils::photosModified, Qt::DirectConnection);
     }
 
@@ -175,44 +400,92 @@ namespace Database
 
         m_cache->introduce(photoInfo);
 
-        const QString insert_msg = QString("Adding photo with id %1 to cache").arg(data.id);
-        m_logger->debug(insert_msg);
+        if (m_logger->isEnabled(ILogger::Severity::Debug))
+        {
+            const QString insert_msg = QString("Adding photo with id %1 to cache").arg(data.id);
+            m_logger->debug(insert_msg);
+        }
 
         return photoInfo;
     }
 
 
-    void Utils::photosModified(const std::set<Photo::Id>& ids)
+    void Utils::photosUpdated(const std::vector<Photo::DataDelta>& deltas)
     {
-        for (const Photo::Id& id: ids)
+        // changes are known, apply them without reading photos back from db
+        for (const Photo::DataDelta& delta: deltas)
         {
-            auto photoInfo = findInCache(id);
+            auto photoInfo = findInCache(delta.getId());
 
             if (photoInfo.get() != nullptr)
             {
-                const Photo::Data photoData = m_backend->getPhoto(id);
+                Photo::Data photoData = photoInfo->data();
+                photoData.apply(delta);
+
+                // empty tags are not stored in db
+                for (auto it = photoData.tags.begin(); it != photoData.tags.end();)
+                    if (it->second.type() == Tag::ValueType::Empty)
+                        it = photoData.tags.erase(it);
+                    else
+                        ++it;
 
                 photoInfo->setData(photoData);
             }
+
+            m_upToDate.insert(delta.getId());
         }
     }
 
 
-    IPhotoInfo::Ptr Utils::findInCache(const Photo::Id& id)
+    void Utils::photosModified(const std::set<Photo::Id>& ids)
     {
-        const QString search_msg = QString("Looking for photo with id %1 in cache").arg(id);
-        m_logger->trace(search_msg);
+        std::map<Photo::Id, IPhotoInfo::Ptr> toRefresh;
 
-        auto photoInfo = m_cache->find(id);
+        for (const Photo::Id& id: ids)
+        {
+            if (m_upToDate.find(id) != m_upToDate.end())
+                continue;
+
+            auto photoInfo = findInCache(id);
 
-        if (photoInfo.get() == nullptr)
+            if (photoInfo.get() != nullptr)
+                toRefresh.emplace(id, photoInfo);
+        }
+
+        m_upToDate.clear();
+
+        if (toRefresh.empty() == false)
         {
-            const QString result_msg = QString("Photo with id %1 not found in cache").arg(id);
-            m_logger->trace(result_msg);
+            const std::vector<Photo::Id> idsToRefresh(key_map_iterator<decltype(toRefresh)>(toRefresh.cbegin()),
+                                                      key_map_iterator<decltype(toRefresh)>(toRefresh.cend()));
+
+            // one batched read instead of getPhoto() for each photo
+            const std::vector<Photo::Data> photosData = m_backend->getPhotos(idsToRefresh);
+
+            for (const Photo::Data& photoData: photosData)
+                toRefresh[photoData.id]->setData(photoData);
         }
-        else
+    }
+
+
+    IPhotoInfo::Ptr Utils::findInCache(const Photo::Id& id)
+    {
+        const bool trace = m_logger->isEnabled(ILogger::Severity::Trace);
+
+        if (trace)
         {
-            const QString result_msg = QString("Photo with id %1 found in cache").arg(id);
+            const QString search_msg = QString("Looking for photo with id %1 in cache").arg(id);
+            m_logger->trace(search_msg);
+        }
+
+        auto photoInfo = m_cache->find(id);
+
+        if (trace)
+        {
+            const QString result_msg = photoInfo.get() == nullptr?
+                                       QString("Photo with id %1 not found in cache").arg(id):
+                                       QString("Photo with id %1 found in cache").arg(id);
+
             m_logger->trace(result_msg);
         }
 
@@ -230,6 +503,7 @@ namespace Database
         m_backend(std::move(backend)),
         m_cache(std::move(cache)),
         m_executor(std::make_unique<Executor>(*m_backend.get(), m_logger.get())),
+        m_readers(std::make_unique<ReadersPool>(m_logger.get())),
         m_utils(m_cache.get(), m_backend.get(), this, m_logger.get()),
         m_working(true)
     {
@@ -252,10 +526,13 @@ namespace Database
 
     void AsyncDatabase::init(const ProjectInfo& prjInfo, const Callback<const BackendStatus &>& callback)
     {
-        exec([prjInfo, callback](IBackend& backend)
+        exec([this, prjInfo, callback](IBackend& backend)
         {
              const Database::BackendStatus status = backend.init(prjInfo);
 
+             if (status)
+                 m_readers->start(backend, prjInfo, ReadersCount);
+
              callback(status);
         });
     }
@@ -263,11 +540,13 @@ namespace Database
 
     void AsyncDatabase::update(const Photo::DataDelta& data)
     {
-        exec([data](IBackend& backend)
-        {
-            const bool status = backend.update( {data} );
-            assert(status);
-        });
+        update(std::vector<Photo::DataDelta>({data}));
+    }
+
+
+    void AsyncDatabase::update(const std::vector<Photo::DataDelta>& data)
+    {
+        addTask(std::make_unique<UpdateTask>(data, m_logger.get()));
     }
 
 
@@ -278,6 +557,18 @@ namespace Database
     }
 
 
+    void AsyncDatabase::executeRead(std::unique_ptr<ITask>&& action)
+    {
+        std::unique_ptr<IThreadTask> task = std::make_unique<CustomAction>(std::move(action));
+
+        // tasks coming from db's thread are executed immediately by addTask()
+        const bool dbThread = std::this_thread::get_id() == m_thread.get_id();
+
+        if (dbThread || m_readers->addTask(task) == false)
+            addTask(std::move(task));
+    }
+
+
     IUtils& AsyncDatabase::utils()
     {
         return m_utils;
@@ -308,6 +599,9 @@ namespace Database
     {
         if (m_working)
         {
+            // finish read only tasks first, they may still add tasks to executor
+            m_readers->stop();
+
             // do not accept any more tasks
             m_working = false;
 
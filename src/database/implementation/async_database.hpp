@@ -33,6 +33,7 @@ struct ILogger;
 namespace Database
 {
     struct Executor;
+    struct ReadersPool;
     struct IThreadTask;
     struct IPhotoInfoCache;
 
@@ -51,7 +52,10 @@ namespace Database
             IBackend* m_backend;
             IDatabase* m_storeKeeper;
 
+            std::set<Photo::Id> m_upToDate;
+
             IPhotoInfo::Ptr constructPhotoInfo(const Photo::Data &);
+            void photosUpdated(const std::vector<Photo::DataDelta> &);
             void photosModified(const std::set<Photo::Id> &);
             IPhotoInfo::Ptr findInCache(const Photo::Id &);
     };
@@ -67,8 +71,10 @@ namespace Database
             AsyncDatabase& operator=(const AsyncDatabase &) = delete;
 
             virtual void update(const Photo::DataDelta &) override;
+            virtual void update(const std::vector<Photo::DataDelta> &) override;
 
             virtual void execute(std::unique_ptr<ITask> &&) override;
+            virtual void executeRead(std::unique_ptr<ITask> &&) override;
 
             IUtils&   utils() override;
             IBackend& backend() override;
@@ -81,6 +87,7 @@ namespace Database
             std::unique_ptr<IBackend> m_backend;
             std::unique_ptr<IPhotoInfoCache> m_cache;
             std::unique_ptr<Executor> m_executor;
+            std::unique_ptr<ReadersPool> m_readers;
             std::thread m_thread;
             Utils m_utils;
             bool m_working;
@@ -45,6 +45,17 @@ namespace Photo
         if (delta.has(Photo::Field::Path))
             path = delta.get<Photo::Field::Path>();
 
+        if (delta.has(Photo::Field::TagsChanges))
+            for (const auto& [name, value]: delta.get<Photo::Field::TagsChanges>())
+                if (value.type() == Tag::ValueType::Empty)
+                    tags.erase(name);
+                else
+                    tags.insert_or_assign(name, value);
+
+        if (delta.has(Photo::Field::FlagsChanges))
+            for (const auto& [flag, value]: delta.get<Photo::Field::FlagsChanges>())
+                flags.insert_or_assign(flag, value);
+
         return *this;
     }
 
@@ -63,6 +74,24 @@ namespace Photo
     }
 
 
+    void DataDelta::setTag(const TagTypes& name, const TagValue& value)
+    {
+        access<Field::TagsChanges>().insert_or_assign(name, value);
+    }
+
+
+    void DataDelta::clearTag(const TagTypes& name)
+    {
+        access<Field::TagsChanges>().insert_or_assign(name, TagValue());
+    }
+
+
+    void DataDelta::setFlag(Photo::FlagsE flag, int value)
+    {
+        access<Field::FlagsChanges>().insert_or_assign(flag, value);
+    }
+
+
     void DataDelta::setId(const Photo::Id& id)
     {
         assert(m_id.valid() == false);      // do we expect id to be set more than once?
@@ -109,16 +138,41 @@ namespace Photo
 
         m_id = other.m_id;
 
+        const bool hasTags = has(Field::Tags);
+        const bool hasFlags = has(Field::Flags);
+
         for(const auto& otherData: other.m_data)
         {
             if (otherData.first == Field::Flags && has(Field::Flags))
             {
-                auto& flags = std::get<DeltaTypes<Field::Flags>::Storage>(m_data[Photo::Field::Flags]);
-                const auto& otherFlags = std::get<DeltaTypes<Field::Flags>::Storage>(otherData.second);
+                auto& flags = access<Field::Flags>();
+                const auto& otherFlags = std::get<static_cast<std::size_t>(Field::Flags)>(otherData.second);
 
                 flags.insert(otherFlags.begin(), otherFlags.end());
 
             }
+            else if (otherData.first == Field::TagsChanges && hasTags)
+            {
+                // whole set of tags takes precedence over changes
+            }
+            else if (otherData.first == Field::FlagsChanges && hasFlags)
+            {
+                // whole set of flags takes precedence over changes
+            }
+            else if (otherData.first == Field::TagsChanges && has(Field::TagsChanges))
+            {
+                auto& changes = access<Field::TagsChanges>();
+                const auto& otherChanges = std::get<static_cast<std::size_t>(Field::TagsChanges)>(otherData.second);
+
+                changes.insert(otherChanges.begin(), otherChanges.end());
+            }
+            else if (otherData.first == Field::FlagsChanges && has(Field::FlagsChanges))
+            {
+                auto& changes = access<Field::FlagsChanges>();
+                const auto& otherChanges = std::get<static_cast<std::size_t>(Field::FlagsChanges)>(otherData.second);
+
+                changes.insert(otherChanges.begin(), otherChanges.end());
+            }
             else
                 m_data.insert(otherData);
         }
@@ -109,7 +109,7 @@ void PhotoInfo::setSha256(const Photo::Sha256sum& sha256)
 
     Photo::DataDelta delta(data->id);
     delta.insert<Photo::Field::Checksum>(data->sha256Sum);
-    delta.insert<Photo::Field::Flags>(data->flags);
+    delta.setFlag(Photo::FlagsE::Sha256Loaded, 1);
     m_storekeeper->update(delta);
 }
 
@@ -124,7 +124,7 @@ void PhotoInfo::setGeometry(const QSize& geometry)
 
     Photo::DataDelta delta(data->id);
     delta.insert<Photo::Field::Geometry>(data->geometry);
-    delta.insert<Photo::Field::Flags>(data->flags);
+    delta.setFlag(Photo::FlagsE::GeometryLoaded, 1);
     m_storekeeper->update(delta);
 }
 
@@ -133,15 +133,13 @@ void PhotoInfo::setTags(const Tag::TagsList& tags)
 {
     auto data = m_data.lock();
 
+    Photo::DataDelta delta(data->id);
+
     // copy only non empty tags to data->tags
-    auto data_tags_ins = std::inserter(data->tags, data->tags.end());
-    std::copy_if(tags.cbegin(), tags.cend(), data_tags_ins, [](const auto& item)
-    {
-        return item.second.type() != Tag::ValueType::Empty;
-    });
+    for (const auto& [name, value]: tags)
+        if (value.type() != Tag::ValueType::Empty && data->tags.emplace(name, value).second)
+            delta.setTag(name, value);
 
-    Photo::DataDelta delta(data->id);
-    delta.insert<Photo::Field::Tags>(data->tags);
     m_storekeeper->update(delta);
 }
 
@@ -150,13 +148,19 @@ void PhotoInfo::setTag(const TagTypes& name, const TagValue& value)
 {
     auto data = m_data.lock();
 
+    Photo::DataDelta delta(data->id);
+
     if (value.type() == Tag::ValueType::Empty)
+    {
         data->tags.erase(name);
+        delta.clearTag(name);
+    }
     else
+    {
         data->tags[name] = value;
+        delta.setTag(name, value);
+    }
 
-    Photo::DataDelta delta(data->id);
-    delta.insert<Photo::Field::Tags>(data->tags);
     m_storekeeper->update(delta);
 }
 
@@ -172,15 +176,19 @@ void PhotoInfo::setGroup(const GroupInfo& info)
 }
 
 
-void PhotoInfo::markFlag(Photo::FlagsE flag, int v)
+void PhotoInfo::apply(const Photo::DataDelta& delta)
 {
-    m_data.lock()->flags[flag] = v;
+    m_data.lock()->apply(delta);
+}
 
+
+void PhotoInfo::markFlag(Photo::FlagsE flag, int v)
+{
     auto data = m_data.lock();
     data->flags[flag] = v;
 
     Photo::DataDelta delta(data->id);
-    delta.insert<Photo::Field::Flags>(data->flags);
+    delta.setFlag(flag, v);
     m_storekeeper->update(delta);
 }
 
@@ -56,6 +56,7 @@ class PhotoInfo final: public IPhotoInfo
         void setTags(const Tag::TagsList &) override;
         void setTag(const TagTypes &, const TagValue &) override;
         void setGroup(const GroupInfo &) override;
+        void apply(const Photo::DataDelta &) override;
 
         //flags
         void markFlag(Photo::FlagsE, int) override;
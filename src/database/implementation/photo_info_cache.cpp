@@ -19,6 +19,8 @@
 
 #include "photo_info_cache.hpp"
 
+#include <algorithm>
+
 #include <core/ilogger.hpp>
 #include <core/ilogger_factory.hpp>
 #include <database/iphoto_info.hpp>
@@ -26,10 +28,17 @@
 #include <idatabase.hpp>
 
 
+namespace
+{
+    constexpr std::size_t MinPruneThreshold = 1024;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 PhotoInfoCache::PhotoInfoCache(ILogger* l):
-    m_logger(l->subLogger("PhotoInfoCache"))
+    m_logger(l->subLogger("PhotoInfoCache")),
+    m_pruneThreshold(MinPruneThreshold)
 {
 }
 
@@ -49,7 +58,7 @@ IPhotoInfo::Ptr PhotoInfoCache::find(const Photo::Id& id) const
     {
         result = it->second.lock();
 
-        if (result.get() == nullptr)
+        if (result.get() == nullptr && m_logger->isEnabled(ILogger::Severity::Debug))
         {
             const QString msg = QString("Photo with id %1 was recently used but has no clients at this moment.").arg(id);
             m_logger->debug(msg);
@@ -65,14 +74,30 @@ void PhotoInfoCache::introduce(const IPhotoInfo::Ptr& ptr)
     const auto id = ptr->getID();
 
     m_photo_cache[id] = ptr;
+
+    if (m_photo_cache.size() >= m_pruneThreshold)
+        pruneExpired();
 }
 
 
 void PhotoInfoCache::forget(const Photo::Id& id)
 {
-    auto it = m_photo_cache.find(id);
+    // entry may be already gone if photo expired and was pruned
+    m_photo_cache.erase(id);
+}
+
+
+void PhotoInfoCache::pruneExpired()
+{
+    for (auto it = m_photo_cache.begin(); it != m_photo_cache.end();)
+        if (it->second.expired())
+            it = m_photo_cache.erase(it);
+        else
+            ++it;
 
-    assert(it != m_photo_cache.end() );
+    // keep pruning cost amortized: next time when cache doubles
+    m_pruneThreshold = std::max(MinPruneThreshold, m_photo_cache.size() * 2);
 
-    m_photo_cache.erase(it);
+    if (m_logger->isEnabled(ILogger::Severity::Debug))
+        m_logger->debug(QString("Pruned expired photos. %1 photos left in cache").arg(m_photo_cache.size()));
 }
@@ -56,6 +56,11 @@ class PhotoInfoCache: public Database::IPhotoInfoCache
         // All introduced photos need (?) to be remembered here, so where won't be more than one
         // independent IPhotoInfos which could damage DB when modified in parallel.
         std::unordered_map<Photo::Id, std::weak_ptr<IPhotoInfo>, Photo::IdHash> m_photo_cache;
+
+        // cache size which triggers removal of expired entries
+        std::size_t m_pruneThreshold;
+
+        void pruneExpired();
 };
 
 #endif // PHOTOINFOMANAGER_H
@@ -0,0 +1,42 @@
+
+#include "tag_values_counts.hpp"
+
+
+namespace Database
+{
+
+    void countTagValues(TagValuesCounts& counts, const Tag::TagsList& previousTags, const Tag::TagsList& tags)
+    {
+        for (const auto& [tagType, tagValue]: previousTags)
+        {
+            auto it = tags.find(tagType);
+
+            if (it == tags.end() || it->second != tagValue)
+                countTagValue(counts, tagType, tagValue, -1);
+        }
+
+        for (const auto& [tagType, tagValue]: tags)
+        {
+            auto it = previousTags.find(tagType);
+
+            if (it == previousTags.end() || it->second != tagValue)
+                countTagValue(counts, tagType, tagValue, 1);
+        }
+    }
+
+
+    void countTagValue(TagValuesCounts& counts, const TagTypes& tagType, const TagValue& tagValue, int difference)
+    {
+        auto& values = counts[tagType];
+        const int count = values[tagValue] += difference;
+
+        if (count == 0)
+        {
+            values.erase(tagValue);
+
+            if (values.empty())
+                counts.erase(tagType);
+        }
+    }
+
+}
@@ -2,6 +2,9 @@
 #ifndef IPEOPLE_INFORMATION_ACCESOR_HPP
 #define IPEOPLE_INFORMATION_ACCESOR_HPP
 
+#include <map>
+#include <vector>
+
 #include "person_data.hpp"
 
 
@@ -28,6 +31,15 @@ namespace Database
             virtual std::vector<PersonFingerprint> fingerprintsFor(const Person::Id &) = 0;
             virtual std::map<PersonInfo::Id, PersonFingerprint> fingerprintsFor(const std::vector<PersonInfo::Id>& id) = 0;
 
+            /**
+            * \brief get average fingerprint of each person
+            * \return centroids of all people with at least one fingerprint
+            *
+            * Centroids are kept up to date when fingerprints or people are stored, \n
+            * so no fingerprints need to be read.
+            */
+            virtual std::map<Person::Id, Person::Fingerprint> peopleCentroids() = 0;
+
             /**
             * \brief Store or update person
             * \arg pn Details about person name to be stored.
@@ -50,11 +62,29 @@ namespace Database
             * then information about person is removed.                             \n
             * if \a pi has invalid id then database will be searched for exisiting  \n
             * rect or person matching information in \a pi. If found, id will be    \n
-            * updated and any not stored detail (rect or person) will be updated.
+            * updated and any not stored detail (rect or person) will be updated.   \n
+            * Invalid id is returned on error.
             */
             virtual PersonInfo::Id           store(const PersonInfo& pi) = 0;
 
+            /**
+            * \brief Store or update fingerprint
+            * \return id of fingerprint or invalid id on error
+            *
+            * Centroids of people using fingerprint are updated in the same transaction.
+            */
             virtual PersonFingerprint::Id    store(const PersonFingerprint &) = 0;
+
+            /**
+            * \brief Store results of face detection for many photos at once
+            * \arg faces locations of faces found on each photo (empty when no face was found)
+            * \return false on error (nothing is stored then)
+            *
+            * Locations overlapping with faces already stored for photo are skipped \n
+            * (so faces marked by user or detected before are not duplicated).      \n
+            * Each photo gets CommonGeneralFlags::FacesAnalysed flag set to 1.
+            */
+            virtual bool                     storeDetectedFaces(const std::map<Photo::Id, std::vector<QRect>>& faces) = 0;
     };
 }
 
@@ -65,6 +65,7 @@ struct DATABASE_EXPORT IPhotoInfo
     virtual void setTag(const TagTypes &, const TagValue &) = 0;      // set tag. if TagValue is empty, tag will be removed
     virtual void setGeometry(const QSize &) = 0;
     virtual void setGroup(const GroupInfo &) = 0;
+    virtual void apply(const Photo::DataDelta &) = 0;        // update data with delta. Delta is not stored in database
 
     //flags
     virtual void markFlag(Photo::FlagsE, int) = 0;
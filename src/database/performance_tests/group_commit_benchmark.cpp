@@ -0,0 +1,162 @@
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <core/task_executor_utils.hpp>
+#include <system/system.hpp>
+#include <unit_tests_utils/empty_logger.hpp>
+
+#include "backends/sql_backends/sqlite_backend/backend.hpp"
+#include "implementation/async_database.hpp"
+#include "implementation/photo_info_cache.hpp"
+#include "project_info.hpp"
+
+
+template<typename T>
+struct ExecutorTraits<Database::IDatabase, T>
+{
+    static void exec(Database::IDatabase* db, T&& t)
+    {
+        db->exec(std::forward<T>(t));
+    }
+};
+
+
+namespace
+{
+    constexpr int Photos = 1000;
+    constexpr int Edits = 10000;
+
+    struct Result
+    {
+        double seconds;
+        int transactions;
+    };
+
+    std::vector<Photo::Id> fill(Database::IDatabase& db)
+    {
+        return evaluate<std::vector<Photo::Id>(Database::IBackend &)>(&db, [](Database::IBackend& backend)
+        {
+            std::vector<Photo::DataDelta> photos;
+
+            for (int i = 0; i < Photos; i++)
+            {
+                Photo::DataDelta delta;
+                delta.insert<Photo::Field::Path>(QString("/some/path/photo_%1.jpeg").arg(i));
+                photos.push_back(delta);
+            }
+
+            backend.addPhotos(photos);
+
+            std::vector<Photo::Id> ids;
+            for (const auto& photo: photos)
+                ids.push_back(photo.getId());
+
+            return ids;
+        });
+    }
+
+    Photo::DataDelta tagEdit(const Photo::Id& id, int i)
+    {
+        Photo::DataDelta delta(id);
+        delta.insert<Photo::Field::Tags>({ {TagTypes::Event, TagValue(QString("event %1").arg(i))} });
+
+        return delta;
+    }
+
+    // each edit as a separate task (each one in its own transaction)
+    void editInSeparateTasks(Database::IDatabase& db, const std::vector<Photo::Id>& ids)
+    {
+        for (int i = 0; i < Edits; i++)
+            db.exec([delta = tagEdit(ids[i % ids.size()], i)](Database::IBackend& backend)
+            {
+                backend.update({delta});
+            });
+    }
+
+    // each edit through IDatabase::update (subject of group commit)
+    void editWithUpdates(Database::IDatabase& db, const std::vector<Photo::Id>& ids)
+    {
+        for (int i = 0; i < Edits; i++)
+            db.update(tagEdit(ids[i % ids.size()], i));
+    }
+
+    template<typename F>
+    Result measure(Database::IDatabase& db, const std::vector<Photo::Id>& ids, F&& edit)
+    {
+        std::atomic<int> transactions(0);
+
+        auto connection = QObject::connect(&db.backend(), &Database::IBackend::photosModified,
+                                           [&transactions](const std::set<Photo::Id> &)
+        {
+            transactions++;
+        });
+
+        const auto start = std::chrono::steady_clock::now();
+
+        edit(db, ids);
+
+        // wait for all edits to be stored
+        evaluate<bool(Database::IBackend &)>(&db, [](Database::IBackend &) { return true; });
+
+        const auto end = std::chrono::steady_clock::now();
+
+        QObject::disconnect(connection);
+
+        return { std::chrono::duration<double>(end - start).count(), transactions.load() };
+    }
+
+    void print(const char* title, const Result& result)
+    {
+        std::cout << title
+                  << Edits / result.seconds << " edits/s, "
+                  << result.transactions / result.seconds << " transactions/s ("
+                  << result.transactions << " transactions)\n";
+    }
+}
+
+
+TEST(GroupCommitBenchmark, singlePhotoTagEdits)
+{
+    auto tmpDir = System::createTmpDir("GroupCommitBenchmark", System::Confidential);
+
+    EmptyLogger logger;
+    auto backend = std::make_unique<Database::SQLiteBackend>(nullptr, &logger);
+    auto cache = std::make_unique<PhotoInfoCache>(&logger);
+    Database::AsyncDatabase db(std::move(backend), std::move(cache), &logger);
+
+    std::promise<bool> initialized;
+    db.init(Database::ProjectInfo(tmpDir->path() + "/db", "SQLite"), [&initialized](const Database::BackendStatus& status)
+    {
+        initialized.set_value(status);
+    });
+
+    ASSERT_TRUE(initialized.get_future().get());
+
+    const std::vector<Photo::Id> ids = fill(db);
+
+    const Result separate = measure(db, ids, &editInSeparateTasks);
+    const Result grouped = measure(db, ids, &editWithUpdates);
+
+    print("transaction per edit:  ", separate);
+    print("group commit:          ", grouped);
+
+    EXPECT_EQ(separate.transactions, Edits);
+    EXPECT_LT(grouped.transactions, separate.transactions);
+    EXPECT_LT(grouped.seconds, separate.seconds);
+
+    // all edits need to be visible
+    const Photo::Data last = evaluate<Photo::Data(Database::IBackend &)>(&db, [id = ids.back()](Database::IBackend& backend)
+    {
+        return backend.getPhoto(id);
+    });
+
+    const Tag::TagsList expected = { {TagTypes::Event, TagValue(QString("event %1").arg(Edits - 1))} };
+    EXPECT_EQ(last.tags, expected);
+
+    db.closeConnections();
+}
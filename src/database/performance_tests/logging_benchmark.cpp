@@ -0,0 +1,102 @@
+
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <core/logger_factory.hpp>
+#include <system/system.hpp>
+
+#include "backends/sql_backends/sqlite_backend/backend.hpp"
+#include "project_info.hpp"
+
+
+namespace
+{
+    constexpr int Photos = 1000;
+    constexpr int Calls = 1000000;
+    constexpr int Reads = 20000;
+
+    // the way trace messages were emitted before isEnabled() existed
+    void unguardedTrace(ILogger& logger, int id)
+    {
+        const QString msg = QString("Looking for photo with id %1 in cache").arg(id);
+        logger.trace(msg);
+    }
+
+    void guardedTrace(ILogger& logger, int id)
+    {
+        if (logger.isEnabled(ILogger::Severity::Trace))
+        {
+            const QString msg = QString("Looking for photo with id %1 in cache").arg(id);
+            logger.trace(msg);
+        }
+    }
+
+    template<typename F>
+    double nsPerCall(F f, int calls)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < calls; i++)
+            f(i);
+
+        const auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+    }
+}
+
+
+TEST(LoggingBenchmark, disabledTraceCallCost)
+{
+    auto tmpDir = System::createTmpDir("LoggingBenchmark", System::Confidential);
+
+    LoggerFactory factory(tmpDir->path());
+    factory.setLogingLevel(ILogger::Severity::Warning);
+
+    auto logger = factory.get("Benchmark");
+
+    const double unguarded = nsPerCall([&logger](int i) { unguardedTrace(*logger, i); }, Calls);
+    const double guarded = nsPerCall([&logger](int i) { guardedTrace(*logger, i); }, Calls);
+
+    std::cout << "disabled trace, message built:     " << unguarded << "ns per call\n";
+    std::cout << "disabled trace, isEnabled() check: " << guarded << "ns per call\n";
+
+    EXPECT_LT(guarded, unguarded);
+}
+
+
+TEST(LoggingBenchmark, photoReadsWithTraceDisabled)
+{
+    auto tmpDir = System::createTmpDir("LoggingBenchmark", System::Confidential);
+
+    LoggerFactory factory(tmpDir->path());
+    factory.setLogingLevel(ILogger::Severity::Warning);
+
+    auto logger = factory.get("Benchmark");
+    Database::SQLiteBackend backend(nullptr, logger.get());
+
+    const QString dbDir = tmpDir->path() + "/db";
+    QDir().mkdir(dbDir);
+    ASSERT_TRUE(backend.init(Database::ProjectInfo(dbDir + "/db", "SQLite")));
+
+    std::vector<Photo::DataDelta> photos;
+    for (int i = 0; i < Photos; i++)
+    {
+        Photo::DataDelta delta;
+        delta.insert<Photo::Field::Path>(QString("/some/path/photo_%1.jpeg").arg(i));
+        photos.push_back(delta);
+    }
+
+    ASSERT_TRUE(backend.addPhotos(photos));
+
+    const double perRead = nsPerCall([&backend, &photos](int i)
+    {
+        backend.getPhoto(photos[i % Photos].getId());
+    }, Reads);
+
+    std::cout << "getPhoto() with trace disabled: " << perRead / 1000 << "us per call\n";
+
+    backend.closeConnections();
+}
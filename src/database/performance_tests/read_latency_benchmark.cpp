@@ -0,0 +1,131 @@
+
+#include <chrono>
+#include <future>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <core/task_executor_utils.hpp>
+#include <system/system.hpp>
+#include <unit_tests_utils/empty_logger.hpp>
+
+#include "backends/sql_backends/sqlite_backend/backend.hpp"
+#include "implementation/async_database.hpp"
+#include "implementation/photo_info_cache.hpp"
+#include "project_info.hpp"
+
+
+template<typename T>
+struct ExecutorTraits<Database::IDatabase, T>
+{
+    static void exec(Database::IDatabase* db, T&& t)
+    {
+        db->exec(std::forward<T>(t));
+    }
+};
+
+
+namespace
+{
+    constexpr int Photos = 20000;
+
+    std::vector<Photo::Id> fill(Database::IDatabase& db)
+    {
+        return evaluate<std::vector<Photo::Id>(Database::IBackend &)>(&db, [](Database::IBackend& backend)
+        {
+            std::vector<Photo::DataDelta> photos;
+
+            for (int i = 0; i < Photos; i++)
+            {
+                Photo::DataDelta delta;
+                delta.insert<Photo::Field::Path>(QString("/some/path/photo_%1.jpeg").arg(i));
+                photos.push_back(delta);
+            }
+
+            backend.addPhotos(photos);
+
+            std::vector<Photo::Id> ids;
+            for (const auto& photo: photos)
+                ids.push_back(photo.getId());
+
+            return ids;
+        });
+    }
+
+    // time between read request and its result while long write is in progress
+    double readLatency(Database::IDatabase& db, const std::vector<Photo::Id>& ids, bool readOnlyTask)
+    {
+        std::promise<void> writeStarted;
+
+        db.exec([&writeStarted, ids](Database::IBackend& backend)
+        {
+            std::vector<Photo::DataDelta> deltas;
+
+            for (const Photo::Id& id: ids)
+            {
+                Photo::DataDelta delta(id);
+                delta.insert<Photo::Field::Tags>({ {TagTypes::Event, TagValue(QString("event %1").arg(id.value()))} });
+                deltas.push_back(delta);
+            }
+
+            writeStarted.set_value();
+            backend.update(deltas);
+        });
+
+        writeStarted.get_future().wait();
+
+        std::promise<void> readDone;
+        auto read = [&readDone, id = ids.front()](Database::IBackend& backend)
+        {
+            backend.getPhoto(id);
+            readDone.set_value();
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+
+        if (readOnlyTask)
+            db.execRead(read);
+        else
+            db.exec(read);
+
+        readDone.get_future().wait();
+
+        const auto end = std::chrono::steady_clock::now();
+
+        // wait for write to finish
+        evaluate<bool(Database::IBackend &)>(&db, [](Database::IBackend &) { return true; });
+
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+
+TEST(ReadLatencyBenchmark, readDuringLongWrite)
+{
+    auto tmpDir = System::createTmpDir("ReadLatencyBenchmark", System::Confidential);
+
+    EmptyLogger logger;
+    auto backend = std::make_unique<Database::SQLiteBackend>(nullptr, &logger);
+    auto cache = std::make_unique<PhotoInfoCache>(&logger);
+    Database::AsyncDatabase db(std::move(backend), std::move(cache), &logger);
+
+    std::promise<bool> initialized;
+    db.init(Database::ProjectInfo(tmpDir->path() + "/db", "SQLite"), [&initialized](const Database::BackendStatus& status)
+    {
+        initialized.set_value(status);
+    });
+
+    ASSERT_TRUE(initialized.get_future().get());
+
+    const std::vector<Photo::Id> ids = fill(db);
+
+    const double serialized = readLatency(db, ids, false);
+    const double concurrent = readLatency(db, ids, true);
+
+    std::cout << "read queued behind write:      " << serialized << "ms\n";
+    std::cout << "read on read only connection:  " << concurrent << "ms\n";
+
+    EXPECT_LT(concurrent, serialized);
+
+    db.closeConnections();
+}
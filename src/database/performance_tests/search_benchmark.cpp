@@ -0,0 +1,92 @@
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <core/search_expression_evaluator.hpp>
+#include <system/system.hpp>
+#include <unit_tests_utils/empty_logger.hpp>
+
+#include "backends/sql_backends/sqlite_backend/backend.hpp"
+#include "project_info.hpp"
+
+
+namespace
+{
+    constexpr int Photos = 300000;
+    constexpr int Repetitions = 10;
+
+    // time limit for results of one keystroke
+    constexpr double KeystrokeLimit = 50.0;
+
+    const QStringList Events = { "Birthday party", "Holiday", "Wedding", "Trip to mountains", "Christmas" };
+    const QStringList Places = { "Warsaw", "Cracow", "Gdansk", "Berlin", "Prague", "Vienna", "Paris" };
+
+    void fill(Database::IBackend& backend)
+    {
+        std::vector<Photo::DataDelta> photos;
+        photos.reserve(Photos);
+
+        for (int i = 0; i < Photos; i++)
+        {
+            Photo::DataDelta delta;
+            delta.insert<Photo::Field::Path>(QString("/photos/%1/album_%2/img_%3.jpeg").arg(2000 + i % 20).arg(i % 1000).arg(i));
+            delta.insert<Photo::Field::Tags>({
+                {TagTypes::Event, TagValue(QString("%1 %2").arg(Events[i % Events.size()]).arg(i % 100))},
+                {TagTypes::Place, TagValue(Places[i % Places.size()])}
+            });
+
+            photos.push_back(delta);
+        }
+
+        backend.addPhotos(photos);
+    }
+
+    // average time of search for each prefix of text (as if it was typed)
+    double typing(Database::IBackend& backend, const QString& text)
+    {
+        const SearchExpressionEvaluator evaluator(",");
+        double total = 0.0;
+
+        for (int i = 1; i <= text.size(); i++)
+        {
+            const Database::FilterPhotosMatchingExpression filter(evaluator.evaluate(text.left(i)));
+
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int r = 0; r < Repetitions; r++)
+                backend.photoOperator().getPhotos(filter);
+
+            const auto end = std::chrono::steady_clock::now();
+
+            total += std::chrono::duration<double, std::milli>(end - start).count() / Repetitions;
+        }
+
+        return total / text.size();
+    }
+}
+
+
+TEST(SearchBenchmark, keystrokeToResults)
+{
+    auto tmpDir = System::createTmpDir("SearchBenchmark", System::Confidential);
+
+    EmptyLogger logger;
+    std::unique_ptr<Database::IBackend> backend = std::make_unique<Database::SQLiteBackend>(nullptr, &logger);
+    ASSERT_TRUE(backend->init(Database::ProjectInfo(tmpDir->path() + "/db", "SQLite")));
+
+    fill(*backend);
+
+    for (const QString& text: { "wedding", "party warsaw", "album_12", "trip 2015" })
+    {
+        const double keystroke = typing(*backend, text);
+
+        std::cout << "searching for '" << text.toStdString() << "': " << keystroke << " ms per keystroke\n";
+
+        EXPECT_LT(keystroke, KeystrokeLimit);
+    }
+
+    backend->closeConnections();
+}
@@ -0,0 +1,151 @@
+
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+#include <QDateTime>
+
+#include <core/iexif_reader.hpp>
+
+#include "database_tools/series_detector.hpp"
+
+
+namespace
+{
+    constexpr int Photos = 300000;
+    constexpr int Cameras = 3;
+
+    struct ExifData
+    {
+        std::optional<int> sequence;
+        std::optional<float> exposure;
+        std::string model;
+    };
+
+    // exif data kept in memory, photo's path is an index
+    class GeneratedExifReader: public IExifReader
+    {
+    public:
+        explicit GeneratedExifReader(const std::vector<ExifData>& data)
+            : m_data(data)
+        {
+
+        }
+
+        bool hasExif(const QString &) override
+        {
+            return true;
+        }
+
+        Tag::TagsList getTagsFor(const QString &) override
+        {
+            return {};
+        }
+
+        std::optional<std::any> get(const QString& path, const TagType& type) override
+        {
+            const ExifData& data = m_data[path.toUInt()];
+            std::optional<std::any> result;
+
+            switch (type)
+            {
+                case TagType::SequenceNumber:
+                    if (data.sequence)
+                        result = *data.sequence;
+                    break;
+
+                case TagType::Exposure:
+                    if (data.exposure)
+                        result = *data.exposure;
+                    break;
+
+                case TagType::CameraModel:
+                    result = data.model;
+                    break;
+
+                default:
+                    break;
+            }
+
+            return result;
+        }
+
+    private:
+        const std::vector<ExifData>& m_data;
+    };
+
+    // Generate photos sorted by time: series of manual shots, animations (bursts) and HDRs
+    // mixed with single photos. Cameras take photos in turns, so their series overlap in time.
+    void generate(std::vector<Photo::Data>& photos, std::vector<ExifData>& exif)
+    {
+        const QDateTime first(QDate(2000, 1, 1), QTime(0, 0));
+
+        photos.reserve(Photos);
+        exif.reserve(Photos);
+
+        qint64 seconds = 0;
+
+        for (int i = 0; i < Photos;)
+        {
+            const int kind = (i / 7) % 4;             // 0 - single photo, 1 - manual series, 2 - animation, 3 - HDR
+            const int length = kind == 0? 1: 3 + i % 5;
+
+            for (int j = 0; j < length && i < Photos; j++, i++)
+            {
+                const QDateTime when = first.addSecs(seconds + (kind == 1? j * 2: 0));
+
+                Photo::Data data;
+                data.id = Photo::Id(i + 1);
+                data.path = QString::number(i);
+                data.tags.emplace(TagTypes::Date, when.date());
+                data.tags.emplace(TagTypes::Time, when.time());
+
+                ExifData exifData;
+                exifData.model = QString("camera %1").arg(i % Cameras).toStdString();
+
+                if (kind == 2 || kind == 3)
+                    exifData.sequence = j + 1;
+
+                if (kind == 3)
+                    exifData.exposure = static_cast<float>(j - 1) / 3.f;
+
+                photos.push_back(data);
+                exif.push_back(exifData);
+            }
+
+            seconds += 3600;
+        }
+    }
+}
+
+
+TEST(SeriesDetectionBenchmark, detectionOverGeneratedCollection)
+{
+    std::vector<Photo::Data> photos;
+    std::vector<ExifData> exif;
+
+    generate(photos, exif);
+
+    GeneratedExifReader exifReader(exif);
+    const SeriesDetector detector(&exifReader);
+
+    std::size_t groups = 0;
+    std::size_t grouped = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    detector.listCandidates(photos, SeriesDetector::Rules(), [&groups, &grouped](const SeriesDetector::GroupCandidate& candidate)
+    {
+        groups++;
+        grouped += candidate.members.size();
+    });
+
+    const auto end = std::chrono::steady_clock::now();
+    const double duration = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::cout << "photos:  " << photos.size() << "\n"
+              << "groups:  " << groups << " (" << grouped << " photos)\n"
+              << "time:    " << duration << " ms\n";
+
+    EXPECT_GT(groups, 0);
+}
@@ -0,0 +1,99 @@
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <system/system.hpp>
+#include <unit_tests_utils/empty_logger.hpp>
+
+#include "backends/sql_backends/sqlite_backend/backend.hpp"
+#include "project_info.hpp"
+
+
+namespace
+{
+    constexpr int Photos = 300000;
+    constexpr int Years = 20;
+    constexpr int Repetitions = 10;
+
+    void fill(Database::IBackend& backend)
+    {
+        const QDate first(2000, 1, 1);
+        const qint64 days = first.daysTo(first.addYears(Years));
+
+        std::vector<Photo::DataDelta> photos;
+        photos.reserve(Photos);
+
+        for (int i = 0; i < Photos; i++)
+        {
+            Photo::DataDelta delta;
+            delta.insert<Photo::Field::Path>(QString("/some/path/photo_%1.jpeg").arg(i));
+
+            // every 100th photo has no date
+            if (i % 100 != 0)
+                delta.insert<Photo::Field::Tags>({ {TagTypes::Date, TagValue(first.addDays(i % days))} });
+
+            photos.push_back(delta);
+        }
+
+        backend.addPhotos(photos);
+    }
+
+    // how PhotosModelControllerComponent was collecting dates before histogram was introduced
+    std::size_t datesFromTags(Database::IBackend& backend)
+    {
+        auto dates = backend.listTagValues(TagTypes::Date, {});
+
+        const Database::FilterPhotosWithTag with_date_filter(TagTypes::Date);
+        const Database::FilterNotMatchingFilter without_date_filter(with_date_filter);
+        const auto photos_without_date_tag = backend.photoOperator().getPhotos(without_date_filter);
+
+        return dates.size() + (photos_without_date_tag.empty()? 0: 1);
+    }
+
+    std::size_t datesFromHistogram(Database::IBackend& backend)
+    {
+        return backend.datesHistogram({}, Database::DatesResolution::Day).size();
+    }
+
+    template<typename F>
+    double measure(Database::IBackend& backend, F&& f, std::size_t& dates)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < Repetitions; i++)
+            dates = f(backend);
+
+        const auto end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::milli>(end - start).count() / Repetitions;
+    }
+}
+
+
+TEST(TimelineBenchmark, timeRangeOfAllPhotos)
+{
+    auto tmpDir = System::createTmpDir("TimelineBenchmark", System::Confidential);
+
+    EmptyLogger logger;
+    std::unique_ptr<Database::IBackend> backend = std::make_unique<Database::SQLiteBackend>(nullptr, &logger);
+    ASSERT_TRUE(backend->init(Database::ProjectInfo(tmpDir->path() + "/db", "SQLite")));
+
+    fill(*backend);
+
+    std::size_t tagDates = 0;
+    std::size_t histogramDates = 0;
+
+    const double fromTags = measure(*backend, &datesFromTags, tagDates);
+    const double fromHistogram = measure(*backend, &datesFromHistogram, histogramDates);
+
+    std::cout << "dates from tags:      " << fromTags << " ms\n"
+              << "dates from histogram: " << fromHistogram << " ms\n";
+
+    EXPECT_EQ(tagDates, histogramDates);
+    EXPECT_LT(fromHistogram, fromTags);
+
+    backend->closeConnections();
+}
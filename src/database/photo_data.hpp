@@ -20,6 +20,7 @@
 #ifndef PHOTO_DATA_HPP
 #define PHOTO_DATA_HPP
 
+#include <map>
 #include <variant>
 #include <QImage>
 
@@ -68,6 +69,7 @@ namespace Photo
         Q_GADGET
     };
 
+    // Order of fields matches order of types in DataDelta::Storage
     enum class Field
     {
         Checksum,
@@ -76,6 +78,8 @@ namespace Photo
         Path,
         Geometry,
         GroupInfo,
+        TagsChanges,            // tags to be set (or removed when value is empty), other tags are not touched
+        FlagsChanges,           // flags to be set, other flags are not touched
     };
 
     template<Field>
@@ -117,6 +121,18 @@ namespace Photo
         typedef GroupInfo Storage;
     };
 
+    template<>
+    struct DeltaTypes<Field::TagsChanges>
+    {
+        typedef Tag::TagsList Storage;
+    };
+
+    template<>
+    struct DeltaTypes<Field::FlagsChanges>
+    {
+        typedef Photo::FlagValues Storage;
+    };
+
     class DATABASE_EXPORT DataDelta
     {
         public:
@@ -127,9 +143,15 @@ namespace Photo
             template<Field field>
             void insert(const typename DeltaTypes<field>::Storage& value)
             {
-                m_data.insert_or_assign(field, value);
+                m_data.insert_or_assign(field, Storage(std::in_place_index<static_cast<std::size_t>(field)>, value));
             }
 
+            // field level changes. Unlike Tags and Flags fields they do not carry
+            // whole state, so backends can apply them without knowing current one.
+            void setTag(const TagTypes &, const TagValue &);
+            void clearTag(const TagTypes &);
+            void setFlag(Photo::FlagsE, int);
+
             void setId(const Photo::Id &);
 
             void clear();
@@ -139,11 +161,9 @@ namespace Photo
             template<Field field>
             const typename DeltaTypes<field>::Storage& get() const
             {
-                typedef typename DeltaTypes<field>::Storage Result;
-
                 const Storage& raw = get(field);
 
-                return std::get<Result>(raw);
+                return std::get<static_cast<std::size_t>(field)>(raw);
             }
 
             const Photo::Id& getId() const;
@@ -158,12 +178,22 @@ namespace Photo
                                  DeltaTypes<Field::Flags>::Storage,
                                  DeltaTypes<Field::Path>::Storage,
                                  DeltaTypes<Field::Geometry>::Storage,
-                                 DeltaTypes<Field::GroupInfo>::Storage> Storage;
+                                 DeltaTypes<Field::GroupInfo>::Storage,
+                                 DeltaTypes<Field::TagsChanges>::Storage,
+                                 DeltaTypes<Field::FlagsChanges>::Storage> Storage;
 
             Photo::Id                m_id;
             std::map<Field, Storage> m_data;
 
             const Storage& get(Field) const;
+
+            template<Field field>
+            typename DeltaTypes<field>::Storage& access()
+            {
+                auto it = m_data.try_emplace(field, std::in_place_index<static_cast<std::size_t>(field)>).first;
+
+                return std::get<static_cast<std::size_t>(field)>(it->second);
+            }
     };
 
 }
@@ -0,0 +1,36 @@
+
+#ifndef TAG_VALUES_COUNTS_HPP_INCLUDED
+#define TAG_VALUES_COUNTS_HPP_INCLUDED
+
+#include <map>
+
+#include <QMetaType>
+
+#include <core/tag.hpp>
+
+#include "database_export.h"
+
+
+namespace Database
+{
+    /// number of photos using each value of each tag
+    typedef std::map<TagTypes, std::map<TagValue, int>> TagValuesCounts;
+
+    /**
+     * \brief collect changes of tag values usage
+     * \arg counts differences to be updated
+     * \arg previousTags tags of photo before change
+     * \arg tags tags of photo after change
+     *
+     * Values photo stopped using are decremented, new ones are incremented. \n
+     * Values which end up with no difference are removed from \a counts.
+     */
+    DATABASE_EXPORT void countTagValues(TagValuesCounts& counts, const Tag::TagsList& previousTags, const Tag::TagsList& tags);
+
+    /// add \a difference to \a counts. Values which end up with 0 are removed
+    DATABASE_EXPORT void countTagValue(TagValuesCounts& counts, const TagTypes &, const TagValue &, int difference);
+}
+
+Q_DECLARE_METATYPE(Database::TagValuesCounts)
+
+#endif // TAG_VALUES_COUNTS_HPP_INCLUDED
@@ -0,0 +1,275 @@
+
+#include <future>
+
+#include <gmock/gmock.h>
+
+#include "implementation/async_database.hpp"
+#include "unit_tests_utils/empty_logger.hpp"
+#include "unit_tests_utils/mock_backend.hpp"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::UnorderedElementsAre;
+
+
+class AsyncDatabaseTest: public testing::Test
+{
+    public:
+        AsyncDatabaseTest()
+        {
+            auto backend = std::make_unique<NiceMock<MockBackend>>();
+            m_backend = backend.get();
+
+            // each update() is one transaction followed by one photosModified() signal
+            ON_CALL(*m_backend, update(_)).WillByDefault(Invoke([this](const std::vector<Photo::DataDelta>& deltas)
+            {
+                m_updates.push_back(deltas);
+                return true;
+            }));
+
+            m_db = std::make_unique<Database::AsyncDatabase>(std::move(backend), nullptr, &m_logger);
+        }
+
+        // keep db's thread busy until returned promise is fulfilled, so next tasks wait in queue
+        std::promise<void> block()
+        {
+            std::promise<void> blocker;
+            std::shared_future<void> blocked = blocker.get_future().share();
+
+            m_db->exec([blocked](Database::IBackend &)
+            {
+                blocked.wait();
+            });
+
+            return blocker;
+        }
+
+        // wait for all queued tasks
+        void finish()
+        {
+            m_db->closeConnections();
+        }
+
+        EmptyLogger m_logger;
+        NiceMock<MockBackend>* m_backend;
+        std::vector<std::vector<Photo::DataDelta>> m_updates;       // modified in db's thread
+        std::unique_ptr<Database::AsyncDatabase> m_db;
+};
+
+
+TEST_F(AsyncDatabaseTest, queuedUpdatesAreStoredInOneTransaction)
+{
+    std::promise<void> blocker = block();
+
+    for (int i = 0; i < 3; i++)
+    {
+        Photo::DataDelta delta(Photo::Id(i));
+        delta.insert<Photo::Field::Path>(QString("photo%1.jpeg").arg(i));
+
+        m_db->update(delta);
+    }
+
+    blocker.set_value();
+    finish();
+
+    ASSERT_EQ(m_updates.size(), 1);
+    EXPECT_EQ(m_updates.front().size(), 3);
+}
+
+
+TEST_F(AsyncDatabaseTest, newerValuesWin)
+{
+    std::promise<void> blocker = block();
+
+    Photo::DataDelta older(Photo::Id(1));
+    older.insert<Photo::Field::Path>("older.jpeg");
+    older.insert<Photo::Field::Checksum>("1111");
+    older.insert<Photo::Field::Flags>({ {Photo::FlagsE::ExifLoaded, 1}, {Photo::FlagsE::Sha256Loaded, 1} });
+
+    Photo::DataDelta newer(Photo::Id(1));
+    newer.insert<Photo::Field::Path>("newer.jpeg");
+    newer.insert<Photo::Field::Flags>({ {Photo::FlagsE::ExifLoaded, 2} });
+
+    m_db->update(older);
+    m_db->update(newer);
+
+    blocker.set_value();
+    finish();
+
+    ASSERT_EQ(m_updates.size(), 1);
+    ASSERT_EQ(m_updates.front().size(), 1);
+
+    const Photo::DataDelta& merged = m_updates.front().front();
+    EXPECT_EQ(merged.get<Photo::Field::Path>(), "newer.jpeg");
+    EXPECT_EQ(merged.get<Photo::Field::Checksum>(), "1111");                // not present in newer delta, older one is kept
+    EXPECT_THAT(merged.get<Photo::Field::Flags>(), UnorderedElementsAre(std::pair{Photo::FlagsE::ExifLoaded, 2},
+                                                                         std::pair{Photo::FlagsE::Sha256Loaded, 1}));
+}
+
+
+TEST_F(AsyncDatabaseTest, tagsTakePrecedenceOverOlderTagsChanges)
+{
+    std::promise<void> blocker = block();
+
+    Photo::DataDelta changes(Photo::Id(1));
+    changes.setTag(TagTypes::Event, QString("event"));
+
+    Photo::DataDelta tags(Photo::Id(1));
+    tags.insert<Photo::Field::Tags>({ {TagTypes::Place, QString("place")} });
+
+    m_db->update(changes);
+    m_db->update(tags);
+
+    blocker.set_value();
+    finish();
+
+    ASSERT_EQ(m_updates.size(), 1);
+    ASSERT_EQ(m_updates.front().size(), 1);
+
+    const Photo::DataDelta& merged = m_updates.front().front();
+    EXPECT_FALSE(merged.has(Photo::Field::TagsChanges));
+    EXPECT_EQ(merged.get<Photo::Field::Tags>(), Tag::TagsList({ {TagTypes::Place, QString("place")} }));
+}
+
+
+TEST_F(AsyncDatabaseTest, newerTagsChangesAreAppliedOnOlderTags)
+{
+    std::promise<void> blocker = block();
+
+    Photo::DataDelta tags(Photo::Id(1));
+    tags.insert<Photo::Field::Tags>({ {TagTypes::Place, QString("place")} });
+
+    Photo::DataDelta changes(Photo::Id(1));
+    changes.setTag(TagTypes::Event, QString("event"));
+
+    m_db->update(tags);
+    m_db->update(changes);
+
+    blocker.set_value();
+    finish();
+
+    ASSERT_EQ(m_updates.size(), 1);
+    ASSERT_EQ(m_updates.front().size(), 1);
+
+    // both are kept, backend applies changes on top of whole set of tags
+    const Photo::DataDelta& merged = m_updates.front().front();
+    EXPECT_EQ(merged.get<Photo::Field::Tags>(), Tag::TagsList({ {TagTypes::Place, QString("place")} }));
+    EXPECT_EQ(merged.get<Photo::Field::TagsChanges>(), Tag::TagsList({ {TagTypes::Event, QString("event")} }));
+}
+
+
+TEST_F(AsyncDatabaseTest, flagsTakePrecedenceOverOlderFlagsChanges)
+{
+    std::promise<void> blocker = block();
+
+    Photo::DataDelta changes(Photo::Id(1));
+    changes.setFlag(Photo::FlagsE::ExifLoaded, 1);
+
+    Photo::DataDelta flags(Photo::Id(1));
+    flags.insert<Photo::Field::Flags>({ {Photo::FlagsE::Sha256Loaded, 1} });
+
+    m_db->update(changes);
+    m_db->update(flags);
+
+    blocker.set_value();
+    finish();
+
+    ASSERT_EQ(m_updates.size(), 1);
+    ASSERT_EQ(m_updates.front().size(), 1);
+
+    const Photo::DataDelta& merged = m_updates.front().front();
+    EXPECT_FALSE(merged.has(Photo::Field::FlagsChanges));
+    EXPECT_THAT(merged.get<Photo::Field::Flags>(), UnorderedElementsAre(std::pair{Photo::FlagsE::Sha256Loaded, 1}));
+}
+
+
+TEST_F(AsyncDatabaseTest, newerFlagsChangesAreAppliedOnOlderFlags)
+{
+    std::promise<void> blocker = block();
+
+    Photo::DataDelta flags(Photo::Id(1));
+    flags.insert<Photo::Field::Flags>({ {Photo::FlagsE::Sha256Loaded, 1} });
+
+    Photo::DataDelta changes(Photo::Id(1));
+    changes.setFlag(Photo::FlagsE::ExifLoaded, 1);
+
+    m_db->update(flags);
+    m_db->update(changes);
+
+    blocker.set_value();
+    finish();
+
+    ASSERT_EQ(m_updates.size(), 1);
+    ASSERT_EQ(m_updates.front().size(), 1);
+
+    const Photo::DataDelta& merged = m_updates.front().front();
+    EXPECT_THAT(merged.get<Photo::Field::Flags>(), UnorderedElementsAre(std::pair{Photo::FlagsE::Sha256Loaded, 1}));
+    EXPECT_THAT(merged.get<Photo::Field::FlagsChanges>(), UnorderedElementsAre(std::pair{Photo::FlagsE::ExifLoaded, 1}));
+}
+
+
+TEST_F(AsyncDatabaseTest, otherTaskEndsBatch)
+{
+    std::promise<void> blocker = block();
+
+    Photo::DataDelta first(Photo::Id(1));
+    first.insert<Photo::Field::Path>("first.jpeg");
+
+    Photo::DataDelta second(Photo::Id(1));
+    second.insert<Photo::Field::Path>("second.jpeg");
+
+    std::size_t updatesBeforeTask = 0;
+
+    m_db->update(first);
+    m_db->exec([this, &updatesBeforeTask](Database::IBackend &)
+    {
+        updatesBeforeTask = m_updates.size();
+    });
+    m_db->update(second);
+
+    blocker.set_value();
+    finish();
+
+    // task sees first update stored, and second one is not merged with first one
+    EXPECT_EQ(updatesBeforeTask, 1);
+
+    ASSERT_EQ(m_updates.size(), 2);
+    EXPECT_EQ(m_updates[0].front().get<Photo::Field::Path>(), "first.jpeg");
+    EXPECT_EQ(m_updates[1].front().get<Photo::Field::Path>(), "second.jpeg");
+}
+
+
+TEST_F(AsyncDatabaseTest, validUpdatesAreStoredWhenBatchFails)
+{
+    // photo 2 was removed, any transaction touching it fails
+    ON_CALL(*m_backend, update(_)).WillByDefault(Invoke([this](const std::vector<Photo::DataDelta>& deltas)
+    {
+        for (const Photo::DataDelta& delta: deltas)
+            if (delta.getId() == Photo::Id(2))
+                return false;
+
+        m_updates.push_back(deltas);
+        return true;
+    }));
+
+    std::promise<void> blocker = block();
+
+    for (int id = 1; id <= 3; id++)
+    {
+        Photo::DataDelta delta(Photo::Id(id));
+        delta.insert<Photo::Field::Path>(QString("photo%1.jpeg").arg(id));
+
+        m_db->update(delta);
+    }
+
+    blocker.set_value();
+    finish();
+
+    // merged update failed, photos were stored one by one
+    ASSERT_EQ(m_updates.size(), 2);
+    ASSERT_EQ(m_updates[0].size(), 1);
+    ASSERT_EQ(m_updates[1].size(), 1);
+    EXPECT_EQ(m_updates[0].front().getId(), Photo::Id(1));
+    EXPECT_EQ(m_updates[1].front().getId(), Photo::Id(3));
+}
@@ -0,0 +1,121 @@
+
+#include <gmock/gmock.h>
+
+#include <QTemporaryFile>
+
+#include <unit_tests_utils/mock_exif_reader.hpp>
+
+#include "database_tools/cached_exif_reader.hpp"
+
+
+using testing::NiceMock;
+using testing::Return;
+using testing::_;
+
+
+namespace
+{
+    struct CachedExifReaderTest: testing::Test
+    {
+        void SetUp() override
+        {
+            ASSERT_TRUE(m_file.open());
+            m_file.write("some data");
+            m_file.close();
+
+            Photo::Data photo;
+            photo.id = Photo::Id(1);
+            photo.path = m_file.fileName();
+
+            m_photos.push_back(photo);
+        }
+
+        QTemporaryFile m_file;
+        std::vector<Photo::Data> m_photos;
+        NiceMock<MockExifReader> m_exif;
+    };
+}
+
+
+TEST_F(CachedExifReaderTest, storedFeaturesAreUsed)
+{
+    Database::ExifFeatures features;
+
+    {
+        NiceMock<MockExifReader> exif;
+        ON_CALL(exif, get(_, _)).WillByDefault(Return(std::optional<std::any>()));
+        ON_CALL(exif, get(_, IExifReader::TagType::SequenceNumber)).WillByDefault(Return(std::any(5)));
+        ON_CALL(exif, get(_, IExifReader::TagType::CameraModel)).WillByDefault(Return(std::any(std::string("camera"))));
+
+        // features of current file
+        features = readExifFeatures(exif, m_file.fileName());
+    }
+
+    EXPECT_CALL(m_exif, get(_, _)).Times(0);
+
+    CachedExifReader reader(m_exif, m_photos, { {m_photos.front().id, features} });
+
+    const auto sequence = reader.get(m_file.fileName(), IExifReader::TagType::SequenceNumber);
+    const auto model = reader.get(m_file.fileName(), IExifReader::TagType::CameraModel);
+    const auto exposure = reader.get(m_file.fileName(), IExifReader::TagType::Exposure);
+
+    ASSERT_TRUE(sequence.has_value());
+    ASSERT_TRUE(model.has_value());
+    EXPECT_EQ(std::any_cast<int>(*sequence), 5);
+    EXPECT_EQ(std::any_cast<std::string>(*model), "camera");
+    EXPECT_FALSE(exposure.has_value());
+
+    EXPECT_TRUE(reader.refreshed().empty());
+}
+
+
+TEST_F(CachedExifReaderTest, missingFeaturesAreReadFromFile)
+{
+    EXPECT_CALL(m_exif, get(_, IExifReader::TagType::SequenceNumber)).WillOnce(Return(std::any(3)));
+
+    CachedExifReader reader(m_exif, m_photos, {});
+
+    // file is read once
+    for (int i = 0; i < 2; i++)
+    {
+        const auto sequence = reader.get(m_file.fileName(), IExifReader::TagType::SequenceNumber);
+
+        ASSERT_TRUE(sequence.has_value());
+        EXPECT_EQ(std::any_cast<int>(*sequence), 3);
+    }
+
+    ASSERT_EQ(reader.refreshed().size(), 1);
+    EXPECT_EQ(reader.refreshed().begin()->first, m_photos.front().id);
+    EXPECT_EQ(reader.refreshed().begin()->second.sequenceNumber, 3);
+}
+
+
+TEST_F(CachedExifReaderTest, featuresOfChangedFileAreRefreshed)
+{
+    Database::ExifFeatures features;
+    features.sequenceNumber = 5;
+    features.fileSize = 1;                  // file has different size now
+    features.fileModified = 0;
+
+    EXPECT_CALL(m_exif, get(_, IExifReader::TagType::SequenceNumber)).WillOnce(Return(std::any(7)));
+
+    CachedExifReader reader(m_exif, m_photos, { {m_photos.front().id, features} });
+
+    const auto sequence = reader.get(m_file.fileName(), IExifReader::TagType::SequenceNumber);
+
+    ASSERT_TRUE(sequence.has_value());
+    EXPECT_EQ(std::any_cast<int>(*sequence), 7);
+    ASSERT_EQ(reader.refreshed().size(), 1);
+    EXPECT_TRUE(exifFeaturesUpToDate(reader.refreshed().begin()->second, m_file.fileName()));
+}
+
+
+TEST_F(CachedExifReaderTest, unknownFilesAreReadDirectly)
+{
+    EXPECT_CALL(m_exif, get(QString("other file"), IExifReader::TagType::SequenceNumber)).WillOnce(Return(std::any(1)));
+
+    CachedExifReader reader(m_exif, m_photos, {});
+
+    EXPECT_TRUE(reader.get("other file", IExifReader::TagType::SequenceNumber).has_value());
+    EXPECT_TRUE(reader.refreshed().empty());
+}
@@ -46,3 +46,66 @@ TEST(DataDeltaTest, mergingWithEmpty)
 
     EXPECT_EQ(d1.getId(), d2.getId());
 }
+
+
+TEST(DataDeltaTest, fieldLevelChanges)
+{
+    Photo::Data data;
+    data.tags = { {TagTypes::Event, TagValue(QString("party"))}, {TagTypes::Place, TagValue(QString("Warsaw"))} };
+    data.flags = { {Photo::FlagsE::StagingArea, 1} };
+
+    Photo::DataDelta delta(Photo::Id(1));
+    delta.setTag(TagTypes::Event, TagValue(QString("holiday")));
+    delta.clearTag(TagTypes::Place);
+    delta.setFlag(Photo::FlagsE::ExifLoaded, 1);
+
+    EXPECT_FALSE(delta.has(Photo::Field::Tags));
+    EXPECT_FALSE(delta.has(Photo::Field::Flags));
+    ASSERT_TRUE(delta.has(Photo::Field::TagsChanges));
+    ASSERT_TRUE(delta.has(Photo::Field::FlagsChanges));
+
+    data.apply(delta);
+
+    EXPECT_THAT(data.tags, UnorderedElementsAre( std::pair{TagTypes::Event, TagValue(QString("holiday"))} ));
+    EXPECT_THAT(data.flags, UnorderedElementsAre( std::pair{Photo::FlagsE::StagingArea, 1}, std::pair{Photo::FlagsE::ExifLoaded, 1} ));
+}
+
+
+TEST(DataDeltaTest, mergingFieldLevelChanges)
+{
+    Photo::DataDelta newer(Photo::Id(1));
+    Photo::DataDelta older(Photo::Id(1));
+
+    newer.setTag(TagTypes::Event, TagValue(QString("holiday")));
+    newer.setFlag(Photo::FlagsE::ExifLoaded, 1);
+
+    older.setTag(TagTypes::Event, TagValue(QString("party")));
+    older.setTag(TagTypes::Place, TagValue(QString("Warsaw")));
+    older.insert<Photo::Field::Flags>( {{Photo::FlagsE::ExifLoaded, 0}, {Photo::FlagsE::StagingArea, 1}} );
+
+    newer |= older;
+
+    // changes are merged, newer ones win
+    EXPECT_THAT(newer.get<Photo::Field::TagsChanges>(), UnorderedElementsAre( std::pair{TagTypes::Event, TagValue(QString("holiday"))},
+                                                                               std::pair{TagTypes::Place, TagValue(QString("Warsaw"))} ));
+
+    // whole set of flags is taken and changes are applied on top of it
+    Photo::Data data;
+    data.apply(newer);
+
+    EXPECT_THAT(data.flags, UnorderedElementsAre( std::pair{Photo::FlagsE::ExifLoaded, 1}, std::pair{Photo::FlagsE::StagingArea, 1} ));
+}
+
+
+TEST(DataDeltaTest, wholeSetOfTagsSupersedesChanges)
+{
+    Photo::DataDelta newer(Photo::Id(1));
+    Photo::DataDelta older(Photo::Id(1));
+
+    newer.insert<Photo::Field::Tags>( {{TagTypes::Event, TagValue(QString("holiday"))}} );
+    older.setTag(TagTypes::Place, TagValue(QString("Warsaw")));
+
+    newer |= older;
+
+    EXPECT_FALSE(newer.has(Photo::Field::TagsChanges));
+}
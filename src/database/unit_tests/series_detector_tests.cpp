@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <random>
 
 #include <QDate>
@@ -18,9 +19,48 @@ using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SizeIs;
 using testing::_;
 
 
+namespace
+{
+    // adapt generator of single photo's data to IBackend::getPhotos()
+    template<typename F>
+    auto forEachPhoto(F generator)
+    {
+        return [generator](const std::vector<Photo::Id>& ids)
+        {
+            std::vector<Photo::Data> photos;
+
+            for (const Photo::Id& id: ids)
+                photos.push_back(generator(id));
+
+            return photos;
+        };
+    }
+
+    // two series of 3 photos taken second by second, with an hour break between them
+    std::vector<Photo::Data> twoManualSeries()
+    {
+        std::vector<Photo::Data> photos;
+
+        for (int i = 0; i < 6; i++)
+        {
+            Photo::Data data;
+            data.id = Photo::Id(i + 1);
+            data.path = QString("path: %1").arg(data.id);
+            data.tags.emplace(TagTypes::Date, QDate::fromString("2000.12.01", "yyyy.MM.dd"));
+            data.tags.emplace(TagTypes::Time, QTime(12 + i / 3, 0, i % 3));
+
+            photos.push_back(data);
+        }
+
+        return photos;
+    }
+}
+
+
 TEST(SeriesDetectorTest, constructor)
 {
     EXPECT_NO_THROW({
@@ -50,7 +90,7 @@ TEST(SeriesDetectorTest, animationDetectionScenario1)
     };
 
     ON_CALL(photoOperator, onPhotos(_, Database::Action(Database::Actions::SortByTimestamp()))).WillByDefault(Return(all_photos));
-    ON_CALL(backend, getPhoto(_)).WillByDefault(Invoke([](const Photo::Id& id) -> Photo::Data
+    ON_CALL(backend, getPhotos(_)).WillByDefault(Invoke(forEachPhoto([](const Photo::Id& id) -> Photo::Data
     {
         Photo::Data data;
         data.id = id;
@@ -59,7 +99,7 @@ TEST(SeriesDetectorTest, animationDetectionScenario1)
         data.tags.emplace(TagTypes::Time, QTime::fromString(QString("12.00.%1").arg(id), "hh.mm.s"));  // simulate different time - use id as second
 
         return data;
-    }));
+    })));
 
     // return sequence number basing on file name (file name contains photo id)
     ON_CALL(exif, get(_, IExifReader::TagType::SequenceNumber)).WillByDefault(Invoke([](const QString& path, IExifReader::TagType) -> std::optional<std::any>
@@ -106,7 +146,7 @@ TEST(SeriesDetectorTest, animationDetectionScenario2)
     };
 
     ON_CALL(photoOperator, onPhotos(_, Database::Action(Database::Actions::SortByTimestamp()))).WillByDefault(Return(all_photos));
-    ON_CALL(backend, getPhoto(_)).WillByDefault(Invoke([](const Photo::Id& id) -> Photo::Data
+    ON_CALL(backend, getPhotos(_)).WillByDefault(Invoke(forEachPhoto([](const Photo::Id& id) -> Photo::Data
     {
         Photo::Data data;
         data.id = id;
@@ -115,7 +155,7 @@ TEST(SeriesDetectorTest, animationDetectionScenario2)
         data.tags.emplace(TagTypes::Time, QTime::fromString(QString("12.00.%1").arg( (id - 1) / 3), "hh.mm.s"));  // simulate same time within a group
 
         return data;
-    }));
+    })));
 
     // return sequence number basing on file name (file name contains photo id)
     ON_CALL(exif, get(_, IExifReader::TagType::SequenceNumber)).WillByDefault(Invoke([](const QString& path, IExifReader::TagType) -> std::optional<std::any>
@@ -163,7 +203,7 @@ TEST(SeriesDetectorTest, animationDetectionScenario3)
     };
 
     ON_CALL(photoOperator, onPhotos(_, Database::Action(Database::Actions::SortByTimestamp()))).WillByDefault(Return(all_photos));
-    ON_CALL(backend, getPhoto(_)).WillByDefault(Invoke([](const Photo::Id& id) -> Photo::Data
+    ON_CALL(backend, getPhotos(_)).WillByDefault(Invoke(forEachPhoto([](const Photo::Id& id) -> Photo::Data
     {
         Photo::Data data;
         data.id = id;
@@ -172,7 +212,7 @@ TEST(SeriesDetectorTest, animationDetectionScenario3)
         data.tags.emplace(TagTypes::Time, QTime::fromString(QString("12.00.%1").arg( (id - 1) / 3), "hh.mm.s"));  // simulate same time within a group
 
         return data;
-    }));
+    })));
 
     // return sequence number basing on file name (file name contains photo id)
     ON_CALL(exif, get(_, IExifReader::TagType::SequenceNumber)).WillByDefault(Invoke([](const QString& path, IExifReader::TagType) -> std::optional<std::any>
@@ -230,7 +270,7 @@ TEST(SeriesDetectorTest, HDRDetectionScenario1)
     };
 
     ON_CALL(photoOperator, onPhotos(_, Database::Action(Database::Actions::SortByTimestamp()) )).WillByDefault(Return(all_photos));
-    ON_CALL(backend, getPhoto(_)).WillByDefault(Invoke([](const Photo::Id& id) -> Photo::Data
+    ON_CALL(backend, getPhotos(_)).WillByDefault(Invoke(forEachPhoto([](const Photo::Id& id) -> Photo::Data
     {
         Photo::Data data;
         data.id = id;
@@ -239,7 +279,7 @@ TEST(SeriesDetectorTest, HDRDetectionScenario1)
         data.tags.emplace(TagTypes::Time, QTime::fromString(QString("12.00.%1").arg( (id - 1) / 3), "hh.mm.s"));  // simulate same time within a group
 
         return data;
-    }));
+    })));
 
     // return sequence number basing on file name (file name contains photo id)
     ON_CALL(exif, get(_, IExifReader::TagType::SequenceNumber)).WillByDefault(Invoke([](const QString& path, IExifReader::TagType) -> std::optional<std::any>
@@ -319,7 +359,7 @@ TEST(SeriesDetectorTest, Complexity)
 
     ON_CALL(photoOperator, onPhotos(_, Database::Action(Database::Actions::SortByTimestamp()))).WillByDefault(Return(all_photos));
 
-    EXPECT_CALL(backend, getPhoto(_)).Times(50).WillRepeatedly(Invoke([](const Photo::Id& id) -> Photo::Data
+    EXPECT_CALL(backend, getPhotos(SizeIs(50))).WillOnce(Invoke(forEachPhoto([](const Photo::Id& id) -> Photo::Data
     {
         Photo::Data data;
         data.id = id;
@@ -328,8 +368,143 @@ TEST(SeriesDetectorTest, Complexity)
         data.tags.emplace(TagTypes::Time, QTime::fromString(QString("12.%1.00").arg(id), "hh.m.ss"));  // simulate different time - use id as minute
 
         return data;
-    }));
+    })));
 
     const SeriesDetector sd(backend, &exif);
     const std::vector<SeriesDetector::GroupCandidate> groupCanditates = sd.listCandidates();
 }
+
+
+TEST(SeriesDetectorTest, candidatesAreReportedAsSoonAsFound)
+{
+    NiceMock<MockExifReader> exif;
+
+    std::vector<SeriesDetector::GroupCandidate> candidates;
+    std::vector<std::size_t> progressOnCandidate;
+    std::vector<std::pair<std::size_t, std::size_t>> progress;
+
+    const SeriesDetector sd(&exif);
+    sd.listCandidates(twoManualSeries(), SeriesDetector::Rules(),
+                      [&candidates, &progress, &progressOnCandidate](const SeriesDetector::GroupCandidate& candidate)
+                      {
+                          candidates.push_back(candidate);
+                          progressOnCandidate.push_back(progress.empty()? 0: progress.back().first);
+                      },
+                      [&progress](std::size_t done, std::size_t total)
+                      {
+                          progress.emplace_back(done, total);
+                      });
+
+    ASSERT_EQ(candidates.size(), 2);
+    EXPECT_EQ(candidates.front().type, Group::Type::Generic);
+    EXPECT_EQ(candidates.front().members.size(), 3);
+
+    // progress grows up to total
+    ASSERT_FALSE(progress.empty());
+    EXPECT_TRUE(std::is_sorted(progress.begin(), progress.end()));
+    EXPECT_EQ(progress.back().first, progress.back().second);
+
+    // first candidate is reported before work is done
+    EXPECT_LT(progressOnCandidate.front(), progress.back().second);
+}
+
+
+TEST(SeriesDetectorTest, detectionCanBeCancelled)
+{
+    NiceMock<MockExifReader> exif;
+
+    std::vector<SeriesDetector::GroupCandidate> candidates;
+
+    const SeriesDetector sd(&exif);
+    sd.listCandidates(twoManualSeries(), SeriesDetector::Rules(),
+                      [&candidates](const SeriesDetector::GroupCandidate& candidate)
+                      {
+                          candidates.push_back(candidate);
+                      },
+                      {},
+                      [&candidates]()
+                      {
+                          return candidates.empty() == false;
+                      });
+
+    EXPECT_EQ(candidates.size(), 1);
+}
+
+
+TEST(SeriesDetectorTest, exifIsReadOncePerPhoto)
+{
+    NiceMock<MockExifReader> exif;
+
+    const std::vector<Photo::Data> photos = twoManualSeries();
+    const int count = static_cast<int>(photos.size());
+
+    EXPECT_CALL(exif, get(_, IExifReader::TagType::SequenceNumber)).Times(count);
+    EXPECT_CALL(exif, get(_, IExifReader::TagType::Exposure)).Times(count);
+    EXPECT_CALL(exif, get(_, IExifReader::TagType::CameraMake)).Times(count);
+    EXPECT_CALL(exif, get(_, IExifReader::TagType::CameraModel)).Times(count);
+    EXPECT_CALL(exif, get(_, IExifReader::TagType::CameraSerialNumber)).Times(count);
+
+    const SeriesDetector sd(&exif);
+    sd.listCandidates(photos, SeriesDetector::Rules(), [](const SeriesDetector::GroupCandidate &) {});
+}
+
+
+TEST(SeriesDetectorTest, seriesOfDifferentCamerasAreNotMixed)
+{
+    NiceMock<MockExifReader> exif;
+
+    // two cameras take bursts of 3 photos at the same time,
+    // so when sorted by time photos of both cameras are interleaved
+    std::vector<Photo::Data> photos;
+
+    for (int i = 0; i < 6; i++)
+    {
+        Photo::Data data;
+        data.id = Photo::Id(i + 1);
+        data.path = QString("path: %1").arg(data.id);
+        data.tags.emplace(TagTypes::Date, QDate::fromString("2000.12.01", "yyyy.MM.dd"));
+        data.tags.emplace(TagTypes::Time, QTime(12, 0, i / 2));
+
+        photos.push_back(data);
+    }
+
+    auto idOf = [](const QString& path)
+    {
+        const QStringList pathSplitted = path.split(" ");
+        assert(pathSplitted.size() == 2);
+
+        return pathSplitted.back().toInt();
+    };
+
+    // id:1 -> 1, id:2 -> 1, id:3 -> 2, id:4 -> 2 ...
+    ON_CALL(exif, get(_, IExifReader::TagType::SequenceNumber)).WillByDefault(Invoke([idOf](const QString& path, IExifReader::TagType) -> std::optional<std::any>
+    {
+        return std::any( (idOf(path) - 1) / 2 + 1 );
+    }));
+
+    // odd ids were taken with first camera, even ids with second one
+    ON_CALL(exif, get(_, IExifReader::TagType::CameraModel)).WillByDefault(Invoke([idOf](const QString& path, IExifReader::TagType) -> std::optional<std::any>
+    {
+        return std::any( std::string(idOf(path) % 2 == 1? "camera 1": "camera 2") );
+    }));
+
+    std::vector<SeriesDetector::GroupCandidate> candidates;
+
+    const SeriesDetector sd(&exif);
+    sd.listCandidates(photos, SeriesDetector::Rules(), [&candidates](const SeriesDetector::GroupCandidate& candidate)
+    {
+        candidates.push_back(candidate);
+    });
+
+    ASSERT_EQ(candidates.size(), 2);
+
+    for (const SeriesDetector::GroupCandidate& candidate: candidates)
+    {
+        EXPECT_EQ(candidate.type, Group::Type::Animation);
+        ASSERT_EQ(candidate.members.size(), 3);
+
+        const int camera = candidate.members.front().id.value() % 2;
+        for (const Photo::Data& member: candidate.members)
+            EXPECT_EQ(member.id.value() % 2, camera);
+    }
+}
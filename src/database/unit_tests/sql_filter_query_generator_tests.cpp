@@ -179,7 +179,7 @@ TEST(SqlFilterQueryGeneratorTest, HandlesSha256Filter)
 
     const QString query = generator.generate(filter);
 
-    EXPECT_EQ("SELECT id FROM photos "
+    EXPECT_EQ("SELECT photos.id FROM photos "
               "JOIN (sha256sums) ON (sha256sums.photo_id = photos.id) "
               "WHERE sha256sums.sha256 = '1234567890'", query);
 }
@@ -224,7 +224,7 @@ TEST(SqlFilterQueryGeneratorTest, HandlesSimpleMergesWell)
         "SELECT id FROM photos "
         "WHERE id IN "
         "("
-            "SELECT id FROM photos JOIN (sha256sums) ON (sha256sums.photo_id = photos.id) "
+            "SELECT photos.id FROM photos JOIN (sha256sums) ON (sha256sums.photo_id = photos.id) "
             "WHERE sha256sums.sha256 = '1234567890'"
         ") "
         "AND id IN "
@@ -336,13 +336,15 @@ TEST(SqlFilterQueryGeneratorTest, SimpleFilterPhotosMatchingExpression)
 
     const QString expected_query =
         "SELECT photos.id FROM photos "
-        "WHERE photos.id IN "
+        "WHERE "
         "("
-            "SELECT photos.id FROM photos JOIN (tags) ON (photos.id = tags.photo_id) WHERE (tags.value LIKE '%Person 1%')"
+            "photos.id IN (SELECT search_terms.photo_id FROM search_terms WHERE search_terms.term >= 'person' AND search_terms.term < 'persoo') AND "
+            "photos.id IN (SELECT search_terms.photo_id FROM search_terms WHERE search_terms.term >= '1' AND search_terms.term < '2')"
         ") "
         "OR photos.id IN "
         "("
-            "SELECT photos.id FROM photos JOIN (people, people_names) ON (photos.id = people.photo_id AND people.person_id = people_names.id) WHERE (people_names.name LIKE '%Person 1%')"
+            "SELECT people.photo_id FROM people JOIN people_names ON (people.person_id = people_names.id) "
+            "WHERE (people_names.name LIKE 'person%' OR people_names.name LIKE '% person%') AND (people_names.name LIKE '1%' OR people_names.name LIKE '% 1%')"
         ")";
 
     EXPECT_EQ(expected_query, query);
@@ -353,20 +355,30 @@ TEST(SqlFilterQueryGeneratorTest, FilterPhotosMatchingDoubleExpression)
 {
     Database::SqlFilterQueryGenerator generator;
 
-    const SearchExpressionEvaluator::Expression expression = { {"Person 1", false}, {"Person 2", false} };
+    const SearchExpressionEvaluator::Expression expression = { {"Person", false}, {"Anna's", true} };
     Database::FilterPhotosMatchingExpression filter(expression);
 
     const QString query = generator.generate(filter);
 
     const QString expected_query =
         "SELECT photos.id FROM photos "
-        "WHERE photos.id IN "
+        "WHERE "
+        "("
+            "photos.id IN (SELECT search_terms.photo_id FROM search_terms WHERE search_terms.term >= 'person' AND search_terms.term < 'persoo')"
+        ") "
+        "OR photos.id IN "
+        "("
+            "SELECT people.photo_id FROM people JOIN people_names ON (people.person_id = people_names.id) "
+            "WHERE (people_names.name LIKE 'person%' OR people_names.name LIKE '% person%')"
+        ") "
+        "OR "
         "("
-            "SELECT photos.id FROM photos JOIN (tags) ON (photos.id = tags.photo_id) WHERE (tags.value LIKE '%Person 1%' OR tags.value LIKE '%Person 2%')"
+            "photos.id IN (SELECT tags.photo_id FROM tags WHERE tags.value = 'Anna''s')"
         ") "
         "OR photos.id IN "
         "("
-            "SELECT photos.id FROM photos JOIN (people, people_names) ON (photos.id = people.photo_id AND people.person_id = people_names.id) WHERE (people_names.name LIKE '%Person 1%' OR people_names.name LIKE '%Person 2%')"
+            "SELECT people.photo_id FROM people JOIN people_names ON (people.person_id = people_names.id) "
+            "WHERE people_names.name = 'Anna''s'"
         ")";
 
     EXPECT_EQ(expected_query, query);
@@ -397,7 +409,7 @@ TEST(SqlFilterQueryGeneratorTest, FiltersPhotosByGroupRepresentativeRole)
 
     const QString query = generator.generate(filter);
 
-    EXPECT_EQ("SELECT groups.representative_id FROM groups", query);
+    EXPECT_EQ("SELECT photos.id FROM photos WHERE photos.id IN (SELECT groups.representative_id FROM groups)", query);
 }
 
 
@@ -408,7 +420,7 @@ TEST(SqlFilterQueryGeneratorTest, FiltersPhotosByGroupMemberRole)
 
     const QString query = generator.generate(filter);
 
-    EXPECT_EQ("SELECT groups_members.photo_id FROM groups_members", query);
+    EXPECT_EQ("SELECT photos.id FROM photos WHERE photos.id IN (SELECT groups_members.photo_id FROM groups_members)", query);
 }
 
 
@@ -8,7 +8,6 @@
 
 #include "database_tools/tag_info_collector.hpp"
 #include "unit_tests_utils/mock_database.hpp"
-#include "unit_tests_utils/mock_photo_info.hpp"
 #include "unit_tests_utils/mock_backend.hpp"
 #include "unit_tests_utils/mock_db_utils.hpp"
 
@@ -19,11 +18,14 @@ using ::testing::ReturnRef;
 using ::testing::Return;
 using ::testing::_;
 using ::testing::NiceMock;
+using ::testing::UnorderedElementsAre;
 
 
 struct Observer: QObject
 {
     MOCK_METHOD1(event, void(const TagTypes &));
+    MOCK_METHOD2(added, void(const TagTypes &, const std::vector<TagValue> &));
+    MOCK_METHOD2(removed, void(const TagTypes &, const std::vector<TagValue> &));
 };
 
 
@@ -45,6 +47,16 @@ class TagInfoCollectorTest: public testing::Test
                 .WillByDefault(ReturnRef(utils));
         }
 
+        void setPhotosTags(const std::vector<Tag::TagsList>& photosTags)
+        {
+            Database::TagValuesCounts counts;
+            for(const Tag::TagsList& tags: photosTags)
+                Database::countTagValues(counts, {}, tags);
+
+            ON_CALL(backend, tagValuesCounts())
+                .WillByDefault(Return(counts));
+        }
+
         NiceMock<MockBackend> backend;
         NiceMock<MockDatabase> database;
         NiceMock<MockUtils> utils;
@@ -77,142 +89,46 @@ TEST_F(TagInfoCollectorTest, GetWithoutDatabase)
 
 TEST_F(TagInfoCollectorTest, LoadDataOnDatabaseSet)
 {
-    EXPECT_CALL(backend, listTagValues(TagTypes::Date, _))
-        .WillOnce( Return(std::vector<TagValue>{QDate(0, 1, 2), QDate(1, 2, 3)}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Event, _))
-        .WillOnce( Return(std::vector<TagValue>{QString("event1"), QString("event2")}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Time, _))
-        .WillOnce( Return(std::vector<TagValue>{QTime(2, 3), QTime(3, 4), QTime(11, 18)}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Place, _))
-        .WillOnce( Return(std::vector<TagValue>{QString("12"), QString("23")}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Rating, _))
-        .WillOnce( Return(std::vector<TagValue>{5, 2, 0}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Category, _))
-        .WillOnce( Return(std::vector<TagValue>{QColor(Qt::red), QColor(Qt::blue)}) );
+    setPhotosTags({
+        { {TagTypes::Date, QDate(0, 1, 2)}, {TagTypes::Event, QString("event1")}, {TagTypes::Time, QTime(2, 3)},
+          {TagTypes::Place, QString("12")}, {TagTypes::Rating, 5}, {TagTypes::Category, QColor(Qt::red)} },
+        { {TagTypes::Date, QDate(1, 2, 3)}, {TagTypes::Event, QString("event2")}, {TagTypes::Time, QTime(3, 4)},
+          {TagTypes::Place, QString("23")}, {TagTypes::Rating, 2}, {TagTypes::Category, QColor(Qt::blue)} },
+        { {TagTypes::Date, QDate(1, 2, 3)}, {TagTypes::Event, QString("event2")}, {TagTypes::Time, QTime(11, 18)},
+          {TagTypes::Rating, 0} },
+    });
 
     TagInfoCollector tagInfoCollector;
     tagInfoCollector.set(&database);
 
-    const std::vector<TagValue>& dates = tagInfoCollector.get(TagTypes::Date);
-    ASSERT_EQ(dates.size(), 2);
-    EXPECT_EQ(dates[0].getDate(), QDate(0, 1, 2));
-    EXPECT_EQ(dates[1].getDate(), QDate(1, 2, 3));
-
-    const std::vector<TagValue>& events = tagInfoCollector.get(TagTypes::Event);
-    ASSERT_EQ(events.size(), 2);
-    EXPECT_EQ(events[0].getString(), "event1");
-    EXPECT_EQ(events[1].getString(), "event2");
-
-    const std::vector<TagValue>& times = tagInfoCollector.get(TagTypes::Time);
-    ASSERT_EQ(times.size(), 3);
-    EXPECT_EQ(times[0].getTime(), QTime(2, 3));
-    EXPECT_EQ(times[1].getTime(), QTime(3, 4));
-    EXPECT_EQ(times[2].getTime(), QTime(11, 18));
-
-    const std::vector<TagValue>& places = tagInfoCollector.get(TagTypes::Place);
-    ASSERT_EQ(places.size(), 2);
-    EXPECT_EQ(places[0].getString(), "12");
-    EXPECT_EQ(places[1].getString(), "23");
-
-    const std::vector<TagValue>& ratings = tagInfoCollector.get(TagTypes::Rating);
-    ASSERT_EQ(ratings.size(), 3);
-    EXPECT_EQ(ratings[0].get<int>(), 5);
-    EXPECT_EQ(ratings[1].get<int>(), 2);
-    EXPECT_EQ(ratings[2].get<int>(), 0);
-
-    const std::vector<TagValue>& categories = tagInfoCollector.get(TagTypes::Category);
-    ASSERT_EQ(categories.size(), 2);
-    EXPECT_EQ(categories[0].get<QColor>(), Qt::red);
-    EXPECT_EQ(categories[1].get<QColor>(), Qt::blue);
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Date), UnorderedElementsAre(QDate(0, 1, 2), QDate(1, 2, 3)));
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Event), UnorderedElementsAre(QString("event1"), QString("event2")));
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Time), UnorderedElementsAre(QTime(2, 3), QTime(3, 4), QTime(11, 18)));
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Place), UnorderedElementsAre(QString("12"), QString("23")));
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Rating), UnorderedElementsAre(5, 2, 0));
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Category), UnorderedElementsAre(QColor(Qt::red), QColor(Qt::blue)));
 }
 
 
 TEST_F(TagInfoCollectorTest, EmptyDatabase)
 {
-    EXPECT_CALL(backend, listTagValues(TagTypes::Date, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Event, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Time, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Place, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Rating, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Category, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
     TagInfoCollector tagInfoCollector;
     tagInfoCollector.set(&database);
 
-    const std::vector<TagValue>& dates = tagInfoCollector.get(TagTypes::Date);
-    EXPECT_TRUE(dates.empty());
-
-    const std::vector<TagValue>& events = tagInfoCollector.get(TagTypes::Event);
-    EXPECT_TRUE(events.empty());
-
-    const std::vector<TagValue>& times = tagInfoCollector.get(TagTypes::Time);
-    EXPECT_TRUE(times.empty());
-
-    const std::vector<TagValue>& places = tagInfoCollector.get(TagTypes::Place);
-    EXPECT_TRUE(places.empty());
-
-    const std::vector<TagValue>& ratings = tagInfoCollector.get(TagTypes::Rating);
-    EXPECT_TRUE(ratings.empty());
-
-    const std::vector<TagValue>& categories = tagInfoCollector.get(TagTypes::Category);
-    EXPECT_TRUE(categories.empty());
+    for(const TagTypes& tag: BaseTags::getAll())
+    {
+        const std::vector<TagValue>& values = tagInfoCollector.get(tag);
+        EXPECT_TRUE(values.empty());
+    }
 }
 
 
 TEST_F(TagInfoCollectorTest, ReactionOnDBChange)
 {
-    EXPECT_CALL(backend, listTagValues(TagTypes::Date, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Event, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Time, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Place, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Rating, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Category, _))
-        .WillOnce( Return( std::vector<TagValue>()) );
-
     TagInfoCollector tagInfoCollector;
     tagInfoCollector.set(&database);
 
-    auto photoInfo = std::make_shared<NiceMock<MockPhotoInfo>>();
-    Tag::TagsList tags = {
-        { TagTypes::Event, TagValue(QString("event 1")) }
-    };
-
-    EXPECT_CALL(*photoInfo, getTags())
-        .WillOnce(Return(tags));
-
-    ON_CALL(*photoInfo, getID)
-        .WillByDefault(Return(Photo::Id(1)));
-
-    ON_CALL(utils, getPhotoFor(Photo::Id(1)))
-        .WillByDefault(Return(photoInfo));
-
-    emit backend.photosModified({ photoInfo->getID() });
+    emit backend.tagValuesChanged({ { TagTypes::Event, { {TagValue(QString("event 1")), 1} } } });
 
     const std::vector<TagValue>& event = tagInfoCollector.get(TagTypes::Event);
     ASSERT_EQ(event.size(), 1);
@@ -222,81 +138,120 @@ TEST_F(TagInfoCollectorTest, ReactionOnDBChange)
 
 TEST_F(TagInfoCollectorTest, ObserversNotification)
 {
-    EXPECT_CALL(backend, listTagValues(TagTypes::Date, _))
-        .WillOnce( Return(std::vector<TagValue>{QDate(0, 1, 2), QDate(1, 2, 3)}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Event, _))
-        .WillOnce( Return( std::vector<TagValue>{QString("event1"), QString("event2")}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Time, _))
-        .WillOnce( Return( std::vector<TagValue>{QTime(2, 3), QTime(3, 4), QTime(11, 18)}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Place, _))
-        .WillOnce( Return( std::vector<TagValue>{QString("12"), QString("23")}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Rating, _))
-        .WillOnce( Return( std::vector<TagValue>{5, 2, 0}) );
-
-    EXPECT_CALL(backend, listTagValues(TagTypes::Category, _))
-        .WillOnce( Return( std::vector<TagValue>{QColor(Qt::yellow), QColor(Qt::cyan)}) );
+    setPhotosTags({
+        { {TagTypes::Date, QDate(0, 1, 2)}, {TagTypes::Event, QString("event1")}, {TagTypes::Time, QTime(2, 3)} },
+        { {TagTypes::Date, QDate(1, 2, 3)}, {TagTypes::Event, QString("event2")}, {TagTypes::Time, QTime(3, 4)} },
+    });
 
     Observer observer;
 
     // called 6 times by TagInfoCollector for each of TagName after database is set
-    //      + 2 times after photo modification (for each tag name)
     EXPECT_CALL(observer, event(_))
-        .Times(8);
+        .Times(6);
+
+    // called 2 times after photo modification (for each tag name with new value)
+    EXPECT_CALL(observer, added(TagTypes::Time, std::vector<TagValue>{QTime(20, 21)}));
+    EXPECT_CALL(observer, added(TagTypes::Event, std::vector<TagValue>{QString("event123")}));
+
+    // previous time and event values of photo are not used anymore, date did not change
+    EXPECT_CALL(observer, removed(TagTypes::Time, std::vector<TagValue>{QTime(2, 3)}));
+    EXPECT_CALL(observer, removed(TagTypes::Event, std::vector<TagValue>{QString("event1")}));
 
     TagInfoCollector tagInfoCollector;
     QObject::connect(&tagInfoCollector, &TagInfoCollector::setOfValuesChanged,
                      &observer, &Observer::event);
+    QObject::connect(&tagInfoCollector, &TagInfoCollector::valuesAdded,
+                     &observer, &Observer::added);
+    QObject::connect(&tagInfoCollector, &TagInfoCollector::valuesRemoved,
+                     &observer, &Observer::removed);
 
     tagInfoCollector.set(&database);
 
-    auto photoInfo = std::make_shared<NiceMock<MockPhotoInfo>>();
-    Tag::TagsList tags = {
-                            { TagTypes::Time, TagValue(QTime(20, 21)) },
-                            { TagTypes::Event, TagValue(QString("event123")) }
-    };
+    // first photo changes its time and event
+    Database::TagValuesCounts changes;
+    Database::countTagValues(changes,
+                             { {TagTypes::Date, QDate(0, 1, 2)}, {TagTypes::Event, QString("event1")},   {TagTypes::Time, QTime(2, 3)} },
+                             { {TagTypes::Date, QDate(0, 1, 2)}, {TagTypes::Event, QString("event123")}, {TagTypes::Time, QTime(20, 21)} });
 
-    EXPECT_CALL(*photoInfo, getTags())
-        .WillOnce(Return(tags));
+    emit backend.tagValuesChanged(changes);
+}
+
+
+TEST_F(TagInfoCollectorTest, ValuesSharedByPhotosAreKept)
+{
+    setPhotosTags({
+        { {TagTypes::Event, QString("event1")} },
+        { {TagTypes::Event, QString("event1")} },
+        { {TagTypes::Event, QString("event2")} },
+    });
 
-    ON_CALL(*photoInfo, getID)
-        .WillByDefault(Return(Photo::Id(1)));
+    TagInfoCollector tagInfoCollector;
+    tagInfoCollector.set(&database);
 
-    ON_CALL(utils, getPhotoFor(Photo::Id(1)))
-        .WillByDefault(Return(photoInfo));
+    Observer observer;
+    EXPECT_CALL(observer, added(_, _)).Times(0);
+    EXPECT_CALL(observer, removed(_, _)).Times(0);
 
-    emit backend.photosModified({ photoInfo->getID() });
+    QObject::connect(&tagInfoCollector, &TagInfoCollector::valuesAdded,
+                     &observer, &Observer::added);
+    QObject::connect(&tagInfoCollector, &TagInfoCollector::valuesRemoved,
+                     &observer, &Observer::removed);
+
+    // one of photos with event1 is changed to event2 - set of values does not change
+    emit backend.tagValuesChanged({ { TagTypes::Event, { {TagValue(QString("event1")), -1}, {TagValue(QString("event2")), 1} } } });
+
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Event), UnorderedElementsAre(QString("event1"), QString("event2")));
 }
 
 
-TEST_F(TagInfoCollectorTest, ReactionOnPhotoChange)
+TEST_F(TagInfoCollectorTest, ReactionOnPhotosRemoval)
 {
+    setPhotosTags({
+        { {TagTypes::Event, QString("event1")}, {TagTypes::Place, QString("place")} },
+        { {TagTypes::Event, QString("event2")}, {TagTypes::Place, QString("place")} },
+    });
+
     TagInfoCollector tagInfoCollector;
     tagInfoCollector.set(&database);
 
-    auto photoInfo = std::make_shared<NiceMock<MockPhotoInfo>>();
-    Tag::TagsList tags = {
-                            { TagTypes::Time, TagValue(QTime(2, 5)) },
-                            { TagTypes::Event, TagValue(QString("event123")) }
-    };
+    Observer observer;
+    EXPECT_CALL(observer, removed(TagTypes::Event, std::vector<TagValue>{QString("event2")}));
+
+    QObject::connect(&tagInfoCollector, &TagInfoCollector::valuesRemoved,
+                     &observer, &Observer::removed);
+
+    // second photo is removed
+    emit backend.tagValuesChanged({
+        { TagTypes::Event, { {TagValue(QString("event2")), -1} } },
+        { TagTypes::Place, { {TagValue(QString("place")), -1} } },
+    });
+
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Event), UnorderedElementsAre(QString("event1")));
+    EXPECT_THAT(tagInfoCollector.get(TagTypes::Place), UnorderedElementsAre(QString("place")));
+}
+
 
-    EXPECT_CALL(*photoInfo.get(), getTags())
-        .WillOnce(Return(tags));
+TEST_F(TagInfoCollectorTest, ChangesIncludedInCountsAreNotAppliedTwice)
+{
+    TagInfoCollector tagInfoCollector;
 
-    ON_CALL(*photoInfo, getID)
-        .WillByDefault(Return(Photo::Id(1)));
+    // counts are read in database's thread and delivered after changes made before reading them
+    std::unique_ptr<MockDatabase::ITask> pendingTask;
+    EXPECT_CALL(database, execute(_))
+        .WillOnce(Invoke([&pendingTask](std::unique_ptr<MockDatabase::ITask>&& task)
+        {
+            pendingTask = std::move(task);
+        }));
 
-    ON_CALL(utils, getPhotoFor(Photo::Id(1)))
-        .WillByDefault(Return(photoInfo));
+    setPhotosTags({ { {TagTypes::Event, QString("event1")} } });
+    tagInfoCollector.set(&database);
 
-    emit backend.photosModified({ photoInfo->getID() });
+    // change made before counts were read is already included in them
+    emit backend.tagValuesChanged({ { TagTypes::Event, { {TagValue(QString("event1")), 1} } } });
+    pendingTask->run(backend);
 
-    auto event = tagInfoCollector.get(TagTypes::Event);
+    // removal of the only photo using event1 drops value
+    emit backend.tagValuesChanged({ { TagTypes::Event, { {TagValue(QString("event1")), -1} } } });
 
-    ASSERT_EQ(event.size(), 1);
-    ASSERT_EQ(event[0].type(), Tag::ValueType::String);
-    EXPECT_EQ(event[0].getString(), "event123");
+    EXPECT_TRUE(tagInfoCollector.get(TagTypes::Event).empty());
 }
@@ -0,0 +1,475 @@
+
+#include <algorithm>
+#include <random>
+
+#include "common.hpp"
+
+
+// Runs the same random sequences of operations on SQLite and Memory backends
+// and expects both to give the same answers.
+// Ids generated by backends differ, so results are compared as indexes of photos/groups in order of creation.
+
+namespace
+{
+    // small pools, so operations hit the same values frequently
+    const std::vector<QString> Paths = { "/a.jpeg", "/b.jpeg", "/c.jpeg", "/d.jpeg" };
+    const std::vector<QString> Events = { "birthday", "holiday", "wedding" };
+    const std::vector<QString> Places = { "home", "beach", "mountains" };
+    const std::vector<QString> Phrases = { "day", "HOLI", "beach", "o", "anna", "3" };
+    const std::vector<QString> Names = { "anna", "bob" };
+    const std::vector<QString> GeneralFlags = { "flag1", "flag2" };
+    const std::vector<QByteArray> Checksums = { "0123456789", "9876543210" };
+
+    const std::vector<Photo::FlagsE> Flags =
+    {
+        Photo::FlagsE::StagingArea,
+        Photo::FlagsE::ExifLoaded,
+        Photo::FlagsE::Sha256Loaded,
+    };
+
+    const std::vector<Database::FilterPhotosWithTag::ValueMode> ValueModes =
+    {
+        Database::FilterPhotosWithTag::ValueMode::Equal,
+        Database::FilterPhotosWithTag::ValueMode::Less,
+        Database::FilterPhotosWithTag::ValueMode::LessOrEqual,
+        Database::FilterPhotosWithTag::ValueMode::Greater,
+        Database::FilterPhotosWithTag::ValueMode::GreaterOrEqual,
+    };
+
+    int randomInt(std::mt19937& rng, int from, int to)
+    {
+        return std::uniform_int_distribution<int>(from, to)(rng);
+    }
+
+    template<typename T>
+    const T& pick(std::mt19937& rng, const std::vector<T>& items)
+    {
+        return items[randomInt(rng, 0, static_cast<int>(items.size()) - 1)];
+    }
+
+    // backend with ids of items created in it
+    struct Side
+    {
+        Database::IBackend* backend;
+        std::vector<Photo::Id> photos;
+        std::vector<Group::Id> groups;
+        std::vector<Person::Id> people;
+
+        template<typename T>
+        static int indexOf(const std::vector<T>& items, const T& id)
+        {
+            const auto it = std::find(items.cbegin(), items.cend(), id);
+            return it == items.cend()? -1: static_cast<int>(std::distance(items.cbegin(), it));
+        }
+
+        std::vector<int> indexes(const std::vector<Photo::Id>& ids) const
+        {
+            std::vector<int> result;
+            for (const Photo::Id& id: ids)
+                result.push_back(indexOf(photos, id));
+
+            std::sort(result.begin(), result.end());
+
+            return result;
+        }
+    };
+
+    Tag::TagsList randomTags(std::mt19937& rng)
+    {
+        Tag::TagsList tags;
+
+        if (randomInt(rng, 0, 1))
+            tags[TagTypes::Event] = TagValue(pick(rng, Events));
+
+        if (randomInt(rng, 0, 1))
+            tags[TagTypes::Place] = TagValue(pick(rng, Places));
+
+        if (randomInt(rng, 0, 1))
+            tags[TagTypes::Rating] = TagValue(randomInt(rng, 0, 5));
+
+        return tags;
+    }
+
+    Photo::FlagValues randomFlags(std::mt19937& rng)
+    {
+        Photo::FlagValues flags;
+
+        for (const Photo::FlagsE flag: Flags)
+            if (randomInt(rng, 0, 1))
+                flags[flag] = randomInt(rng, 0, 1);
+
+        return flags;
+    }
+
+    Database::Filter randomFilter(std::mt19937& rng, const Side& side, int depth)
+    {
+        switch (randomInt(rng, 0, depth > 0? 12: 10))
+        {
+            case 0:
+                return Database::EmptyFilter();
+
+            case 1:
+            {
+                const TagTypes type = randomInt(rng, 0, 1)? TagTypes::Event: TagTypes::Place;
+                const TagValue value = randomInt(rng, 0, 3) == 0? TagValue(): TagValue(pick(rng, type == TagTypes::Event? Events: Places));
+
+                return Database::FilterPhotosWithTag(type, value, pick(rng, ValueModes), randomInt(rng, 0, 1));
+            }
+
+            case 2:
+                return Database::FilterPhotosWithTag(TagTypes::Rating, TagValue(randomInt(rng, 0, 5)), pick(rng, ValueModes), randomInt(rng, 0, 1));
+
+            case 3:
+            {
+                Database::FilterPhotosWithFlags filter;
+                filter.mode = randomInt(rng, 0, 1)? Database::FilterPhotosWithFlags::Mode::And: Database::FilterPhotosWithFlags::Mode::Or;
+
+                const int count = randomInt(rng, 1, 2);
+                for (int i = 0; i < count; i++)
+                    filter.flags[pick(rng, Flags)] = randomInt(rng, 0, 1);
+
+                return filter;
+            }
+
+            case 4:
+            {
+                Database::FilterPhotosWithSha256 filter;
+                filter.sha256 = pick(rng, Checksums);
+
+                return filter;
+            }
+
+            case 5:
+            {
+                Database::FilterPhotosWithId filter;
+                if (side.photos.empty() == false)
+                    filter.filter = pick(rng, side.photos);
+
+                return filter;
+            }
+
+            case 6:
+                return Database::FilterPhotosMatchingExpression( { SearchExpressionEvaluator::Filter(pick(rng, Phrases), randomInt(rng, 0, 1)) } );
+
+            case 7:
+                return Database::FilterPhotosWithPath(pick(rng, Paths));
+
+            case 8:
+            {
+                const std::vector<Database::FilterPhotosWithRole::Role> roles =
+                {
+                    Database::FilterPhotosWithRole::Role::Regular,
+                    Database::FilterPhotosWithRole::Role::GroupRepresentative,
+                    Database::FilterPhotosWithRole::Role::GroupMember,
+                };
+
+                return Database::FilterPhotosWithRole(pick(rng, roles));
+            }
+
+            case 9:
+                return Database::FilterPhotosWithGeneralFlags(pick(rng, GeneralFlags), randomInt(rng, 0, 1));
+
+            case 10:
+                return side.people.empty()?
+                           Database::Filter(Database::EmptyFilter()):
+                           Database::Filter(Database::FilterPhotosWithPerson(pick(rng, side.people)));
+
+            case 11:
+                return Database::FilterNotMatchingFilter(randomFilter(rng, side, depth - 1));
+
+            default:
+            {
+                const Database::Filter lhs = randomFilter(rng, side, depth - 1);
+                const Database::Filter rhs = randomFilter(rng, side, depth - 1);
+
+                return Database::GroupFilter( {lhs, rhs} );
+            }
+        }
+    }
+}
+
+
+struct BackendsComparisonTest: testing::Test
+{
+    BackendsComparisonTest()
+        : testing::Test()
+    {
+    }
+
+    void run(unsigned int seed, int steps)
+    {
+        const QString db_path = m_wd.path() + QString("/SQLite%1").arg(seed);
+        QDir().mkdir(db_path);
+
+        auto sqlite = construct<Database::SQLiteBackend>(&m_logger);
+        auto memory = construct<Database::MemoryBackend>(&m_logger);
+
+        ASSERT_TRUE(sqlite->init(Database::ProjectInfo(db_path + "/db", "SQLite")));
+        ASSERT_TRUE(memory->init(Database::ProjectInfo("", "Memory")));
+
+        m_sqlite = Side{sqlite.get(), {}, {}, {}};
+        m_memory = Side{memory.get(), {}, {}, {}};
+        m_rng.seed(seed);
+
+        for (int step = 0; step < steps && testing::Test::HasFailure() == false; step++)
+        {
+            SCOPED_TRACE(QString("seed: %1, step: %2").arg(seed).arg(step).toStdString());
+
+            randomOperation();
+            compare();
+        }
+
+        sqlite->closeConnections();
+        memory->closeConnections();
+    }
+
+    // perform the same operation on both sides
+    template<typename F>
+    void onBoth(const F& operation)
+    {
+        const std::mt19937 state = m_rng;
+
+        std::mt19937 sqliteRng = state;
+        operation(m_sqlite, sqliteRng);
+
+        std::mt19937 memoryRng = state;
+        operation(m_memory, memoryRng);
+
+        m_rng = sqliteRng;
+    }
+
+    std::vector<int> alivePhotos()
+    {
+        const std::vector<Photo::Id> ids = m_memory.backend->photoOperator().getPhotos(Database::EmptyFilter());
+
+        return m_memory.indexes(ids);
+    }
+
+    void randomOperation()
+    {
+        const std::vector<int> alive = alivePhotos();
+        const int operation = alive.size() < 3? 0: randomInt(m_rng, 0, 8);
+
+        switch (operation)
+        {
+            case 0:     // add photos
+                onBoth([](Side& side, std::mt19937& rng)
+                {
+                    std::vector<Photo::DataDelta> photos(randomInt(rng, 1, 3));
+
+                    for (Photo::DataDelta& photo: photos)
+                    {
+                        photo.insert<Photo::Field::Path>(pick(rng, Paths));
+                        photo.insert<Photo::Field::Tags>(randomTags(rng));
+
+                        if (randomInt(rng, 0, 1))
+                            photo.insert<Photo::Field::Flags>(randomFlags(rng));
+
+                        if (randomInt(rng, 0, 1))
+                            photo.insert<Photo::Field::Checksum>(pick(rng, Checksums));
+                    }
+
+                    EXPECT_TRUE(side.backend->addPhotos(photos));
+
+                    for (const Photo::DataDelta& photo: photos)
+                        side.photos.push_back(photo.getId());
+                });
+                break;
+
+            case 1:     // modify tags
+            case 2:     // modify flags
+                onBoth([&alive, operation](Side& side, std::mt19937& rng)
+                {
+                    Photo::DataDelta delta(side.photos[pick(rng, alive)]);
+
+                    if (operation == 1)
+                        delta.insert<Photo::Field::Tags>(randomTags(rng));
+                    else
+                        delta.insert<Photo::Field::Flags>(randomFlags(rng));
+
+                    EXPECT_TRUE(side.backend->update( {delta} ));
+                });
+                break;
+
+            case 3:     // general flags
+                onBoth([&alive](Side& side, std::mt19937& rng)
+                {
+                    const Photo::Id id = side.photos[pick(rng, alive)];
+                    const QString& name = pick(rng, GeneralFlags);
+
+                    side.backend->set(id, name, randomInt(rng, 0, 1));
+                });
+                break;
+
+            case 4:     // new group
+            {
+                std::vector<int> ungrouped;
+                for (int i: alive)
+                    if (m_memory.backend->getPhoto(m_memory.photos[i]).groupInfo.role == GroupInfo::None)
+                        ungrouped.push_back(i);
+
+                if (ungrouped.size() >= 2)
+                {
+                    std::shuffle(ungrouped.begin(), ungrouped.end(), m_rng);
+                    ungrouped.resize(std::min<std::size_t>(ungrouped.size(), randomInt(m_rng, 2, 4)));
+
+                    onBoth([&ungrouped](Side& side, std::mt19937 &)
+                    {
+                        Database::GroupDefinition group;
+                        group.representative = side.photos[ungrouped.front()];
+                        group.type = Group::Type::Animation;
+
+                        for (auto it = std::next(ungrouped.cbegin()); it != ungrouped.cend(); ++it)
+                            group.members.push_back(side.photos[*it]);
+
+                        const std::vector<Group::Id> ids = side.backend->groupOperator().addGroups( {group} );
+                        ASSERT_EQ(ids.size(), 1);
+
+                        side.groups.push_back(ids.front());
+                    });
+                }
+                break;
+            }
+
+            case 5:     // group removal
+            {
+                std::vector<int> groups;
+                for (std::size_t i = 0; i < m_memory.groups.size(); i++)
+                    if (m_memory.backend->groupOperator().type(m_memory.groups[i]) != Group::Type::Invalid)
+                        groups.push_back(static_cast<int>(i));
+
+                if (groups.empty() == false)
+                {
+                    const int group = pick(m_rng, groups);
+
+                    onBoth([group](Side& side, std::mt19937 &)
+                    {
+                        side.backend->groupOperator().removeGroups( {side.groups[group]} );
+                    });
+                }
+                break;
+            }
+
+            case 6:     // person on photo
+                onBoth([&alive](Side& side, std::mt19937& rng)
+                {
+                    const Photo::Id id = side.photos[pick(rng, alive)];
+                    const QString& name = pick(rng, Names);
+                    const int position = randomInt(rng, 0, 3);
+
+                    Database::IPeopleInformationAccessor& people = side.backend->peopleInformationAccessor();
+                    const Person::Id pid = people.store(PersonName(name));
+
+                    if (std::find(side.people.cbegin(), side.people.cend(), pid) == side.people.cend())
+                        side.people.push_back(pid);
+
+                    people.store(PersonInfo(pid, id, PersonFingerprint::Id(), QRect(position * 10, 0, 10, 10)));
+                });
+                break;
+
+            case 7:     // review
+            {
+                std::vector<int> reviewed[2];
+                int side_idx = 0;
+
+                onBoth([&reviewed, &side_idx](Side& side, std::mt19937 &)
+                {
+                    reviewed[side_idx++] = side.indexes(side.backend->markStagedAsReviewed());
+                });
+
+                EXPECT_EQ(reviewed[0], reviewed[1]);
+                break;
+            }
+
+            default:    // removal (rare)
+                if (randomInt(m_rng, 0, 3) == 0)
+                    onBoth([](Side& side, std::mt19937& rng)
+                    {
+                        const Database::Filter filter = randomFilter(rng, side, 1);
+                        EXPECT_TRUE(side.backend->photoOperator().removePhotos(filter));
+                    });
+                break;
+        }
+    }
+
+    void compare()
+    {
+        const std::vector<int> alive = alivePhotos();
+        EXPECT_EQ(m_sqlite.indexes(m_sqlite.backend->photoOperator().getPhotos(Database::EmptyFilter())), alive);
+
+        // photos details
+        for (int i: alive)
+        {
+            const Photo::Data sqlitePhoto = m_sqlite.backend->getPhoto(m_sqlite.photos[i]);
+            const Photo::Data memoryPhoto = m_memory.backend->getPhoto(m_memory.photos[i]);
+
+            EXPECT_EQ(sqlitePhoto.path, memoryPhoto.path);
+            EXPECT_EQ(sqlitePhoto.sha256Sum, memoryPhoto.sha256Sum);
+            EXPECT_EQ(sqlitePhoto.flags, memoryPhoto.flags);
+            EXPECT_EQ(sqlitePhoto.groupInfo.role, memoryPhoto.groupInfo.role);
+            EXPECT_EQ(Side::indexOf(m_sqlite.groups, sqlitePhoto.groupInfo.group_id),
+                      Side::indexOf(m_memory.groups, memoryPhoto.groupInfo.group_id));
+
+            std::map<TagTypes, QString> sqliteTags, memoryTags;
+            for (const auto& [type, value]: sqlitePhoto.tags)
+                sqliteTags.emplace(type, value.rawValue());
+
+            for (const auto& [type, value]: memoryPhoto.tags)
+                memoryTags.emplace(type, value.rawValue());
+
+            EXPECT_EQ(sqliteTags, memoryTags);
+        }
+
+        // groups
+        for (std::size_t i = 0; i < m_memory.groups.size(); i++)
+        {
+            EXPECT_EQ(m_sqlite.backend->groupOperator().type(m_sqlite.groups[i]),
+                      m_memory.backend->groupOperator().type(m_memory.groups[i]));
+
+            EXPECT_EQ(m_sqlite.indexes(m_sqlite.backend->groupOperator().membersOf(m_sqlite.groups[i])),
+                      m_memory.indexes(m_memory.backend->groupOperator().membersOf(m_memory.groups[i])));
+        }
+
+        // filters
+        for (int i = 0; i < 10; i++)
+        {
+            std::vector<int> photos[2];
+            int count[2];
+            std::vector<QString> values[2];
+            int side_idx = 0;
+
+            onBoth([&](Side& side, std::mt19937& rng)
+            {
+                const Database::Filter filter = randomFilter(rng, side, 2);
+
+                photos[side_idx] = side.indexes(side.backend->photoOperator().getPhotos(filter));
+                count[side_idx] = side.backend->getPhotosCount(filter);
+
+                for (const TagValue& value: side.backend->listTagValues(TagTypes::Event, filter))
+                    values[side_idx].push_back(value.rawValue());
+
+                std::sort(values[side_idx].begin(), values[side_idx].end());
+
+                side_idx++;
+            });
+
+            EXPECT_EQ(photos[0], photos[1]);
+            EXPECT_EQ(count[0], count[1]);
+            EXPECT_EQ(count[0], static_cast<int>(photos[0].size()));
+            EXPECT_EQ(values[0], values[1]);
+        }
+    }
+
+    EmptyLogger m_logger;
+    QTemporaryDir m_wd;
+    Side m_sqlite;
+    Side m_memory;
+    std::mt19937 m_rng;
+};
+
+
+TEST_F(BackendsComparisonTest, randomOperations)
+{
+    for (unsigned int seed = 1; seed <= 10; seed++)
+        run(seed, 60);
+}
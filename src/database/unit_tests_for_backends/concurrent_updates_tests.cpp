@@ -0,0 +1,132 @@
+
+#include <future>
+#include <thread>
+
+#include <core/task_executor_utils.hpp>
+
+#include "implementation/async_database.hpp"
+#include "implementation/photo_info_cache.hpp"
+
+#include "common.hpp"
+
+
+template<typename T>
+struct ExecutorTraits<Database::IDatabase, T>
+{
+    static void exec(Database::IDatabase* db, T&& t)
+    {
+        db->exec(std::forward<T>(t));
+    }
+};
+
+
+template<typename T>
+struct ConcurrentUpdatesTest: testing::Test
+{
+    ConcurrentUpdatesTest()
+        : testing::Test()
+        , m_db(construct<T>(&m_logger), std::make_unique<PhotoInfoCache>(&m_logger), &m_logger)
+    {
+        const QString name = BackendInfo<T>::name;
+        const QString db_path = m_wd.path() + "/" + name;
+        QDir().mkdir(db_path);
+
+        // backend is initialized in database's thread, as it will be used there
+        std::promise<bool> initialized;
+        m_db.init(Database::ProjectInfo(db_path + "/db", name), [&initialized](const Database::BackendStatus& status)
+        {
+            initialized.set_value(status);
+        });
+
+        EXPECT_TRUE(initialized.get_future().get());
+    }
+
+    Photo::Id addPhoto()
+    {
+        return evaluate<Photo::Id(Database::IBackend &)>(&m_db, [](Database::IBackend& backend)
+        {
+            Photo::DataDelta photo;
+            photo.insert<Photo::Field::Path>("photo.jpeg");
+            photo.insert<Photo::Field::Flags>({ {Photo::FlagsE::StagingArea, 1} });
+
+            std::vector<Photo::DataDelta> photos = { photo };
+            backend.addPhotos(photos);
+
+            return photos.front().getId();
+        });
+    }
+
+    Photo::Data getPhoto(const Photo::Id& id)
+    {
+        return evaluate<Photo::Data(Database::IBackend &)>(&m_db, [id](Database::IBackend& backend)
+        {
+            return backend.getPhoto(id);
+        });
+    }
+
+    EmptyLogger m_logger;
+    QTemporaryDir m_wd;
+    Database::AsyncDatabase m_db;
+};
+
+TYPED_TEST_SUITE(ConcurrentUpdatesTest, BackendTypes);
+
+
+TYPED_TEST(ConcurrentUpdatesTest, singleFieldChangesOfSamePhotoDoNotOverwriteEachOther)
+{
+    const Photo::Id id = this->addPhoto();
+    Database::IDatabase& db = this->m_db;
+
+    // each thread changes its own tag and flag of the same photo
+    auto edit = [&db, id](TagTypes tag, Photo::FlagsE flag)
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            Photo::DataDelta delta(id);
+            delta.setTag(tag, TagValue(QString("value %1").arg(i)));
+
+            db.update(delta);
+        }
+
+        Photo::DataDelta delta(id);
+        delta.setFlag(flag, 1);
+
+        db.update(delta);
+    };
+
+    // and one more changes flag only
+    auto flip = [&db, id]()
+    {
+        for (int i = 0; i < 100; i++)
+        {
+            Photo::DataDelta delta(id);
+            delta.setFlag(Photo::FlagsE::GeometryLoaded, i % 2);
+
+            db.update(delta);
+        }
+    };
+
+    std::thread events(edit, TagTypes::Event, Photo::FlagsE::ExifLoaded);
+    std::thread places(edit, TagTypes::Place, Photo::FlagsE::Sha256Loaded);
+    std::thread geometry(flip);
+
+    events.join();
+    places.join();
+    geometry.join();
+
+    // tasks are executed in order, so all updates are stored when photo is read
+    const Photo::Data photo = this->getPhoto(id);
+
+    const Tag::TagsList expected_tags =
+    {
+        { TagTypes::Event, TagValue(QString("value 99")) },
+        { TagTypes::Place, TagValue(QString("value 99")) },
+    };
+
+    EXPECT_EQ(photo.tags, expected_tags);
+    EXPECT_EQ(photo.flags.at(Photo::FlagsE::StagingArea), 1);
+    EXPECT_EQ(photo.flags.at(Photo::FlagsE::ExifLoaded), 1);
+    EXPECT_EQ(photo.flags.at(Photo::FlagsE::Sha256Loaded), 1);
+    EXPECT_EQ(photo.flags.at(Photo::FlagsE::GeometryLoaded), 1);
+    EXPECT_EQ(photo.flags.at(Photo::FlagsE::ThumbnailLoaded), 0);
+}
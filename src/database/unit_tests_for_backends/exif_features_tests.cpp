@@ -0,0 +1,100 @@
+
+#include <database/iexif_features_operator.hpp>
+#include <database/iphoto_operator.hpp>
+
+#include "common.hpp"
+
+
+template<typename T>
+struct ExifFeaturesTest: DatabaseTest<T>
+{
+    std::vector<Photo::Id> addPhotos(std::size_t count)
+    {
+        std::vector<Photo::DataDelta> photos(count);
+        for (std::size_t i = 0; i < count; i++)
+            photos[i].insert<Photo::Field::Path>(QString("photo%1.jpeg").arg(i));
+
+        this->m_backend->addPhotos(photos);
+
+        std::vector<Photo::Id> ids;
+        for (const Photo::DataDelta& photo: photos)
+            ids.push_back(photo.getId());
+
+        return ids;
+    }
+
+    static Database::ExifFeatures features(int sequence)
+    {
+        Database::ExifFeatures data;
+        data.sequenceNumber = sequence;
+        data.exposure = -0.3f;
+        data.subSecondTime = 250;
+        data.cameraMake = "Maker";
+        data.cameraModel = "Model";
+        data.fileSize = 123456;
+        data.fileModified = 1577880000000;
+
+        return data;
+    }
+};
+
+TYPED_TEST_SUITE(ExifFeaturesTest, BackendTypes);
+
+
+TYPED_TEST(ExifFeaturesTest, storeAndRead)
+{
+    const std::vector<Photo::Id> ids = this->addPhotos(3);
+
+    const std::map<Photo::Id, Database::ExifFeatures> features =
+    {
+        { ids[0], this->features(1) },
+        { ids[2], Database::ExifFeatures() },       // no exif data at all
+    };
+
+    ASSERT_TRUE(this->m_backend->exifFeaturesOperator().storeFeatures(features));
+
+    // photos without features are skipped
+    const auto stored = this->m_backend->exifFeaturesOperator().getFeatures(ids);
+    EXPECT_EQ(stored, features);
+}
+
+
+TYPED_TEST(ExifFeaturesTest, featuresAreReplaced)
+{
+    const std::vector<Photo::Id> ids = this->addPhotos(2);
+
+    ASSERT_TRUE(this->m_backend->exifFeaturesOperator().storeFeatures({ {ids[0], this->features(1)}, {ids[1], this->features(2)} }));
+    ASSERT_TRUE(this->m_backend->exifFeaturesOperator().storeFeatures({ {ids[1], this->features(3)} }));
+
+    const auto stored = this->m_backend->exifFeaturesOperator().getFeatures(ids);
+    ASSERT_EQ(stored.size(), 2);
+    EXPECT_EQ(stored.at(ids[0]), this->features(1));
+    EXPECT_EQ(stored.at(ids[1]), this->features(3));
+}
+
+
+TYPED_TEST(ExifFeaturesTest, featuresAreRemovedWithPhoto)
+{
+    const std::vector<Photo::Id> ids = this->addPhotos(2);
+
+    ASSERT_TRUE(this->m_backend->exifFeaturesOperator().storeFeatures({ {ids[0], this->features(1)}, {ids[1], this->features(2)} }));
+    ASSERT_TRUE(this->m_backend->photoOperator().removePhoto(ids[0]));
+
+    const auto stored = this->m_backend->exifFeaturesOperator().getFeatures(ids);
+    ASSERT_EQ(stored.size(), 1);
+    EXPECT_EQ(stored.begin()->first, ids[1]);
+}
+
+
+TYPED_TEST(ExifFeaturesTest, featuresOfMissingPhotosAreSkipped)
+{
+    const std::vector<Photo::Id> ids = this->addPhotos(1);
+    const Photo::Id removed = this->addPhotos(1).front();
+
+    ASSERT_TRUE(this->m_backend->photoOperator().removePhoto(removed));
+    ASSERT_TRUE(this->m_backend->exifFeaturesOperator().storeFeatures({ {ids[0], this->features(1)}, {removed, this->features(2)} }));
+
+    const auto stored = this->m_backend->exifFeaturesOperator().getFeatures({ids[0], removed});
+    ASSERT_EQ(stored.size(), 1);
+    EXPECT_EQ(stored.begin()->first, ids[0]);
+}
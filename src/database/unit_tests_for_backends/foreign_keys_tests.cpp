@@ -0,0 +1,123 @@
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "database_tools/json_to_backend.hpp"
+#include "unit_tests_utils/sample_db.json.hpp"
+
+#include "backends/sql_backends/tables.hpp"
+#include "common.hpp"
+
+
+namespace
+{
+    // count rows in 'table' referring photos which do not exist
+    int orphans(QSqlDatabase& db, const QString& table, const QString& column = "photo_id")
+    {
+        QSqlQuery query(db);
+        const QString queryStr = QString("SELECT COUNT(*) FROM %1 WHERE %2 NOT IN (SELECT id FROM " TAB_PHOTOS ")")
+                                    .arg(table)
+                                    .arg(column);
+
+        EXPECT_TRUE(query.exec(queryStr));
+        EXPECT_TRUE(query.next());
+
+        return query.value(0).toInt();
+    }
+
+    int rows(QSqlDatabase& db, const QString& table)
+    {
+        QSqlQuery query(db);
+
+        EXPECT_TRUE(query.exec(QString("SELECT COUNT(*) FROM %1").arg(table)));
+        EXPECT_TRUE(query.next());
+
+        return query.value(0).toInt();
+    }
+}
+
+
+struct SQLiteForeignKeysTest: DatabaseTest<Database::SQLiteBackend>
+{
+    SQLiteForeignKeysTest()
+    {
+        m_db = QSqlDatabase::addDatabase("QSQLITE", "foreign_keys_test");
+        m_db.setDatabaseName(m_wd.path() + "/SQLite/db");
+        EXPECT_TRUE(m_db.open());
+    }
+
+    ~SQLiteForeignKeysTest()
+    {
+        m_db.close();
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("foreign_keys_test");
+    }
+
+    QSqlDatabase m_db;
+};
+
+
+TEST_F(SQLiteForeignKeysTest, photosRemovalLeavesNoOrphans)
+{
+    Database::JsonToBackend converter(*m_backend);
+    converter.append(SampleDB::db1);
+
+    const std::vector<Photo::Id> ids = m_backend->photoOperator().getPhotos({});
+    ASSERT_EQ(ids.size(), 3);
+
+    // fill all tables with photos' data
+    std::vector<Photo::DataDelta> deltas;
+    for (const Photo::Id& id: ids)
+    {
+        Photo::DataDelta delta(id);
+        delta.insert<Photo::Field::Tags>({ {TagTypes::Event, TagValue(QString("event"))} });
+        delta.insert<Photo::Field::Geometry>(QSize(100, 200));
+        delta.insert<Photo::Field::Checksum>(QByteArray("0123456789abcdef0123456789abcdef"));
+        delta.insert<Photo::Field::Flags>({ {Photo::FlagsE::StagingArea, 1} });
+        deltas.push_back(delta);
+
+        m_backend->set(id, "some flag", 1);
+        m_backend->peopleInformationAccessor().store(PersonInfo(Person::Id(), id, {}, QRect(1, 2, 3, 4)));
+    }
+
+    ASSERT_TRUE(m_backend->update(deltas));
+
+    // representative is removed with its members
+    m_backend->groupOperator().addGroups( { {ids[0], Group::Type::Animation, {ids[1]}} } );
+
+    const std::vector<QString> tables = { TAB_TAGS, TAB_FLAGS, TAB_PEOPLE, TAB_SHA256SUMS, TAB_GEOMETRY, TAB_GROUPS_MEMBERS };
+
+    for (const QString& table: tables)
+        EXPECT_GT(rows(m_db, table), 0) << table.toStdString();
+
+    ASSERT_TRUE(m_backend->photoOperator().removePhoto(ids[0]));
+    ASSERT_TRUE(m_backend->photoOperator().removePhoto(ids[2]));
+
+    for (const QString& table: tables)
+        EXPECT_EQ(orphans(m_db, table), 0) << table.toStdString();
+
+    EXPECT_EQ(orphans(m_db, TAB_GROUPS, "representative_id"), 0);
+    EXPECT_EQ(rows(m_db, TAB_GROUPS), 0);
+    EXPECT_EQ(rows(m_db, TAB_GROUPS_MEMBERS), 0);
+    EXPECT_EQ(rows(m_db, TAB_PHOTOS), 1);
+}
+
+
+TEST_F(SQLiteForeignKeysTest, groupRemovalRemovesMembership)
+{
+    Database::JsonToBackend converter(*m_backend);
+    converter.append(SampleDB::db1);
+
+    const std::vector<Photo::Id> ids = m_backend->photoOperator().getPhotos({});
+    ASSERT_EQ(ids.size(), 3);
+
+    const std::vector<Group::Id> gids = m_backend->groupOperator().addGroups( { {ids[0], Group::Type::Animation, {ids[1], ids[2]}} } );
+    ASSERT_EQ(gids.size(), 1);
+    EXPECT_EQ(rows(m_db, TAB_GROUPS_MEMBERS), 2);
+
+    m_backend->groupOperator().removeGroups(gids);
+
+    EXPECT_EQ(rows(m_db, TAB_GROUPS), 0);
+    EXPECT_EQ(rows(m_db, TAB_GROUPS_MEMBERS), 0);
+    EXPECT_EQ(rows(m_db, TAB_PHOTOS), 3);
+}
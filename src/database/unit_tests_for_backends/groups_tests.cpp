@@ -80,3 +80,64 @@ TYPED_TEST(GroupsTest, groupRemoval)
     // expect all photos to be modified
     ASSERT_EQ(modified_photos.size(), 3);
 }
+
+
+TYPED_TEST(GroupsTest, manyGroupsCreationAndRemoval)
+{
+    std::vector<Photo::DataDelta> photos(6);
+    for (std::size_t i = 0; i < photos.size(); i++)
+        photos[i].insert<Photo::Field::Path>(QString("photo%1.jpeg").arg(i));
+
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    const std::vector<Database::GroupDefinition> groups =
+    {
+        { photos[0].getId(), Group::Type::Animation, { photos[1].getId(), photos[2].getId() } },
+        { photos[3].getId(), Group::Type::HDR,       { photos[4].getId(), photos[5].getId() } },
+    };
+
+    const std::vector<Group::Id> gids = this->m_backend->groupOperator().addGroups(groups);
+    ASSERT_EQ(gids.size(), 2);
+    EXPECT_TRUE(gids[0].valid());
+    EXPECT_TRUE(gids[1].valid());
+    EXPECT_NE(gids[0], gids[1]);
+
+    EXPECT_EQ(this->m_backend->getPhoto(photos[2].getId()).groupInfo, GroupInfo(gids[0], GroupInfo::Member));
+    EXPECT_EQ(this->m_backend->getPhoto(photos[4].getId()).groupInfo, GroupInfo(gids[1], GroupInfo::Member));
+
+    // watch for changes
+    std::set<Photo::Id> modified_photos;
+    QObject::connect(this->m_backend.get(), &Database::IBackend::photosModified, [&modified_photos](const std::set<Photo::Id>& ids)
+    {
+        modified_photos.insert(ids.begin(), ids.end());
+    });
+
+    const std::vector<Photo::Id> representatives = this->m_backend->groupOperator().removeGroups(gids);
+    EXPECT_EQ(representatives, std::vector<Photo::Id>({ photos[0].getId(), photos[3].getId() }));
+
+    // all photos are affected
+    EXPECT_EQ(modified_photos.size(), 6);
+
+    for (const Photo::DataDelta& photo: photos)
+        EXPECT_EQ(this->m_backend->getPhoto(photo.getId()).groupInfo, GroupInfo());
+
+    // each representative and member is logged when joining and leaving group
+    QStringList expectedChangeLog;
+
+    for (std::size_t i = 0; i < groups.size(); i++)
+    {
+        std::vector<std::pair<Photo::Id, int>> photosRoles = { {groups[i].representative, GroupInfo::Representative} };
+
+        for (const Photo::Id& member: groups[i].members)
+            photosRoles.emplace_back(member, GroupInfo::Member);
+
+        for (const auto& [id, role]: photosRoles)
+        {
+            expectedChangeLog.append(QString("photo id: %1. Group added. %2: %3").arg(id).arg(gids[i]).arg(role));
+            expectedChangeLog.append(QString("photo id: %1. Group removed. %2: %3").arg(id).arg(gids[i]).arg(role));
+        }
+    }
+
+    const QStringList changeLog = this->m_backend->photoChangeLogOperator().dumpChangeLog();
+    EXPECT_THAT(changeLog, testing::UnorderedElementsAreArray(expectedChangeLog));
+}
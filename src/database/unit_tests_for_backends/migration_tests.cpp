@@ -0,0 +1,252 @@
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "backends/sql_backends/tables.hpp"
+#include "common.hpp"
+
+
+namespace
+{
+    const char* ConnectionName = "migration_test";
+
+    QString encode(const QString& value)
+    {
+        return QString::fromUtf8(value.toUtf8().toBase64());
+    }
+
+    // Schema of database in version 5 or 6.
+    // Version 6 differs from 5 only by ON DELETE CASCADE in foreign keys.
+    QStringList schema(int version)
+    {
+        const QString cascade = version >= 6? " ON DELETE CASCADE": "";
+
+        return {
+            "CREATE TABLE version(version INT NOT NULL)",
+            QString("INSERT INTO version(version) VALUES(%1)").arg(version),
+            "CREATE TABLE photos(id INTEGER PRIMARY KEY, path VARCHAR(1024) NOT NULL, store_date TIMESTAMP NOT NULL)",
+            QString("CREATE TABLE tags(id INTEGER PRIMARY KEY, value VARCHAR(256), name INTEGER NOT NULL, photo_id INTEGER NOT NULL, "
+                    "FOREIGN KEY(photo_id) REFERENCES photos(id)%1)").arg(cascade),
+            QString("CREATE TABLE thumbnails(id INTEGER PRIMARY KEY, photo_id INTEGER NOT NULL, data BLOB, "
+                    "FOREIGN KEY(photo_id) REFERENCES photos(id)%1)").arg(cascade),
+            QString("CREATE TABLE sha256sums(id INTEGER PRIMARY KEY, photo_id INTEGER NOT NULL, sha256 CHAR(32) NOT NULL, "
+                    "FOREIGN KEY(photo_id) REFERENCES photos(id)%1)").arg(cascade),
+            QString("CREATE TABLE geometry(id INTEGER PRIMARY KEY, photo_id INTEGER NOT NULL, width INT NOT NULL, height INT NOT NULL, "
+                    "FOREIGN KEY(photo_id) REFERENCES photos(id)%1)").arg(cascade),
+            QString("CREATE TABLE flags(id INTEGER PRIMARY KEY, photo_id INTEGER NOT NULL, staging_area INT NOT NULL, tags_loaded INT NOT NULL, "
+                    "sha256_loaded INT NOT NULL, thumbnail_loaded INT NOT NULL, geometry_loaded INT NOT NULL, "
+                    "FOREIGN KEY(photo_id) REFERENCES photos(id)%1)").arg(cascade),
+            QString("CREATE TABLE groups(id INTEGER PRIMARY KEY, representative_id INTEGER NOT NULL, type INTEGER, "
+                    "FOREIGN KEY(representative_id) REFERENCES photos(id)%1)").arg(cascade),
+            QString("CREATE TABLE groups_members(id INTEGER PRIMARY KEY, group_id INTEGER NOT NULL, photo_id INTEGER NOT NULL, "
+                    "FOREIGN KEY(group_id) REFERENCES groups(id)%1, FOREIGN KEY(photo_id) REFERENCES photos(id)%1)").arg(cascade),
+            "CREATE TABLE people_names(id INTEGER PRIMARY KEY, name VARCHAR(256))",
+            "CREATE TABLE faces_fingerprints(id INTEGER PRIMARY KEY, fingerprint BLOB)",
+            QString("CREATE TABLE people(id INTEGER PRIMARY KEY, photo_id INTEGER NOT NULL, person_id INTEGER, fingerprint_id INTEGER, location CHAR(64), "
+                    "FOREIGN KEY(photo_id) REFERENCES photos(id)%1, FOREIGN KEY(person_id) REFERENCES people_names(id), "
+                    "FOREIGN KEY(fingerprint_id) REFERENCES faces_fingerprints(id))").arg(cascade),
+            QString("CREATE TABLE general_flags(id INTEGER PRIMARY KEY, photo_id INTEGER NOT NULL, name CHAR(64), value INTEGER, "
+                    "FOREIGN KEY(photo_id) REFERENCES photos(id)%1)").arg(cascade),
+            QString("CREATE TABLE photos_change_log(id INTEGER PRIMARY KEY, photo_id INTEGER NOT NULL, operation INTEGER, field INTEGER, "
+                    "data VARCHAR(256), date TIMESTAMP NOT NULL, FOREIGN KEY(photo_id) REFERENCES photos(id)%1)").arg(cascade),
+        };
+    }
+
+    // Two photos with data in each table.
+    // Photo #1 is a representative of group #1, photo #2 its member.
+    QStringList data()
+    {
+        return {
+            "INSERT INTO photos(id, path, store_date) VALUES(1, '/photo1.jpeg', '2021-01-01 10:00:00')",
+            "INSERT INTO photos(id, path, store_date) VALUES(2, '/photo2.jpeg', '2021-01-01 10:00:00')",
+            QString("INSERT INTO tags(id, value, name, photo_id) VALUES(1, 'party', %1, 1)").arg(TagTypes::Event),
+            QString("INSERT INTO tags(id, value, name, photo_id) VALUES(2, '2021.01.01', %1, 2)").arg(TagTypes::Date),
+            "INSERT INTO thumbnails(id, photo_id, data) VALUES(1, 1, 'thumbnail')",
+            "INSERT INTO sha256sums(id, photo_id, sha256) VALUES(1, 1, '0123456789abcdef0123456789abcdef')",
+            "INSERT INTO geometry(id, photo_id, width, height) VALUES(1, 1, 100, 200)",
+            "INSERT INTO flags(id, photo_id, staging_area, tags_loaded, sha256_loaded, thumbnail_loaded, geometry_loaded) VALUES(1, 1, 0, 1, 1, 1, 1)",
+            "INSERT INTO groups(id, representative_id, type) VALUES(1, 1, 1)",
+            "INSERT INTO groups_members(id, group_id, photo_id) VALUES(1, 1, 2)",
+            "INSERT INTO people_names(id, name) VALUES(1, 'John')",
+            "INSERT INTO faces_fingerprints(id, fingerprint) VALUES(1, '0.5 0.25')",
+            "INSERT INTO people(id, photo_id, person_id, fingerprint_id, location) VALUES(1, 1, 1, 1, '1,2 3x4')",
+            "INSERT INTO general_flags(id, photo_id, name, value) VALUES(1, 2, 'some flag', 1)",
+
+            // change log in v6 format: tags: 'type base64(old) base64(new)', groups: 'old_id new_id,old_role new_role'
+            QString("INSERT INTO photos_change_log(id, photo_id, operation, field, data, date) VALUES(1, 1, 1, 1, '%1 %2', '2021-01-01 10:00:00')")
+                .arg(TagTypes::Event).arg(encode("party")),
+            QString("INSERT INTO photos_change_log(id, photo_id, operation, field, data, date) VALUES(2, 1, 2, 1, '%1 %2 %3', '2021-01-01 10:00:01')")
+                .arg(TagTypes::Event).arg(encode("party")).arg(encode("wedding party")),
+            QString("INSERT INTO photos_change_log(id, photo_id, operation, field, data, date) VALUES(3, 2, 3, 1, '%1 %2', '2021-01-01 10:00:02')")
+                .arg(TagTypes::Place).arg(encode("home")),
+            "INSERT INTO photos_change_log(id, photo_id, operation, field, data, date) VALUES(4, 2, 1, 2, '1,2', '2021-01-01 10:00:03')",
+            "INSERT INTO photos_change_log(id, photo_id, operation, field, data, date) VALUES(5, 2, 2, 2, '1 2,2 1', '2021-01-01 10:00:04')",
+        };
+    }
+
+    // Data referring photo #3 which does not exist.
+    // Version 5 had no cascades so such rows could be left behind.
+    QStringList orphans()
+    {
+        return {
+            QString("INSERT INTO tags(id, value, name, photo_id) VALUES(3, 'orphan', %1, 3)").arg(TagTypes::Event),
+            "INSERT INTO flags(id, photo_id, staging_area, tags_loaded, sha256_loaded, thumbnail_loaded, geometry_loaded) VALUES(2, 3, 0, 1, 1, 1, 1)",
+            "INSERT INTO people(id, photo_id, person_id, fingerprint_id, location) VALUES(2, 3, NULL, NULL, '5,6 7x8')",
+            "INSERT INTO groups(id, representative_id, type) VALUES(2, 3, 1)",
+            "INSERT INTO groups_members(id, group_id, photo_id) VALUES(2, 2, 1)",
+            "INSERT INTO photos_change_log(id, photo_id, operation, field, data, date) VALUES(6, 3, 1, 2, '2,1', '2021-01-01 10:00:05')",
+        };
+    }
+}
+
+
+struct SQLiteMigrationTest: testing::Test
+{
+    SQLiteMigrationTest()
+        : m_backend(std::make_unique<Database::SQLiteBackend>(nullptr, &m_logger))
+        , m_path(m_wd.path() + "/db")
+    {
+
+    }
+
+    ~SQLiteMigrationTest()
+    {
+        m_backend->closeConnections();
+
+        m_db.close();
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(ConnectionName);
+    }
+
+    void prepare(const QStringList& queries)
+    {
+        m_db = QSqlDatabase::addDatabase("QSQLITE", ConnectionName);
+        m_db.setDatabaseName(m_path);
+        ASSERT_TRUE(m_db.open());
+
+        QSqlQuery query(m_db);
+        for (const QString& queryStr: queries)
+            ASSERT_TRUE(query.exec(queryStr)) << queryStr.toStdString();
+    }
+
+    Database::BackendStatus open()
+    {
+        const Database::ProjectInfo prjInfo(m_path, "SQLite");
+
+        return m_backend->init(prjInfo);
+    }
+
+    int value(const QString& queryStr)
+    {
+        QSqlQuery query(m_db);
+
+        EXPECT_TRUE(query.exec(queryStr));
+        EXPECT_TRUE(query.next());
+
+        return query.value(0).toInt();
+    }
+
+    int rows(const QString& table)
+    {
+        return value(QString("SELECT COUNT(*) FROM %1").arg(table));
+    }
+
+    // number of rows in tables with photos' data
+    std::map<QString, int> photosDataRows()
+    {
+        std::map<QString, int> result;
+
+        for (const QString& table: { TAB_TAGS, TAB_THUMBS, TAB_SHA256SUMS, TAB_GEOMETRY, TAB_FLAGS, TAB_GROUPS,
+                                     TAB_GROUPS_MEMBERS, TAB_PEOPLE, TAB_GENERAL_FLAGS, TAB_PHOTOS_CHANGE_LOG })
+            result[table] = rows(table);
+
+        return result;
+    }
+
+    void expectMigratedData()
+    {
+        EXPECT_EQ(value("SELECT version FROM " TAB_VER), 11);
+
+        const std::map<QString, int> expectedRows =
+        {
+            { TAB_TAGS,              2 },
+            { TAB_THUMBS,            1 },
+            { TAB_SHA256SUMS,        1 },
+            { TAB_GEOMETRY,          1 },
+            { TAB_FLAGS,             1 },
+            { TAB_GROUPS,            1 },
+            { TAB_GROUPS_MEMBERS,    1 },
+            { TAB_PEOPLE,            1 },
+            { TAB_GENERAL_FLAGS,     1 },
+            { TAB_PHOTOS_CHANGE_LOG, 5 },
+        };
+
+        EXPECT_EQ(photosDataRows(), expectedRows);
+
+        // change log is decoded into typed columns
+        const QStringList changeLog = m_backend->photoChangeLogOperator().dumpChangeLog();
+        EXPECT_EQ(changeLog, QStringList({
+            "photo id: 1. Tag added. Event: party",
+            "photo id: 1. Tag modified. Event: party -> wedding party",
+            "photo id: 2. Tag removed. Place: home",
+            "photo id: 2. Group added. 1: 2",
+            "photo id: 2. Group modified. 1 -> 2, 2 -> 1",
+        }));
+
+        // people data survives later upgrades
+        const std::vector<PersonInfo> people = m_backend->peopleInformationAccessor().listPeople(Photo::Id(1));
+        ASSERT_EQ(people.size(), 1);
+        EXPECT_EQ(people.front().rect, QRect(1, 2, 3, 4));
+        EXPECT_EQ(people.front().p_id, Person::Id(1));
+
+        const Person::Fingerprint fingerprint = { 0.5, 0.25 };
+        const std::map<Person::Id, Person::Fingerprint> centroids = m_backend->peopleInformationAccessor().peopleCentroids();
+        EXPECT_EQ(centroids, (std::map<Person::Id, Person::Fingerprint>{ {Person::Id(1), fingerprint} }));
+
+        // foreign keys cascade: removal of representative removes all its data and group
+        ASSERT_TRUE(m_backend->photoOperator().removePhoto(Photo::Id(1)));
+
+        const std::map<QString, int> expectedRowsAfterRemoval =
+        {
+            { TAB_TAGS,              1 },
+            { TAB_THUMBS,            0 },
+            { TAB_SHA256SUMS,        0 },
+            { TAB_GEOMETRY,          0 },
+            { TAB_FLAGS,             0 },
+            { TAB_GROUPS,            0 },
+            { TAB_GROUPS_MEMBERS,    0 },
+            { TAB_PEOPLE,            0 },
+            { TAB_GENERAL_FLAGS,     1 },
+            { TAB_PHOTOS_CHANGE_LOG, 3 },
+        };
+
+        EXPECT_EQ(photosDataRows(), expectedRowsAfterRemoval);
+    }
+
+    EmptyLogger m_logger;
+    QTemporaryDir m_wd;
+    std::unique_ptr<Database::IBackend> m_backend;
+    const QString m_path;
+    QSqlDatabase m_db;
+};
+
+
+TEST_F(SQLiteMigrationTest, upgradeFromV5)
+{
+    prepare(schema(5) + data() + orphans());
+
+    ASSERT_TRUE(open());
+
+    // orphans are dropped, the rest is migrated
+    expectMigratedData();
+}
+
+
+TEST_F(SQLiteMigrationTest, upgradeFromV6)
+{
+    prepare(schema(6) + data());
+
+    ASSERT_TRUE(open());
+
+    expectMigratedData();
+}
@@ -1,5 +1,8 @@
 
+#include <algorithm>
+
 #include "common.hpp"
+#include "general_flags.hpp"
 
 
 // TODO: reenable
@@ -552,3 +555,135 @@ TYPED_TEST(PeopleTest, removePersonWhenItsRemovedFromTags)
     });
 }
 */
+
+
+TYPED_TEST(PeopleTest, fingerprintsStorage)
+{
+    Photo::DataDelta pd;
+    pd.insert<Photo::Field::Path>("photo1.jpeg");
+
+    std::vector<Photo::DataDelta> photos = { pd };
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    Person::Fingerprint fingerprint(128);
+    for(std::size_t i = 0; i < fingerprint.size(); i++)
+        fingerprint[i] = (static_cast<double>(i) - 64.0) / 300.0;
+
+    Database::IPeopleInformationAccessor& people = this->m_backend->peopleInformationAccessor();
+    const Person::Id pid = people.store(PersonName("John Smith"));
+    const PersonFingerprint::Id fid = people.store(PersonFingerprint(fingerprint));
+    const PersonInfo::Id iid = people.store(PersonInfo(pid, photos.front().getId(), fid, QRect(10, 10, 50, 50)));
+
+    ASSERT_TRUE(fid.valid());
+
+    // fingerprints are stored with float precision
+    Person::Fingerprint expected(fingerprint.size());
+    std::transform(fingerprint.cbegin(), fingerprint.cend(), expected.begin(), [](double v) { return static_cast<float>(v); });
+
+    const std::vector<PersonFingerprint> person_fingerprints = people.fingerprintsFor(pid);
+    ASSERT_EQ(person_fingerprints.size(), 1);
+    EXPECT_EQ(person_fingerprints.front().id(), fid);
+    EXPECT_EQ(person_fingerprints.front().fingerprint(), expected);
+
+    const std::map<PersonInfo::Id, PersonFingerprint> faces_fingerprints = people.fingerprintsFor(std::vector<PersonInfo::Id>{ iid });
+    ASSERT_EQ(faces_fingerprints.size(), 1);
+    EXPECT_EQ(faces_fingerprints.begin()->second.fingerprint(), expected);
+}
+
+
+TYPED_TEST(PeopleTest, detectedFacesStorage)
+{
+    Photo::DataDelta pd1, pd2;
+    pd1.insert<Photo::Field::Path>("photo1.jpeg");
+    pd2.insert<Photo::Field::Path>("photo2.jpeg");
+
+    std::vector<Photo::DataDelta> photos = { pd1, pd2 };
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    const Photo::Id id1 = photos[0].getId();
+    const Photo::Id id2 = photos[1].getId();
+
+    Database::IPeopleInformationAccessor& people = this->m_backend->peopleInformationAccessor();
+    const Person::Id pid = people.store(PersonName("John Smith"));
+    people.store(PersonInfo(pid, id1, PersonFingerprint::Id(), QRect(10, 10, 50, 50)));
+
+    // face known already (located a bit differently) and new one for first photo, nothing for second one
+    const std::map<Photo::Id, std::vector<QRect>> faces = {
+        { id1, { QRect(12, 14, 48, 48), QRect(100, 100, 40, 40) } },
+        { id2, { } },
+    };
+
+    EXPECT_TRUE(people.storeDetectedFaces(faces));
+    EXPECT_TRUE(people.storeDetectedFaces(faces));     // repeated store should change nothing
+
+    const std::vector<PersonInfo> photo1_people = people.listPeople(id1);
+    ASSERT_EQ(photo1_people.size(), 2);
+
+    const auto known = std::find_if(photo1_people.cbegin(), photo1_people.cend(), [](const PersonInfo& info) { return info.rect == QRect(10, 10, 50, 50); });
+    const auto detected = std::find_if(photo1_people.cbegin(), photo1_people.cend(), [](const PersonInfo& info) { return info.rect == QRect(100, 100, 40, 40); });
+    ASSERT_NE(known, photo1_people.cend());
+    ASSERT_NE(detected, photo1_people.cend());
+    EXPECT_EQ(known->p_id, pid);
+    EXPECT_FALSE(detected->p_id.valid());
+
+    EXPECT_TRUE(people.listPeople(id2).empty());
+
+    EXPECT_EQ(this->m_backend->get(id1, Database::CommonGeneralFlags::FacesAnalysed), 1);
+    EXPECT_EQ(this->m_backend->get(id2, Database::CommonGeneralFlags::FacesAnalysed), 1);
+
+    // analysed photos are not returned by filter for not analysed ones
+    const Database::FilterPhotosWithGeneralFlags notAnalysed(Database::CommonGeneralFlags::FacesAnalysed, 0);
+    EXPECT_EQ(this->m_backend->getPhotosCount(notAnalysed), 0);
+}
+
+
+TYPED_TEST(PeopleTest, peopleCentroids)
+{
+    Photo::DataDelta pd1, pd2, pd3;
+    pd1.insert<Photo::Field::Path>("photo1.jpeg");
+    pd2.insert<Photo::Field::Path>("photo2.jpeg");
+    pd3.insert<Photo::Field::Path>("photo3.jpeg");
+
+    std::vector<Photo::DataDelta> photos = { pd1, pd2, pd3 };
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    const Photo::Id id1 = photos[0].getId();
+    const Photo::Id id2 = photos[1].getId();
+    const Photo::Id id3 = photos[2].getId();
+
+    Database::IPeopleInformationAccessor& people = this->m_backend->peopleInformationAccessor();
+    const Person::Id john = people.store(PersonName("John Smith"));
+    const Person::Id jane = people.store(PersonName("Jane Smith"));
+    const Person::Id bob = people.store(PersonName("Bob Smith"));
+
+    // values with exact float representation
+    const PersonFingerprint::Id fid1 = people.store(PersonFingerprint(Person::Fingerprint{1.0, 0.5}));
+    const PersonFingerprint::Id fid2 = people.store(PersonFingerprint(Person::Fingerprint{0.0, 1.5}));
+    const PersonFingerprint::Id fid3 = people.store(PersonFingerprint(Person::Fingerprint{2.0, 2.0}));
+
+    people.store(PersonInfo(john, id1, fid1, QRect(10, 10, 50, 50)));
+    const PersonInfo::Id iid2 = people.store(PersonInfo(john, id2, fid2, QRect(10, 10, 50, 50)));
+    people.store(PersonInfo(jane, id3, fid3, QRect(10, 10, 50, 50)));
+    people.store(PersonInfo(bob, id1, PersonFingerprint::Id(), QRect(100, 100, 50, 50)));   // no fingerprint, no centroid
+
+    typedef std::map<Person::Id, Person::Fingerprint> Centroids;
+
+    EXPECT_EQ(people.peopleCentroids(), Centroids({ {john, {0.5, 1.0}}, {jane, {2.0, 2.0}} }));
+
+    // reassign face to other person
+    people.store(PersonInfo(iid2, jane, id2, fid2, QRect(10, 10, 50, 50)));
+
+    EXPECT_EQ(people.peopleCentroids(), Centroids({ {john, {1.0, 0.5}}, {jane, {1.0, 1.75}} }));
+
+    // modify fingerprint
+    people.store(PersonFingerprint(fid1, Person::Fingerprint{3.0, 1.5}));
+
+    EXPECT_EQ(people.peopleCentroids(), Centroids({ {john, {3.0, 1.5}}, {jane, {1.0, 1.75}} }));
+
+    // remove photo with one of faces
+    Database::FilterPhotosWithId filter;
+    filter.filter = id3;
+    ASSERT_TRUE(this->m_backend->photoOperator().removePhotos(filter));
+
+    EXPECT_EQ(people.peopleCentroids(), Centroids({ {john, {3.0, 1.5}}, {jane, {0.0, 1.5}} }));
+}
@@ -85,3 +85,43 @@ TYPED_TEST(PhotoOperatorTest, sortingByTimestampActionOnPhotos)
     }
 }
 
+
+
+TYPED_TEST(PhotoOperatorTest, searchingByBeginningsOfWords)
+{
+    std::vector<Photo::DataDelta> photos(3);
+    photos[0].insert<Photo::Field::Path>("/photos/2020/Holiday_in_Spain.jpeg");
+    photos[1].insert<Photo::Field::Path>("/photos/2021/img_0001.jpeg");
+    photos[2].insert<Photo::Field::Path>("/photos/2021/img_0002.jpeg");
+    photos[1].insert<Photo::Field::Tags>( { {TagTypes::Event, TagValue(QString("Birthday party"))}, {TagTypes::Place, TagValue(QString("Warsaw"))} } );
+
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    auto search = [this](const QString& expression)
+    {
+        return this->m_backend->photoOperator().getPhotos(
+            Database::FilterPhotosMatchingExpression(SearchExpressionEvaluator(",").evaluate(expression))
+        );
+    };
+
+    EXPECT_EQ(search("holi"), std::vector<Photo::Id>{ photos[0].getId() });
+    EXPECT_EQ(search("SPA"), std::vector<Photo::Id>{ photos[0].getId() });
+    EXPECT_EQ(search("party birth"), std::vector<Photo::Id>{ photos[1].getId() });
+    EXPECT_EQ(search("warsaw, holiday"), std::vector<Photo::Id>({ photos[0].getId(), photos[1].getId() }));
+    EXPECT_TRUE(search("arty").empty());                                    // only beginnings of words are matched
+    EXPECT_TRUE(search("party spain").empty());                             // all words need to match
+
+    // index follows tags changes
+    Photo::DataDelta delta(photos[2].getId());
+    delta.insert<Photo::Field::Tags>( { {TagTypes::Event, TagValue(QString("Party"))} } );
+    ASSERT_TRUE(this->m_backend->update( {delta} ));
+
+    EXPECT_EQ(search("part"), std::vector<Photo::Id>({ photos[1].getId(), photos[2].getId() }));
+
+    // and people
+    Database::IPeopleInformationAccessor& people = this->m_backend->peopleInformationAccessor();
+    const Person::Id pid = people.store(PersonName("John Smith"));
+    people.store(PersonInfo(pid, photos[2].getId(), PersonFingerprint::Id(), QRect(10, 10, 50, 50)));
+
+    EXPECT_EQ(search("smi"), std::vector<Photo::Id>{ photos[2].getId() });
+}
@@ -115,3 +115,33 @@ TYPED_TEST(PhotosChangeLog, groupsManipulation)
     EXPECT_EQ(changeLog[6], QString("photo id: %1. Group removed. %2: 2").arg(id2).arg(gr1)); // photo #3 removed from group #1 (member)
     EXPECT_EQ(changeLog[7], QString("photo id: %1. Group removed. %2: 1").arg(id3).arg(gr2)); // photo #4 removed from group #2 (representative)
 }
+
+
+TYPED_TEST(PhotosChangeLog, manyPhotosInOneUpdate)
+{
+    // more photos than change log operators store in one query
+    std::vector<Photo::DataDelta> photos(250);
+    for (std::size_t i = 0; i < photos.size(); i++)
+        photos[i].insert<Photo::Field::Path>(QString("photo%1.jpeg").arg(i));
+
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    std::vector<Photo::DataDelta> deltas;
+    for (std::size_t i = 0; i < photos.size(); i++)
+    {
+        Photo::DataDelta delta(photos[i].getId());
+        delta.insert<Photo::Field::Tags>( { {TagTypes::Event, TagValue(QString("event %1").arg(i))} } );
+
+        deltas.push_back(delta);
+    }
+
+    ASSERT_TRUE(this->m_backend->update(deltas));
+
+    // verify change log
+    const QStringList changeLog = this->m_backend->photoChangeLogOperator().dumpChangeLog();
+
+    ASSERT_EQ(changeLog.size(), 250);
+
+    for (std::size_t i = 0; i < photos.size(); i++)
+        EXPECT_EQ(changeLog[static_cast<int>(i)], QString("photo id: %1. Tag added. Event: event %2").arg(photos[i].getId()).arg(i));
+}
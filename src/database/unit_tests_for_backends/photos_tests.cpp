@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "database_tools/json_to_backend.hpp"
 #include "unit_tests_utils/sample_db.json.hpp"
 
@@ -28,3 +30,139 @@ TYPED_TEST(PhotosTest, insertion)
 
     EXPECT_EQ(reported_ids.size(), 3);
 }
+
+
+TYPED_TEST(PhotosTest, readingManyPhotosAtOnce)
+{
+    Database::JsonToBackend converter(*this->m_backend.get());
+    converter.append(SampleDB::db1);
+
+    std::vector<Photo::Id> ids = this->m_backend->photoOperator().getPhotos({});
+    ASSERT_EQ(ids.size(), 3);
+
+    this->m_backend->groupOperator().addGroup(ids[1], Group::Type::Animation);
+
+    // reversed order and one unknown photo
+    std::reverse(ids.begin(), ids.end());
+    ids.insert(ids.begin() + 1, Photo::Id(1000));
+
+    const std::vector<Photo::Data> photos = this->m_backend->getPhotos(ids);
+    ASSERT_EQ(photos.size(), 3);
+
+    ids.erase(ids.begin() + 1);
+
+    for (std::size_t i = 0; i < photos.size(); i++)
+    {
+        const Photo::Data photo = this->m_backend->getPhoto(ids[i]);
+
+        EXPECT_EQ(photos[i].id, photo.id);
+        EXPECT_EQ(photos[i].path, photo.path);
+        EXPECT_EQ(photos[i].tags, photo.tags);
+        EXPECT_EQ(photos[i].flags, photo.flags);
+        EXPECT_EQ(photos[i].geometry, photo.geometry);
+        EXPECT_EQ(photos[i].sha256Sum, photo.sha256Sum);
+        EXPECT_EQ(photos[i].groupInfo, photo.groupInfo);
+    }
+}
+
+
+TYPED_TEST(PhotosTest, datesHistogram)
+{
+    const QDate jan1(2020, 1, 1);
+    const QDate jan2(2020, 1, 2);
+    const QDate feb1(2020, 2, 1);
+
+    std::vector<Photo::DataDelta> photos(5);
+    for (std::size_t i = 0; i < photos.size(); i++)
+        photos[i].insert<Photo::Field::Path>(QString("photo%1.jpeg").arg(i));
+
+    photos[0].insert<Photo::Field::Tags>({ {TagTypes::Date, TagValue(jan1)} });
+    photos[1].insert<Photo::Field::Tags>({ {TagTypes::Date, TagValue(jan1)}, {TagTypes::Event, TagValue(QString("party"))} });
+    photos[2].insert<Photo::Field::Tags>({ {TagTypes::Date, TagValue(jan2)} });
+    photos[3].insert<Photo::Field::Tags>({ {TagTypes::Date, TagValue(feb1)}, {TagTypes::Event, TagValue(QString("party"))} });
+
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    typedef std::map<QDate, int> Histogram;
+
+    EXPECT_EQ(this->m_backend->datesHistogram({}, Database::DatesResolution::Day),
+              Histogram({ {QDate(), 1}, {jan1, 2}, {jan2, 1}, {feb1, 1} }));
+
+    EXPECT_EQ(this->m_backend->datesHistogram({}, Database::DatesResolution::Month),
+              Histogram({ {QDate(), 1}, {jan1, 3}, {feb1, 1} }));
+
+    const Database::FilterPhotosWithTag partyFilter(TagTypes::Event, QString("party"));
+    EXPECT_EQ(this->m_backend->datesHistogram(partyFilter, Database::DatesResolution::Day),
+              Histogram({ {jan1, 1}, {feb1, 1} }));
+
+    // move photo to another day and drop date of another one
+    Photo::DataDelta moved(photos[0].getId());
+    moved.insert<Photo::Field::Tags>({ {TagTypes::Date, TagValue(jan2)} });
+
+    Photo::DataDelta undated(photos[2].getId());
+    undated.insert<Photo::Field::Tags>({});
+
+    ASSERT_TRUE(this->m_backend->update( {moved, undated} ));
+
+    EXPECT_EQ(this->m_backend->datesHistogram({}, Database::DatesResolution::Day),
+              Histogram({ {QDate(), 2}, {jan1, 1}, {jan2, 1}, {feb1, 1} }));
+
+    // removed photos are not counted
+    ASSERT_TRUE(this->m_backend->photoOperator().removePhotos(partyFilter));
+
+    EXPECT_EQ(this->m_backend->datesHistogram({}, Database::DatesResolution::Day),
+              Histogram({ {QDate(), 2}, {jan2, 1} }));
+}
+
+
+TYPED_TEST(PhotosTest, fieldLevelChanges)
+{
+    Photo::DataDelta photo;
+    photo.insert<Photo::Field::Path>("photo.jpeg");
+    photo.insert<Photo::Field::Tags>({ {TagTypes::Event, TagValue(QString("party"))}, {TagTypes::Place, TagValue(QString("Warsaw"))} });
+    photo.insert<Photo::Field::Flags>({ {Photo::FlagsE::StagingArea, 1} });
+
+    std::vector<Photo::DataDelta> photos = { photo };
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    const Photo::Id id = photos.front().getId();
+
+    Photo::DataDelta eventChange(id);
+    eventChange.setTag(TagTypes::Event, TagValue(QString("holiday")));
+
+    Photo::DataDelta placeRemoval(id);
+    placeRemoval.clearTag(TagTypes::Place);
+
+    Photo::DataDelta ratingChange(id);
+    ratingChange.setTag(TagTypes::Rating, TagValue(5));
+
+    Photo::DataDelta exifFlag(id);
+    exifFlag.setFlag(Photo::FlagsE::ExifLoaded, 1);
+
+    Photo::DataDelta sha256Flag(id);
+    sha256Flag.setFlag(Photo::FlagsE::Sha256Loaded, 1);
+
+    this->m_backend->update({ eventChange, placeRemoval, ratingChange, exifFlag, sha256Flag });
+
+    const Photo::Data data = this->m_backend->getPhoto(id);
+
+    const Tag::TagsList expected_tags = { {TagTypes::Event, TagValue(QString("holiday"))}, {TagTypes::Rating, TagValue(5)} };
+    EXPECT_EQ(data.tags, expected_tags);
+
+    // changes of one flag do not touch other ones
+    EXPECT_EQ(data.flags.at(Photo::FlagsE::StagingArea), 1);
+    EXPECT_EQ(data.flags.at(Photo::FlagsE::ExifLoaded), 1);
+    EXPECT_EQ(data.flags.at(Photo::FlagsE::Sha256Loaded), 1);
+    EXPECT_EQ(data.flags.at(Photo::FlagsE::GeometryLoaded), 0);
+
+    // text search follows tags
+    auto search = [this](const QString& expression)
+    {
+        return this->m_backend->photoOperator().getPhotos(
+            Database::FilterPhotosMatchingExpression(SearchExpressionEvaluator(",").evaluate(expression))
+        );
+    };
+
+    EXPECT_EQ(search("holiday"), std::vector<Photo::Id>{ id });
+    EXPECT_TRUE(search("warsaw").empty());
+}
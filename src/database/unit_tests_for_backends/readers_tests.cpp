@@ -0,0 +1,44 @@
+
+#include "common.hpp"
+
+
+struct SQLiteReaderTest: DatabaseTest<Database::SQLiteBackend>
+{
+    Database::ProjectInfo projectInfo() const
+    {
+        return Database::ProjectInfo(m_wd.path() + "/SQLite/db", "SQLite");
+    }
+};
+
+
+TEST_F(SQLiteReaderTest, readerSeesCommittedData)
+{
+    std::vector<Photo::DataDelta> photos(1);
+    photos.front().insert<Photo::Field::Path>("/some/path/photo.jpeg");
+    ASSERT_TRUE(m_backend->addPhotos(photos));
+
+    const Photo::Id id = photos.front().getId();
+
+    auto reader = m_backend->createReader();
+    ASSERT_NE(reader, nullptr);
+    ASSERT_TRUE(reader->init(projectInfo()));
+
+    EXPECT_EQ(reader->getPhoto(id).path, "/some/path/photo.jpeg");
+
+    const Tag::TagsList tags = { {TagTypes::Event, TagValue(QString("party"))} };
+    Photo::DataDelta delta(id);
+    delta.insert<Photo::Field::Tags>(tags);
+    ASSERT_TRUE(m_backend->update({delta}));
+
+    EXPECT_EQ(reader->getPhoto(id).tags, tags);
+
+    reader->closeConnections();
+}
+
+
+TEST(MemoryReaderTest, memoryBackendHasNoReaders)
+{
+    Database::MemoryBackend backend;
+
+    EXPECT_EQ(backend.createReader(), nullptr);
+}
@@ -34,3 +34,67 @@ TYPED_TEST(TagsTest, listTagValues)
     EXPECT_THAT(all_dates, Contains(TagValue(QDate::fromString("2001.01.06", Qt::ISODate))));
     EXPECT_THAT(all_dates, Contains(TagValue(QDate::fromString("2001.01.07", Qt::ISODate))));
 }
+
+
+TYPED_TEST(TagsTest, tagValuesCountsFollowChanges)
+{
+    Database::TagValuesCounts changes;
+    QObject::connect(this->m_backend.get(), &Database::IBackend::tagValuesChanged, [&changes](const Database::TagValuesCounts& differences)
+    {
+        for (const auto& [tagType, values]: differences)
+            for (const auto& [tagValue, difference]: values)
+                Database::countTagValue(changes, tagType, tagValue, difference);
+    });
+
+    // store 3 photos
+    Photo::DataDelta pd1, pd2, pd3;
+    pd1.insert<Photo::Field::Path>("photo1.jpeg");
+    pd1.insert<Photo::Field::Tags>({ {TagTypes::Event, QString("event1")}, {TagTypes::Place, QString("place")} });
+    pd2.insert<Photo::Field::Path>("photo2.jpeg");
+    pd2.insert<Photo::Field::Tags>({ {TagTypes::Event, QString("event1")}, {TagTypes::Place, QString("place")} });
+    pd3.insert<Photo::Field::Path>("photo3.jpeg");
+    pd3.insert<Photo::Field::Tags>({ {TagTypes::Event, QString("event2")} });
+
+    std::vector<Photo::DataDelta> photos = { pd1, pd2, pd3 };
+    ASSERT_TRUE(this->m_backend->addPhotos(photos));
+
+    const Database::TagValuesCounts initialCounts = {
+        { TagTypes::Event, { {TagValue(QString("event1")), 2}, {TagValue(QString("event2")), 1} } },
+        { TagTypes::Place, { {TagValue(QString("place")), 2} } },
+    };
+
+    EXPECT_EQ(this->m_backend->tagValuesCounts(), initialCounts);
+    EXPECT_EQ(changes, initialCounts);
+
+    // change event of first photo
+    changes.clear();
+
+    Photo::DataDelta update(photos[0].getId());
+    update.insert<Photo::Field::Tags>({ {TagTypes::Event, QString("event2")}, {TagTypes::Place, QString("place")} });
+    ASSERT_TRUE(this->m_backend->update({update}));
+
+    const Database::TagValuesCounts updateChanges = {
+        { TagTypes::Event, { {TagValue(QString("event1")), -1}, {TagValue(QString("event2")), 1} } },
+    };
+
+    EXPECT_EQ(changes, updateChanges);
+
+    // remove second photo
+    changes.clear();
+
+    ASSERT_TRUE(this->m_backend->photoOperator().removePhoto(photos[1].getId()));
+
+    const Database::TagValuesCounts removalChanges = {
+        { TagTypes::Event, { {TagValue(QString("event1")), -1} } },
+        { TagTypes::Place, { {TagValue(QString("place")), -1} } },
+    };
+
+    EXPECT_EQ(changes, removalChanges);
+
+    const Database::TagValuesCounts finalCounts = {
+        { TagTypes::Event, { {TagValue(QString("event2")), 2} } },
+        { TagTypes::Place, { {TagValue(QString("place")), 1} } },
+    };
+
+    EXPECT_EQ(this->m_backend->tagValuesCounts(), finalCounts);
+}
@@ -1,4 +1,6 @@
 
+#include <mutex>
+
 #include <dlib/image_processing/frontal_face_detector.h>
 #include <dlib/dnn.h>
 #include <QRgb>
@@ -51,11 +53,14 @@ namespace dlib_api
         bool has_hardware_accelearion()
         {
             // if cuda was disabled during dlib build then get_num_devices() will return 1 which is not what we want
-            const bool has = (CUDA_AVAILABLE ? dlib_cuda_devices() : 0) > 0;
+            static const bool has = (CUDA_AVAILABLE ? dlib_cuda_devices() : 0) > 0;
 
             return has;
         }
 
+        // gpu is shared by all threads, do not let them use it simultaneously
+        std::mutex g_cudaMutex;
+
         QString rectToString(const QRect& rect)
         {
             return QString("%1,%2 (%3x%4)")
@@ -128,20 +133,34 @@ namespace dlib_api
             const auto cnn_face_detection_model = modelPath<human_face_model>();
             return new cnn_face_detection_model_v1(cnn_face_detection_model.toStdString());
         }
+
+        // Detectors keep intermediate results in their members, so they cannot be used by many threads at once.
+        // Each thread gets its own instances, which live as long as thread does.
+        dlib::frontal_face_detector& hog_face_detector()
+        {
+            // hog detector is cheap to copy, but not to construct
+            static const dlib::frontal_face_detector prototype = dlib::get_frontal_face_detector();
+            thread_local dlib::frontal_face_detector detector = prototype;
+
+            return detector;
+        }
+
+        cnn_face_detection_model_v1& cnn_face_detector()
+        {
+            thread_local std::unique_ptr<cnn_face_detection_model_v1> detector(construct_cnn_face_detector());
+
+            return *detector;
+        }
     }
 
 
     struct FaceLocator::Data
     {
-        lazy_ptr<cnn_face_detection_model_v1, decltype(&construct_cnn_face_detector)> cnn_face_detector;
-        lazy_ptr<dlib::frontal_face_detector, decltype(&dlib::get_frontal_face_detector)> hog_face_detector;
         std::unique_ptr<ILogger> logger;
         const bool cuda_available;
 
         explicit Data(ILogger* l, bool ca)
-            : cnn_face_detector(&construct_cnn_face_detector)
-            , hog_face_detector(&dlib::get_frontal_face_detector)
-            , logger(l->subLogger("FaceLocator"))
+            : logger(l->subLogger("FaceLocator"))
             , cuda_available(ca)
         {
 
@@ -165,6 +184,11 @@ namespace dlib_api
 
     QVector<QRect> FaceLocator::face_locations(const QImage& qimage, int number_of_times_to_upsample)
     {
+        // without cuda all work is done on cpu with thread's own detectors, so no locking is needed
+        std::unique_lock<std::mutex> cuda_lock(g_cudaMutex, std::defer_lock);
+        if (m_data->cuda_available)
+            cuda_lock.lock();
+
         std::optional<QVector<QRect>> faces;
 
         // when there are no cuda devices, cnn will perform poorly so do not use it
@@ -226,7 +250,7 @@ namespace dlib_api
 
     QVector<QRect> FaceLocator::face_locations_cnn(const QImage& qimage, int number_of_times_to_upsample)
     {
-        const auto dlib_results = m_data->cnn_face_detector->detect(qimage, number_of_times_to_upsample);
+        const auto dlib_results = cnn_face_detector().detect(qimage, number_of_times_to_upsample);
         const auto faces = dlib_rects_to_qrects(dlib_results);
 
         return faces;
@@ -237,7 +261,7 @@ namespace dlib_api
     {
         dlib::matrix<dlib::rgb_pixel> image = qimage_to_dlib_matrix(qimage);
 
-        const auto dlib_results = (*m_data->hog_face_detector)(image, number_of_times_to_upsample);
+        const auto dlib_results = hog_face_detector()(image, number_of_times_to_upsample);
         const QVector<QRect> faces = dlib_rects_to_qrects(dlib_results);
 
         return faces;
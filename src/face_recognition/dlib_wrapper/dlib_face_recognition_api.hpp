@@ -26,7 +26,9 @@ namespace dlib_api
 
     typedef std::vector<double> FaceEncodings;
 
-    // FaceLocator may be a very heavy object. Delete it as soon as it is not needed.
+    // FaceLocator is a light object. Detectors it uses are kept per thread,
+    // so FaceLocators can be used in parallel (each thread should use its own FaceLocator).
+    // Without CUDA, no locking is involved.
     // based on:
     // https://github.com/ageitgey/face_recognition/blob/5fe85a1a8cbd1b994b505464b555d12cd25eee5f/face_recognition/api.py#L108
     class DLIB_WRAPPER_EXPORT FaceLocator
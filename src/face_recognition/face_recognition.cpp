@@ -46,6 +46,7 @@
 #include <system/system.hpp>
 
 #include "dlib_wrapper/dlib_face_recognition_api.hpp"
+#include "fingerprints_index.hpp"
 #include "unit_tests_utils/empty_logger.hpp"
 
 
@@ -60,18 +61,6 @@ struct ExecutorTraits<Database::IDatabase, T>
     }
 };
 
-namespace
-{
-    std::mutex g_dlibMutex;   // global mutex for dlib usage.
-
-    int chooseClosestMatching(const std::vector<double>& distances)
-    {
-        auto closest = std::min_element(distances.cbegin(), distances.cend());
-
-        return (closest == distances.cend() || *closest > 0.6)? -1 : static_cast<int>(std::distance(distances.cbegin(), closest));
-    }
-}
-
 
 struct FaceRecognition::Data
 {
@@ -110,13 +99,36 @@ bool FaceRecognition::checkSystem()
 
 QVector<QRect> FaceRecognition::fetchFaces(const QString& path) const
 {
-    OrientedImage orientedPhoto(m_data->m_exif, path);
+    const OrientedImage orientedPhoto(m_data->m_exif, path);
+
+    m_data->m_logger->debug(QString("Looking for faces in photo %1").arg(path));
+
+    return fetchFaces(orientedPhoto);
+}
+
+
+QVector<QRect> FaceRecognition::fetchFaces(const QString& path, int detectionSize) const
+{
+    const OrientedImage orientedPhoto(m_data->m_exif, path, detectionSize);
 
+    m_data->m_logger->debug(QString("Looking for faces in photo %1").arg(path));
+
+    QVector<QRect> faces = fetchFaces(orientedPhoto);
+
+    std::transform(faces.begin(), faces.end(), faces.begin(), [&orientedPhoto](const QRect& face){
+        return orientedPhoto.mapToOriginal(face);
+    });
+
+    return faces;
+}
+
+
+QVector<QRect> FaceRecognition::fetchFaces(const OrientedImage& orientedPhoto) const
+{
     const int pixels = orientedPhoto->width() * orientedPhoto->height();
     const double mpixels = pixels / 1e6;
 
-    m_data->m_logger->debug(QString("Looking for faces in photo %1. Size: %2Mpx")
-        .arg(path)
+    m_data->m_logger->debug(QString("Looking for faces in photo of size: %1Mpx")
         .arg(mpixels, 0, 'f', 1)
     );
 
@@ -148,16 +160,20 @@ Person::Fingerprint FaceRecognition::getFingerprint(const OrientedImage& image,
 
 int FaceRecognition::recognize(const Person::Fingerprint& unknown, const std::vector<Person::Fingerprint>& known)
 {
-    const std::vector<double> distance = dlib_api::face_distance(known, unknown);
-    const auto closestMatching = chooseClosestMatching(distance);
+    const FingerprintsIndex index(known);
+
+    return recognize(unknown, index);
+}
+
 
-    return closestMatching;
+int FaceRecognition::recognize(const Person::Fingerprint& unknown, const FingerprintsIndex& known)
+{
+    return known.closest(unknown);
 }
 
 
 QVector<QRect> FaceRecognition::fetchFaces(const OrientedImage& orientedPhoto, double scale) const
 {
-    std::lock_guard lock(g_dlibMutex);
     QVector<QRect> result;
 
     const QSize scaledSize = orientedPhoto.get().size() * scale;
@@ -166,8 +182,8 @@ QVector<QRect> FaceRecognition::fetchFaces(const OrientedImage& orientedPhoto, d
     result = dlib_api::FaceLocator(m_data->m_logger.get()).face_locations(photo, 0);
 
     std::transform(result.begin(), result.end(), result.begin(), [scale](const QRect& face){
-        return QRect(face.topLeft().x() / scale, face.topLeft().y() / scale,
-                        face.width() / scale, face.height() / scale);
+        return QRectF(face.topLeft().x() / scale, face.topLeft().y() / scale,
+                      face.width() / scale, face.height() / scale).toRect();
     });
 
     return result;
@@ -33,6 +33,7 @@ struct IExifReader;
 struct ILogger;
 struct ITmpDir;
 struct FacesData;
+class FingerprintsIndex;
 class OrientedImage;
 
 namespace Database
@@ -56,9 +57,17 @@ class FACE_RECOGNITION_EXPORT FaceRecognition final
         // Locate faces on given photo.
         QVector<QRect> fetchFaces(const QString &) const;
 
+        // Locate faces on photo decoded with longer side limited to detectionSize.
+        // Returned locations are in coordinates of full size photo.
+        QVector<QRect> fetchFaces(const QString &, int detectionSize) const;
+
+        // Locate faces on already decoded photo.
+        QVector<QRect> fetchFaces(const OrientedImage &) const;
+
         Person::Fingerprint getFingerprint(const OrientedImage& image, const QRect& face = QRect());
 
         int recognize(const Person::Fingerprint& unknown, const std::vector<Person::Fingerprint>& known);
+        int recognize(const Person::Fingerprint& unknown, const FingerprintsIndex& known);
 
     private:
         struct Data;
@@ -0,0 +1,24 @@
+
+include(${CMAKE_SOURCE_DIR}/cmake/functions.cmake)
+
+find_package(Qt5 REQUIRED COMPONENTS Core)
+
+addTestTarget(face_recognition
+                SOURCES
+                    fingerprints_index.cpp
+
+                    # tests:
+                    unit_tests/fingerprints_index_tests.cpp
+
+                LIBRARIES
+                    database
+                    dlib_wrapper
+                    Qt::Core
+                    GTest::gtest
+                    GTest::gtest_main
+
+                INCLUDES
+                    ${CMAKE_SOURCE_DIR}/src
+                    ${CMAKE_CURRENT_SOURCE_DIR}
+                    ${CMAKE_CURRENT_BINARY_DIR}
+)
@@ -0,0 +1,176 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fingerprints_index.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+
+namespace
+{
+    // Known fingerprints are stored in tiles of TileRows rows.
+    // Within tile components are interleaved (first components of all rows, then second ones and so on),
+    // so distances to all rows of tile are calculated in one loop which compiler can turn into vector instructions.
+    constexpr std::size_t TileRows = 16;
+
+    // number of components compared before checking if any row of tile can still be the closest one
+    constexpr std::size_t Block = 32;
+
+    // value for unused rows of last tile - too far to be ever matched
+    constexpr float Padding = 1e6f;
+
+    void squaredDistances(const float* tile, const float* unknown, std::size_t dimensions, float limit, float* result)
+    {
+        // local accumulators - compiler knows they do not alias with input
+        float sums[TileRows] = {};
+
+        for (std::size_t b = 0; b < dimensions; b += Block)
+        {
+            const std::size_t last = std::min(b + Block, dimensions);
+
+            for (std::size_t d = b; d < last; d++)
+            {
+                const float* components = tile + d * TileRows;
+                const float component = unknown[d];
+
+                for (std::size_t r = 0; r < TileRows; r++)
+                {
+                    const float diff = components[r] - component;
+                    sums[r] += diff * diff;
+                }
+            }
+
+            if (*std::min_element(std::begin(sums), std::end(sums)) > limit)
+                break;
+        }
+
+        std::copy(std::begin(sums), std::end(sums), result);
+    }
+}
+
+
+FingerprintsIndex::FingerprintsIndex(const std::vector<Person::Fingerprint>& known)
+    : m_matrix()
+    , m_dimensions(known.empty()? 0: known.front().size())
+    , m_rows(known.size())
+{
+    const std::size_t tiles = (m_rows + TileRows - 1) / TileRows;
+    m_matrix.resize(tiles * TileRows * m_dimensions, Padding);
+
+    for (std::size_t r = 0; r < m_rows; r++)
+    {
+        const Person::Fingerprint& fingerprint = known[r];
+        assert(fingerprint.size() == m_dimensions);
+
+        float* tile = &m_matrix[(r / TileRows) * TileRows * m_dimensions];
+
+        for (std::size_t d = 0; d < m_dimensions; d++)
+            tile[d * TileRows + r % TileRows] = static_cast<float>(fingerprint[d]);
+    }
+}
+
+
+std::size_t FingerprintsIndex::size() const
+{
+    return m_rows;
+}
+
+
+std::vector<double> FingerprintsIndex::distances(const Person::Fingerprint& unknown) const
+{
+    const std::vector<float> row = toRow(unknown);
+    const float limit = std::numeric_limits<float>::infinity();
+
+    std::vector<double> result;
+    result.reserve(m_rows);
+
+    for (std::size_t t = 0; t * TileRows < m_rows; t++)
+    {
+        float sums[TileRows];
+        squaredDistances(&m_matrix[t * TileRows * m_dimensions], row.data(), m_dimensions, limit, sums);
+
+        const std::size_t rows = std::min(TileRows, m_rows - t * TileRows);
+
+        for (std::size_t r = 0; r < rows; r++)
+            result.push_back(std::sqrt(sums[r]));
+    }
+
+    return result;
+}
+
+
+int FingerprintsIndex::closest(const Person::Fingerprint& unknown, double tolerance) const
+{
+    const std::vector<float> row = toRow(unknown);
+
+    return closest(row.data(), static_cast<float>(tolerance * tolerance));
+}
+
+
+std::vector<int> FingerprintsIndex::closest(const std::vector<Person::Fingerprint>& unknown, double tolerance) const
+{
+    const float limit = static_cast<float>(tolerance * tolerance);
+
+    std::vector<int> result;
+    result.reserve(unknown.size());
+
+    for (const Person::Fingerprint& fingerprint: unknown)
+    {
+        const std::vector<float> row = toRow(fingerprint);
+        result.push_back(closest(row.data(), limit));
+    }
+
+    return result;
+}
+
+
+std::vector<float> FingerprintsIndex::toRow(const Person::Fingerprint& fingerprint) const
+{
+    assert(m_rows == 0 || fingerprint.size() == m_dimensions);
+
+    std::vector<float> row(m_dimensions, 0.0f);
+    std::copy_n(fingerprint.cbegin(), std::min(fingerprint.size(), m_dimensions), row.begin());
+
+    return row;
+}
+
+
+int FingerprintsIndex::closest(const float* unknown, float limit) const
+{
+    int result = -1;
+    float best = std::numeric_limits<float>::infinity();
+
+    for (std::size_t t = 0; t * TileRows < m_rows; t++)
+    {
+        float sums[TileRows];
+        squaredDistances(&m_matrix[t * TileRows * m_dimensions], unknown, m_dimensions, std::min(best, limit), sums);
+
+        for (std::size_t r = 0; r < TileRows; r++)
+            if (sums[r] <= limit && sums[r] < best)
+            {
+                best = sums[r];
+                result = static_cast<int>(t * TileRows + r);
+            }
+    }
+
+    return result;
+}
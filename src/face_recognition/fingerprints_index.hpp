@@ -0,0 +1,59 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FINGERPRINTSINDEX_HPP
+#define FINGERPRINTSINDEX_HPP
+
+#include <vector>
+
+#include <database/person_data.hpp>
+#include "face_recognition_export.h"
+
+
+/**
+ * @brief Known fingerprints kept in one contiguous matrix of floats
+ *
+ * Lookups compute squared euclidean distances (as dlib_api::face_distance does)
+ * and skip known fingerprint as soon as its partial distance exceeds the best one found so far.
+ */
+class FACE_RECOGNITION_EXPORT FingerprintsIndex final
+{
+    public:
+        explicit FingerprintsIndex(const std::vector<Person::Fingerprint>& known);
+
+        std::size_t size() const;
+
+        // distances to all known fingerprints
+        std::vector<double> distances(const Person::Fingerprint& unknown) const;
+
+        // position of closest known fingerprint or -1 if none is closer than tolerance
+        int closest(const Person::Fingerprint& unknown, double tolerance = 0.6) const;
+
+        // closest() for many fingerprints at once
+        std::vector<int> closest(const std::vector<Person::Fingerprint>& unknown, double tolerance = 0.6) const;
+
+    private:
+        std::vector<float> m_matrix;
+        std::size_t m_dimensions;
+        std::size_t m_rows;
+
+        std::vector<float> toRow(const Person::Fingerprint &) const;
+        int closest(const float* unknown, float limit) const;
+};
+
+#endif
@@ -0,0 +1,86 @@
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+#include <gtest/gtest.h>
+#include <QDirIterator>
+
+#include <core/stopwatch.hpp>
+#include <core/task_executor.hpp>
+#include <core/task_executor_utils.hpp>
+#include <unit_tests_utils/empty_logger.hpp>
+
+#include "utils.hpp"
+#include "face_recognition/dlib_wrapper/dlib_face_recognition_api.hpp"
+
+
+namespace
+{
+    constexpr int PhotosCount = 256;
+
+    // fixed set of photos: first photos of dataset in alphabetical order
+    QStringList photoSet()
+    {
+        QStringList photos;
+        QDirIterator di(utils::photoSetPath(), {"*.jpg"}, QDir::Files, QDirIterator::Subdirectories);
+
+        while (di.hasNext())
+            photos.append(di.next());
+
+        std::sort(photos.begin(), photos.end());
+
+        return photos.mid(0, PhotosCount);
+    }
+
+    double facesPerSecond(int faces, int ms)
+    {
+        return ms > 0? faces * 1000.0 / ms: 0.0;
+    }
+}
+
+
+TEST(FaceDetectionThroughput, sequentialVsParallel)
+{
+    const QStringList photos = photoSet();
+    ASSERT_EQ(photos.size(), PhotosCount);
+
+    std::vector<QImage> images;
+    for (const QString& path: photos)
+        images.emplace_back(path);
+
+    EmptyLogger logger;
+    Stopwatch stopwatch;
+
+    // one thread
+    int sequential_faces = 0;
+    stopwatch.start();
+
+    for (const QImage& image: images)
+    {
+        dlib_api::FaceLocator locator(&logger);
+        sequential_faces += locator.face_locations(image, 0).size();
+    }
+
+    const int sequential_time = stopwatch.stop();
+
+    // all cores, each thread with its own detectors
+    TaskExecutor executor(&logger);
+    std::atomic<int> parallel_faces(0);
+    stopwatch.start();
+
+    parallelFor(&executor, images.size(), executor.heavyWorkers(), [&](std::size_t i)
+    {
+        dlib_api::FaceLocator locator(&logger);
+        parallel_faces += locator.face_locations(images[i], 0).size();
+    });
+
+    const int parallel_time = stopwatch.stop();
+
+    EXPECT_EQ(sequential_faces, parallel_faces);
+
+    std::cout << "photos:     " << images.size() << ", faces: " << sequential_faces << std::endl;
+    std::cout << "sequential: " << sequential_time << "ms, " << facesPerSecond(sequential_faces, sequential_time) << " faces/s" << std::endl;
+    std::cout << "parallel:   " << parallel_time << "ms, " << facesPerSecond(parallel_faces, parallel_time) << " faces/s"
+              << " (" << executor.heavyWorkers() << " workers)" << std::endl;
+}
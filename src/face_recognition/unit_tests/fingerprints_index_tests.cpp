@@ -0,0 +1,116 @@
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "dlib_wrapper/dlib_face_recognition_api.hpp"
+#include "fingerprints_index.hpp"
+
+
+namespace
+{
+    // reference implementation: closest matching chosen from scalar distances
+    int scalarClosest(const std::vector<Person::Fingerprint>& known, const Person::Fingerprint& unknown)
+    {
+        const std::vector<double> distances = dlib_api::face_distance(known, unknown);
+        auto closest = std::min_element(distances.cbegin(), distances.cend());
+
+        return (closest == distances.cend() || *closest > 0.6)? -1 : static_cast<int>(std::distance(distances.cbegin(), closest));
+    }
+
+    std::vector<Person::Fingerprint> randomFingerprints(std::mt19937& generator, std::size_t count)
+    {
+        // dlib's fingerprints have 128 components. Distances between faces of the same person are below 0.6
+        std::normal_distribution<double> component(0.0, 0.08);
+
+        std::vector<Person::Fingerprint> fingerprints(count, Person::Fingerprint(128));
+
+        for (Person::Fingerprint& fingerprint: fingerprints)
+            for (double& value: fingerprint)
+                value = component(generator);
+
+        return fingerprints;
+    }
+}
+
+
+TEST(FingerprintsIndexTest, emptyIndex)
+{
+    const FingerprintsIndex index({});
+
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_EQ(index.closest(Person::Fingerprint(128, 0.0)), -1);
+    EXPECT_TRUE(index.distances(Person::Fingerprint(128, 0.0)).empty());
+}
+
+
+TEST(FingerprintsIndexTest, distancesMatchScalarPath)
+{
+    std::mt19937 generator(12345);
+    const std::vector<Person::Fingerprint> known = randomFingerprints(generator, 200);
+    const std::vector<Person::Fingerprint> unknown = randomFingerprints(generator, 20);
+
+    const FingerprintsIndex index(known);
+    ASSERT_EQ(index.size(), known.size());
+
+    for (const Person::Fingerprint& fingerprint: unknown)
+    {
+        const std::vector<double> expected = dlib_api::face_distance(known, fingerprint);
+        const std::vector<double> distances = index.distances(fingerprint);
+
+        ASSERT_EQ(distances.size(), expected.size());
+
+        for (std::size_t i = 0; i < expected.size(); i++)
+            EXPECT_NEAR(distances[i], expected[i], 1e-5);
+    }
+}
+
+
+TEST(FingerprintsIndexTest, closestMatchesScalarPath)
+{
+    std::mt19937 generator(54321);
+    std::normal_distribution<double> noise(0.0, 0.04);
+
+    const std::vector<Person::Fingerprint> known = randomFingerprints(generator, 500);
+
+    // unknown faces: some are modified known faces, some are strangers
+    std::vector<Person::Fingerprint> unknown = randomFingerprints(generator, 100);
+    for (std::size_t i = 0; i < unknown.size(); i += 2)
+    {
+        unknown[i] = known[(i * 7) % known.size()];
+
+        for (double& value: unknown[i])
+            value += noise(generator);
+    }
+
+    const FingerprintsIndex index(known);
+    const std::vector<int> closest = index.closest(unknown);
+
+    ASSERT_EQ(closest.size(), unknown.size());
+
+    int matches = 0;
+    for (std::size_t i = 0; i < unknown.size(); i++)
+    {
+        const int expected = scalarClosest(known, unknown[i]);
+
+        EXPECT_EQ(closest[i], expected);
+        EXPECT_EQ(index.closest(unknown[i]), expected);
+
+        if (expected != -1)
+            matches++;
+    }
+
+    // make sure both paths were exercised
+    EXPECT_GT(matches, 0);
+    EXPECT_LT(matches, static_cast<int>(unknown.size()));
+}
+
+
+TEST(FingerprintsIndexTest, firstOfEquallyCloseIsChosen)
+{
+    Person::Fingerprint fingerprint(128, 0.01);
+
+    const FingerprintsIndex index({ Person::Fingerprint(128, 0.5), fingerprint, fingerprint });
+
+    EXPECT_EQ(index.closest(fingerprint), 1);
+}
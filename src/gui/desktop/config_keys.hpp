@@ -18,4 +18,15 @@ namespace UpdateConfigKeys
     const char* const lastCheck       = "updater::last_check";
 }
 
+namespace GroupingConfigKeys
+{
+    const char* const previewRamBudget  = "grouping::preview_ram_budget";       // in MiB
+    const char* const previewDiskBudget = "grouping::preview_disk_budget";      // in MiB
+}
+
+namespace FacesConfigKeys
+{
+    const char* const backgroundDetection = "faces::background_detection";
+}
+
 #endif // CONFIG_KEYS_HPP
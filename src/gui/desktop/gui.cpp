@@ -18,6 +18,7 @@
 #include <core/thumbnail_generator.hpp>
 #include <core/thumbnail_manager.hpp>
 #include <core/thumbnails_cache.hpp>
+#include <database/tag_values_counts.hpp>
 #include <system/filesystem.hpp>
 
 #ifdef UPDATER_ENABLED
@@ -68,6 +69,8 @@ Gui::Gui(IProjectManager& prjMgr, IPluginLoader& pluginLoader, ICoreFactoryAcces
     qRegisterMetaType<std::set<Photo::Id>>("std::set<Photo::Id>");
     qRegisterMetaType<Photo::Id>("Photo::Id");
     qRegisterMetaType<IPhotoInfo::Ptr>("IPhotoInfo::Ptr");
+    qRegisterMetaType<std::vector<IPhotoInfo::Ptr>>("std::vector<IPhotoInfo::Ptr>");
+    qRegisterMetaType<Database::TagValuesCounts>("Database::TagValuesCounts");
 }
 
 
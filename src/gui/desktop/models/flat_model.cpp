@@ -31,6 +31,7 @@ using namespace std::placeholders;
 FlatModel::FlatModel(QObject* p)
     : APhotoInfoModel(p)
     , m_db(nullptr)
+    , m_fetchGeneration(0)
 {
 }
 
@@ -155,14 +156,14 @@ void FlatModel::reloadPhotos()
     resetModel();
 
     if (m_db != nullptr)
-        m_db->exec(std::bind(&FlatModel::fetchMatchingPhotos, this, _1));
+        m_db->execRead(std::bind(&FlatModel::fetchMatchingPhotos, this, _1, ++m_fetchGeneration));
 }
 
 
 void FlatModel::updatePhotos()
 {
     if (m_db != nullptr)
-        m_db->exec(std::bind(&FlatModel::fetchMatchingPhotos, this, _1));
+        m_db->execRead(std::bind(&FlatModel::fetchMatchingPhotos, this, _1, ++m_fetchGeneration));
 }
 
 
@@ -208,11 +209,11 @@ void FlatModel::fetchPhotoData(const Photo::Id& id) const
 {
     auto b = std::bind(qOverload<Database::IBackend &, const Photo::Id &>(&FlatModel::fetchPhotoProperties), this, _1, id);
 
-    m_db->exec(b);
+    m_db->execRead(b);
 }
 
 
-void FlatModel::fetchMatchingPhotos(Database::IBackend& backend)
+void FlatModel::fetchMatchingPhotos(Database::IBackend& backend, int generation)
 {
     const Database::Actions::GroupAction sort_action({
         Database::Actions::SortByTimestamp(),
@@ -222,7 +223,7 @@ void FlatModel::fetchMatchingPhotos(Database::IBackend& backend)
     const auto view_filters = filters();
     const auto photos = backend.photoOperator().onPhotos(view_filters, sort_action);
 
-    invokeMethod(this, &FlatModel::fetchedPhotos, photos);
+    invokeMethod(this, &FlatModel::fetchedPhotos, photos, generation);
 }
 
 
@@ -234,8 +235,12 @@ void FlatModel::fetchPhotoProperties(Database::IBackend& backend, const Photo::I
 }
 
 
-void FlatModel::fetchedPhotos(const std::vector<Photo::Id>& photos)
+void FlatModel::fetchedPhotos(const std::vector<Photo::Id>& photos, int generation)
 {
+    // newer results are on their way
+    if (generation != m_fetchGeneration)
+        return;
+
     auto last_new_it = [&photos](){ return photos.end(); };
     auto last_old_it = [this](){ return m_photos.end(); };
     auto new_photos_it = photos.begin();
@@ -60,6 +60,7 @@ class FlatModel: public APhotoInfoModel
         mutable std::map<Photo::Id, int> m_idToRow;
         mutable std::map<Photo::Id, Photo::Data> m_properties;
         Database::IDatabase* m_db;
+        int m_fetchGeneration;                  // read tasks may finish out of order, use the newest one only
 
         void reloadPhotos();
         void updatePhotos();
@@ -71,11 +72,11 @@ class FlatModel: public APhotoInfoModel
         void fetchPhotoData(const Photo::Id &) const;
 
         // methods working on backend
-        void fetchMatchingPhotos(Database::IBackend &);
+        void fetchMatchingPhotos(Database::IBackend &, int generation);
         void fetchPhotoProperties(Database::IBackend &, const Photo::Id &) const;
 
         // results from backend
-        void fetchedPhotos(const std::vector<Photo::Id> &);
+        void fetchedPhotos(const std::vector<Photo::Id> &, int generation);
         void fetchedPhotoProperties(const Photo::Id &, const Photo::Data &);
 
         // altering model
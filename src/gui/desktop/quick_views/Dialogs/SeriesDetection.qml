@@ -88,6 +88,16 @@ Item
                 }
             }
 
+            // candidates are appended as they are found, show progress until detection is done
+            ProgressBar {
+                id: progressId
+                Layout.fillWidth: true
+                visible: groupsModelState.loaded == false
+                from: 0
+                to: 100
+                value: groupsModelState.progress
+            }
+
             Button {
                 id: button
                 text: qsTr("Group", "used as verb - group photos")
@@ -139,7 +149,7 @@ Item
 
             Text {
                 id: infoId
-                text: qsTr("Looking for group candidates...")
+                text: qsTr("Looking for group candidates... %1%").arg(groupsModelState.progress)
                 anchors.top: parent.top
                 font.pixelSize: 12
             }
@@ -157,7 +167,7 @@ Item
         },
         State {
             name: "LoadedState"
-            when: groupsModelState.loaded
+            when: groupsModelState.loaded || groupsListId.count > 0
         }
     ]
 
@@ -231,6 +231,12 @@ QDate PhotosModelControllerComponent::dateFor(unsigned int idx) const
 }
 
 
+int PhotosModelControllerComponent::photosCountFor(unsigned int idx) const
+{
+    return idx >= m_photosPerDate.size()? 0: m_photosPerDate[idx];
+}
+
+
 void PhotosModelControllerComponent::markNewAsReviewed()
 {
     m_db->exec(std::bind(&PhotosModelControllerComponent::markPhotosAsReviewed, this, _1));
@@ -245,10 +251,19 @@ void PhotosModelControllerComponent::updateModelFilters()
 }
 
 
-void PhotosModelControllerComponent::setAvailableDates(const std::vector<TagValue>& dates_as_tags)
+void PhotosModelControllerComponent::setAvailableDates(const std::map<QDate, int>& histogram)
 {
     std::vector<QDate> dates;
-    std::transform(dates_as_tags.begin(), dates_as_tags.end(), std::back_inserter(dates), [](const auto& d) { return d.getDate(); });
+    dates.reserve(histogram.size());
+    m_photosPerDate.clear();
+    m_photosPerDate.reserve(histogram.size());
+
+    // invalid date (photos without date) goes first
+    for (const auto& [date, photos]: histogram)
+    {
+        dates.push_back(date);
+        m_photosPerDate.push_back(photos);
+    }
 
     if (dates != m_dates)
     {
@@ -266,7 +281,7 @@ void PhotosModelControllerComponent::setAvailableDates(const std::vector<TagValu
 
 void PhotosModelControllerComponent::updateTimeRange()
 {
-    m_db->exec(std::bind(&PhotosModelControllerComponent::getTimeRangeForFilters, this, _1));
+    m_db->execRead(std::bind(&PhotosModelControllerComponent::getTimeRangeForFilters, this, _1));
 }
 
 
@@ -331,17 +346,9 @@ QStringList PhotosModelControllerComponent::rawCategories() const
 
 void PhotosModelControllerComponent::getTimeRangeForFilters(Database::IBackend& backend)
 {
-    auto dates = backend.listTagValues(TagTypes::Date, {});
-
-    const Database::FilterPhotosWithTag with_date_filter(TagTypes::Date);
-    const Database::FilterNotMatchingFilter without_date_filter(with_date_filter);
-    const auto photos_without_date_tag = backend.photoOperator().getPhotos(without_date_filter);
-
-    if (photos_without_date_tag.empty() == false)
-        dates.push_back(QDate());
+    const auto histogram = backend.datesHistogram({}, Database::DatesResolution::Day);
 
-    std::sort(dates.begin(), dates.end());
-    invokeMethod(this, &PhotosModelControllerComponent::setAvailableDates, dates);
+    invokeMethod(this, &PhotosModelControllerComponent::setAvailableDates, histogram);
 }
 
 
@@ -80,6 +80,7 @@ class PhotosModelControllerComponent: public QObject
 
         // helpers and actions for qml
         Q_INVOKABLE QDate dateFor(unsigned int) const;
+        Q_INVOKABLE int photosCountFor(unsigned int) const;
         Q_INVOKABLE void markNewAsReviewed();
 
     signals:
@@ -90,6 +91,7 @@ class PhotosModelControllerComponent: public QObject
     private:
         QTimer m_searchLauncher;
         std::vector<QDate> m_dates;
+        std::vector<int> m_photosPerDate;
 
         // filters
         QPair<unsigned int, unsigned int> m_timeView;
@@ -105,7 +107,7 @@ class PhotosModelControllerComponent: public QObject
         ICompleterFactory* m_completerFactory;
 
         void updateModelFilters();
-        void setAvailableDates(const std::vector<TagValue> &);
+        void setAvailableDates(const std::map<QDate, int> &);
         void updateTimeRange();
         Database::Filter allFilters() const;
         QStringList rawCategories() const;
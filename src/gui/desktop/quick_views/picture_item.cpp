@@ -1,4 +1,7 @@
 
+#include <algorithm>
+#include <cmath>
+
 #include <QPainter>
 
 #include "picture_item.hpp"
@@ -7,7 +10,7 @@
 PictureItem::PictureItem(QQuickItem* p)
     : QQuickPaintedItem(p)
 {
-
+    connect(this, &QQuickItem::scaleChanged, this, &PictureItem::updateTexture);
 }
 
 
@@ -20,7 +23,9 @@ void PictureItem::setSource(const QImage& image)
     setImplicitWidth(img_size.width());
     setImplicitHeight(img_size.height());
 
-    update();
+    m_displayed = QImage();
+    m_levels.clear();
+    updateTexture();
 
     emit sourceChanged();
 }
@@ -35,7 +40,15 @@ const QImage& PictureItem::source() const
 void PictureItem::paint(QPainter* painter)
 {
     const QRectF rect(QPointF(0, 0), QSizeF(implicitWidth(), implicitHeight()));
-    painter->drawImage(rect, m_source);
+    painter->drawImage(rect, m_displayed);
+}
+
+
+void PictureItem::geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry)
+{
+    QQuickPaintedItem::geometryChanged(newGeometry, oldGeometry);
+
+    updateTexture();
 }
 
 
@@ -46,3 +59,46 @@ bool PictureItem::validateInputs() const
 
     return (img_size.isEmpty() || item_size.height() < 1.0 || item_size.width() < 1.0) == false;
 }
+
+
+void PictureItem::updateTexture()
+{
+    // Picture is usually displayed scaled down (zoomed out).
+    // Keep texture and painted image no bigger than twice the displayed size
+    // so a full resolution bitmap is not duplicated in scene graph.
+    // Scale is rounded to a power of two, so zooming or resizing within the same
+    // level reuses already scaled image instead of scaling source again.
+    const qreal displayScale = std::min<qreal>(scale(), 1.0);
+
+    if (m_source.isNull() || displayScale <= 0.0)
+        m_displayed = QImage();
+    else
+    {
+        const std::size_t levelNo = static_cast<std::size_t>(std::floor(std::log2(1.0 / displayScale)));
+        m_displayed = level(levelNo);
+    }
+
+    setTextureSize(m_displayed.size().expandedTo(QSize(1, 1)));
+    update();
+}
+
+
+const QImage& PictureItem::level(std::size_t levelNo)
+{
+    if (m_levels.empty())
+        m_levels.push_back(m_source);
+
+    // each level is made of previous one, which is much cheaper than scaling source
+    while (m_levels.size() <= levelNo)
+    {
+        const QImage& previous = m_levels.back();
+
+        if (previous.width() == 1 && previous.height() == 1)
+            break;
+
+        const QSize halfSize = (previous.size() / 2).expandedTo(QSize(1, 1));
+        m_levels.push_back(previous.scaled(halfSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    }
+
+    return m_levels[std::min(levelNo, m_levels.size() - 1)];
+}
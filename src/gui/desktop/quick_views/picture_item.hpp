@@ -2,6 +2,8 @@
 #ifndef IMAGE_ITEM_HPP
 #define IMAGE_ITEM_HPP
 
+#include <vector>
+
 #include <QImage>
 #include <QQuickPaintedItem>
 
@@ -18,10 +20,17 @@ class PictureItem: public QQuickPaintedItem
 
         void paint(QPainter * painter) override;
 
+    protected:
+        void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+
     private:
         QImage m_source;
+        QImage m_displayed;
+        std::vector<QImage> m_levels;           // m_source downscaled by powers of two. Level 0 is m_source itself
 
         bool validateInputs() const;
+        void updateTexture();
+        const QImage& level(std::size_t);
 
     signals:
         void sourceChanged();
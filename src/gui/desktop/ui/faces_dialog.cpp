@@ -11,9 +11,7 @@
 #include <QStyledItemDelegate>
 
 #include <core/down_cast.hpp>
-#include <core/iexif_reader.hpp>
 #include <core/icore_factory_accessor.hpp>
-#include <core/image_tools.hpp>
 #include <database/photo_data.hpp>
 #include <project_utils/project.hpp>
 
@@ -57,15 +55,16 @@ FacesDialog::FacesDialog(const Photo::Data& data, ICompleterFactory* completerFa
     m_id(data.id),
     m_peopleManipulator(data.id, *prj->getDatabase(), *coreAccessor),
     m_faces(),
-    m_photoPath(data.path),
-    ui(new Ui::FacesDialog),
-    m_exif(coreAccessor->getExifReaderFactory().get())
+    ui(new Ui::FacesDialog)
 {
     ui->setupUi(this);
 
     ui->quickView->setSource(QUrl("qrc:/ui/Dialogs/FacesDialog.qml"));
     ui->peopleList->setItemDelegate(new TableDelegate(completerFactory, this));
 
+    connect(&m_peopleManipulator, &PeopleManipulator::imageLoaded,
+            this, &FacesDialog::setImage);
+
     connect(&m_peopleManipulator, &PeopleManipulator::facesAnalyzed,
             this, &FacesDialog::updateFaceInformation);
 
@@ -75,8 +74,6 @@ FacesDialog::FacesDialog(const Photo::Data& data, ICompleterFactory* completerFa
     connect(ui->peopleList, &QTableWidget::itemSelectionChanged, this, &FacesDialog::selectFace);
 
     updateDetectionState(0);
-
-    setImage();
 }
 
 
@@ -133,19 +130,19 @@ void FacesDialog::applyFaceName(const QRect& face, const PersonName& person)
 }
 
 
-void FacesDialog::setImage()
+void FacesDialog::setImage(const QImage& image)
 {
-    const OrientedImage oriented_image = Image::normalized(m_photoPath, m_exif);
-    m_photoSize = oriented_image->size();
+    // image is shared with face detection, QML displays it without a copy
+    m_photoSize = image.size();
 
-    if (oriented_image->isNull())
+    if (image.isNull())
     {
         // TODO: display some empty image or something
     }
     else
     {
         QObject* photo = QmlUtils::findQmlObject(ui->quickView, "flickablePhoto");
-        photo->setProperty("source", QVariant(oriented_image.get()));
+        photo->setProperty("source", QVariant(image));
         QMetaObject::invokeMethod(photo, "zoomToFit", Qt::QueuedConnection);
     }
 }
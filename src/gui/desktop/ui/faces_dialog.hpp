@@ -14,7 +14,6 @@
 class QTableWidgetItem;
 
 struct ICoreFactoryAccessor;
-struct IExifReader;
 
 namespace Ui {
     class FacesDialog;
@@ -35,14 +34,12 @@ class FacesDialog: public QDialog
         const Photo::Id m_id;
         PeopleManipulator m_peopleManipulator;
         QVector<QRect> m_faces;
-        QString m_photoPath;
         QSize m_photoSize;
         Ui::FacesDialog *ui;
-        IExifReader* m_exif;
 
         void updateFaceInformation();
         void applyFaceName(const QRect &, const PersonName &);
-        void setImage();
+        void setImage(const QImage &);
         void updatePeopleList();
         void selectFace();
 
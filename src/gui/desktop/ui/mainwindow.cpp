@@ -35,6 +35,7 @@
 #include "widgets/series_detection/series_detection.hpp"
 #include "widgets/collection_dir_scan_dialog.hpp"
 #include "ui_utils/config_dialog_manager.hpp"
+#include "utils/faces_analyzer.hpp"
 #include "utils/groups_manager.hpp"
 #include "utils/selection_to_photoid_translator.hpp"
 #include "utils/model_index_utils.hpp"
@@ -149,6 +150,9 @@ void MainWindow::setupConfig()
 {
     // setup defaults
     m_configuration.setDefaultValue(UpdateConfigKeys::updateEnabled,   true);
+    m_configuration.setDefaultValue(GroupingConfigKeys::previewRamBudget,  512);
+    m_configuration.setDefaultValue(GroupingConfigKeys::previewDiskBudget, 2048);
+    m_configuration.setDefaultValue(FacesConfigKeys::backgroundDetection, true);
 
     loadGeometry();
     loadRecentCollections();
@@ -361,9 +365,18 @@ void MainWindow::updateTools()
     {
         m_photosAnalyzer = std::make_unique<PhotosAnalyzer>(m_coreAccessor, m_currentPrj->getDatabase());
         m_photosAnalyzer->set(ui->tasksWidget);
+
+        if (m_enableFaceRecognition && m_configuration.getEntry(FacesConfigKeys::backgroundDetection).toBool())
+        {
+            m_facesAnalyzer = std::make_unique<FacesAnalyzer>(m_coreAccessor, m_currentPrj->getDatabase());
+            m_facesAnalyzer->set(ui->tasksWidget);
+        }
     }
     else
+    {
+        m_facesAnalyzer.reset();
         m_photosAnalyzer.reset();
+    }
 }
 
 
@@ -18,6 +18,7 @@ class ConfigDialogManager;
 class LookTabController;
 class MainTabController;
 class ToolsTabController;
+class FacesAnalyzer;
 class PhotosAnalyzer;
 class PhotosWidget;
 struct ICoreFactoryAccessor;
@@ -68,6 +69,7 @@ class MainWindow: public QMainWindow, public INotifications
         ICoreFactoryAccessor*     m_coreAccessor;
         IThumbnailsManager*       m_thumbnailsManager;
         std::unique_ptr<PhotosAnalyzer> m_photosAnalyzer;
+        std::unique_ptr<FacesAnalyzer> m_facesAnalyzer;
         std::unique_ptr<ConfigDialogManager> m_configDialogManager;
         std::unique_ptr<MainTabController> m_mainTabCtrl;
         std::unique_ptr<ToolsTabController> m_toolsTabCtrl;
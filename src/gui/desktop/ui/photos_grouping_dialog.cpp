@@ -19,9 +19,11 @@
 
 #include "ui_photos_grouping_dialog.h"
 
+#include "config_keys.hpp"
 #include "utils/groups_manager.hpp"
 #include "utils/grouppers/animation_generator.hpp"
 #include "utils/grouppers/hdr_generator.hpp"
+#include "utils/grouppers/preview_cache.hpp"
 #include "widgets/media_preview.hpp"
 
 
@@ -37,6 +39,13 @@ namespace
             return Group::Invalid;
     }
 
+    std::size_t budget(IConfiguration& configuration, const char* entry)
+    {
+        const int mebibytes = configuration.getEntry(entry).toInt();
+
+        return mebibytes > 0? static_cast<std::size_t>(mebibytes) * 1024 * 1024: 0;
+    }
+
     int groupTypeTocombobox(Group::Type type)
     {
         switch(type)
@@ -86,6 +95,8 @@ PhotosGroupingDialog::PhotosGroupingDialog(const std::vector<Photo::Data>& photo
     QDialog(parent),
     m_model(),
     m_tmpDir(System::createTmpDir("PGD_wd", System::Confidential)),
+    m_previewCache(std::make_shared<PreviewCache>(budget(configuration, GroupingConfigKeys::previewRamBudget),
+                                                  budget(configuration, GroupingConfigKeys::previewDiskBudget))),
     m_sortProxy(),
     m_representativeFile(),
     m_photos(photos),
@@ -298,13 +309,14 @@ void PhotosGroupingDialog::makeAnimation()
     generator_data.alignImageStackPath = m_config.getEntry(ExternalToolsConfigKeys::aisPath).toString();
     generator_data.magickPath = m_config.getEntry(ExternalToolsConfigKeys::magickPath).toString();
     generator_data.photos = getPhotos();
+    generator_data.cache = m_previewCache;
     generator_data.format = ui->formatComboBox->currentText();
     generator_data.fps = ui->speedSpinBox->value();
     generator_data.scale = ui->scaleSpinBox->value();
     generator_data.delay = ui->delaySpinBox->value();
     generator_data.stabilize = ui->stabilizationCheckBox->isChecked();
 
-    auto animation_task = std::make_unique<AnimationGenerator>(generator_data, m_logger, m_exifReaderFactory);
+    auto animation_task = std::make_unique<AnimationGenerator>(generator_data, m_logger, m_exifReaderFactory, m_executor);
 
     connect(this, &PhotosGroupingDialog::cancel, animation_task.get(), &AnimationGenerator::cancel);
     connect(ui->previewScaleSlider, &QSlider::sliderMoved,        this, &PhotosGroupingDialog::scalePreview);
@@ -330,11 +342,10 @@ void PhotosGroupingDialog::makeHDR()
     HDRGenerator::Data generator_data;
 
     generator_data.storage = m_tmpDir->path();
-    generator_data.alignImageStackPath = m_config.getEntry(ExternalToolsConfigKeys::aisPath).toString();
-    generator_data.magickPath = m_config.getEntry(ExternalToolsConfigKeys::magickPath).toString();
     generator_data.photos = getPhotos();
+    generator_data.cache = m_previewCache;
 
-    auto hdr_task = std::make_unique<HDRGenerator>(generator_data, m_logger, m_exifReaderFactory);
+    auto hdr_task = std::make_unique<HDRGenerator>(generator_data, m_logger, m_exifReaderFactory, m_executor);
 
     connect(this, &PhotosGroupingDialog::cancel, hdr_task.get(), &AnimationGenerator::cancel);
     connect(ui->previewScaleSlider, &QSlider::sliderMoved,  this, &PhotosGroupingDialog::scalePreview);
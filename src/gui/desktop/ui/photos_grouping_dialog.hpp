@@ -10,6 +10,7 @@
 
 
 class MediaPreview;
+class PreviewCache;
 class Project;
 struct IConfiguration;
 struct IExifReaderFactory;
@@ -79,6 +80,7 @@ class PhotosGroupingDialog: public QDialog
     private:
         QStandardItemModel m_model;
         std::shared_ptr<ITmpDir> m_tmpDir;
+        std::shared_ptr<PreviewCache> m_previewCache;
         SortingProxy m_sortProxy;
         QString m_representativeFile;
         std::vector<Photo::Data> m_photos;
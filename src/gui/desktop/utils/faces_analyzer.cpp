@@ -0,0 +1,346 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "faces_analyzer.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QFileInfo>
+#include <QPointer>
+
+#include <core/function_wrappers.hpp>
+#include <core/icore_factory_accessor.hpp>
+#include <core/itask_executor.hpp>
+#include <core/itasks_view.hpp>
+#include <core/iview_task.hpp>
+#include <database/general_flags.hpp>
+#include <database/ibackend.hpp>
+#include <database/idatabase.hpp>
+#include <database/iphoto_operator.hpp>
+#include <face_recognition/face_recognition.hpp>
+
+
+namespace
+{
+    // photos analyzed by one task (and stored in database at once)
+    constexpr std::size_t BatchSize = 16;
+
+    // longer side of photo used for detection. Photos are decoded with this size,
+    // which is much faster than decoding them in full size.
+    constexpr int DetectionSize = 2048;
+
+    // time after last user's input when user is considered idle
+    constexpr qint64 UserIdleTime = 5000;
+}
+
+
+struct FacesDetectionTask: ITaskExecutor::ITask
+{
+    FacesDetectionTask(FacesAnalyzer* analyzer, const std::map<Photo::Id, QString>& photos):
+        m_analyzer(analyzer),
+        m_photos(photos)
+    {
+    }
+
+    FacesDetectionTask(const FacesDetectionTask &) = delete;
+    FacesDetectionTask& operator=(const FacesDetectionTask &) = delete;
+
+    std::string name() const override
+    {
+        return "Faces detection";
+    }
+
+    void perform() override
+    {
+        const FacesAnalyzer::Detector detect = m_analyzer->m_detectorFactory();
+        std::map<Photo::Id, std::vector<QRect>> faces;
+
+        for (const auto& [id, path]: m_photos)
+        {
+            if (m_analyzer->m_stopped)
+                break;
+
+            const QVector<QRect> found = detect(path);
+            faces.emplace(id, std::vector<QRect>(found.cbegin(), found.cend()));
+        }
+
+        // photos not analyzed due to stop will be picked up next time
+        if (faces.empty() == false)
+            m_analyzer->m_database->exec([faces](Database::IBackend& backend)
+            {
+                backend.peopleInformationAccessor().storeDetectedFaces(faces);
+            });
+
+        invokeMethod(m_analyzer, &FacesAnalyzer::batchAnalyzed, static_cast<int>(m_photos.size()));
+
+        m_analyzer->taskFinished();
+    }
+
+    FacesAnalyzer* m_analyzer;
+    const std::map<Photo::Id, QString> m_photos;
+};
+
+
+FacesAnalyzer::FacesAnalyzer(ICoreFactoryAccessor* coreFactory, Database::IDatabase* database):
+    FacesAnalyzer(coreFactory, database, [coreFactory]() -> Detector
+    {
+        auto faceRecognition = std::make_shared<FaceRecognition>(coreFactory);
+
+        return [faceRecognition](const QString& path)
+        {
+            return faceRecognition->fetchFaces(path, DetectionSize);
+        };
+    })
+{
+
+}
+
+
+FacesAnalyzer::FacesAnalyzer(ICoreFactoryAccessor* coreFactory, Database::IDatabase* database, const DetectorFactory& detectorFactory):
+    m_photosToAnalyze(),
+    m_timer(),
+    m_userActivity(),
+    m_tasksMutex(),
+    m_finishedTask(),
+    m_stopped(false),
+    m_detectorFactory(detectorFactory),
+    m_database(database),
+    m_executor(coreFactory->getTaskExecutor()),
+    m_tasksView(nullptr),
+    m_viewTask(nullptr),
+    m_tasks(0),
+    m_analyzed(0),
+    m_total(0),
+    m_loadingBatch(false)
+{
+    // watch user's activity to slow down when user works with application
+    QCoreApplication::instance()->installEventFilter(this);
+
+    // timer refreshes progress and lets more tasks in when user goes idle
+    connect(&m_timer, &QTimer::timeout, this, &FacesAnalyzer::refreshView);
+    connect(&m_timer, &QTimer::timeout, this, &FacesAnalyzer::processPhotos);
+    m_timer.start(500);
+
+    // photos without FacesAnalysed flag were not analyzed yet (or analysis was interrupted)
+    const Database::FilterPhotosWithGeneralFlags analysed_filter(Database::CommonGeneralFlags::FacesAnalysed, 0);
+
+    // only normal photos
+    const Database::FilterPhotosWithGeneralFlags state_filter(Database::CommonGeneralFlags::State,
+                                                              static_cast<int>(Database::CommonGeneralFlags::StateType::Normal));
+
+    const Database::GroupFilter filters = {analysed_filter, state_filter};
+
+    connect(&m_database->backend(), &Database::IBackend::photosAdded,
+            this, &FacesAnalyzer::addPhotos);
+
+    QPointer<QObject> self(this);
+    m_database->exec([self, this, filters](Database::IBackend& backend)
+    {
+        const std::vector<Photo::Id> photos = backend.photoOperator().getPhotos(filters);
+
+        call_from_this_thread(self, [this, photos]
+        {
+            addPhotos(photos);
+        });
+    });
+}
+
+
+FacesAnalyzer::~FacesAnalyzer()
+{
+    stop();
+
+    if (m_viewTask)
+        m_viewTask->finished();
+
+    QCoreApplication::instance()->removeEventFilter(this);
+}
+
+
+void FacesAnalyzer::set(ITasksView* tasksView)
+{
+    m_tasksView = tasksView;
+}
+
+
+void FacesAnalyzer::stop()
+{
+    m_stopped = true;
+    m_photosToAnalyze.clear();
+
+    disconnect(&m_database->backend(), &Database::IBackend::photosAdded,
+               this, &FacesAnalyzer::addPhotos);
+
+    waitForActiveTasks();
+}
+
+
+bool FacesAnalyzer::eventFilter(QObject* watched, QEvent* event)
+{
+    switch(event->type())
+    {
+        case QEvent::KeyPress:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseMove:
+        case QEvent::Wheel:
+            m_userActivity.start();
+            break;
+
+        default:
+            break;
+    }
+
+    return QObject::eventFilter(watched, event);
+}
+
+
+void FacesAnalyzer::addPhotos(const std::vector<Photo::Id>& ids)
+{
+    if (m_stopped)
+        return;
+
+    m_photosToAnalyze.insert(m_photosToAnalyze.end(), ids.begin(), ids.end());
+    m_total += static_cast<int>(ids.size());
+
+    processPhotos();
+}
+
+
+void FacesAnalyzer::processPhotos()
+{
+    if (m_loadingBatch == false &&
+        m_photosToAnalyze.empty() == false &&
+        tasksInProgress() < allowedTasks())
+    {
+        m_loadingBatch = true;
+
+        const std::size_t toProcess = std::min(m_photosToAnalyze.size(), BatchSize);
+        const std::vector<Photo::Id> batch(m_photosToAnalyze.begin(), m_photosToAnalyze.begin() + toProcess);
+        m_photosToAnalyze.erase(m_photosToAnalyze.begin(), m_photosToAnalyze.begin() + toProcess);
+
+        QPointer<QObject> self(this);
+        m_database->exec([self, this, batch](Database::IBackend& backend)
+        {
+            std::map<Photo::Id, QString> paths;
+
+            for(const Photo::Id& id: batch)
+            {
+                const Photo::Data photo = backend.getPhoto(id);
+                paths.emplace(id, QFileInfo(photo.path).absoluteFilePath());
+            }
+
+            call_from_this_thread(self, [this, paths]
+            {
+                startBatch(paths);
+            });
+        });
+    }
+}
+
+
+void FacesAnalyzer::startBatch(const std::map<Photo::Id, QString>& photos)
+{
+    m_loadingBatch = false;
+
+    if (m_stopped)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_tasksMutex);
+        m_tasks++;
+    }
+
+    m_executor.add(std::make_unique<FacesDetectionTask>(this, photos));
+
+    processPhotos();
+}
+
+
+void FacesAnalyzer::batchAnalyzed(int photos)
+{
+    m_analyzed += photos;
+
+    processPhotos();
+}
+
+
+void FacesAnalyzer::taskFinished()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_tasksMutex);
+        m_tasks--;
+    }
+
+    m_finishedTask.notify_one();
+}
+
+
+void FacesAnalyzer::waitForActiveTasks()
+{
+    std::unique_lock<std::mutex> lock(m_tasksMutex);
+    m_finishedTask.wait(lock, [&]
+    {
+        return m_tasks == 0;
+    });
+}
+
+
+int FacesAnalyzer::tasksInProgress()
+{
+    std::lock_guard<std::mutex> lock(m_tasksMutex);
+
+    return m_tasks;
+}
+
+
+int FacesAnalyzer::allowedTasks() const
+{
+    const bool userActive = m_userActivity.isValid() && m_userActivity.elapsed() < UserIdleTime;
+
+    return userActive? 1: std::max(1, m_executor.heavyWorkers());
+}
+
+
+void FacesAnalyzer::refreshView()
+{
+    if (m_tasksView == nullptr)
+        return;
+
+    const bool working = m_analyzed < m_total;
+
+    if (working && m_viewTask == nullptr)
+        m_viewTask = m_tasksView->add(tr("Looking for faces..."));
+    else if (working == false && m_viewTask != nullptr)
+    {
+        m_viewTask->finished();
+        m_viewTask = nullptr;
+
+        m_analyzed = 0;
+        m_total = 0;
+    }
+
+    if (m_viewTask != nullptr)
+    {
+        IProgressBar* progressBar = m_viewTask->getProgressBar();
+        progressBar->setMaximum(m_total);
+        progressBar->setValue(m_analyzed);
+    }
+}
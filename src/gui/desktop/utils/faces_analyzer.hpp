@@ -0,0 +1,108 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FACES_ANALYZER_HPP
+#define FACES_ANALYZER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QRect>
+#include <QTimer>
+#include <QVector>
+
+#include <database/photo_types.hpp>
+
+struct ICoreFactoryAccessor;
+struct ITaskExecutor;
+struct ITasksView;
+struct IViewTask;
+struct FacesDetectionTask;
+
+namespace Database
+{
+    struct IDatabase;
+}
+
+
+// Looks for faces on all photos of collection in background.
+// Photos are processed in batches. Results of each batch are stored at once
+// together with FacesAnalysed flag, so when work is interrupted (application closed or crashed)
+// it will be continued from the first batch which was not stored.
+// When user is active, only one batch is being processed at a time.
+class FacesAnalyzer final: public QObject
+{
+        Q_OBJECT
+
+    public:
+        // detects faces on photo with given path
+        typedef std::function<QVector<QRect>(const QString &)> Detector;
+
+        // constructs detector for one batch of photos (called from task executor's thread)
+        typedef std::function<Detector()> DetectorFactory;
+
+        FacesAnalyzer(ICoreFactoryAccessor *, Database::IDatabase *);
+        FacesAnalyzer(ICoreFactoryAccessor *, Database::IDatabase *, const DetectorFactory &);
+        FacesAnalyzer(const FacesAnalyzer &) = delete;
+        ~FacesAnalyzer();
+
+        FacesAnalyzer& operator=(const FacesAnalyzer &) = delete;
+
+        void set(ITasksView *);
+        void stop();
+
+    protected:
+        bool eventFilter(QObject *, QEvent *) override;
+
+    private:
+        friend struct FacesDetectionTask;
+
+        std::deque<Photo::Id> m_photosToAnalyze;
+        QTimer m_timer;
+        QElapsedTimer m_userActivity;
+        std::mutex m_tasksMutex;
+        std::condition_variable m_finishedTask;
+        std::atomic<bool> m_stopped;
+        DetectorFactory m_detectorFactory;
+        Database::IDatabase* m_database;
+        ITaskExecutor& m_executor;
+        ITasksView* m_tasksView;
+        IViewTask* m_viewTask;
+        int m_tasks;
+        int m_analyzed;
+        int m_total;
+        bool m_loadingBatch;
+
+        void addPhotos(const std::vector<Photo::Id> &);
+        void processPhotos();
+        void startBatch(const std::map<Photo::Id, QString> &);
+        void batchAnalyzed(int);
+        void taskFinished();
+        void waitForActiveTasks();
+        int tasksInProgress();
+        int allowedTasks() const;
+        void refreshView();
+};
+
+#endif // FACES_ANALYZER_HPP
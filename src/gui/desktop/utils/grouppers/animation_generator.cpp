@@ -19,21 +19,28 @@
 
 #include "animation_generator.hpp"
 
+#include <atomic>
 #include <cassert>
 
 #include <QDirIterator>
+#include <QFile>
 #include <QFileInfo>
 
 #include <core/function_wrappers.hpp>
+#include <core/iexif_reader.hpp>
+#include <core/image_tools.hpp>
+#include <core/task_executor_utils.hpp>
 #include <system/system.hpp>
 
+#include "gif_encoder.hpp"
+
 using std::placeholders::_1;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 
-AnimationGenerator::AnimationGenerator(const Data& data, ILogger* logger, IExifReaderFactory& exif):
-    GeneratorUtils::BreakableTask(data.storage, exif),
+AnimationGenerator::AnimationGenerator(const Data& data, ILogger* logger, IExifReaderFactory& exif, ITaskExecutor& executor):
+    GeneratorUtils::BreakableTask(data.storage, exif, executor),
     m_data(data),
     m_logger(logger)
 {
@@ -57,15 +64,12 @@ void AnimationGenerator::run()
 {
     emit progress(-1);
 
-    // stabilize?
     try
     {
-        const QStringList images_to_be_used = m_data.stabilize?
-                                              stabilize():
-                                              m_data.photos;
-
-        // generate animation (if there was no cancel during stabilization)
-        const QString animation_path = generateAnimation(images_to_be_used);
+        // gif can be generated in process, other formats require ImageMagick
+        const QString animation_path = format() == "gif"?
+                                       encodeAnimation():
+                                       convertAnimation(m_data.stabilize? stabilize().paths: prepare().paths);
 
         emit finished(animation_path);
     }
@@ -76,22 +80,41 @@ void AnimationGenerator::run()
 }
 
 
-QStringList AnimationGenerator::stabilize()
+PreviewCache::Files AnimationGenerator::prepare()
+{
+    std::optional<PreviewCache::Files> cached = m_data.cache->preparedPhotos(m_data.photos, m_data.scale);
+
+    if (cached)
+        return *cached;
+
+    // align_image_stack doesn't respect photo's rotation
+    // generate rotated copies of original images.
+    // Scale them down at the same time as animation will be scaled anyway - makes stabilization faster
+    PreviewCache::Files prepared;
+    prepared.dir = System::createTmpDir("AG_rotate", System::Confidential);
+    prepared.paths = rotatePhotos(m_data.photos, prepared.dir->path(), m_data.scale);
+
+    m_data.cache->storePreparedPhotos(m_data.photos, m_data.scale, prepared);
+
+    return prepared;
+}
+
+
+PreviewCache::Files AnimationGenerator::stabilize()
 {
     using GeneratorUtils::AISOutputAnalyzer;
 
+    std::optional<PreviewCache::Files> cached = m_data.cache->alignedPhotos(m_data.photos, m_data.scale);
+
+    if (cached)
+        return *cached;
+
     const int photos_count = m_data.photos.size();
 
-    emit operation(tr("Preparing photos"));
-    emit progress(0);
     // https://groups.google.com/forum/#!topic/hugin-ptx/gqodoTgAjbI
     // http://wiki.panotools.org/Panorama_scripting_in_a_nutshell
     // http://wiki.panotools.org/Align_image_stack
-
-    // align_image_stack doesn't respect photo's rotation
-    // generate rotated copies of original images
-    auto dirForRotatedPhotos = System::createTmpDir("AG_rotate", System::Confidential);
-    const QStringList rotated_photos = rotatePhotos(m_data.photos, dirForRotatedPhotos->path());
+    const PreviewCache::Files prepared = prepare();
 
     AISOutputAnalyzer analyzer(m_logger, photos_count);
     connect(&analyzer, &AISOutputAnalyzer::operation, this, &AnimationGenerator::operation);
@@ -100,7 +123,11 @@ QStringList AnimationGenerator::stabilize()
 
     // generate aligned files
     emit operation(tr("Stabilizing photos"));
-    const QString output_prefix = m_tmpDir->path() + "/stabilized";
+
+    PreviewCache::Files stabilized;
+    stabilized.dir = System::createTmpDir("AG_stabilize", System::Confidential);
+
+    const QString output_prefix = stabilized.dir->path() + "/stabilized";
 
     GeneratorUtils::execute(m_logger,
             m_data.alignImageStackPath,
@@ -112,7 +139,7 @@ QStringList AnimationGenerator::stabilize()
             "-d", "-i", "-x", "-y", "-z",
             "-s", "0",
             "-a", output_prefix,
-            rotated_photos);
+            prepared.paths);
 
     if (m_runner.getExitCode() != 0)
     {
@@ -120,28 +147,113 @@ QStringList AnimationGenerator::stabilize()
         throw output;
     }
 
-    QStringList stabilized_images;
-
     const QFileInfo output_prefix_info(output_prefix);
     QDirIterator filesIterator(output_prefix_info.absolutePath(), {output_prefix_info.fileName() + "*"}, QDir::Files);
 
     while(filesIterator.hasNext())
-        stabilized_images.push_back(filesIterator.next());
+        stabilized.paths.push_back(filesIterator.next());
 
-    std::sort(stabilized_images.begin(), stabilized_images.end());
+    std::sort(stabilized.paths.begin(), stabilized.paths.end());
 
-    return stabilized_images;
+    m_data.cache->storeAlignedPhotos(m_data.photos, m_data.scale, stabilized);
+
+    return stabilized;
 }
 
 
-QString AnimationGenerator::generateAnimation(const QStringList& photos)
+QString AnimationGenerator::encodeAnimation()
+{
+    // compressed frames do not depend on animation's timing,
+    // so when only delays were changed just write them again
+    PreviewCache::Animation animation = m_data.cache->encodedAnimation(m_data.photos, m_data.scale, m_data.stabilize);
+
+    if (animation.get() == nullptr)
+    {
+        // stabilized photos are already scaled
+        animation = m_data.stabilize?
+                    encodeFrames(stabilize().paths, 100.0):
+                    encodeFrames(m_data.photos, m_data.scale);
+
+        m_data.cache->storeEncodedAnimation(m_data.photos, m_data.scale, m_data.stabilize, animation);
+    }
+
+    emit operation(tr("Assembling final file"));
+
+    const int photos_count = static_cast<int>(animation->frames.size());
+    const int frame_delay = qRound(1/m_data.fps * 100);            // convert fps to 1/100th of a second
+    const QString location = System::getTmpFile(m_storage, format());
+
+    std::vector<int> delays(static_cast<std::size_t>(photos_count), frame_delay);
+    delays.back() = lastPhotoDelay();
+
+    QFile animation_file(location);
+
+    const bool success = animation_file.open(QIODevice::WriteOnly) &&
+                         GifEncoder::write(*animation, delays, animation_file);
+
+    if (success == false)
+        throw QStringList( tr("Could not save animation as %1").arg(location) );
+
+    return location;
+}
+
+
+PreviewCache::Animation AnimationGenerator::encodeFrames(const QStringList& photos, double scale)
+{
+    const int photos_count = photos.size();
+
+    emit operation(tr("Loading photos to be animated"));
+    emit progress(0);
+
+    std::vector<QImage> frames(static_cast<std::size_t>(photos_count));
+    std::atomic<int> photos_loaded(0);
+
+    parallelFor(&m_executor, photos_count, m_executor.heavyWorkers(), [&](std::size_t i)
+    {
+        if (m_runner.isCancelled())
+            return;
+
+        QImage image = Image::normalized(photos[static_cast<int>(i)], m_exif.get()).get();
+
+        if (scale != 100.0 && image.isNull() == false)
+            image = image.scaled(image.size() * (scale / 100.0), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        frames[i] = image;
+
+        emit progress( ++photos_loaded * 100 / photos_count );
+    });
+
+    if (m_runner.isCancelled())
+        throw false;
+
+    emit operation(tr("Compressing frames"));
+    emit progress(0);
+
+    auto animation = std::make_shared<GifEncoder::EncodedAnimation>();
+    GifEncoder encoder(m_executor);
+
+    const bool success = encoder.encode(frames,
+                                        *animation,
+                                        [this](int p) { emit progress(p); },
+                                        [this]() { return m_runner.isCancelled(); });
+
+    if (m_runner.isCancelled())
+        throw false;
+
+    if (success == false)
+        throw QStringList( tr("Could not load photos") );
+
+    return animation;
+}
+
+
+QString AnimationGenerator::convertAnimation(const QStringList& photos)
 {
     using GeneratorUtils::MagickOutputAnalyzer;
 
-    // generate animation
+    // generate animation from prepared (rotated and scaled) or stabilized photos
     const int photos_count = m_data.photos.size();
-    const double last_photo_exact_delay = (m_data.delay / 1000.0) * 100 + (1 / m_data.fps * 100);
-    const int last_photo_delay = static_cast<int>(last_photo_exact_delay);
+    const int last_photo_delay = lastPhotoDelay();
     const QStringList all_but_last = photos.mid(0, photos.size() - 1);
     const QString last = photos.last();
     const QString extension = format();
@@ -167,7 +279,6 @@ QString AnimationGenerator::generateAnimation(const QStringList& photos)
             "+repage",                                       // [1]
             "-auto-orient",
             "-loop", "0",
-            "-scale", QString::number(m_data.scale) + "%",
             location);
 
     return location;
@@ -180,6 +291,14 @@ QString AnimationGenerator::generateAnimation(const QStringList& photos)
 }
 
 
+int AnimationGenerator::lastPhotoDelay() const
+{
+    const double last_photo_exact_delay = (m_data.delay / 1000.0) * 100 + (1 / m_data.fps * 100);
+
+    return static_cast<int>(last_photo_exact_delay);
+}
+
+
 QString AnimationGenerator::format() const
 {
     if (m_data.format == "GIF")
@@ -23,6 +23,7 @@
 #include <QSize>
 
 #include "generator_utils.hpp"
+#include "preview_cache.hpp"
 
 class QProcess;
 
@@ -39,16 +40,17 @@ class AnimationGenerator: public GeneratorUtils::BreakableTask
             QString magickPath;
             QString alignImageStackPath;
             QStringList photos;
+            std::shared_ptr<PreviewCache> cache;
             QString format;
             double fps;
             double delay;
             double scale;
             bool stabilize;
 
-            Data(): storage(), magickPath(), alignImageStackPath(), photos(), fps(0.0), delay(0.0), scale(0.0), stabilize(false) {}
+            Data(): storage(), magickPath(), alignImageStackPath(), photos(), cache(), fps(0.0), delay(0.0), scale(0.0), stabilize(false) {}
         };
 
-        AnimationGenerator(const Data& data, ILogger *, IExifReaderFactory &);
+        AnimationGenerator(const Data& data, ILogger *, IExifReaderFactory &, ITaskExecutor &);
         AnimationGenerator(const AnimationGenerator &) = delete;
         ~AnimationGenerator();
 
@@ -61,8 +63,12 @@ class AnimationGenerator: public GeneratorUtils::BreakableTask
         Data m_data;
         ILogger* m_logger;
 
-        QStringList stabilize();
-        QString generateAnimation(const QStringList &);
+        PreviewCache::Files prepare();
+        PreviewCache::Files stabilize();
+        QString encodeAnimation();
+        PreviewCache::Animation encodeFrames(const QStringList &, double scale);
+        QString convertAnimation(const QStringList &);
+        int lastPhotoDelay() const;
         QString format() const;
 };
 
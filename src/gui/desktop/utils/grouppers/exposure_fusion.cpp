@@ -0,0 +1,649 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "exposure_fusion.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <QPoint>
+
+#include <core/task_executor_utils.hpp>
+
+
+namespace
+{
+    // Inner loops below work on contiguous rows of floats with no branches
+    // so compiler can vectorize them.
+
+    struct Plane
+    {
+        Plane() = default;
+        Plane(int w, int h): width(w), height(h), data(static_cast<std::size_t>(w) * h, 0.0f) {}
+
+        float* row(int y) { return data.data() + static_cast<std::size_t>(y) * width; }
+        const float* row(int y) const { return data.data() + static_cast<std::size_t>(y) * width; }
+
+        int width = 0;
+        int height = 0;
+        std::vector<float> data;
+    };
+
+    typedef std::vector<Plane> Pyramid;
+
+    struct GrayLevel
+    {
+        int width;
+        int height;
+        std::vector<std::uint8_t> data;
+        int median;
+    };
+
+    typedef std::vector<GrayLevel> GrayPyramid;
+
+    constexpr int RowsPerBand = 32;
+    constexpr int MinLevelSize = 8;
+    constexpr int AlignmentLevels = 6;              // max shift of 2^6 pixels
+    constexpr int AlignmentNoise = 4;               // pixels this close to median are ignored during alignment
+
+
+    void forEachBand(ITaskExecutor& executor, int height, const std::function<void(int, int)>& op)
+    {
+        const std::size_t bands = static_cast<std::size_t>((height + RowsPerBand - 1) / RowsPerBand);
+        const std::size_t jobs = static_cast<std::size_t>(std::max(executor.heavyWorkers(), 1));
+
+        parallelFor(&executor, bands, jobs, [&op, height](std::size_t band)
+        {
+            const int begin = static_cast<int>(band) * RowsPerBand;
+            const int end = std::min(height, begin + RowsPerBand);
+
+            op(begin, end);
+        });
+    }
+
+
+    int clamp(int v, int max)
+    {
+        return std::clamp(v, 0, max - 1);
+    }
+
+
+    int levelsFor(int width, int height)
+    {
+        int levels = 1;
+
+        for (int size = std::min(width, height); size / 2 >= MinLevelSize; size /= 2)
+            levels++;
+
+        return levels;
+    }
+
+
+    const QRgb* shiftedLine(const QImage& image, int y, const QPoint& shift)
+    {
+        return reinterpret_cast<const QRgb *>(image.constScanLine(clamp(y - shift.y(), image.height())));
+    }
+
+
+    // 5 tap binomial filter [1 4 6 4 1] / 16 followed by 2x decimation
+    Plane reduce(ITaskExecutor& executor, const Plane& src)
+    {
+        const int width = (src.width + 1) / 2;
+        const int height = (src.height + 1) / 2;
+
+        Plane horizontal(width, src.height);
+        Plane result(width, height);
+
+        forEachBand(executor, src.height, [&](int begin, int end)
+        {
+            for (int y = begin; y < end; y++)
+            {
+                const float* in = src.row(y);
+                float* out = horizontal.row(y);
+
+                for (int x = 0; x < width; x++)
+                {
+                    const int c = 2 * x;
+                    out[x] = (      in[clamp(c - 2, src.width)] +
+                              4.f * in[clamp(c - 1, src.width)] +
+                              6.f * in[c] +
+                              4.f * in[clamp(c + 1, src.width)] +
+                                    in[clamp(c + 2, src.width)]) / 16.f;
+                }
+            }
+        });
+
+        forEachBand(executor, height, [&](int begin, int end)
+        {
+            for (int y = begin; y < end; y++)
+            {
+                const int c = 2 * y;
+                const float* r0 = horizontal.row(clamp(c - 2, src.height));
+                const float* r1 = horizontal.row(clamp(c - 1, src.height));
+                const float* r2 = horizontal.row(c);
+                const float* r3 = horizontal.row(clamp(c + 1, src.height));
+                const float* r4 = horizontal.row(clamp(c + 2, src.height));
+                float* out = result.row(y);
+
+                for (int x = 0; x < width; x++)
+                    out[x] = (r0[x] + 4.f * r1[x] + 6.f * r2[x] + 4.f * r3[x] + r4[x]) / 16.f;
+            }
+        });
+
+        return result;
+    }
+
+
+    // inverse of reduce(): 2x interpolation to given size
+    Plane expand(ITaskExecutor& executor, const Plane& src, int width, int height)
+    {
+        Plane horizontal(width, src.height);
+        Plane result(width, height);
+
+        forEachBand(executor, src.height, [&](int begin, int end)
+        {
+            for (int y = begin; y < end; y++)
+            {
+                const float* in = src.row(y);
+                float* out = horizontal.row(y);
+
+                for (int x = 0; x < width; x++)
+                {
+                    const int i = x / 2;
+                    const float prev = in[clamp(i - 1, src.width)];
+                    const float curr = in[clamp(i, src.width)];
+                    const float next = in[clamp(i + 1, src.width)];
+
+                    out[x] = (x % 2 == 0)?
+                        (prev + 6.f * curr + next) / 8.f:
+                        (curr + next) / 2.f;
+                }
+            }
+        });
+
+        forEachBand(executor, height, [&](int begin, int end)
+        {
+            for (int y = begin; y < end; y++)
+            {
+                const int j = y / 2;
+                const float* prev = horizontal.row(clamp(j - 1, src.height));
+                const float* curr = horizontal.row(clamp(j, src.height));
+                const float* next = horizontal.row(clamp(j + 1, src.height));
+                float* out = result.row(y);
+
+                if (y % 2 == 0)
+                    for (int x = 0; x < width; x++)
+                        out[x] = (prev[x] + 6.f * curr[x] + next[x]) / 8.f;
+                else
+                    for (int x = 0; x < width; x++)
+                        out[x] = (curr[x] + next[x]) / 2.f;
+            }
+        });
+
+        return result;
+    }
+
+
+    Pyramid gaussianPyramid(ITaskExecutor& executor, Plane&& base, int levels)
+    {
+        Pyramid pyramid;
+        pyramid.push_back(std::move(base));
+
+        for (int l = 1; l < levels; l++)
+            pyramid.push_back(reduce(executor, pyramid.back()));
+
+        return pyramid;
+    }
+
+
+    // result[l] += weights[l] * laplacian[l], laplacian pyramid levels are calculated one by one
+    void accumulateLaplacian(ITaskExecutor& executor, Plane&& base, const Pyramid& weights, Pyramid& result)
+    {
+        const int levels = static_cast<int>(weights.size());
+        Plane current = std::move(base);
+
+        for (int l = 0; l < levels; l++)
+        {
+            const bool top = l + 1 == levels;
+            Plane next;
+            Plane expanded;
+
+            if (top == false)
+            {
+                next = reduce(executor, current);
+                expanded = expand(executor, next, current.width, current.height);
+            }
+
+            const Plane& weight = weights[l];
+            Plane& level = result[l];
+
+            forEachBand(executor, current.height, [&](int begin, int end)
+            {
+                for (int y = begin; y < end; y++)
+                {
+                    const float* in = current.row(y);
+                    const float* w = weight.row(y);
+                    float* out = level.row(y);
+
+                    if (top)
+                        for (int x = 0; x < current.width; x++)
+                            out[x] += w[x] * in[x];
+                    else
+                    {
+                        const float* e = expanded.row(y);
+
+                        for (int x = 0; x < current.width; x++)
+                            out[x] += w[x] * (in[x] - e[x]);
+                    }
+                }
+            });
+
+            current = std::move(next);
+        }
+    }
+
+
+    Plane collapse(ITaskExecutor& executor, const Pyramid& pyramid)
+    {
+        Plane result = pyramid.back();
+
+        for (int l = static_cast<int>(pyramid.size()) - 2; l >= 0; l--)
+        {
+            const Plane& level = pyramid[l];
+            result = expand(executor, result, level.width, level.height);
+
+            forEachBand(executor, level.height, [&](int begin, int end)
+            {
+                for (int y = begin; y < end; y++)
+                {
+                    const float* in = level.row(y);
+                    float* out = result.row(y);
+
+                    for (int x = 0; x < level.width; x++)
+                        out[x] += in[x];
+                }
+            });
+        }
+
+        return result;
+    }
+
+
+    Plane channel(ITaskExecutor& executor, const QImage& image, const QPoint& shift, int shiftBits)
+    {
+        const int width = image.width();
+        Plane result(width, image.height());
+
+        forEachBand(executor, image.height(), [&](int begin, int end)
+        {
+            for (int y = begin; y < end; y++)
+            {
+                const QRgb* in = shiftedLine(image, y, shift);
+                float* out = result.row(y);
+
+                for (int x = 0; x < width; x++)
+                    out[x] = ((in[clamp(x - shift.x(), width)] >> shiftBits) & 0xff) / 255.f;
+            }
+        });
+
+        return result;
+    }
+
+
+    // Mertens' quality measures: contrast * saturation * well-exposedness
+    Plane weights(ITaskExecutor& executor, const QImage& image, const QPoint& shift)
+    {
+        const int width = image.width();
+        const int height = image.height();
+
+        Plane gray(width, height);
+        Plane result(width, height);
+
+        forEachBand(executor, height, [&](int begin, int end)
+        {
+            for (int y = begin; y < end; y++)
+            {
+                const QRgb* in = shiftedLine(image, y, shift);
+                float* out = gray.row(y);
+
+                for (int x = 0; x < width; x++)
+                {
+                    const QRgb rgb = in[clamp(x - shift.x(), width)];
+                    out[x] = (0.299f * qRed(rgb) + 0.587f * qGreen(rgb) + 0.114f * qBlue(rgb)) / 255.f;
+                }
+            }
+        });
+
+        forEachBand(executor, height, [&](int begin, int end)
+        {
+            constexpr float sigma2 = 2.f * 0.2f * 0.2f;
+
+            for (int y = begin; y < end; y++)
+            {
+                const QRgb* in = shiftedLine(image, y, shift);
+                const float* above = gray.row(clamp(y - 1, height));
+                const float* curr = gray.row(y);
+                const float* below = gray.row(clamp(y + 1, height));
+                float* out = result.row(y);
+
+                for (int x = 0; x < width; x++)
+                {
+                    const QRgb rgb = in[clamp(x - shift.x(), width)];
+                    const float r = qRed(rgb) / 255.f;
+                    const float g = qGreen(rgb) / 255.f;
+                    const float b = qBlue(rgb) / 255.f;
+
+                    const float laplacian = above[x] + below[x] + curr[clamp(x - 1, width)] + curr[clamp(x + 1, width)] - 4.f * curr[x];
+                    const float contrast = std::abs(laplacian);
+
+                    const float mean = (r + g + b) / 3.f;
+                    const float saturation = std::sqrt(((r - mean) * (r - mean) + (g - mean) * (g - mean) + (b - mean) * (b - mean)) / 3.f);
+
+                    const float exposedness = std::exp(-((r - .5f) * (r - .5f) + (g - .5f) * (g - .5f) + (b - .5f) * (b - .5f)) / sigma2);
+
+                    out[x] = contrast * saturation * exposedness + 1e-12f;
+                }
+            }
+        });
+
+        return result;
+    }
+
+
+    GrayPyramid grayPyramid(const QImage& image)
+    {
+        GrayPyramid pyramid;
+
+        GrayLevel base{image.width(), image.height(), {}, 0};
+        base.data.resize(static_cast<std::size_t>(base.width) * base.height);
+
+        for (int y = 0; y < base.height; y++)
+        {
+            const QRgb* in = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+            std::uint8_t* out = base.data.data() + static_cast<std::size_t>(y) * base.width;
+
+            for (int x = 0; x < base.width; x++)
+                out[x] = static_cast<std::uint8_t>((54 * qRed(in[x]) + 183 * qGreen(in[x]) + 19 * qBlue(in[x])) >> 8);
+        }
+
+        pyramid.push_back(std::move(base));
+
+        for (int l = 1; l < AlignmentLevels && std::min(pyramid.back().width, pyramid.back().height) / 2 >= MinLevelSize; l++)
+        {
+            const GrayLevel& prev = pyramid.back();
+            GrayLevel level{prev.width / 2, prev.height / 2, {}, 0};
+            level.data.resize(static_cast<std::size_t>(level.width) * level.height);
+
+            for (int y = 0; y < level.height; y++)
+                for (int x = 0; x < level.width; x++)
+                {
+                    const std::size_t p = static_cast<std::size_t>(2 * y) * prev.width + 2 * x;
+                    const int sum = prev.data[p] + prev.data[p + 1] + prev.data[p + prev.width] + prev.data[p + prev.width + 1];
+
+                    level.data[static_cast<std::size_t>(y) * level.width + x] = static_cast<std::uint8_t>(sum / 4);
+                }
+
+            pyramid.push_back(std::move(level));
+        }
+
+        for (GrayLevel& level: pyramid)
+        {
+            std::array<std::size_t, 256> histogram = {};
+            for (const std::uint8_t v: level.data)
+                histogram[v]++;
+
+            std::size_t accumulated = 0;
+            level.median = 0;
+
+            while (level.median < 255 && accumulated + histogram[level.median] < level.data.size() / 2)
+                accumulated += histogram[level.median++];
+        }
+
+        return pyramid;
+    }
+
+
+    // median threshold bitmap alignment (G. Ward). Returns shift which needs to be applied to 'image' to match 'reference'
+    QPoint alignmentShift(const GrayPyramid& reference, const GrayPyramid& image)
+    {
+        const std::size_t levels = std::min(reference.size(), image.size());
+        QPoint shift(0, 0);
+
+        for (int l = static_cast<int>(levels) - 1; l >= 0; l--)
+        {
+            const GrayLevel& ref = reference[l];
+            const GrayLevel& img = image[l];
+            const int width = std::min(ref.width, img.width);
+            const int height = std::min(ref.height, img.height);
+
+            shift *= 2;
+
+            QPoint best = shift;
+            std::size_t bestError = std::numeric_limits<std::size_t>::max();
+
+            for (int dy = -1; dy <= 1; dy++)
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    const QPoint candidate = shift + QPoint(dx, dy);
+                    std::size_t error = 0;
+
+                    for (int y = std::max(0, candidate.y()); y < std::min(height, height + candidate.y()); y++)
+                    {
+                        const std::uint8_t* r = ref.data.data() + static_cast<std::size_t>(y) * ref.width;
+                        const std::uint8_t* i = img.data.data() + static_cast<std::size_t>(y - candidate.y()) * img.width - candidate.x();
+
+                        for (int x = std::max(0, candidate.x()); x < std::min(width, width + candidate.x()); x++)
+                        {
+                            const bool refBit = r[x] > ref.median;
+                            const bool imgBit = i[x] > img.median;
+                            const bool significant = std::abs(r[x] - ref.median) > AlignmentNoise &&
+                                                     std::abs(i[x] - img.median) > AlignmentNoise;
+
+                            error += (refBit != imgBit) && significant;
+                        }
+                    }
+
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        best = candidate;
+                    }
+                }
+
+            shift = best;
+        }
+
+        return shift;
+    }
+}
+
+
+ExposureFusion::ExposureFusion(ITaskExecutor& executor):
+    m_executor(executor)
+{
+
+}
+
+
+QImage ExposureFusion::fuse(std::size_t count,
+                            const ImageSource& source,
+                            const ProgressCallback& progressCallback,
+                            const CancelPredicate& cancelPredicate)
+{
+    if (count == 0)
+        return {};
+
+    const std::size_t totalSteps = count * 2 + 1;       // weights and blending for each photo + final image
+    std::size_t stepsDone = 0;
+
+    auto stepDone = [&]()
+    {
+        stepsDone++;
+
+        if (progressCallback)
+            progressCallback(static_cast<int>(stepsDone * 100 / totalSteps));
+    };
+
+    auto isCancelled = [&]()
+    {
+        return cancelPredicate && cancelPredicate();
+    };
+
+    QSize size;
+
+    auto load = [&](std::size_t i)
+    {
+        QImage image = source(i).convertToFormat(QImage::Format_RGB32);
+
+        if (image.isNull() == false && size.isValid() && image.size() != size)
+            image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        return image;
+    };
+
+    // 1st pass: find alignment of each photo and sum of weights
+    std::vector<QPoint> shifts(count);
+    GrayPyramid reference;
+    Plane weightsSum;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (isCancelled())
+            return {};
+
+        const QImage image = load(i);
+
+        if (image.isNull())
+            return {};
+
+        if (i == 0)
+        {
+            size = image.size();
+            reference = grayPyramid(image);
+            weightsSum = Plane(size.width(), size.height());
+        }
+        else
+            shifts[i] = alignmentShift(reference, grayPyramid(image));
+
+        const Plane w = weights(m_executor, image, shifts[i]);
+
+        forEachBand(m_executor, size.height(), [&](int begin, int end)
+        {
+            for (int y = begin; y < end; y++)
+            {
+                const float* in = w.row(y);
+                float* out = weightsSum.row(y);
+
+                for (int x = 0; x < size.width(); x++)
+                    out[x] += in[x];
+            }
+        });
+
+        stepDone();
+    }
+
+    reference.clear();
+
+    // 2nd pass: blend laplacian pyramids of photos using gaussian pyramids of normalized weights
+    const int levels = levelsFor(size.width(), size.height());
+    std::array<Pyramid, 3> result;
+
+    for (Pyramid& pyramid: result)
+    {
+        int width = size.width();
+        int height = size.height();
+
+        for (int l = 0; l < levels; l++)
+        {
+            pyramid.emplace_back(width, height);
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+        }
+    }
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        if (isCancelled())
+            return {};
+
+        const QImage image = load(i);
+
+        if (image.isNull())
+            return {};
+
+        Plane w = weights(m_executor, image, shifts[i]);
+
+        forEachBand(m_executor, size.height(), [&](int begin, int end)
+        {
+            for (int y = begin; y < end; y++)
+            {
+                const float* sum = weightsSum.row(y);
+                float* out = w.row(y);
+
+                for (int x = 0; x < size.width(); x++)
+                    out[x] /= sum[x];
+            }
+        });
+
+        const Pyramid weightsPyramid = gaussianPyramid(m_executor, std::move(w), levels);
+
+        for (int c = 0; c < 3; c++)
+            accumulateLaplacian(m_executor, channel(m_executor, image, shifts[i], 16 - c * 8), weightsPyramid, result[c]);
+
+        stepDone();
+    }
+
+    weightsSum = Plane();
+
+    if (isCancelled())
+        return {};
+
+    // collapse pyramids into final image
+    std::array<Plane, 3> channels;
+    for (int c = 0; c < 3; c++)
+    {
+        channels[c] = collapse(m_executor, result[c]);
+        result[c].clear();
+    }
+
+    QImage fused(size, QImage::Format_RGB32);
+
+    forEachBand(m_executor, size.height(), [&](int begin, int end)
+    {
+        for (int y = begin; y < end; y++)
+        {
+            const float* r = channels[0].row(y);
+            const float* g = channels[1].row(y);
+            const float* b = channels[2].row(y);
+            QRgb* out = reinterpret_cast<QRgb *>(fused.scanLine(y));
+
+            for (int x = 0; x < size.width(); x++)
+                out[x] = qRgb(static_cast<int>(std::clamp(r[x], 0.f, 1.f) * 255.f + .5f),
+                              static_cast<int>(std::clamp(g[x], 0.f, 1.f) * 255.f + .5f),
+                              static_cast<int>(std::clamp(b[x], 0.f, 1.f) * 255.f + .5f));
+        }
+    });
+
+    stepDone();
+
+    return fused;
+}
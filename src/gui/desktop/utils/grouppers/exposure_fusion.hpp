@@ -0,0 +1,58 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPOSURE_FUSION_HPP
+#define EXPOSURE_FUSION_HPP
+
+#include <functional>
+
+#include <QImage>
+
+struct ITaskExecutor;
+
+
+// In-process exposure fusion (T. Mertens, J. Kautz, F. Van Reeth: "Exposure Fusion").
+// Photos are aligned with median threshold bitmaps (translation only),
+// weighted by contrast, saturation and well-exposedness and blended with laplacian pyramids.
+// Work is split into bands of rows processed in parallel on given executor.
+//
+// Photos are loaded on demand (twice: once for weights, once for blending),
+// so only one photo and one set of pyramids is kept in memory at a time.
+class ExposureFusion
+{
+    public:
+        typedef std::function<QImage(std::size_t)> ImageSource;     // returns n-th photo
+        typedef std::function<void(int)> ProgressCallback;          // progress in percents
+        typedef std::function<bool()> CancelPredicate;              // returns true when work should be stopped
+
+        explicit ExposureFusion(ITaskExecutor &);
+        ExposureFusion(const ExposureFusion &) = delete;
+
+        ExposureFusion& operator=(const ExposureFusion &) = delete;
+
+        // Returns null image on error or when cancelled.
+        QImage fuse(std::size_t count,
+                    const ImageSource &,
+                    const ProgressCallback & = {},
+                    const CancelPredicate & = {});
+
+    private:
+        ITaskExecutor& m_executor;
+};
+
+#endif // EXPOSURE_FUSION_HPP
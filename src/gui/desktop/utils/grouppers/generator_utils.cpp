@@ -18,11 +18,17 @@
 
 #include "generator_utils.hpp"
 
+#include <algorithm>
+#include <any>
+#include <vector>
+
 #include <QEventLoop>
+#include <QImageReader>
 #include <QRegularExpression>
 
 #include <core/iexif_reader.hpp>
 #include <core/image_tools.hpp>
+#include <core/task_executor_utils.hpp>
 #include <system/system.hpp>
 
 
@@ -35,6 +41,21 @@ namespace
     const QRegularExpression cp_regExp("^(?:Creating control points between|Optimizing Variables).*");
     const QRegularExpression run_regExp("^Run called.*");
     const QRegularExpression save_regExp("^saving.*");
+
+    // memory which may be used by photos being prepared at the same time
+    constexpr qint64 normalizationMemoryBudget = 1024ll * 1024 * 1024;
+
+    std::size_t normalizationJobs(const QString& photo, int maxJobs)
+    {
+        const QImageReader reader(photo);
+        const QSize size = reader.size();
+
+        // decoded image and its transformed copy, 4 bytes per pixel each
+        const qint64 photoMemory = size.isValid()? size.width() * static_cast<qint64>(size.height()) * 4 * 2: 0;
+        const qint64 jobs = photoMemory > 0? normalizationMemoryBudget / photoMemory: maxJobs;
+
+        return static_cast<std::size_t>(std::clamp<qint64>(jobs, 1, std::max(maxJobs, 1)));
+    }
 }
 
 namespace GeneratorUtils
@@ -214,6 +235,12 @@ namespace GeneratorUtils
     }
 
 
+    bool ProcessRunner::isCancelled() const
+    {
+        return m_work == false;
+    }
+
+
     void ProcessRunner::exitCode(int e)
     {
         m_exitCode = e;
@@ -223,12 +250,13 @@ namespace GeneratorUtils
     ///////////////////////////////////////////////////////////////////////////
 
 
-    BreakableTask::BreakableTask(const QString& storage, IExifReaderFactory& exif):
+    BreakableTask::BreakableTask(const QString& storage, IExifReaderFactory& exif, ITaskExecutor& executor):
         QObject(),
         m_tmpDir(System::createTmpDir("BT_tmp", System::Confidential)),
         m_storage(storage),
         m_runner(),
-        m_exif(exif)
+        m_exif(exif),
+        m_executor(executor)
     {
         connect(this, &BreakableTask::canceled,
                 &m_runner, &GeneratorUtils::ProcessRunner::cancel);
@@ -260,34 +288,55 @@ namespace GeneratorUtils
 
 
     QStringList BreakableTask::rotatePhotos(const QStringList& photos,
-                                            const QString& storage)
+                                            const QString& storage,
+                                            double scale)
     {
         emit operation(tr("Preparing photos"));
         emit progress(0);
 
-        IExifReader* exif = m_exif.get();
+        const int p_s = photos.size();
+        const bool scaling = scale < 100.0;
 
-        int photo_index = 0;
-        QStringList rotated_photos;
+        std::vector<QString> rotated_photos(photos.begin(), photos.end());
+        std::atomic<int> prepared_photos(0);
 
-        const int p_s = photos.size();
+        // Process photos in parallel but do not keep too many decoded photos in memory at once.
+        const std::size_t jobs = p_s > 0? normalizationJobs(photos.front(), m_executor.heavyWorkers()): 1;
 
-        for (int i = 0; i < p_s; i++)
+        parallelFor(&m_executor, p_s, jobs, [&](std::size_t i)
         {
-            const QString& photo = photos[i];
-            const QString location = QString("%1/%2.tiff")
-                                    .arg(storage)
-                                    .arg(photo_index);
+            if (m_runner.isCancelled())
+                return;
 
-            Image::normalize(photo, location, exif);
+            const QString& photo = photos[static_cast<int>(i)];
+            IExifReader* exif = m_exif.get();
 
-            rotated_photos << location;
-            photo_index++;
+            const std::optional<std::any> orientation_raw = exif->get(photo, IExifReader::TagType::Orientation);
+            const int orientation = orientation_raw.has_value()? std::any_cast<int>(*orientation_raw): 0;
 
-            emit progress( (i + 1) * 100 /p_s );
-        }
+            // orientation 0 (no data) or 1 (normal) with no scaling - original file can be used directly
+            if (orientation > 1 || scaling)
+            {
+                const QString location = QString("%1/%2.tiff")
+                                        .arg(storage)
+                                        .arg(i);
+
+                QImage image = Image::normalized(photo, exif).get();
+
+                if (scaling && image.isNull() == false)
+                    image = image.scaled(image.size() * (scale / 100.0), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+                image.save(location);
+                rotated_photos[i] = location;
+            }
+
+            emit progress( ++prepared_photos * 100 / p_s );
+        });
+
+        if (m_runner.isCancelled())
+            throw false;
 
-        return rotated_photos;
+        return QStringList(rotated_photos.begin(), rotated_photos.end());
     }
 
 }
@@ -19,6 +19,7 @@
 #ifndef GENERATORUTILS_HPP
 #define GENERATORUTILS_HPP
 
+#include <atomic>
 #include <functional>
 
 #include <QProcess>
@@ -168,10 +169,11 @@ namespace GeneratorUtils
             void cancel();
 
             int getExitCode() const;
+            bool isCancelled() const;
 
         private:
             int m_exitCode;
-            bool m_work;
+            std::atomic<bool> m_work;
 
             void exitCode(int);
 
@@ -185,7 +187,7 @@ namespace GeneratorUtils
             Q_OBJECT
 
         public:
-            BreakableTask(const QString& storage, IExifReaderFactory &);
+            BreakableTask(const QString& storage, IExifReaderFactory &, ITaskExecutor &);
             virtual ~BreakableTask();
 
             void perform() override final;
@@ -196,10 +198,14 @@ namespace GeneratorUtils
             const QString m_storage;
             ProcessRunner m_runner;
             IExifReaderFactory& m_exif;
+            ITaskExecutor& m_executor;
 
             virtual void run() = 0;
 
-            QStringList rotatePhotos(const QStringList& photos, const QString& storage);
+            // Prepare photos for external tools: apply exif rotation and scale (in percents).
+            // Photos which need no changes are returned as they are.
+            // Throws `bool` if action was cancelled.
+            QStringList rotatePhotos(const QStringList& photos, const QString& storage, double scale = 100.0);
 
         signals:
             void operation(const QString &) const;
@@ -0,0 +1,630 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gif_encoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+
+#include <QIODevice>
+#include <QRect>
+
+#include <core/task_executor_utils.hpp>
+
+
+namespace
+{
+    constexpr int PaletteSize = 256;
+    constexpr int QuantizedColors = 255;            // last palette entry is reserved for transparency
+    constexpr int TransparentIndex = 255;
+    constexpr int MinCodeSize = 8;
+    constexpr int HistogramBins = 1 << 15;          // 5 bits per channel
+
+    typedef std::array<QRgb, PaletteSize> Palette;
+
+    struct QuantizedFrame
+    {
+        Palette palette;
+        std::vector<std::uint8_t> indices;
+    };
+
+    struct EncodedFrame
+    {
+        QRect rect;
+        Palette palette;
+        std::vector<std::uint8_t> data;             // lzw compressed indices
+        bool transparency;
+    };
+
+    struct Bin
+    {
+        int bin;
+        std::uint32_t count;
+        std::uint64_t r, g, b;                      // sums of exact colors
+    };
+
+    struct Box
+    {
+        std::size_t begin;
+        std::size_t end;
+        std::uint64_t population;
+        int channel;                                // channel with widest range
+        int range;
+    };
+
+
+    int binOf(QRgb rgb)
+    {
+        return ((qRed(rgb) >> 3) << 10) | ((qGreen(rgb) >> 3) << 5) | (qBlue(rgb) >> 3);
+    }
+
+
+    int channelOf(int bin, int channel)
+    {
+        return (bin >> (10 - channel * 5)) & 31;
+    }
+
+
+    Box makeBox(const std::vector<Bin>& bins, std::size_t begin, std::size_t end)
+    {
+        std::array<int, 3> min = {31, 31, 31};
+        std::array<int, 3> max = {0, 0, 0};
+        std::uint64_t population = 0;
+
+        for (std::size_t i = begin; i < end; i++)
+        {
+            population += bins[i].count;
+
+            for (int c = 0; c < 3; c++)
+            {
+                const int v = channelOf(bins[i].bin, c);
+                min[c] = std::min(min[c], v);
+                max[c] = std::max(max[c], v);
+            }
+        }
+
+        int channel = 0;
+        for (int c = 1; c < 3; c++)
+            if (max[c] - min[c] > max[channel] - min[channel])
+                channel = c;
+
+        return Box{begin, end, population, channel, max[channel] - min[channel]};
+    }
+
+
+    // median cut over histogram bins
+    void medianCut(std::vector<Bin>& bins, Palette& palette, std::vector<std::uint8_t>& binToIndex)
+    {
+        std::vector<Box> boxes;
+        boxes.push_back(makeBox(bins, 0, bins.size()));
+
+        while (boxes.size() < QuantizedColors)
+        {
+            // split box with the biggest population * range
+            auto best = boxes.end();
+            std::uint64_t bestScore = 0;
+
+            for (auto it = boxes.begin(); it != boxes.end(); ++it)
+            {
+                const std::uint64_t score = it->population * static_cast<std::uint64_t>(it->range);
+
+                if (it->end - it->begin > 1 && score > bestScore)
+                {
+                    best = it;
+                    bestScore = score;
+                }
+            }
+
+            if (best == boxes.end())
+                break;
+
+            const Box box = *best;
+            const int channel = box.channel;
+
+            std::sort(bins.begin() + box.begin, bins.begin() + box.end, [channel](const Bin& lhs, const Bin& rhs)
+            {
+                return channelOf(lhs.bin, channel) < channelOf(rhs.bin, channel);
+            });
+
+            std::uint64_t accumulated = 0;
+            std::size_t median = box.begin;
+
+            while (median < box.end && accumulated < box.population / 2)
+                accumulated += bins[median++].count;
+
+            median = std::clamp(median, box.begin + 1, box.end - 1);
+
+            *best = makeBox(bins, box.begin, median);
+            boxes.push_back(makeBox(bins, median, box.end));
+        }
+
+        palette.fill(qRgb(0, 0, 0));
+
+        for (std::size_t i = 0; i < boxes.size(); i++)
+        {
+            const Box& box = boxes[i];
+            std::uint64_t r = 0, g = 0, b = 0;
+
+            for (std::size_t j = box.begin; j < box.end; j++)
+            {
+                r += bins[j].r;
+                g += bins[j].g;
+                b += bins[j].b;
+
+                binToIndex[bins[j].bin] = static_cast<std::uint8_t>(i);
+            }
+
+            const std::uint64_t population = std::max<std::uint64_t>(box.population, 1);
+            palette[i] = qRgb(static_cast<int>(r / population),
+                              static_cast<int>(g / population),
+                              static_cast<int>(b / population));
+        }
+    }
+
+
+    QuantizedFrame quantize(const QImage& image)
+    {
+        assert(image.format() == QImage::Format_RGB32);
+
+        const int width = image.width();
+        const int height = image.height();
+
+        std::vector<Bin> histogram(HistogramBins, Bin{0, 0, 0, 0, 0});
+
+        for (int y = 0; y < height; y++)
+        {
+            const QRgb* line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+
+            for (int x = 0; x < width; x++)
+            {
+                const QRgb rgb = line[x];
+                Bin& bin = histogram[binOf(rgb)];
+
+                bin.count++;
+                bin.r += qRed(rgb);
+                bin.g += qGreen(rgb);
+                bin.b += qBlue(rgb);
+            }
+        }
+
+        std::vector<Bin> usedBins;
+        for (int i = 0; i < HistogramBins; i++)
+            if (histogram[i].count > 0)
+            {
+                usedBins.push_back(histogram[i]);
+                usedBins.back().bin = i;
+            }
+
+        QuantizedFrame frame;
+        std::vector<std::uint8_t> binToIndex(HistogramBins, 0);
+
+        medianCut(usedBins, frame.palette, binToIndex);
+
+        frame.indices.resize(static_cast<std::size_t>(width) * height);
+
+        for (int y = 0; y < height; y++)
+        {
+            const QRgb* line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+            std::uint8_t* indices = frame.indices.data() + static_cast<std::size_t>(y) * width;
+
+            for (int x = 0; x < width; x++)
+                indices[x] = binToIndex[binOf(line[x])];
+        }
+
+        return frame;
+    }
+
+
+    class BitWriter
+    {
+        public:
+            void write(int code, int size)
+            {
+                m_accumulator |= static_cast<std::uint32_t>(code) << m_bits;
+                m_bits += size;
+
+                while (m_bits >= 8)
+                {
+                    m_bytes.push_back(static_cast<std::uint8_t>(m_accumulator & 0xff));
+                    m_accumulator >>= 8;
+                    m_bits -= 8;
+                }
+            }
+
+            std::vector<std::uint8_t> finish()
+            {
+                if (m_bits > 0)
+                    m_bytes.push_back(static_cast<std::uint8_t>(m_accumulator & 0xff));
+
+                m_accumulator = 0;
+                m_bits = 0;
+
+                return std::move(m_bytes);
+            }
+
+        private:
+            std::vector<std::uint8_t> m_bytes;
+            std::uint32_t m_accumulator = 0;
+            int m_bits = 0;
+    };
+
+
+    // Variable code length LZW as described in GIF89a specification.
+    // Dictionary is kept in an open addressing hash table (as in classic 'compress') so it is cheap to reset.
+    std::vector<std::uint8_t> compress(const std::vector<std::uint8_t>& indices)
+    {
+        assert(indices.empty() == false);
+
+        constexpr int HashSize = 5003;
+        constexpr int MaxCode = 4095;
+        const int clearCode = 1 << MinCodeSize;
+        const int endCode = clearCode + 1;
+
+        std::vector<std::int32_t> keys(HashSize, -1);
+        std::vector<std::uint16_t> codes(HashSize, 0);
+
+        BitWriter writer;
+        int codeSize = MinCodeSize + 1;
+        int lastCode = endCode;
+
+        writer.write(clearCode, codeSize);
+
+        int prefix = indices.front();
+
+        for (std::size_t i = 1; i < indices.size(); i++)
+        {
+            const int c = indices[i];
+            const std::int32_t key = (prefix << 8) | c;
+
+            int h = (c << 4) ^ prefix;
+            const int step = h == 0? 1: HashSize - h;
+            bool found = false;
+
+            while (keys[h] != -1)
+            {
+                if (keys[h] == key)
+                {
+                    found = true;
+                    break;
+                }
+
+                h -= step;
+                if (h < 0)
+                    h += HashSize;
+            }
+
+            if (found)
+            {
+                prefix = codes[h];
+                continue;
+            }
+
+            writer.write(prefix, codeSize);
+
+            lastCode++;
+            keys[h] = key;
+            codes[h] = static_cast<std::uint16_t>(lastCode);
+
+            if (lastCode >= (1 << codeSize))
+                codeSize++;
+
+            if (lastCode == MaxCode)
+            {
+                writer.write(clearCode, codeSize);
+
+                std::fill(keys.begin(), keys.end(), -1);
+                codeSize = MinCodeSize + 1;
+                lastCode = endCode;
+            }
+
+            prefix = c;
+        }
+
+        writer.write(prefix, codeSize);
+
+        // decoder is one entry behind encoder - it will add an entry after reading last code
+        if (lastCode > endCode && lastCode + 2 == (1 << codeSize) && codeSize < 12)
+            codeSize++;
+
+        writer.write(endCode, codeSize);
+
+        return writer.finish();
+    }
+
+
+    EncodedFrame encodeFrame(const QuantizedFrame& current, const QuantizedFrame* previous, const QSize& size)
+    {
+        const int width = size.width();
+        const int height = size.height();
+
+        EncodedFrame encoded;
+        encoded.palette = current.palette;
+
+        if (previous == nullptr)
+        {
+            encoded.rect = QRect(QPoint(0, 0), size);
+            encoded.data = compress(current.indices);
+            encoded.transparency = false;
+        }
+        else
+        {
+            // find rectangle containing all changed pixels
+            int left = width, right = -1, top = height, bottom = -1;
+
+            for (int y = 0; y < height; y++)
+            {
+                const std::size_t lineOffset = static_cast<std::size_t>(y) * width;
+
+                for (int x = 0; x < width; x++)
+                {
+                    const std::size_t p = lineOffset + x;
+
+                    if (current.palette[current.indices[p]] != previous->palette[previous->indices[p]])
+                    {
+                        left = std::min(left, x);
+                        right = std::max(right, x);
+                        top = std::min(top, y);
+                        bottom = std::max(bottom, y);
+                    }
+                }
+            }
+
+            std::vector<std::uint8_t> indices;
+
+            if (right == -1)                // nothing has changed - store one transparent pixel
+            {
+                encoded.rect = QRect(0, 0, 1, 1);
+                indices.push_back(TransparentIndex);
+            }
+            else
+            {
+                encoded.rect = QRect(QPoint(left, top), QPoint(right, bottom));
+                indices.reserve(static_cast<std::size_t>(encoded.rect.width()) * encoded.rect.height());
+
+                for (int y = top; y <= bottom; y++)
+                {
+                    const std::size_t lineOffset = static_cast<std::size_t>(y) * width;
+
+                    for (int x = left; x <= right; x++)
+                    {
+                        const std::size_t p = lineOffset + x;
+                        const bool same = current.palette[current.indices[p]] == previous->palette[previous->indices[p]];
+
+                        indices.push_back(same? TransparentIndex: current.indices[p]);
+                    }
+                }
+            }
+
+            encoded.data = compress(indices);
+            encoded.transparency = true;
+        }
+
+        return encoded;
+    }
+
+
+    void appendWord(QByteArray& output, int value)
+    {
+        output.append(static_cast<char>(value & 0xff));
+        output.append(static_cast<char>((value >> 8) & 0xff));
+    }
+
+
+    void appendHeader(QByteArray& output, const QSize& size)
+    {
+        output.append("GIF89a");
+        appendWord(output, size.width());
+        appendWord(output, size.height());
+        output.append(static_cast<char>(0x70));             // no global color table, 8 bit color resolution
+        output.append(static_cast<char>(0));                // background color index
+        output.append(static_cast<char>(0));                // pixel aspect ratio
+
+        // loop forever
+        output.append("\x21\xff\x0b" "NETSCAPE2.0" "\x03\x01", 16);
+        appendWord(output, 0);
+        output.append(static_cast<char>(0));
+    }
+
+
+    // image descriptor, local color table and compressed data - everything but frame's timing
+    QByteArray imageBlock(const EncodedFrame& frame)
+    {
+        QByteArray output;
+
+        // image descriptor with local color table of 256 entries
+        output.append(static_cast<char>(0x2c));
+        appendWord(output, frame.rect.left());
+        appendWord(output, frame.rect.top());
+        appendWord(output, frame.rect.width());
+        appendWord(output, frame.rect.height());
+        output.append(static_cast<char>(0x80 | 7));
+
+        for (const QRgb rgb: frame.palette)
+        {
+            output.append(static_cast<char>(qRed(rgb)));
+            output.append(static_cast<char>(qGreen(rgb)));
+            output.append(static_cast<char>(qBlue(rgb)));
+        }
+
+        // image data split into sub-blocks
+        output.append(static_cast<char>(MinCodeSize));
+
+        for (std::size_t offset = 0; offset < frame.data.size(); offset += 255)
+        {
+            const std::size_t blockSize = std::min<std::size_t>(255, frame.data.size() - offset);
+
+            output.append(static_cast<char>(blockSize));
+            output.append(reinterpret_cast<const char *>(frame.data.data() + offset), static_cast<int>(blockSize));
+        }
+
+        output.append(static_cast<char>(0));
+
+        return output;
+    }
+
+
+    void appendFrame(QByteArray& output, const QByteArray& image, bool transparency, int delay)
+    {
+        // graphic control extension: 'do not dispose' so unchanged (transparent) pixels show previous frame
+        output.append("\x21\xf9\x04", 3);
+        output.append(static_cast<char>((1 << 2) | (transparency? 1: 0)));
+        appendWord(output, delay);
+        output.append(static_cast<char>(TransparentIndex));
+        output.append(static_cast<char>(0));
+
+        output.append(image);
+    }
+}
+
+
+std::size_t GifEncoder::EncodedAnimation::bytes() const
+{
+    std::size_t result = 0;
+
+    for (const QByteArray& frame: frames)
+        result += static_cast<std::size_t>(frame.size());
+
+    return result;
+}
+
+
+GifEncoder::GifEncoder(ITaskExecutor& executor):
+    m_executor(executor)
+{
+
+}
+
+
+bool GifEncoder::encode(const std::vector<Frame>& frames,
+                        QIODevice& device,
+                        const ProgressCallback& progressCallback,
+                        const CancelPredicate& cancelPredicate)
+{
+    std::vector<QImage> images;
+    std::vector<int> delays;
+
+    images.reserve(frames.size());
+    delays.reserve(frames.size());
+
+    for (const Frame& frame: frames)
+    {
+        images.push_back(frame.image);
+        delays.push_back(frame.delay);
+    }
+
+    EncodedAnimation animation;
+
+    return encode(images, animation, progressCallback, cancelPredicate) &&
+           write(animation, delays, device);
+}
+
+
+bool GifEncoder::encode(const std::vector<QImage>& images,
+                        EncodedAnimation& animation,
+                        const ProgressCallback& progressCallback,
+                        const CancelPredicate& cancelPredicate)
+{
+    if (images.empty() || images.front().isNull())
+        return false;
+
+    const QSize size = images.front().size();
+    const std::size_t count = images.size();
+    const std::size_t totalSteps = count * 2;                   // quantization + compression of each frame
+    const std::size_t jobs = static_cast<std::size_t>(std::max(m_executor.heavyWorkers(), 1));
+
+    std::atomic<std::size_t> stepsDone(0);
+    std::atomic<bool> cancelled(false);
+
+    auto stepDone = [&]()
+    {
+        const std::size_t done = ++stepsDone;
+
+        if (progressCallback)
+            progressCallback(static_cast<int>(done * 100 / totalSteps));
+    };
+
+    auto isCancelled = [&]()
+    {
+        if (cancelled == false && cancelPredicate && cancelPredicate())
+            cancelled = true;
+
+        return cancelled.load();
+    };
+
+    std::vector<QuantizedFrame> quantized(count);
+
+    parallelFor(&m_executor, count, jobs, [&](std::size_t i)
+    {
+        if (isCancelled())
+            return;
+
+        QImage image = images[i].convertToFormat(QImage::Format_RGB32);
+
+        if (image.size() != size)
+            image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        quantized[i] = quantize(image);
+
+        stepDone();
+    });
+
+    if (isCancelled())
+        return false;
+
+    animation.size = size;
+    animation.frames.assign(count, QByteArray());
+    animation.transparency.assign(count, 0);
+
+    parallelFor(&m_executor, count, jobs, [&](std::size_t i)
+    {
+        if (isCancelled())
+            return;
+
+        const EncodedFrame encoded = encodeFrame(quantized[i], i == 0? nullptr: &quantized[i - 1], size);
+
+        animation.frames[i] = imageBlock(encoded);
+        animation.transparency[i] = encoded.transparency? 1: 0;
+
+        stepDone();
+    });
+
+    return isCancelled() == false;
+}
+
+
+bool GifEncoder::write(const EncodedAnimation& animation, const std::vector<int>& delays, QIODevice& device)
+{
+    const std::size_t count = animation.frames.size();
+
+    if (count == 0 || delays.size() != count)
+        return false;
+
+    QByteArray output;
+    output.reserve(static_cast<int>(animation.bytes() + count * 8 + 64));
+    appendHeader(output, animation.size);
+
+    for (std::size_t i = 0; i < count; i++)
+        appendFrame(output, animation.frames[i], animation.transparency[i] != 0, delays[i]);
+
+    output.append(static_cast<char>(0x3b));                 // trailer
+
+    return device.write(output) == output.size();
+}
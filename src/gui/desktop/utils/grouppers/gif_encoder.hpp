@@ -0,0 +1,86 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GIF_ENCODER_HPP
+#define GIF_ENCODER_HPP
+
+#include <functional>
+#include <vector>
+
+#include <QByteArray>
+#include <QImage>
+
+class QIODevice;
+struct ITaskExecutor;
+
+
+// In-process animated gif encoder.
+// Each frame gets its own palette (median cut quantization).
+// Pixels which do not change between frames are stored as transparent,
+// and only a rectangle containing changes is stored.
+// Frames are quantized and compressed in parallel on given executor.
+// Compression does not depend on frames' timing, so compressed frames
+// can be kept and written many times with different delays.
+class GifEncoder
+{
+    public:
+        struct Frame
+        {
+            QImage image;
+            int delay;                  // in 1/100th of a second
+        };
+
+        struct EncodedAnimation
+        {
+            QSize size;
+            std::vector<QByteArray> frames;     // image descriptors with compressed data
+            std::vector<char> transparency;     // not vector<bool>: frames are compressed in parallel
+
+            std::size_t bytes() const;
+        };
+
+        typedef std::function<void(int)> ProgressCallback;     // progress in percents
+        typedef std::function<bool()> CancelPredicate;         // returns true when encoding should be stopped
+
+        explicit GifEncoder(ITaskExecutor &);
+        GifEncoder(const GifEncoder &) = delete;
+
+        GifEncoder& operator=(const GifEncoder &) = delete;
+
+        // All frames are expected to have the same size as the first one (they will be scaled otherwise).
+        // Returns false on write error or when encoding was cancelled.
+        bool encode(const std::vector<Frame> &,
+                    QIODevice &,
+                    const ProgressCallback & = {},
+                    const CancelPredicate & = {});
+
+        // Quantize and compress frames without writing them.
+        // Returns false when there is nothing to encode or when encoding was cancelled.
+        bool encode(const std::vector<QImage> &,
+                    EncodedAnimation &,
+                    const ProgressCallback & = {},
+                    const CancelPredicate & = {});
+
+        // Write encoded animation. One delay (in 1/100th of a second) per frame is expected.
+        static bool write(const EncodedAnimation &, const std::vector<int> &, QIODevice &);
+
+    private:
+        ITaskExecutor& m_executor;
+};
+
+#endif // GIF_ENCODER_HPP
@@ -18,11 +18,17 @@
 
 #include "hdr_generator.hpp"
 
-#include "system/system.hpp"
+#include <algorithm>
 
+#include <core/image_tools.hpp>
+#include <core/ilogger.hpp>
+#include <system/system.hpp>
 
-HDRGenerator::HDRGenerator(const Data& data, ILogger* logger, IExifReaderFactory& exif):
-    GeneratorUtils::BreakableTask(data.storage, exif),
+#include "exposure_fusion.hpp"
+
+
+HDRGenerator::HDRGenerator(const Data& data, ILogger* logger, IExifReaderFactory& exif, ITaskExecutor& executor):
+    GeneratorUtils::BreakableTask(data.storage, exif, executor),
     m_data(data),
     m_logger(logger)
 {
@@ -37,49 +43,78 @@ std::string HDRGenerator::name() const
 
 void HDRGenerator::run()
 {
-    using GeneratorUtils::AISOutputAnalyzer;
-    using GeneratorUtils::MagickOutputAnalyzer;
+    emit operation(tr("generating HDR"));
+    emit progress(0);
 
-    // rotate photos
-    const QStringList rotated = rotatePhotos(m_data.photos, m_tmpDir->path());
+    const QImage hdr = fuse();
 
-    // blend them!
-    const int photos_count = m_data.photos.size();
-    AISOutputAnalyzer analyzer(m_logger, photos_count);
-    connect(&analyzer, &AISOutputAnalyzer::operation, this, &HDRGenerator::operation);
-    connect(&analyzer, &AISOutputAnalyzer::progress,  this, &HDRGenerator::progress);
-    connect(&analyzer, &AISOutputAnalyzer::finished,  this, &HDRGenerator::finished);
+    if (m_runner.isCancelled())
+        throw false;
 
-    emit operation(tr("generating HDR"));
-    const QString location = System::getTmpFile(m_storage, "hdr");
-
-    GeneratorUtils::execute(m_logger,
-            m_data.alignImageStackPath,
-            analyzer,
-            m_runner,
-            "-C",
-            "-v",                              // for align_image_stack_output_analizer
-            "-d", "-i", "-x", "-y", "-z",
-            "-s", "0",
-            "-o", location,
-            rotated);
+    emit operation(tr("Saving result"));
 
     const QString output = System::getTmpFile(m_storage, "jpeg");
-    MagickOutputAnalyzer moa(m_logger, photos_count);
-    connect(&moa, &MagickOutputAnalyzer::operation, this, &HDRGenerator::operation);
-    connect(&moa, &MagickOutputAnalyzer::progress,  this, &HDRGenerator::progress);
-    connect(&moa, &MagickOutputAnalyzer::finished,  this, &HDRGenerator::finished);
 
-    emit operation(tr("Saving result"));
+    if (hdr.isNull() || hdr.save(output) == false)
+    {
+        const QString message = hdr.isNull()?
+                                tr("Could not load photos"):
+                                tr("Could not save result as %1").arg(output);
+
+        m_logger->error(message);
+        emit error(tr("Error occured during HDR generation"), QStringList(message));
+    }
+    else
+        emit finished(output);
+}
+
+
+QImage HDRGenerator::fuse()
+{
+    const QStringList& photos = m_data.photos;
+    const std::size_t photos_count = static_cast<std::size_t>(photos.size());
+    const PreviewCache::Frames cached = m_data.cache->normalizedPhotos(photos);
+
+    // fusion loads each photo twice, keep decoded photos (within RAM budget)
+    // so they are decoded once and can be reused by next generation
+    auto loaded = std::make_shared<std::vector<QImage>>(photos_count);
+    std::size_t loaded_bytes = 0;
+    bool keep_loaded = cached.get() == nullptr;
+
+    ExposureFusion fusion(m_executor);
+
+    const QImage hdr = fusion.fuse(photos_count,
+                                   [&](std::size_t i)
+                                   {
+                                       if (cached)
+                                           return (*cached)[i];
+
+                                       if (keep_loaded && (*loaded)[i].isNull() == false)
+                                           return (*loaded)[i];
+
+                                       const QImage image = Image::normalized(photos[static_cast<int>(i)], m_exif.get()).get();
+
+                                       if (keep_loaded)
+                                       {
+                                           loaded_bytes += static_cast<std::size_t>(image.bytesPerLine()) * static_cast<std::size_t>(image.height());
+                                           keep_loaded = loaded_bytes <= m_data.cache->ramBudget();
+
+                                           if (keep_loaded)
+                                               (*loaded)[i] = image;
+                                           else
+                                               loaded->clear();
+                                       }
+
+                                       return image;
+                                   },
+                                   [this](int p) { emit progress(p); },
+                                   [this]() { return m_runner.isCancelled(); });
+
+    const bool all_loaded = keep_loaded &&
+                            std::none_of(loaded->cbegin(), loaded->cend(), [](const QImage& image) { return image.isNull(); });
 
-    GeneratorUtils::execute(m_logger,
-            m_data.magickPath,
-            moa,
-            m_runner,
-            "convert",
-            "-monitor",                                      // for convert_output_analizer
-            location,
-            output);
+    if (hdr.isNull() == false && all_loaded)
+        m_data.cache->storeNormalizedPhotos(photos, loaded);
 
-    emit finished(output);
+    return hdr;
 }
@@ -20,6 +20,7 @@
 #define HDRGENERATOR_HPP
 
 #include "generator_utils.hpp"
+#include "preview_cache.hpp"
 
 class HDRGenerator: public GeneratorUtils::BreakableTask
 {
@@ -29,14 +30,13 @@ class HDRGenerator: public GeneratorUtils::BreakableTask
         struct Data
         {
             QString storage;
-            QString magickPath;
-            QString alignImageStackPath;
             QStringList photos;
+            std::shared_ptr<PreviewCache> cache;
 
-            Data(): storage(), magickPath(), alignImageStackPath(), photos() {}
+            Data(): storage(), photos(), cache() {}
         };
 
-        HDRGenerator(const Data& photos, ILogger *, IExifReaderFactory &);
+        HDRGenerator(const Data& photos, ILogger *, IExifReaderFactory &, ITaskExecutor &);
 
         std::string name() const override;
         void run() override;
@@ -44,6 +44,8 @@ class HDRGenerator: public GeneratorUtils::BreakableTask
     private:
         const Data m_data;
         ILogger* m_logger;
+
+        QImage fuse();
 };
 
 #endif // HDRGENERATOR_HPP
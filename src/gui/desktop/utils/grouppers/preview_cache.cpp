@@ -0,0 +1,209 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "preview_cache.hpp"
+
+#include <tuple>
+
+#include <QDirIterator>
+#include <QFileInfo>
+
+#include <system/system.hpp>
+
+
+namespace
+{
+    std::size_t imageBytes(const QImage& image)
+    {
+        return static_cast<std::size_t>(image.bytesPerLine()) * static_cast<std::size_t>(image.height());
+    }
+
+    // only files owned by cache's directory count, original photos may be referenced directly
+    std::size_t directorySize(const ITmpDir* dir)
+    {
+        std::size_t size = 0;
+
+        if (dir != nullptr)
+        {
+            QDirIterator it(dir->path(), QDir::Files, QDirIterator::Subdirectories);
+
+            while(it.hasNext())
+            {
+                it.next();
+                size += static_cast<std::size_t>(it.fileInfo().size());
+            }
+        }
+
+        return size;
+    }
+}
+
+
+bool PreviewCache::Key::operator<(const Key& other) const
+{
+    return std::tie(stage, photos, scale, stabilized) < std::tie(other.stage, other.photos, other.scale, other.stabilized);
+}
+
+
+PreviewCache::PreviewCache(std::size_t ramBudget, std::size_t diskBudget):
+    m_cacheMutex(),
+    m_entries(),
+    m_ramBudget(ramBudget),
+    m_diskBudget(diskBudget),
+    m_useCounter(0)
+{
+
+}
+
+
+std::size_t PreviewCache::ramBudget() const
+{
+    return m_ramBudget;
+}
+
+
+std::optional<PreviewCache::Files> PreviewCache::preparedPhotos(const QStringList& photos, double scale)
+{
+    return findFiles( {Stage::Prepared, photos, scale, false} );
+}
+
+
+void PreviewCache::storePreparedPhotos(const QStringList& photos, double scale, const Files& files)
+{
+    storeFiles( {Stage::Prepared, photos, scale, false}, files);
+}
+
+
+std::optional<PreviewCache::Files> PreviewCache::alignedPhotos(const QStringList& photos, double scale)
+{
+    return findFiles( {Stage::Aligned, photos, scale, true} );
+}
+
+
+void PreviewCache::storeAlignedPhotos(const QStringList& photos, double scale, const Files& files)
+{
+    storeFiles( {Stage::Aligned, photos, scale, true}, files);
+}
+
+
+PreviewCache::Frames PreviewCache::normalizedPhotos(const QStringList& photos)
+{
+    const std::any value = find( {Stage::Normalized, photos, 100.0, false} );
+
+    return value.has_value()? std::any_cast<Frames>(value): Frames();
+}
+
+
+void PreviewCache::storeNormalizedPhotos(const QStringList& photos, const Frames& frames)
+{
+    std::size_t cost = 0;
+
+    for (const QImage& frame: *frames)
+        cost += imageBytes(frame);
+
+    store( {Stage::Normalized, photos, 100.0, false}, frames, cost, false);
+}
+
+
+PreviewCache::Animation PreviewCache::encodedAnimation(const QStringList& photos, double scale, bool stabilized)
+{
+    const std::any value = find( {Stage::Encoded, photos, scale, stabilized} );
+
+    return value.has_value()? std::any_cast<Animation>(value): Animation();
+}
+
+
+void PreviewCache::storeEncodedAnimation(const QStringList& photos, double scale, bool stabilized, const Animation& animation)
+{
+    store( {Stage::Encoded, photos, scale, stabilized}, animation, animation->bytes(), false);
+}
+
+
+std::any PreviewCache::find(const Key& key)
+{
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+    auto it = m_entries.find(key);
+
+    if (it == m_entries.end())
+        return {};
+
+    it->second.lastUse = ++m_useCounter;
+
+    return it->second.value;
+}
+
+
+void PreviewCache::store(const Key& key, const std::any& value, std::size_t cost, bool onDisk)
+{
+    const std::size_t budget = onDisk? m_diskBudget: m_ramBudget;
+
+    if (cost > budget)
+        return;
+
+    // evicted values are released outside of lock (removal of directories may take a while)
+    std::vector<std::any> evicted;
+
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+
+        auto previous = m_entries.find(key);
+        if (previous != m_entries.end())
+        {
+            evicted.push_back(previous->second.value);
+            m_entries.erase(previous);
+        }
+
+        for(;;)
+        {
+            std::size_t used = 0;
+            auto oldest = m_entries.end();
+
+            for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+                if (it->second.onDisk == onDisk)
+                {
+                    used += it->second.cost;
+
+                    if (oldest == m_entries.end() || it->second.lastUse < oldest->second.lastUse)
+                        oldest = it;
+                }
+
+            if (used + cost <= budget)
+                break;
+
+            evicted.push_back(oldest->second.value);
+            m_entries.erase(oldest);
+        }
+
+        m_entries.emplace(key, Entry{value, cost, ++m_useCounter, onDisk});
+    }
+}
+
+
+std::optional<PreviewCache::Files> PreviewCache::findFiles(const Key& key)
+{
+    const std::any value = find(key);
+
+    return value.has_value()? std::any_cast<Files>(value): std::optional<Files>();
+}
+
+
+void PreviewCache::storeFiles(const Key& key, const Files& files)
+{
+    store(key, files, directorySize(files.dir.get()), true);
+}
@@ -0,0 +1,120 @@
+/*
+ * Photo Broom - photos management tool.
+ * Copyright (C) 2021  Michał Walenciak <Kicer86@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PREVIEW_CACHE_HPP
+#define PREVIEW_CACHE_HPP
+
+#include <any>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <QImage>
+#include <QStringList>
+
+#include "gif_encoder.hpp"
+
+struct ITmpDir;
+
+
+// Results of intermediate stages of group preview generation.
+// Each stage is identified by photos it was generated from and by parameters which affect it,
+// so when preview is generated again only stages with changed parameters need to be run.
+//
+// Files (prepared and aligned photos) are counted against disk budget,
+// decoded and encoded frames against RAM budget.
+// Least recently used entries are dropped when budget is exceeded.
+// Entries bigger than budget are not stored at all.
+class PreviewCache
+{
+    public:
+        struct Files
+        {
+            std::shared_ptr<ITmpDir> dir;           // files are removed with directory
+            QStringList paths;
+        };
+
+        typedef std::shared_ptr<const std::vector<QImage>> Frames;
+        typedef std::shared_ptr<const GifEncoder::EncodedAnimation> Animation;
+
+        PreviewCache(std::size_t ramBudget, std::size_t diskBudget);   // in bytes
+        PreviewCache(const PreviewCache &) = delete;
+
+        PreviewCache& operator=(const PreviewCache &) = delete;
+
+        std::size_t ramBudget() const;
+
+        // photos rotated according to exif and scaled
+        std::optional<Files> preparedPhotos(const QStringList& photos, double scale);
+        void storePreparedPhotos(const QStringList& photos, double scale, const Files &);
+
+        // prepared photos aligned to the first one
+        std::optional<Files> alignedPhotos(const QStringList& photos, double scale);
+        void storeAlignedPhotos(const QStringList& photos, double scale, const Files &);
+
+        // decoded photos rotated according to exif
+        Frames normalizedPhotos(const QStringList& photos);
+        void storeNormalizedPhotos(const QStringList& photos, const Frames &);
+
+        // compressed animation frames (without timing)
+        Animation encodedAnimation(const QStringList& photos, double scale, bool stabilized);
+        void storeEncodedAnimation(const QStringList& photos, double scale, bool stabilized, const Animation &);
+
+    private:
+        enum class Stage
+        {
+            Prepared,
+            Aligned,
+            Normalized,
+            Encoded,
+        };
+
+        struct Key
+        {
+            Stage stage;
+            QStringList photos;
+            double scale;
+            bool stabilized;
+
+            bool operator<(const Key &) const;
+        };
+
+        struct Entry
+        {
+            std::any value;
+            std::size_t cost;
+            std::uint64_t lastUse;
+            bool onDisk;
+        };
+
+        std::mutex m_cacheMutex;
+        std::map<Key, Entry> m_entries;
+        const std::size_t m_ramBudget;
+        const std::size_t m_diskBudget;
+        std::uint64_t m_useCounter;
+
+        std::any find(const Key &);
+        void store(const Key &, const std::any &, std::size_t cost, bool onDisk);
+        std::optional<Files> findFiles(const Key &);
+        void storeFiles(const Key &, const Files &);
+};
+
+#endif // PREVIEW_CACHE_HPP
@@ -48,26 +48,9 @@ void GroupsManager::group(Database::IDatabase* database,
             std::vector photos_to_store = {data};
             backend.addPhotos(photos_to_store);
 
-            // create group
+            // create group with members
             const Photo::Id representativeId = photos_to_store.front().getId();
-            const auto groupId = backend.groupOperator().addGroup(representativeId, type);
-
-            // update group information on each member
-            std::vector<Photo::DataDelta> deltas;
-            deltas.reserve(photos.size());
-
-            for(const auto memberId: photos)
-            {
-                GroupInfo grpInfo(groupId, GroupInfo::Member);
-
-                Photo::DataDelta memberData;
-                memberData.setId(memberId);
-                memberData.insert<Photo::Field::GroupInfo>(grpInfo);
-
-                deltas.push_back(memberData);
-            }
-
-            backend.update(deltas);
+            backend.groupOperator().addGroups( { {representativeId, type, photos} } );
         });
     }
 }
@@ -19,12 +19,13 @@
 
 #include <QFileInfo>
 
-#include <core/containers_utils.hpp>
 #include <core/icore_factory_accessor.hpp>
 #include <core/iexif_reader.hpp>
 #include <core/task_executor_utils.hpp>
+#include <database/general_flags.hpp>
 #include <database/ibackend.hpp>
 #include <face_recognition/face_recognition.hpp>
+#include <face_recognition/fingerprints_index.hpp>
 
 
 template<typename T>
@@ -39,24 +40,22 @@ struct ExecutorTraits<Database::IDatabase, T>
 
 namespace
 {
-    const QString faces_recognized_flag = QStringLiteral("faces_recognized");
-
-    Person::Fingerprint average_fingerprint(const std::vector<PersonFingerprint>& faces)
+    // marks tasks which only read from database
+    struct DatabaseReader
     {
-        if (faces.empty())
-            return {};
-
-        Person::Fingerprint avg_face;
-
-        for(const PersonFingerprint& fingerprint: faces)
-            avg_face += fingerprint.fingerprint();
+        Database::IDatabase* db;
+    };
+}
 
-        avg_face /= faces.size();
 
-        return avg_face;
+template<typename T>
+struct ExecutorTraits<DatabaseReader, T>
+{
+    static void exec(DatabaseReader* reader, T&& t)
+    {
+        reader->db->execRead(std::forward<T>(t));
     }
-}
-
+};
 
 
 PeopleManipulator::PeopleManipulator(const Photo::Id& pid, Database::IDatabase& db, ICoreFactoryAccessor& core)
@@ -147,12 +146,15 @@ void PeopleManipulator::findFaces_thrd()
     const QString full_path = pathInfo.absoluteFilePath();
     m_image = OrientedImage(m_core.getExifReaderFactory().get(), full_path);
 
+    // photo is decoded once and shared (QImage is implicitly shared) with whoever displays it
+    invokeMethod(this, &PeopleManipulator::findFaces_image, m_image.get());
+
     const std::vector<QRect> list_of_faces = fetchFacesFromDb();
 
     if (list_of_faces.empty())
     {
         FaceRecognition face_recognition(&m_core);
-        const auto faces = face_recognition.fetchFaces(full_path);
+        const auto faces = face_recognition.fetchFaces(m_image);
 
         for(const QRect& face: faces)
             result.append(face);
@@ -177,6 +179,12 @@ void PeopleManipulator::findFaces_thrd()
 }
 
 
+void PeopleManipulator::findFaces_image(const QImage& image)
+{
+    emit imageLoaded(image);
+}
+
+
 void PeopleManipulator::findFaces_result(const QVector<QRect>& faces)
 {
     m_faces.reserve(faces.size());
@@ -255,7 +263,7 @@ void PeopleManipulator::recognizeFaces_thrd_recognize_people()
 {
     FaceRecognition face_recognition(&m_core);
     const auto people_fingerprints = fetchPeopleAndFingerprints();
-    const std::vector<Person::Fingerprint>& known_fingerprints = std::get<0>(people_fingerprints);
+    const FingerprintsIndex known_fingerprints(std::get<0>(people_fingerprints));
 
     for (FaceInfo& faceInfo: m_faces)
         if (faceInfo.person.name().isEmpty())
@@ -346,6 +354,12 @@ void PeopleManipulator::store_people_information()
             backend.peopleInformationAccessor().store(faceInfo);
         });
     }
+
+    // faces on this photo were reviewed, no need to look for them in background
+    m_db.exec([id = m_pid](Database::IBackend& backend)
+    {
+        backend.set(id, Database::CommonGeneralFlags::FacesAnalysed, 1);
+    });
 }
 
 
@@ -382,21 +396,21 @@ std::tuple<std::vector<Person::Fingerprint>, std::vector<Person::Id>> PeopleMani
 {
     typedef std::tuple<std::vector<Person::Fingerprint>, std::vector<Person::Id>> Result;
 
-    return evaluate<Result(Database::IBackend &)>(&m_db, [](Database::IBackend& backend)
+    DatabaseReader reader{&m_db};
+
+    return evaluate<Result(Database::IBackend &)>(&reader, [](Database::IBackend& backend)
     {
         std::vector<Person::Fingerprint> people_fingerprints;
         std::vector<Person::Id> people;
 
-        const auto all_people = backend.peopleInformationAccessor().listPeople();
-        for(const auto& person: all_people)
-        {
-            const auto fingerprints = backend.peopleInformationAccessor().fingerprintsFor(person.id());
+        const auto centroids = backend.peopleInformationAccessor().peopleCentroids();
+        people_fingerprints.reserve(centroids.size());
+        people.reserve(centroids.size());
 
-            if (fingerprints.empty() == false)
-            {
-                people_fingerprints.push_back(average_fingerprint(fingerprints));
-                people.push_back(person.id());
-            }
+        for(const auto& [id, centroid]: centroids)
+        {
+            people_fingerprints.push_back(centroid);
+            people.push_back(id);
         }
 
         return std::tuple(people_fingerprints, people);
@@ -408,8 +422,10 @@ std::map<PersonInfo::Id, PersonFingerprint> PeopleManipulator::fetchFingerprints
 {
     typedef std::map<PersonInfo::Id, PersonFingerprint> Result;
 
+    DatabaseReader reader{&m_db};
+
     return evaluate<Result(Database::IBackend &)>
-                    (&m_db, [ids](Database::IBackend& backend)
+                    (&reader, [ids](Database::IBackend& backend)
     {
         const Result result = backend.peopleInformationAccessor().fingerprintsFor(ids);
 
@@ -41,6 +41,7 @@ class PeopleManipulator: public QObject
         void store();
 
     signals:
+        void imageLoaded(const QImage &) const;
         void facesAnalyzed() const;
 
     private:
@@ -67,6 +68,7 @@ class PeopleManipulator: public QObject
 
         void findFaces();
         void findFaces_thrd();
+        void findFaces_image(const QImage &);
         void findFaces_result(const QVector<QRect> &);
 
         void recognizeFaces();
@@ -19,6 +19,7 @@
 
 #include "tag_value_model.hpp"
 
+#include <QHash>
 #include <QLocale>
 
 #include <core/base_tags.hpp>
@@ -66,6 +67,12 @@ TagValueModel::TagValueModel(const std::set<TagTypes>& infos, ITagInfoCollector*
     connect(m_tagInfoCollector, &ITagInfoCollector::setOfValuesChanged,
             this,               &TagValueModel::collectorNotification);
 
+    connect(m_tagInfoCollector, &ITagInfoCollector::valuesAdded,
+            this,               &TagValueModel::valuesAdded);
+
+    connect(m_tagInfoCollector, &ITagInfoCollector::valuesRemoved,
+            this,               &TagValueModel::valuesRemoved);
+
     updateData();
 }
 
@@ -120,3 +127,59 @@ void TagValueModel::collectorNotification(const TagTypes& tagType)
     if ( m_tagInfos.find(tagType) != m_tagInfos.end())
         updateData();
 }
+
+
+void TagValueModel::valuesAdded(const TagTypes& tagType, const std::vector<TagValue>& values)
+{
+    if (m_tagInfos.find(tagType) != m_tagInfos.end() && values.empty() == false)
+    {
+        const QLocale locale;
+        const int first = m_values.size();
+
+        for(const TagValue& value: values)
+            m_values.append(localize(value.get(), locale));
+
+        emit rowsAppended(first, m_values.size() - 1);
+    }
+}
+
+
+void TagValueModel::valuesRemoved(const TagTypes& tagType, const std::vector<TagValue>& values)
+{
+    if (m_tagInfos.find(tagType) != m_tagInfos.end() && values.empty() == false)
+    {
+        const QLocale locale;
+
+        // number of occurrences of each value to be removed
+        QHash<QString, int> toRemove;
+        for(const TagValue& value: values)
+            toRemove[localize(value.get(), locale)]++;
+
+        // find rows to remove with one pass
+        std::vector<int> rows;
+        for(int row = 0; row < m_values.size() && rows.size() < values.size(); row++)
+        {
+            auto it = toRemove.find(m_values[row]);
+
+            if (it != toRemove.end() && it.value() > 0)
+            {
+                it.value()--;
+                rows.push_back(row);
+            }
+        }
+
+        // remove contiguous ranges of rows starting from the last one, so rows of remaining ranges stay valid
+        for(auto last = rows.rbegin(); last != rows.rend();)
+        {
+            auto first = last;
+            while(std::next(first) != rows.rend() && *std::next(first) + 1 == *first)
+                ++first;
+
+            m_values.erase(m_values.begin() + *first, m_values.begin() + *last + 1);
+
+            emit rowsRemoved(*first, *last);
+
+            last = std::next(first);
+        }
+    }
+}
@@ -47,6 +47,8 @@ class TagValueModel: public IModelCompositorDataSource
 
         void updateData();
         void collectorNotification(const TagTypes &);
+        void valuesAdded(const TagTypes &, const std::vector<TagValue> &);
+        void valuesRemoved(const TagTypes &, const std::vector<TagValue> &);
 };
 
 #endif // TAGVALUEMODEL_HPP
@@ -29,6 +29,8 @@
 #include <core/iexif_reader.hpp>
 #include <core/ilogger.hpp>
 #include <core/ilogger_factory.hpp>
+#include <core/task_executor_utils.hpp>
+#include <database/database_tools/cached_exif_reader.hpp>
 #include <database/idatabase.hpp>
 
 #include "ui/photos_grouping_dialog.hpp"
@@ -46,6 +48,7 @@ namespace
     constexpr int GroupTypeRole = PhotoDataRole + 1;
     constexpr int thumbnail_size = 64;
     const QString loadedPropertyName("loaded");
+    const QString progressPropertyName("progress");
 }
 
 SeriesDetection::SeriesDetection(Database::IDatabase* db,
@@ -58,7 +61,8 @@ SeriesDetection::SeriesDetection(Database::IDatabase* db,
     m_db(db),
     m_project(project),
     m_qmlView(nullptr),
-    m_thumbnailsManager4QML(thbMgr)
+    m_thumbnailsManager4QML(thbMgr),
+    m_cancelled(std::make_shared<std::atomic<bool>>(false))
 {
     // dialog top layout setup
     resize(320, 480);
@@ -68,6 +72,7 @@ SeriesDetection::SeriesDetection(Database::IDatabase* db,
 
     // NOTE: https://machinekoder.com/creating-qml-properties-dynamically-runtime-c/
     m_modelDynamicProperties.insert(loadedPropertyName, false);
+    m_modelDynamicProperties.insert(progressPropertyName, 0);
 
     m_tabModel->setItemRoleNames( {
         {PhotoDataRole, "photoData"},
@@ -98,6 +103,8 @@ SeriesDetection::SeriesDetection(Database::IDatabase* db,
 
 SeriesDetection::~SeriesDetection()
 {
+    // stop detection (if still running) and make sure it won't reach us
+    *m_cancelled = true;
     m_callback_mgr.invalidate();
 
     // delete qml view before all other objects it referes to will be deleted
@@ -107,44 +114,110 @@ SeriesDetection::~SeriesDetection()
 
 void SeriesDetection::fetch_series(Database::IBackend& backend)
 {
-    IExifReaderFactory& exif = m_core->getExifReaderFactory();
-    SeriesDetector detector(backend, exif.get());
+    // read photos in db thread, but analyze them (which includes reading exif of each photo)
+    // in task executor, so database is not blocked for the time of detection
+    const std::vector<Photo::Data> photos = SeriesDetector::readCandidates(backend);
 
-    const auto candidates = detector.listCandidates();
+    std::vector<Photo::Id> ids;
+    ids.reserve(photos.size());
 
-    // go back to main thread
-    invokeMethod(this, &SeriesDetection::load_series, candidates);
+    for (const Photo::Data& photo: photos)
+        ids.push_back(photo.id);
+
+    // exif data stored in database, so files do not need to be opened again
+    const std::map<Photo::Id, Database::ExifFeatures> features = backend.exifFeaturesOperator().getFeatures(ids);
+
+    detect_series(photos, features);
 }
 
 
-void SeriesDetection::load_series(const std::vector<SeriesDetector::GroupCandidate>& candidates)
+void SeriesDetection::detect_series(const std::vector<Photo::Data>& photos, const std::map<Photo::Id, Database::ExifFeatures>& features)
 {
-    for(std::size_t i = 0; i < candidates.size(); i++)
+    auto candidateFound = m_callback_mgr.make_safe_callback<const SeriesDetector::GroupCandidate &>([this](const SeriesDetector::GroupCandidate& candidate)
+    {
+        invokeMethod(this, &SeriesDetection::add_candidate, candidate);
+    });
+
+    auto progressChanged = m_callback_mgr.make_safe_callback<int>([this](int progress)
+    {
+        invokeMethod(this, &SeriesDetection::set_progress, progress);
+    });
+
+    auto finished = m_callback_mgr.make_safe_callback<>([this]()
     {
-        const SeriesDetector::GroupCandidate& candidate = candidates[i];
-        const Photo::Data& representativeData = candidate.members.front();
+        invokeMethod(this, &SeriesDetection::detection_finished);
+    });
 
-        QList<QStandardItem *> row;
+    runOn(&m_core->getTaskExecutor(), [photos, features, db = m_db, exifFactory = &m_core->getExifReaderFactory(), cancelled = m_cancelled, candidateFound, progressChanged, finished]()
+    {
+        int reportedProgress = -1;
+
+        CachedExifReader exifReader(*exifFactory->get(), photos, features);
+
+        const SeriesDetector detector(&exifReader);
+        detector.listCandidates(photos, SeriesDetector::Rules(), candidateFound,
+                                [&reportedProgress, &progressChanged](std::size_t done, std::size_t total)
+                                {
+                                    // report whole percents only
+                                    const int progress = static_cast<int>(done * 100 / total);
+
+                                    if (progress != reportedProgress)
+                                    {
+                                        reportedProgress = progress;
+                                        progressChanged(progress);
+                                    }
+                                },
+                                [&cancelled]()
+                                {
+                                    return cancelled->load();
+                                });
+
+        // store exif data read from files for the next time
+        if (exifReader.refreshed().empty() == false)
+            db->exec([refreshed = exifReader.refreshed()](Database::IBackend& backend)
+            {
+                backend.exifFeaturesOperator().storeFeatures(refreshed);
+            });
+
+        finished();
+    });
+}
 
-        QString type;
-        switch (candidate.type)
-        {
-            case Group::Type::Invalid:                           break;
-            case Group::Type::Animation: type = tr("Animation"); break;
-            case Group::Type::HDR:       type = tr("HDR");       break;
-            case Group::Type::Generic:   type = tr("Generic");   break;
-        }
 
-        QStandardItem* groupItem = new QStandardItem;
-        groupItem->setData(QVariant::fromValue(representativeData), PhotoDataRole);
-        groupItem->setData(QVariant::fromValue(candidate), DetailsRole);
-        groupItem->setData(type, GroupTypeRole);
+void SeriesDetection::add_candidate(const SeriesDetector::GroupCandidate& candidate)
+{
+    const Photo::Data& representativeData = candidate.members.front();
 
-        row.append(groupItem);
+    QList<QStandardItem *> row;
 
-        m_tabModel->appendRow(row);
+    QString type;
+    switch (candidate.type)
+    {
+        case Group::Type::Invalid:                           break;
+        case Group::Type::Animation: type = tr("Animation"); break;
+        case Group::Type::HDR:       type = tr("HDR");       break;
+        case Group::Type::Generic:   type = tr("Generic");   break;
     }
 
+    QStandardItem* groupItem = new QStandardItem;
+    groupItem->setData(QVariant::fromValue(representativeData), PhotoDataRole);
+    groupItem->setData(QVariant::fromValue(candidate), DetailsRole);
+    groupItem->setData(type, GroupTypeRole);
+
+    row.append(groupItem);
+
+    m_tabModel->appendRow(row);
+}
+
+
+void SeriesDetection::set_progress(int progress)
+{
+    m_modelDynamicProperties.insert(progressPropertyName, progress);
+}
+
+
+void SeriesDetection::detection_finished()
+{
     m_modelDynamicProperties.insert(loadedPropertyName, true);
 }
 
@@ -19,12 +19,16 @@
 #ifndef SERIESDETECTION_HPP
 #define SERIESDETECTION_HPP
 
+#include <atomic>
+#include <memory>
+
 #include <QDialog>
 #include <QQmlPropertyMap>
 
 #include <core/function_wrappers.hpp>
 #include <core/ithumbnails_manager.hpp>
 #include <database/database_tools/series_detector.hpp>
+#include <database/iexif_features_operator.hpp>
 #include <database/photo_data.hpp>
 #include "quick_views/qml_setup.hpp"
 
@@ -58,9 +62,13 @@ class SeriesDetection: public QDialog
         Project* m_project;
         QQuickWidget* m_qmlView;
         QML_IThumbnailsManager m_thumbnailsManager4QML;
+        std::shared_ptr<std::atomic<bool>> m_cancelled;
 
         void fetch_series(Database::IBackend &);
-        void load_series(const std::vector<SeriesDetector::GroupCandidate> &);
+        void detect_series(const std::vector<Photo::Data> &, const std::map<Photo::Id, Database::ExifFeatures> &);
+        void add_candidate(const SeriesDetector::GroupCandidate &);
+        void set_progress(int);
+        void detection_finished();
         void launch_groupping_dialog(const std::vector<Photo::Data> &, Group::Type);
         int selected_row() const;
 
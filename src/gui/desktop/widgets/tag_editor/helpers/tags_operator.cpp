@@ -19,15 +19,25 @@
 
 #include "tags_operator.hpp"
 
+#include <algorithm>
+
 #include <QObject>
 
+#include <database/idatabase.hpp>
+
 
-TagsOperator::TagsOperator(): m_photos()
+TagsOperator::TagsOperator(): m_photos(), m_database(nullptr)
 {
 
 }
 
 
+void TagsOperator::set(Database::IDatabase* database)
+{
+    m_database = database;
+}
+
+
 void TagsOperator::operateOn(const std::vector<IPhotoInfo::Ptr>& photos)
 {
     m_photos = photos;
@@ -70,17 +80,28 @@ Tag::TagsList TagsOperator::getTags() const
 }
 
 
-void TagsOperator::setTag(const TagTypes& name, const TagValue& values)
+void TagsOperator::setTag(const TagTypes& name, const TagValue& value)
 {
-    for (auto& photo: m_photos)
-        photo->setTag(name, values);
+    updateTags([&name, &value](Tag::TagsList& tags)
+    {
+        if (value.type() == Tag::ValueType::Empty)
+            tags.erase(name);
+        else
+            tags[name] = value;
+    });
 }
 
 
 void TagsOperator::setTags(const Tag::TagsList& tags)
 {
-    for (auto& photo: m_photos)
-        photo->setTags(tags);
+    updateTags([&tags](Tag::TagsList& photoTags)
+    {
+        // copy only non empty tags
+        std::copy_if(tags.cbegin(), tags.cend(), std::inserter(photoTags, photoTags.end()), [](const auto& item)
+        {
+            return item.second.type() != Tag::ValueType::Empty;
+        });
+    });
 }
 
 
@@ -107,3 +128,46 @@ void TagsOperator::insert(const TagTypes& name, const TagValue& value)
     if (updated == false)
         setTag(name, value);
 }
+
+
+void TagsOperator::updateTags(const std::function<void(Tag::TagsList &)>& change)
+{
+    // Collect changes of all photos and store them at once,
+    // so database gets one update and emits one photosModified() for all of them.
+
+    std::vector<Photo::DataDelta> deltas;
+    deltas.reserve(m_photos.size());
+
+    for (auto& photo: m_photos)
+    {
+        const Tag::TagsList currentTags = photo->getTags();
+        Tag::TagsList tags = currentTags;
+
+        change(tags);
+
+        if (tags != currentTags)
+        {
+            // pass changed tags only, so changes done meanwhile by others are not overwritten
+            Photo::DataDelta delta(photo->getID());
+
+            for (const auto& [name, value]: currentTags)
+                if (tags.find(name) == tags.end())
+                    delta.clearTag(name);
+
+            for (const auto& [name, value]: tags)
+            {
+                auto it = currentTags.find(name);
+
+                if (it == currentTags.end() || it->second != value)
+                    delta.setTag(name, value);
+            }
+
+            photo->apply(delta);
+
+            deltas.push_back(delta);
+        }
+    }
+
+    if (m_database != nullptr && deltas.empty() == false)
+        m_database->update(deltas);
+}
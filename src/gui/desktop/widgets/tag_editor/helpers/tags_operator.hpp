@@ -20,17 +20,25 @@
 #ifndef TAGS_OPERATOR_HPP
 #define TAGS_OPERATOR_HPP
 
+#include <functional>
 #include <vector>
 
 #include <database/iphoto_info.hpp>
 
 #include "itags_operator.hpp"
 
+namespace Database
+{
+    struct IDatabase;
+}
+
 class TagsOperator: public ITagsOperator
 {
     public:
         TagsOperator();
 
+        void set(Database::IDatabase *);
+
         void operateOn(const std::vector< IPhotoInfo::Ptr >&) override;
 
         Tag::TagsList getTags() const override;
@@ -41,6 +49,9 @@ class TagsOperator: public ITagsOperator
 
     private:
         std::vector<IPhotoInfo::Ptr> m_photos;
+        Database::IDatabase* m_database;
+
+        void updateTags(const std::function<void(Tag::TagsList &)> &);
 };
 
 #endif // TAGS_OPERATOR_HPP
@@ -57,6 +57,7 @@ TagEditorWidget::~TagEditorWidget()
 void TagEditorWidget::setDatabase(Database::IDatabase* db)
 {
     m_model->set(db);
+    m_tagsOperator.set(db);
 }
 
 
@@ -11,8 +11,13 @@ addTestTarget(gui
                 SOURCES
                     desktop/models/aphoto_info_model.cpp
                     desktop/models/flat_model.cpp
+                    desktop/utils/faces_analyzer.cpp
                     desktop/utils/model_index_utils.cpp
+                    desktop/utils/grouppers/exposure_fusion.cpp
+                    desktop/utils/grouppers/gif_encoder.cpp
+                    desktop/utils/grouppers/preview_cache.cpp
                     desktop/quick_views/selection_manager_component.cpp
+                    desktop/widgets/tag_editor/helpers/tags_operator.cpp
 
                     # model tests:
                     unit_tests/model/aphoto_info_model_tests.cpp
@@ -26,9 +31,16 @@ addTestTarget(gui
                     unit_tests/test_helpers/internal_task_executor.hpp
 
                     # utils:
+                    unit_tests/utils/exposure_fusion_tests.cpp
+                    unit_tests/utils/faces_analyzer_tests.cpp
+                    unit_tests/utils/gif_encoder_tests.cpp
                     unit_tests/utils/model_index_utils_tests.cpp
+                    unit_tests/utils/preview_cache_tests.cpp
                     unit_tests/utils/selection_manager_component_tests.cpp
 
+                    # widgets:
+                    unit_tests/widgets/tags_operator_tests.cpp
+
                     # main()
                     unit_tests/main.cpp
 
@@ -36,8 +48,10 @@ addTestTarget(gui
                     core
                     database
                     database_memory_backend
+                    face_recognition
                     photos_crawler
                     sample_dbs
+                    system
                     Qt::Core
                     Qt::Gui
                     Qt::Widgets
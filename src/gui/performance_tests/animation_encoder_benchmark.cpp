@@ -0,0 +1,146 @@
+
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QStandardPaths>
+
+#include <core/stopwatch.hpp>
+#include <core/task_executor.hpp>
+#include <core/task_executor_utils.hpp>
+#include <system/system.hpp>
+#include <unit_tests_utils/empty_logger.hpp>
+
+#include "desktop/utils/grouppers/gif_encoder.hpp"
+
+
+namespace
+{
+    constexpr int BurstSize = 30;
+    constexpr int Scale = 25;               // in percents
+    const QSize PhotoSize(4000, 3000);
+
+    // generate a burst of photos with an object moving over static background
+    QStringList generateBurst(const QString& dir)
+    {
+        QStringList photos;
+
+        QImage background(PhotoSize, QImage::Format_RGB32);
+        for (int y = 0; y < PhotoSize.height(); y++)
+            for (int x = 0; x < PhotoSize.width(); x++)
+                background.setPixel(x, y, qRgb(x * 255 / PhotoSize.width(), y * 255 / PhotoSize.height(), (x ^ y) & 0xff));
+
+        for (int i = 0; i < BurstSize; i++)
+        {
+            QImage photo = background;
+
+            for (int y = 1000; y < 1600; y++)
+                for (int x = i * 100; x < i * 100 + 600; x++)
+                    photo.setPixel(x, y, qRgb(255, i * 8, 0));
+
+            const QString path = QString("%1/%2.jpeg").arg(dir).arg(i, 2, 10, QChar('0'));
+            photo.save(path, "JPEG", 95);
+            photos.append(path);
+        }
+
+        return photos;
+    }
+}
+
+
+TEST(AnimationEncoderBenchmark, thirtyFramesBurst)
+{
+    auto tmpDir = System::createTmpDir("AnimationEncoderBenchmark", System::Confidential);
+    const QStringList photos = generateBurst(tmpDir->path());
+
+    EmptyLogger logger;
+    TaskExecutor executor(&logger);
+    Stopwatch stopwatch;
+
+    // native encoder: load, scale and encode in process
+    stopwatch.start();
+
+    std::vector<GifEncoder::Frame> frames(photos.size());
+    parallelFor(&executor, frames.size(), executor.heavyWorkers(), [&](std::size_t i)
+    {
+        const QImage photo(photos[static_cast<int>(i)]);
+        frames[i] = { photo.scaled(photo.size() * (Scale / 100.0), Qt::IgnoreAspectRatio, Qt::SmoothTransformation), 10 };
+    });
+
+    QFile native(tmpDir->path() + "/native.gif");
+    ASSERT_TRUE(native.open(QIODevice::WriteOnly));
+
+    GifEncoder encoder(executor);
+    ASSERT_TRUE(encoder.encode(frames, native));
+    native.close();
+
+    const int native_time = stopwatch.stop();
+
+    std::cout << "native encoder: " << native_time << "ms, " << native.size() / 1024 << "KiB" << std::endl;
+
+    // ImageMagick's convert
+    const QString magick = QStandardPaths::findExecutable("magick");
+    const QString convert = QStandardPaths::findExecutable("convert");
+
+    if (magick.isEmpty() && convert.isEmpty())
+        GTEST_SKIP() << "ImageMagick not found, skipping comparison with convert";
+
+    QStringList args;
+    if (magick.isEmpty() == false)
+        args << "convert";
+
+    const QString output = tmpDir->path() + "/convert.gif";
+    args << "-delay" << "10" << photos << "-loop" << "0" << "-scale" << QString("%1%").arg(Scale) << output;
+
+    stopwatch.start();
+
+    QProcess process;
+    process.start(magick.isEmpty()? convert: magick, args);
+    ASSERT_TRUE(process.waitForFinished(-1));
+
+    const int convert_time = stopwatch.stop();
+
+    std::cout << "convert:        " << convert_time << "ms, " << QFileInfo(output).size() / 1024 << "KiB" << std::endl;
+}
+
+
+TEST(AnimationEncoderBenchmark, delayChangeOfEncodedBurst)
+{
+    auto tmpDir = System::createTmpDir("AnimationEncoderBenchmark", System::Confidential);
+    const QStringList photos = generateBurst(tmpDir->path());
+
+    EmptyLogger logger;
+    TaskExecutor executor(&logger);
+    Stopwatch stopwatch;
+
+    std::vector<QImage> frames(photos.size());
+    parallelFor(&executor, frames.size(), executor.heavyWorkers(), [&](std::size_t i)
+    {
+        const QImage photo(photos[static_cast<int>(i)]);
+        frames[i] = photo.scaled(photo.size() * (Scale / 100.0), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    });
+
+    // compressed frames are kept by preview cache, only delays change
+    GifEncoder encoder(executor);
+    GifEncoder::EncodedAnimation animation;
+    ASSERT_TRUE(encoder.encode(frames, animation));
+
+    std::vector<int> delays(frames.size(), 10);
+    delays.back() = 100;
+
+    stopwatch.start();
+
+    QFile output(tmpDir->path() + "/delayed.gif");
+    ASSERT_TRUE(output.open(QIODevice::WriteOnly));
+    ASSERT_TRUE(GifEncoder::write(animation, delays, output));
+    output.close();
+
+    const int write_time = stopwatch.stop();
+
+    std::cout << "delay change:   " << write_time << "ms, " << output.size() / 1024 << "KiB" << std::endl;
+
+    EXPECT_LT(write_time, 1000);
+}
@@ -0,0 +1,147 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <desktop/utils/grouppers/exposure_fusion.hpp>
+#include <unit_tests_utils/fake_task_executor.hpp>
+
+
+namespace
+{
+    QImage texture(const QSize& size, double gain, const QPoint& shift = QPoint())
+    {
+        QImage image(size, QImage::Format_RGB32);
+
+        for (int y = 0; y < size.height(); y++)
+            for (int x = 0; x < size.width(); x++)
+            {
+                const int sx = x - shift.x();
+                const int sy = y - shift.y();
+                const double value = 0.5 + 0.3 * std::sin(sx * 0.3) * std::cos(sy * 0.2) + 0.15 * std::sin((sx + sy) * 0.05);
+
+                auto component = [value, gain](double k)
+                {
+                    return static_cast<int>(std::clamp(value * k * gain * 255.0, 0.0, 255.0));
+                };
+
+                image.setPixel(x, y, qRgb(component(1.0), component(0.8), component(0.6)));
+            }
+
+        return image;
+    }
+
+    int maxDifference(const QImage& lhs, const QImage& rhs, int margin = 0)
+    {
+        int difference = 0;
+
+        for (int y = margin; y < lhs.height() - margin; y++)
+            for (int x = margin; x < lhs.width() - margin; x++)
+            {
+                const QRgb l = lhs.pixel(x, y);
+                const QRgb r = rhs.pixel(x, y);
+
+                difference = std::max({difference,
+                                       std::abs(qRed(l) - qRed(r)),
+                                       std::abs(qGreen(l) - qGreen(r)),
+                                       std::abs(qBlue(l) - qBlue(r))});
+            }
+
+        return difference;
+    }
+
+    double meanGreen(const QImage& image)
+    {
+        double sum = 0.0;
+
+        for (int y = 0; y < image.height(); y++)
+            for (int x = 0; x < image.width(); x++)
+                sum += qGreen(image.pixel(x, y));
+
+        return sum / (image.width() * image.height());
+    }
+}
+
+
+TEST(ExposureFusionTest, identicalPhotosGiveSamePhoto)
+{
+    FakeTaskExecutor executor;
+    ExposureFusion fusion(executor);
+
+    const QImage photo = texture(QSize(160, 120), 1.0);
+    const QImage result = fusion.fuse(3, [&photo](std::size_t) { return photo; });
+
+    ASSERT_EQ(result.size(), photo.size());
+    EXPECT_LE(maxDifference(result, photo), 1);
+}
+
+
+TEST(ExposureFusionTest, photosAreAligned)
+{
+    FakeTaskExecutor executor;
+    ExposureFusion fusion(executor);
+
+    const QImage reference = texture(QSize(160, 120), 1.0);
+    const QImage shifted = texture(QSize(160, 120), 1.0, QPoint(3, 2));
+    const QImage result = fusion.fuse(2, [&](std::size_t i) { return i == 0? reference: shifted; });
+
+    ASSERT_GT(maxDifference(reference, shifted, 8), 32);
+    EXPECT_LE(maxDifference(result, reference, 8), 1);
+}
+
+
+TEST(ExposureFusionTest, wellExposedPartsArePreferred)
+{
+    FakeTaskExecutor executor;
+    ExposureFusion fusion(executor);
+
+    const QImage dark = texture(QSize(160, 120), 0.3);
+    const QImage bright = texture(QSize(160, 120), 2.5);
+    const QImage result = fusion.fuse(2, [&](std::size_t i) { return i == 0? dark: bright; });
+
+    const double mean = meanGreen(result);
+
+    EXPECT_GT(mean, meanGreen(dark) + 50);
+    EXPECT_LT(mean, meanGreen(bright) - 50);
+}
+
+
+TEST(ExposureFusionTest, progressIsReported)
+{
+    FakeTaskExecutor executor;
+    ExposureFusion fusion(executor);
+
+    const QImage photo = texture(QSize(64, 64), 1.0);
+    std::vector<int> progress;
+
+    fusion.fuse(2, [&photo](std::size_t) { return photo; }, [&progress](int p) { progress.push_back(p); });
+
+    EXPECT_THAT(progress, testing::ElementsAre(20, 40, 60, 80, 100));
+}
+
+
+TEST(ExposureFusionTest, cancelledFusionGivesNullImage)
+{
+    FakeTaskExecutor executor;
+    ExposureFusion fusion(executor);
+
+    const QImage photo = texture(QSize(64, 64), 1.0);
+    int checks = 0;
+
+    const QImage result = fusion.fuse(3, [&photo](std::size_t) { return photo; }, {}, [&checks]() { return ++checks > 2; });
+
+    EXPECT_TRUE(result.isNull());
+}
+
+
+TEST(ExposureFusionTest, missingPhotoGivesNullImage)
+{
+    FakeTaskExecutor executor;
+    ExposureFusion fusion(executor);
+
+    const QImage photo = texture(QSize(64, 64), 1.0);
+    const QImage result = fusion.fuse(2, [&photo](std::size_t i) { return i == 0? photo: QImage(); });
+
+    EXPECT_TRUE(result.isNull());
+}
@@ -0,0 +1,275 @@
+
+#include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <gmock/gmock.h>
+
+#include <QCoreApplication>
+#include <QKeyEvent>
+
+#include <database/backends/memory_backend/memory_backend.hpp>
+#include <database/general_flags.hpp>
+#include <database/iphoto_operator.hpp>
+#include <desktop/utils/faces_analyzer.hpp>
+#include "unit_tests_utils/mock_core_factory_accessor.hpp"
+#include "unit_tests_utils/mock_database.hpp"
+
+
+using namespace std::chrono_literals;
+using testing::_;
+using testing::Invoke;
+using testing::IsEmpty;
+using testing::NiceMock;
+using testing::ReturnRef;
+using testing::SizeIs;
+using testing::UnorderedElementsAreArray;
+
+
+namespace
+{
+    // keeps tasks until test runs them
+    struct QueuedTaskExecutor: ITaskExecutor
+    {
+        void add(std::unique_ptr<ITask>&& task) override
+        {
+            tasks.push_back(std::move(task));
+        }
+
+        void addLight(std::unique_ptr<ITask>&& task) override
+        {
+            tasks.push_back(std::move(task));
+        }
+
+        int heavyWorkers() const override
+        {
+            return 4;
+        }
+
+        std::unique_ptr<ITask> take()
+        {
+            std::unique_ptr<ITask> task = std::move(tasks.front());
+            tasks.pop_front();
+
+            return task;
+        }
+
+        void runNext()
+        {
+            take()->perform();
+        }
+
+        void runAll()
+        {
+            while(tasks.empty() == false)
+                runNext();
+        }
+
+        std::deque<std::unique_ptr<ITask>> tasks;
+    };
+}
+
+
+class FacesAnalyzerTest: public testing::Test
+{
+    public:
+        FacesAnalyzerTest()
+        {
+            ON_CALL(coreFactory, getTaskExecutor()).WillByDefault(ReturnRef(executor));
+
+            ON_CALL(db, execute(_)).WillByDefault(Invoke([this](std::unique_ptr<Database::IDatabase::ITask>&& task)
+            {
+                task->run(backend);
+            }));
+
+            ON_CALL(db, backend()).WillByDefault(ReturnRef(backend));
+        }
+
+        std::vector<Photo::Id> addPhotos(int count)
+        {
+            std::vector<Photo::DataDelta> photos(count);
+            for (int i = 0; i < count; i++)
+                photos[i].insert<Photo::Field::Path>(QString("photo%1.jpeg").arg(i));
+
+            backend.addPhotos(photos);
+
+            std::vector<Photo::Id> ids;
+            for (const Photo::DataDelta& photo: photos)
+                ids.push_back(photo.getId());
+
+            return ids;
+        }
+
+        // detector finding one face on each photo
+        FacesAnalyzer::DetectorFactory detector()
+        {
+            return [this]() -> FacesAnalyzer::Detector
+            {
+                return [this](const QString& path)
+                {
+                    std::lock_guard<std::mutex> lock(detectedMutex);
+                    detected.push_back(path);
+
+                    return QVector<QRect>{ QRect(10, 10, 50, 50) };
+                };
+            };
+        }
+
+        std::vector<Photo::Id> analysedPhotos()
+        {
+            const Database::FilterPhotosWithGeneralFlags filter(Database::CommonGeneralFlags::FacesAnalysed, 1);
+
+            return backend.photoOperator().getPhotos(filter);
+        }
+
+        void simulateUserActivity()
+        {
+            QObject receiver;
+            QKeyEvent keyPress(QEvent::KeyPress, Qt::Key_A, Qt::NoModifier);
+
+            QCoreApplication::sendEvent(&receiver, &keyPress);
+        }
+
+        Database::MemoryBackend backend;
+        NiceMock<MockDatabase> db;
+        NiceMock<MockCoreFactoryAccessor> coreFactory;
+        QueuedTaskExecutor executor;
+        std::mutex detectedMutex;
+        std::vector<QString> detected;
+};
+
+
+TEST_F(FacesAnalyzerTest, photosAreAnalyzedInBatches)
+{
+    const std::vector<Photo::Id> photos = addPhotos(40);
+
+    FacesAnalyzer analyzer(&coreFactory, &db, detector());
+
+    // 16 + 16 + 8 photos, all batches can be processed in parallel when user is idle
+    EXPECT_EQ(executor.tasks.size(), 3);
+
+    executor.runAll();
+
+    EXPECT_THAT(detected, SizeIs(40));
+    EXPECT_THAT(analysedPhotos(), UnorderedElementsAreArray(photos));
+
+    for (const Photo::Id& id: photos)
+        EXPECT_THAT(backend.peopleInformationAccessor().listPeople(id), SizeIs(1));
+}
+
+
+TEST_F(FacesAnalyzerTest, analysisIsResumedFromNotAnalysedPhotos)
+{
+    const std::vector<Photo::Id> photos = addPhotos(20);
+
+    // first 12 photos were analysed before application was closed
+    std::map<Photo::Id, std::vector<QRect>> analysed;
+    for (std::size_t i = 0; i < 12; i++)
+        analysed.emplace(photos[i], std::vector<QRect>());
+
+    backend.peopleInformationAccessor().storeDetectedFaces(analysed);
+
+    FacesAnalyzer analyzer(&coreFactory, &db, detector());
+    executor.runAll();
+
+    EXPECT_THAT(detected, SizeIs(8));
+    EXPECT_THAT(analysedPhotos(), UnorderedElementsAreArray(photos));
+
+    for (std::size_t i = 0; i < photos.size(); i++)
+        EXPECT_THAT(backend.peopleInformationAccessor().listPeople(photos[i]), SizeIs(i < 12? 0: 1));
+}
+
+
+TEST_F(FacesAnalyzerTest, newPhotosAreAnalyzed)
+{
+    FacesAnalyzer analyzer(&coreFactory, &db, detector());
+    EXPECT_THAT(executor.tasks, IsEmpty());
+
+    const std::vector<Photo::Id> photos = addPhotos(5);
+    EXPECT_EQ(executor.tasks.size(), 1);
+
+    executor.runAll();
+
+    EXPECT_THAT(analysedPhotos(), UnorderedElementsAreArray(photos));
+}
+
+
+TEST_F(FacesAnalyzerTest, oneBatchAtTimeWhenUserIsActive)
+{
+    FacesAnalyzer analyzer(&coreFactory, &db, detector());
+
+    simulateUserActivity();
+
+    const std::vector<Photo::Id> photos = addPhotos(40);
+
+    // next batch is started when previous one is done
+    for (int batch = 0; batch < 3; batch++)
+    {
+        ASSERT_EQ(executor.tasks.size(), 1);
+        executor.runNext();
+    }
+
+    EXPECT_THAT(executor.tasks, IsEmpty());
+    EXPECT_THAT(analysedPhotos(), UnorderedElementsAreArray(photos));
+}
+
+
+TEST_F(FacesAnalyzerTest, stopWaitsForRunningTask)
+{
+    const std::vector<Photo::Id> photos = addPhotos(16);
+
+    std::promise<void> started;
+    std::promise<void> released;
+    std::shared_future<void> release = released.get_future().share();
+
+    // detector blocks on first photo until released
+    auto blockingDetector = [&]() -> FacesAnalyzer::Detector
+    {
+        return [&](const QString& path)
+        {
+            {
+                std::lock_guard<std::mutex> lock(detectedMutex);
+                detected.push_back(path);
+            }
+
+            if (detected.size() == 1)
+            {
+                started.set_value();
+                release.wait();
+            }
+
+            return QVector<QRect>();
+        };
+    };
+
+    FacesAnalyzer analyzer(&coreFactory, &db, blockingDetector);
+    ASSERT_EQ(executor.tasks.size(), 1);
+
+    std::unique_ptr<ITaskExecutor::ITask> task = executor.take();
+    std::thread worker([&task]
+    {
+        task->perform();
+    });
+
+    started.get_future().wait();
+
+    std::thread releaser([&released]
+    {
+        std::this_thread::sleep_for(100ms);
+        released.set_value();
+    });
+
+    // returns when task is done - results of analysed photo are stored at that point
+    analyzer.stop();
+
+    EXPECT_THAT(detected, SizeIs(1));
+    EXPECT_THAT(analysedPhotos(), SizeIs(1));
+
+    releaser.join();
+    worker.join();
+
+    // no new batches after stop
+    addPhotos(5);
+    EXPECT_THAT(executor.tasks, IsEmpty());
+}
@@ -0,0 +1,179 @@
+
+#include <gmock/gmock.h>
+
+#include <QBuffer>
+#include <QImageReader>
+
+#include <desktop/utils/grouppers/gif_encoder.hpp>
+#include <unit_tests_utils/fake_task_executor.hpp>
+
+
+namespace
+{
+    QImage gradient(const QSize& size)
+    {
+        QImage image(size, QImage::Format_RGB32);
+
+        for (int y = 0; y < size.height(); y++)
+            for (int x = 0; x < size.width(); x++)
+                image.setPixel(x, y, qRgb(x * 255 / size.width(), y * 255 / size.height(), 128));
+
+        return image;
+    }
+
+    std::vector<QImage> decode(QByteArray& data)
+    {
+        QBuffer buffer(&data);
+        QImageReader reader(&buffer, "gif");
+
+        std::vector<QImage> frames;
+
+        for (QImage frame = reader.read(); frame.isNull() == false; frame = reader.read())
+            frames.push_back(frame.convertToFormat(QImage::Format_RGB32));
+
+        return frames;
+    }
+
+    int maxDifference(const QImage& lhs, const QImage& rhs)
+    {
+        int difference = 0;
+
+        for (int y = 0; y < lhs.height(); y++)
+            for (int x = 0; x < lhs.width(); x++)
+            {
+                const QRgb l = lhs.pixel(x, y);
+                const QRgb r = rhs.pixel(x, y);
+
+                difference = std::max({difference,
+                                       std::abs(qRed(l) - qRed(r)),
+                                       std::abs(qGreen(l) - qGreen(r)),
+                                       std::abs(qBlue(l) - qBlue(r))});
+            }
+
+        return difference;
+    }
+}
+
+
+TEST(GifEncoderTest, framesWithFewColorsAreStoredLosslessly)
+{
+    FakeTaskExecutor executor;
+    GifEncoder encoder(executor);
+
+    QImage first(64, 48, QImage::Format_RGB32);
+    first.fill(Qt::blue);
+
+    QImage second = first;
+    for (int y = 10; y < 20; y++)
+        for (int x = 30; x < 40; x++)
+            second.setPixel(x, y, qRgb(255, 0, 0));
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    ASSERT_TRUE(encoder.encode({ {first, 10}, {second, 10}, {second, 20} }, buffer));
+
+    const std::vector<QImage> frames = decode(data);
+
+    ASSERT_EQ(frames.size(), 3);
+    EXPECT_EQ(maxDifference(frames[0], first), 0);
+    EXPECT_EQ(maxDifference(frames[1], second), 0);
+    EXPECT_EQ(maxDifference(frames[2], second), 0);
+}
+
+
+TEST(GifEncoderTest, manyColorsAreQuantized)
+{
+    FakeTaskExecutor executor;
+    GifEncoder encoder(executor);
+
+    const QImage image = gradient(QSize(256, 256));
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    ASSERT_TRUE(encoder.encode({ {image, 10} }, buffer));
+
+    const std::vector<QImage> frames = decode(data);
+
+    ASSERT_EQ(frames.size(), 1);
+    EXPECT_EQ(frames[0].size(), image.size());
+    EXPECT_LE(maxDifference(frames[0], image), 24);
+}
+
+
+TEST(GifEncoderTest, progressIsReported)
+{
+    FakeTaskExecutor executor;
+    GifEncoder encoder(executor);
+
+    const QImage image = gradient(QSize(32, 32));
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    std::vector<int> progress;
+    encoder.encode({ {image, 10}, {image, 10} }, buffer, [&progress](int p)
+    {
+        progress.push_back(p);
+    });
+
+    EXPECT_THAT(progress, testing::ElementsAre(25, 50, 75, 100));
+}
+
+
+TEST(GifEncoderTest, cancel)
+{
+    FakeTaskExecutor executor;
+    GifEncoder encoder(executor);
+
+    const QImage image = gradient(QSize(32, 32));
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+
+    const bool status = encoder.encode({ {image, 10} }, buffer, {}, []()
+    {
+        return true;
+    });
+
+    EXPECT_FALSE(status);
+    EXPECT_TRUE(data.isEmpty());
+}
+
+
+TEST(GifEncoderTest, encodedAnimationCanBeWrittenWithDifferentDelays)
+{
+    FakeTaskExecutor executor;
+    GifEncoder encoder(executor);
+
+    const QImage image = gradient(QSize(32, 32));
+
+    GifEncoder::EncodedAnimation animation;
+    ASSERT_TRUE(encoder.encode(std::vector<QImage>{ image, image.mirrored() }, animation));
+
+    QByteArray fast, slow;
+    QBuffer fastBuffer(&fast), slowBuffer(&slow);
+    fastBuffer.open(QIODevice::WriteOnly);
+    slowBuffer.open(QIODevice::WriteOnly);
+
+    ASSERT_TRUE(GifEncoder::write(animation, {10, 10}, fastBuffer));
+    ASSERT_TRUE(GifEncoder::write(animation, {20, 50}, slowBuffer));
+    EXPECT_FALSE(GifEncoder::write(animation, {10}, fastBuffer));        // one delay per frame expected
+
+    // only timing differs
+    EXPECT_EQ(fast.size(), slow.size());
+    EXPECT_NE(fast, slow);
+
+    const std::vector<QImage> fastFrames = decode(fast);
+    const std::vector<QImage> slowFrames = decode(slow);
+
+    ASSERT_EQ(fastFrames.size(), 2);
+    ASSERT_EQ(slowFrames.size(), 2);
+    EXPECT_EQ(maxDifference(fastFrames[0], slowFrames[0]), 0);
+    EXPECT_EQ(maxDifference(fastFrames[1], slowFrames[1]), 0);
+}
@@ -0,0 +1,145 @@
+
+#include <gmock/gmock.h>
+
+#include <QDir>
+#include <QFile>
+
+#include <desktop/utils/grouppers/preview_cache.hpp>
+#include <system/system.hpp>
+
+
+namespace
+{
+    const QStringList Photos = { "/photo1.jpeg", "/photo2.jpeg" };
+
+    PreviewCache::Frames frames(int count, const QSize& size)
+    {
+        return std::make_shared<std::vector<QImage>>(count, QImage(size, QImage::Format_RGB32));
+    }
+
+    PreviewCache::Animation animation(int bytes)
+    {
+        auto encoded = std::make_shared<GifEncoder::EncodedAnimation>();
+        encoded->frames.push_back(QByteArray(bytes, 0));
+        encoded->transparency.push_back(0);
+
+        return encoded;
+    }
+
+    PreviewCache::Files files(int bytes)
+    {
+        PreviewCache::Files result;
+        result.dir = System::createTmpDir("PreviewCacheTest", System::Generic);
+
+        const QString path = result.dir->path() + "/file";
+        QFile file(path);
+        file.open(QIODevice::WriteOnly);
+        file.write(QByteArray(bytes, 0));
+
+        result.paths.append(path);
+
+        return result;
+    }
+}
+
+
+TEST(PreviewCacheTest, storedStagesAreReturned)
+{
+    PreviewCache cache(1024 * 1024, 1024 * 1024);
+
+    const PreviewCache::Animation encoded = animation(100);
+    const PreviewCache::Frames normalized = frames(2, QSize(10, 10));
+    const PreviewCache::Files prepared = files(100);
+
+    cache.storeEncodedAnimation(Photos, 50.0, false, encoded);
+    cache.storeNormalizedPhotos(Photos, normalized);
+    cache.storePreparedPhotos(Photos, 50.0, prepared);
+
+    EXPECT_EQ(cache.encodedAnimation(Photos, 50.0, false), encoded);
+    EXPECT_EQ(cache.normalizedPhotos(Photos), normalized);
+
+    const std::optional<PreviewCache::Files> cached = cache.preparedPhotos(Photos, 50.0);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->paths, prepared.paths);
+}
+
+
+TEST(PreviewCacheTest, changedParametersMiss)
+{
+    PreviewCache cache(1024 * 1024, 1024 * 1024);
+
+    cache.storeEncodedAnimation(Photos, 50.0, false, animation(100));
+    cache.storePreparedPhotos(Photos, 50.0, files(100));
+
+    EXPECT_EQ(cache.encodedAnimation(Photos, 40.0, false), nullptr);
+    EXPECT_EQ(cache.encodedAnimation(Photos, 50.0, true), nullptr);
+    EXPECT_EQ(cache.encodedAnimation({ Photos[1], Photos[0] }, 50.0, false), nullptr);
+    EXPECT_FALSE(cache.preparedPhotos(Photos, 40.0).has_value());
+    EXPECT_FALSE(cache.alignedPhotos(Photos, 50.0).has_value());
+}
+
+
+TEST(PreviewCacheTest, leastRecentlyUsedEntryIsDroppedWhenOverBudget)
+{
+    PreviewCache cache(250, 1024 * 1024);
+
+    cache.storeEncodedAnimation(Photos, 10.0, false, animation(100));
+    cache.storeEncodedAnimation(Photos, 20.0, false, animation(100));
+
+    // use first one so second becomes the oldest
+    EXPECT_NE(cache.encodedAnimation(Photos, 10.0, false), nullptr);
+
+    cache.storeEncodedAnimation(Photos, 30.0, false, animation(100));
+
+    EXPECT_NE(cache.encodedAnimation(Photos, 10.0, false), nullptr);
+    EXPECT_EQ(cache.encodedAnimation(Photos, 20.0, false), nullptr);
+    EXPECT_NE(cache.encodedAnimation(Photos, 30.0, false), nullptr);
+}
+
+
+TEST(PreviewCacheTest, entriesBiggerThanBudgetAreNotStored)
+{
+    PreviewCache cache(100, 100);
+
+    cache.storeEncodedAnimation(Photos, 50.0, false, animation(101));
+    cache.storeNormalizedPhotos(Photos, frames(1, QSize(10, 10)));
+    cache.storePreparedPhotos(Photos, 50.0, files(101));
+
+    EXPECT_EQ(cache.encodedAnimation(Photos, 50.0, false), nullptr);
+    EXPECT_EQ(cache.normalizedPhotos(Photos), nullptr);
+    EXPECT_FALSE(cache.preparedPhotos(Photos, 50.0).has_value());
+}
+
+
+TEST(PreviewCacheTest, ramAndDiskBudgetsAreSeparate)
+{
+    PreviewCache cache(100, 100);
+
+    cache.storeEncodedAnimation(Photos, 50.0, false, animation(100));
+    cache.storePreparedPhotos(Photos, 50.0, files(100));
+
+    EXPECT_NE(cache.encodedAnimation(Photos, 50.0, false), nullptr);
+    EXPECT_TRUE(cache.preparedPhotos(Photos, 50.0).has_value());
+}
+
+
+TEST(PreviewCacheTest, droppedFilesAreRemoved)
+{
+    PreviewCache cache(100, 150);
+
+    QString dir;
+
+    {
+        const PreviewCache::Files prepared = files(100);
+        dir = prepared.dir->path();
+
+        cache.storePreparedPhotos(Photos, 50.0, prepared);
+    }
+
+    EXPECT_TRUE(QDir(dir).exists());
+
+    cache.storeAlignedPhotos(Photos, 50.0, files(100));
+
+    EXPECT_FALSE(cache.preparedPhotos(Photos, 50.0).has_value());
+    EXPECT_FALSE(QDir(dir).exists());
+}
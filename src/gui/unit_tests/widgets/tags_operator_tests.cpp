@@ -0,0 +1,99 @@
+
+#include <gmock/gmock.h>
+
+#include "desktop/widgets/tag_editor/helpers/tags_operator.hpp"
+#include "unit_tests_utils/mock_database.hpp"
+#include "unit_tests_utils/mock_photo_info.hpp"
+
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SaveArg;
+
+
+namespace
+{
+    std::shared_ptr<NiceMock<MockPhotoInfo>> photo(int id, const Tag::TagsList& tags)
+    {
+        Photo::Data data;
+        data.id = Photo::Id(id);
+        data.tags = tags;
+
+        auto photoInfo = std::make_shared<NiceMock<MockPhotoInfo>>();
+        ON_CALL(*photoInfo, data).WillByDefault(Return(data));
+        ON_CALL(*photoInfo, getTags).WillByDefault(Return(tags));
+        ON_CALL(*photoInfo, getID).WillByDefault(Return(data.id));
+
+        return photoInfo;
+    }
+}
+
+
+TEST(TagsOperatorTest, changesOfManyPhotosAreStoredAtOnce)
+{
+    NiceMock<MockDatabase> database;
+
+    auto photo1 = photo(1, { {TagTypes::Event, QString("party")} });
+    auto photo2 = photo(2, { {TagTypes::Event, QString("holiday")}, {TagTypes::Place, QString("Warsaw")} });
+    auto photo3 = photo(3, { {TagTypes::Event, QString("party")}, {TagTypes::Place, QString("Paris")} });
+
+    TagsOperator tagsOperator;
+    tagsOperator.set(&database);
+    tagsOperator.operateOn({photo1, photo2, photo3});
+
+    // photos are not stored one by one
+    EXPECT_CALL(*photo1, setTag(_, _)).Times(0);
+    EXPECT_CALL(*photo2, setTag(_, _)).Times(0);
+    EXPECT_CALL(*photo3, setTag(_, _)).Times(0);
+
+    // but updated in memory
+    EXPECT_CALL(*photo1, apply(_)).Times(0);            // already has this value
+    EXPECT_CALL(*photo2, apply(_)).Times(1);
+    EXPECT_CALL(*photo3, apply(_)).Times(0);
+
+    // whole data is not overwritten, as it could have been changed meanwhile
+    EXPECT_CALL(*photo1, setData(_)).Times(0);
+    EXPECT_CALL(*photo2, setData(_)).Times(0);
+    EXPECT_CALL(*photo3, setData(_)).Times(0);
+
+    std::vector<Photo::DataDelta> deltas;
+    EXPECT_CALL(database, update(testing::An<const std::vector<Photo::DataDelta> &>()))
+        .WillOnce(SaveArg<0>(&deltas));
+
+    tagsOperator.setTag(TagTypes::Event, QString("party"));
+
+    ASSERT_EQ(deltas.size(), 1);
+    EXPECT_EQ(deltas[0].getId(), Photo::Id(2));
+    EXPECT_FALSE(deltas[0].has(Photo::Field::Tags));
+
+    // only changed tag is expected
+    const Tag::TagsList expected_changes = { {TagTypes::Event, QString("party")} };
+    EXPECT_EQ(deltas[0].get<Photo::Field::TagsChanges>(), expected_changes);
+}
+
+
+TEST(TagsOperatorTest, tagRemoval)
+{
+    NiceMock<MockDatabase> database;
+
+    auto photo1 = photo(1, { {TagTypes::Event, QString("party")} });
+    auto photo2 = photo(2, { {TagTypes::Event, QString("holiday")}, {TagTypes::Place, QString("Warsaw")} });
+
+    TagsOperator tagsOperator;
+    tagsOperator.set(&database);
+    tagsOperator.operateOn({photo1, photo2});
+
+    std::vector<Photo::DataDelta> deltas;
+    EXPECT_CALL(database, update(testing::An<const std::vector<Photo::DataDelta> &>()))
+        .WillOnce(SaveArg<0>(&deltas));
+
+    tagsOperator.setTag(TagTypes::Event, TagValue());
+
+    ASSERT_EQ(deltas.size(), 2);
+
+    // removal is expressed as empty value
+    const Tag::TagsList expected_changes = { {TagTypes::Event, TagValue()} };
+    EXPECT_EQ(deltas[0].get<Photo::Field::TagsChanges>(), expected_changes);
+    EXPECT_EQ(deltas[1].get<Photo::Field::TagsChanges>(), expected_changes);
+}
@@ -8,6 +8,7 @@ class EmptyLogger: public ILogger
 {
     public:
         void log(Severity, const QString &) override {}
+        bool isEnabled(Severity) const override { return false; }
 
         void info(const QString &) override {}
         void warning(const QString &) override {}
@@ -96,6 +96,11 @@ public:
         m_data.groupInfo = group;
     }
 
+    void apply(const Photo::DataDelta& delta) override
+    {
+        m_data.apply(delta);
+    }
+
     void markFlag(Photo::FlagsE flag, int value) override
     {
         m_data.flags[flag] = value;
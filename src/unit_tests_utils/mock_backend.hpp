@@ -7,6 +7,7 @@
 
 #include <database/filter.hpp>
 #include <database/ibackend.hpp>
+#include <database/iexif_features_operator.hpp>
 #include <database/igroup_operator.hpp>
 #include <database/iphoto_change_log_operator.hpp>
 #include <database/iphoto_operator.hpp>
@@ -23,11 +24,14 @@ struct MockBackend: public Database::IBackend
   MOCK_METHOD(bool, update, (const std::vector<Photo::DataDelta> &), (override));
 
   MOCK_METHOD(std::vector<TagValue>, listTagValues, (const TagTypes &, const Database::Filter &), (override));
+  MOCK_METHOD(Database::TagValuesCounts, tagValuesCounts, (), (override));
   MOCK_METHOD0(getAllPhotos,
       std::vector<Photo::Id>());
   MOCK_METHOD1(getPhoto,
       Photo::Data(const Photo::Id &));
+  MOCK_METHOD(std::vector<Photo::Data>, getPhotos, (const std::vector<Photo::Id> &), (override));
   MOCK_METHOD(int, getPhotosCount, (const Database::Filter &), (override));
+  MOCK_METHOD((std::map<QDate, int>), datesHistogram, (const Database::Filter &, Database::DatesResolution), (override));
   MOCK_METHOD0(listPeople,
       std::vector<PersonName>());
   MOCK_METHOD1(listPeople,
@@ -49,6 +53,7 @@ struct MockBackend: public Database::IBackend
   MOCK_METHOD(Database::IPhotoOperator&, photoOperator, (), (override));
   MOCK_METHOD(Database::IPhotoChangeLogOperator&, photoChangeLogOperator, (), (override));
   MOCK_METHOD(Database::IPeopleInformationAccessor&, peopleInformationAccessor, (), (override));
+  MOCK_METHOD(Database::IExifFeaturesOperator&, exifFeaturesOperator, (), (override));
 };
 
 
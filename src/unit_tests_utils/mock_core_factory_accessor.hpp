@@ -0,0 +1,22 @@
+
+#ifndef MOCK_CORE_FACTORY_ACCESSOR_HPP
+#define MOCK_CORE_FACTORY_ACCESSOR_HPP
+
+#include <gmock/gmock.h>
+
+#include <core/iconfiguration.hpp>
+#include <core/icore_factory_accessor.hpp>
+#include <core/iexif_reader.hpp>
+#include <core/ilogger_factory.hpp>
+#include <core/itask_executor.hpp>
+
+
+struct MockCoreFactoryAccessor: ICoreFactoryAccessor
+{
+    MOCK_METHOD(ILoggerFactory&, getLoggerFactory, (), (override));
+    MOCK_METHOD(IExifReaderFactory&, getExifReaderFactory, (), (override));
+    MOCK_METHOD(IConfiguration&, getConfiguration, (), (override));
+    MOCK_METHOD(ITaskExecutor&, getTaskExecutor, (), (override));
+};
+
+#endif
@@ -13,6 +13,7 @@ struct MockDatabase: Database::IDatabase
 {
     MOCK_METHOD1(update, void(const IPhotoInfo::Ptr &) );
     MOCK_METHOD1(update, void(const Photo::DataDelta &) );
+    MOCK_METHOD1(update, void(const std::vector<Photo::DataDelta> &) );
 
     MOCK_METHOD2(getPhotos, void(const std::vector<Photo::Id> &, const std::function<void(const std::vector<IPhotoInfo::Ptr> &)> &) );
 
@@ -28,6 +28,7 @@ struct MockPhotoInfo: IPhotoInfo
     MOCK_METHOD2(setTag, void(const TagTypes &, const TagValue &));
     MOCK_METHOD1(setGeometry, void(const QSize &));
     MOCK_METHOD1(setGroup, void(const GroupInfo &));
+    MOCK_METHOD1(apply, void(const Photo::DataDelta &));
 
     MOCK_METHOD2(markFlag, void(Photo::FlagsE, int));
     MOCK_CONST_METHOD1(getFlag, int(Photo::FlagsE));